@@ -40,7 +40,8 @@ this:SetLayout("TitledGridBack", 2, "Home > File Systems > ramfs",
 ++*/
 
 /*--
-this:AddWidget("Spinbox", 8, 2048, "File chain size (bytes)")
+this:AddWidget("Spinbox", 8, 2048, "File chunk size (bytes)")
+this:SetToolTip("Size of regular file data chunk. Chunks are indexed by table, so\nunwritten areas of sparse files do not consume memory.")
 --*/
 #define __RAMFS_FILE_CHAIN_SIZE__ 32
 
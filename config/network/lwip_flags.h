@@ -89,6 +89,17 @@ this:SetToolTip("MEMP_SANITY_CHECK = 1: run a sanity check after each memp_free(
                 "to make sure that there are no cycles in the linked lists.")
 --*/
 #define __NETWORK_MEMP_SANITY_CHECK__ 0
+/*--
+this:AddWidget("Combobox", "Dedicated memory pools")
+this:AddItem("No (0)", "0")
+this:AddItem("Yes (1)", "1")
+this:SetToolTip("If selected yes, the PBUF_POOL, TCP_SEG, and NETBUF objects are\n"..
+                "allocated from statically reserved pools (sized by PBUF_POOL_SIZE,\n"..
+                "MEMP_NUM_TCP_SEG, and MEMP_NUM_NETBUF) instead of the kernel heap.\n"..
+                "Received packets are stored in PBUF_POOL buffers.\n"..
+                "Other lwIP objects are still allocated from the kernel heap.")
+--*/
+#define __NETWORK_MEMP_DEDICATED_POOLS__ 0
 
 
 /*------------------------------------------------------------------------------
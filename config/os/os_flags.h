@@ -103,6 +103,20 @@ this:SetToolTip("Number of threads that can be started by system process.")
 --*/
 #define __OS_TASK_MAX_SYSTEM_THREADS__ 12
 
+/*--
+this:AddWidget("Spinbox", 1, 31, "Number of file system syscall workers")
+this:SetToolTip("Number of threads pre-spawned by the kworker process to handle file system system calls. "..
+                "The sum of file system and network workers must be lower than the maximum number of system process threads.")
+--*/
+#define __OS_SYSCALL_FS_WORKERS__ 3
+
+/*--
+this:AddWidget("Spinbox", 1, 31, "Number of network syscall workers")
+this:SetToolTip("Number of threads pre-spawned by the kworker process to handle network system calls. "..
+                "Workers are used only when network is enabled.")
+--*/
+#define __OS_SYSCALL_NET_WORKERS__ 2
+
 
 /*--
 this:AddExtraWidget("Label", "LabelFeatures", "\nSystem features (advanced)", -1, "bold")
@@ -114,6 +128,14 @@ this:SetToolTip("If this option is selected then system is halted in the idle ta
 --*/
 #define __OS_SLEEP_ON_IDLE__ _NO_
 
+/*--
+this:AddWidget("Checkbox", "Tickless idle")
+this:SetToolTip("If this option is selected then system tick is stopped in the idle task and CPU sleeps until "..
+                "the nearest task timeout. Uptime and CPU load are compensated after wake up. "..
+                "CPU frequency should not be changed at runtime when this option is used. This option can prevent debugging.")
+--*/
+#define __OS_TICKLESS_IDLE__ _NO_
+
 /*--
 this:AddWidget("Checkbox", "Color terminal")
 this:SetToolTip("If this function is selected then terminal output can be colorized by using VT100 commands.")
@@ -249,7 +271,7 @@ this:SetToolTip("This value determines a size of buffer used in the particular s
 this:AddWidget("Spinbox", 8, 1024, "Length of pipe buffer [bytes]")
 this:SetToolTip("This value determines a size of buffer used in the each pipe (FIFO file).")
 --*/
-#define __OS_PIPE_LENGTH__ 8
+#define __OS_PIPE_LENGTH__ 64
 
 /*--
 this:AddWidget("Spinbox", 4, 1024, "Memory allocation size [bytes]")
@@ -257,10 +279,21 @@ this:SetToolTip("The allocation block size is a minimal memory block that can be
 --*/
 #define __HEAP_BLOCK_SIZE__ 4
 
+/*--
+this:AddWidget("Combobox", "Memory allocator")
+this:AddItem("First-fit (the smallest code)", "0")
+this:AddItem("TLSF (constant allocation time)", "1")
+this:SetToolTip("The first-fit allocator searches the heap for free block so allocation "..
+                "time depends on fragmentation. The TLSF (two-level segregated fit) "..
+                "allocator finds free block in constant time by using segregated free lists.")
+--*/
+#define __HEAP_ALLOCATOR__ 0
+
 /*--
 --this:AddExtraWidget("Void", "VoidOption")
 this:AddWidget("Spinbox", 1, 250, "System log columns")
-this:SetToolTip("This option determine how many characters in row can be stored. " ..
+this:SetToolTip("This option determine how many characters of string arguments " ..
+                "can be stored in each message. " ..
                 "Option is active when system log function is enabled.")
 --*/
 #define __OS_SYSTEM_MSG_COLS__ 64
@@ -272,6 +305,18 @@ this:SetToolTip("This option determine how many rows is stored in buffer. " ..
 --*/
 #define __OS_SYSTEM_MSG_ROWS__ 24
 
+/*--
+this:AddWidget("Combobox", "System log level")
+this:AddItem("Errors", "0")
+this:AddItem("Warnings", "1")
+this:AddItem("Information", "2")
+this:AddItem("Debug", "3")
+this:SetToolTip("Messages of higher level than selected are not stored in the system log. " ..
+                "Level can be changed at runtime. " ..
+                "Option is active when system log function is enabled.")
+--*/
+#define __OS_SYSTEM_MSG_LEVEL__ 2
+
 /*--
 this:AddWidget("Spinbox", 0, 65536, "Cache subsystem gap [bytes]")
 this:SetToolTip("This option determine how many free memory in bytes should be " ..
@@ -281,10 +326,34 @@ this:SetToolTip("This option determine how many free memory in bytes should be "
 
 /*--
 this:AddWidget("Spinbox", 10, 600, "Cache synchronization interval [s]")
-this:SetToolTip("This option determine period of cache synchronization with storage.")
+this:SetToolTip("This option determine maximum time that block can stay dirty " ..
+                "in the cache before writeback thread synchronize it with storage.")
 --*/
 #define __OS_SYSTEM_CACHE_SYNC_PERIOD__ 30
 
+/*--
+this:AddWidget("Spinbox", 0, 1048576, "Cache dirty background threshold [bytes]")
+this:SetToolTip("When amount of dirty data exceed this threshold then writeback " ..
+                "thread starts synchronization of the oldest blocks in the background.")
+--*/
+#define __OS_SYSTEM_CACHE_DIRTY_BACKGROUND__ 4096
+
+/*--
+this:AddWidget("Spinbox", 0, 1048576, "Cache dirty limit [bytes]")
+this:SetToolTip("When amount of dirty data exceed this limit then writers are " ..
+                "throttled until writeback thread synchronize blocks. " ..
+                "Value must be greater or equal than background threshold.")
+--*/
+#define __OS_SYSTEM_CACHE_DIRTY_LIMIT__ 16384
+
+/*--
+this:AddWidget("Spinbox", 0, 32, "Cache read-ahead [blocks]")
+this:SetToolTip("This option determine how many blocks are read in advance " ..
+                "when sequential read of device is detected. Value 0 disables " ..
+                "read-ahead.")
+--*/
+#define __OS_SYSTEM_CACHE_READ_AHEAD__ 4
+
 /*--
 this:AddWidget("Spinbox", 0, 16777216, "Network memory limit [bytes]")
 this:SetToolTip("This option enables memory limit for network subsystem. Use 0 for no limit.")
@@ -201,14 +201,16 @@ static inline int btree_predecessor(btree_t *tree, void *key, void *ret)
 
 //==============================================================================
 /**
- * @brief  Function insert object to BTree.
+ * @brief  Function insert object to BTree. Object is not inserted when equal
+ *         object (compare functor returns 0) already exists in the tree.
  *
  * @note Function can be used only by file system or driver code.
  *
  * @param  tree         BTree object
  * @param  data         object to insert to
  *
- * @return On success 0 is returned.
+ * @return On success 0 is returned. EEXIST is returned if equal object already
+ *         exists.
  */
 //==============================================================================
 static inline int btree_insert(btree_t *tree, void *data)
@@ -233,6 +235,88 @@ static inline int btree_remove(btree_t *tree, void *data)
         return _builtinfunc(btree_remove, tree, data);
 }
 
+//==============================================================================
+/**
+ * @brief  Function set cursor at object with minimum value. Cursor visits
+ *         objects in order without searching tree from the root.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor to set
+ * @param  ret          first object
+ *
+ * @return On success 0 is returned.
+ */
+//==============================================================================
+static inline int btree_cursor_first(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        return _builtinfunc(btree_cursor_first, tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function set cursor at object with maximum value.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor to set
+ * @param  ret          last object
+ *
+ * @return On success 0 is returned.
+ */
+//==============================================================================
+static inline int btree_cursor_last(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        return _builtinfunc(btree_cursor_last, tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function move cursor to the next object.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor
+ * @param  ret          next object
+ *
+ * @return On success 0 is returned.
+ */
+//==============================================================================
+static inline int btree_cursor_next(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        return _builtinfunc(btree_cursor_next, tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function move cursor to the previous object.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor
+ * @param  ret          previous object
+ *
+ * @return On success 0 is returned.
+ */
+//==============================================================================
+static inline int btree_cursor_prev(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        return _builtinfunc(btree_cursor_prev, tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function build balanced BTree from sorted array of objects.
+ *         BTree must be empty.
+ *
+ * @param  tree         BTree object
+ * @param  data         array of unique objects sorted in ascending order
+ * @param  count        number of objects in array
+ *
+ * @return On success 0 is returned.
+ */
+//==============================================================================
+static inline int btree_build(btree_t *tree, const void *data, size_t count)
+{
+        return _builtinfunc(btree_build, tree, data, count);
+}
+
 #ifdef __cplusplus
 }
 #endif
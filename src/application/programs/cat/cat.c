@@ -140,6 +140,10 @@ int_main(cat, STACK_DEPTH_LOW, int argc, char *argv[])
                                         fputs(str, stdout);
                                 }
 
+                        /* copy file by system */
+                        } else if (!printable_only) {
+                                while (copy_file_range(file, stdout, 4096) > 0);
+
                         /* read RAW data for the file */
                         } else {
                                 int n;
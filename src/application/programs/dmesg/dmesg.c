@@ -80,6 +80,8 @@ int_main(dmesg, STACK_DEPTH_LOW, int argc, char *argv[])
 {
         bool clear = false;
         bool loop  = false;
+        bool stat  = false;
+        int  level = -1;
 
         for (int i = 1; i < argc; i++) {
             if (isstreq(argv[i], "-h") || isstreq(argv[i], "--help")) {
@@ -88,6 +90,8 @@ int_main(dmesg, STACK_DEPTH_LOW, int argc, char *argv[])
                     puts("  -c, --clear     log clear");
                     puts("  -h, --help      this help");
                     puts("  -l,             loop");
+                    puts("  -n <level>      set log level (0: errors, 1: warnings, 2: info, 3: debug)");
+                    puts("  -s              show log statistics");
                     return EXIT_FAILURE;
             }
 
@@ -98,9 +102,26 @@ int_main(dmesg, STACK_DEPTH_LOW, int argc, char *argv[])
             if (isstreq(argv[i], "-l")) {
                     loop = true;
             }
+
+            if (isstreq(argv[i], "-n") && (i + 1 < argc)) {
+                    level = atoi(argv[++i]);
+            }
+
+            if (isstreq(argv[i], "-s")) {
+                    stat = true;
+            }
         }
 
-        if (clear) {
+        if (level >= 0) {
+                syslog_set_level(level);
+
+        } else if (stat) {
+                _printk_stat_t st;
+                syslog_get_stat(&st);
+                printf("Level: %u\nFilter: 0x%08X\nWritten: %u\nDropped: %u\n",
+                       st.level, st.filter, st.written, st.dropped);
+
+        } else if (clear) {
                 syslog_clear();
 
         } else {
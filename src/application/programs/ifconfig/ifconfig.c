@@ -101,8 +101,9 @@ static void print_help_msg(const char *prog_name)
                "  -h, --help    this help\n\n"
 
                "Options for INET:\n"
-               "  Static: INET up=address,netmask,gateway\n"
-               "  DHCP  : INET up=dhcp\n",
+               "  Static  : INET up=address,netmask,gateway\n"
+               "  DHCP    : INET up=dhcp\n"
+               "  Loopback: INET up=loopback[,mtu]\n",
 
                prog_name);
 }
@@ -127,6 +128,27 @@ static void INET_up(const char *options)
                         perror("INET");
                 }
 
+        } else if (strncmp(options, "loopback", 8) == 0) {
+                int mtu = 0;
+                sscanf(options + 8, ",%6d", &mtu);
+
+                if ((mtu < 0) or (mtu > 0xFFFF)) {
+                        fputs("Incorrect MTU.\n", stderr);
+                        return;
+                }
+
+                NET_INET_config_t config = {
+                        .mode    = NET_INET_MODE__LOOPBACK,
+                        .address = NET_INET_IPv4_LOOPBACK,
+                        .mask    = NET_INET_IPv4(255,0,0,0),
+                        .gateway = NET_INET_IPv4_ANY,
+                        .mtu     = mtu
+                };
+
+                if (ifup(NET_FAMILY__INET, &config) != 0) {
+                        perror("INET");
+                }
+
         } else {
                 int aa = INT_MAX, ab = INT_MAX, ac = INT_MAX, ad = INT_MAX;
                 int ma = INT_MAX, mb = INT_MAX, mc = INT_MAX, md = INT_MAX;
@@ -180,7 +202,8 @@ static void INET_status(void)
                "STATIC IP",
                "DHCP CONFIGURING",
                "DHCP",
-               "LINK DISCONNECTED"
+               "LINK DISCONNECTED",
+               "LOOPBACK"
         };
 
         NET_INET_status_t ifstat;
@@ -225,6 +248,23 @@ static void INET_status(void)
                        (uint)ifstat.rx_packets, cast(uint, ifstat.rx_bytes), rx_unit,
                        (uint)ifstat.tx_packets, cast(uint, ifstat.tx_bytes), tx_unit
                );
+
+                static const char *pool_name[_NET_INET_POOL__COUNT] = {
+                       "PBUF   ",
+                       "TCP_SEG",
+                       "NETBUF "
+                };
+
+                for (int i = 0; i < _NET_INET_POOL__COUNT; i++) {
+                        const NET_INET_pool_stat_t *pool = &ifstat.pool[i];
+
+                        if (pool->total) {
+                                printf("  Pool %s: %u/%u used (max %u), %u fails, %u B\n",
+                                       pool_name[i],
+                                       pool->used, pool->total, pool->used_max,
+                                       cast(uint, pool->fails), pool->size);
+                        }
+                }
         } else {
                 perror("INET");
         }
@@ -0,0 +1,585 @@
+/*=========================================================================*//**
+@file    netbench.c
+
+@author  Daniel Zorychta
+
+@brief   Network stack benchmark (throughput and round-trip time).
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dnx/net.h>
+#include <dnx/thread.h>
+#include <dnx/os.h>
+#include <dnx/misc.h>
+
+/*==============================================================================
+  Local symbolic constants/macros
+==============================================================================*/
+#define DEFAULT_PORT                    5001
+#define DEFAULT_SIZE                    1024
+#define DEFAULT_TIME                    5
+#define DEFAULT_COUNT                   1000
+#define UDP_MAX_SIZE                    1024
+#define UDP_RECV_TIMEOUT                500
+#define RTT_RECV_TIMEOUT                1000
+
+/*==============================================================================
+  Local types, enums definitions
+==============================================================================*/
+typedef enum {
+        TEST_TCP,
+        TEST_UDP,
+        TEST_TCP_RTT,
+        TEST_UDP_RTT,
+} test_t;
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local object definitions
+==============================================================================*/
+GLOBAL_VARIABLES_SECTION {
+        NET_INET_sockaddr_t addr;
+        size_t              size;
+        u32_t               time;
+        u32_t               count;
+        test_t              test;
+        SOCKET             *server;
+        u64_t               rx_bytes;
+        u32_t               rx_packets;
+};
+
+static const thread_attr_t thread_attr = {
+        .priority    = PRIORITY_NORMAL,
+        .stack_depth = STACK_DEPTH_LOW,
+        .detached    = false
+};
+
+/*==============================================================================
+  Exported object definitions
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Print help message
+ * @param  prog_name    program name
+ */
+//==============================================================================
+static void print_help_msg(const char *prog_name)
+{
+        printf("Usage: %s [options] <tcp|udp|rtt|all>\n"
+               "Tests:\n"
+               "  tcp           TCP throughput\n"
+               "  udp           UDP throughput and loss\n"
+               "  rtt           TCP and UDP round-trip time\n"
+               "  all           all tests\n"
+               "Options:\n"
+               "  -a <address>  server address (default 127.0.0.1)\n"
+               "  -p <port>     server port (default %d)\n"
+               "  -s <size>     buffer size (default %d)\n"
+               "  -t <seconds>  throughput test time (default %d)\n"
+               "  -n <count>    round-trip iterations (default %d)\n"
+               "  -h, --help    this help\n",
+
+               prog_name, DEFAULT_PORT, DEFAULT_SIZE, DEFAULT_TIME, DEFAULT_COUNT);
+}
+
+//==============================================================================
+/**
+ * @brief  Server side of tests. Socket is created by main thread before
+ *         client starts, thus client can connect at any time.
+ *
+ * @param  arg          not used
+ */
+//==============================================================================
+static void server_thread(void *arg)
+{
+        UNUSED_ARG1(arg);
+
+        char *buf = malloc(global->size);
+        if (!buf) {
+                return;
+        }
+
+        SOCKET *sock = global->server;
+
+        if (global->test == TEST_TCP || global->test == TEST_TCP_RTT) {
+                sock = NULL;
+                if (socket_accept(global->server, &sock) != 0) {
+                        free(buf);
+                        return;
+                }
+        }
+
+        for (;;) {
+                NET_INET_sockaddr_t from;
+                int n;
+
+                switch (global->test) {
+                case TEST_TCP:
+                        n = socket_recv(sock, buf, global->size, NET_FLAGS__NONE);
+                        break;
+
+                case TEST_UDP:
+                        n = socket_recv(sock, buf, global->size, NET_FLAGS__FREEBUF);
+                        break;
+
+                case TEST_TCP_RTT:
+                        n = socket_recv(sock, buf, global->size, NET_FLAGS__NONE);
+                        if (n > 0) {
+                                socket_send(sock, buf, n, NET_FLAGS__NONE);
+                        }
+                        break;
+
+                case TEST_UDP_RTT:
+                        n = socket_recvfrom(sock, buf, global->size, NET_FLAGS__FREEBUF, &from);
+                        if (n > 0) {
+                                socket_sendto(sock, buf, n, NET_FLAGS__NONE, &from);
+                        }
+                        break;
+
+                default:
+                        n = -1;
+                        break;
+                }
+
+                if (n <= 0) {
+                        break;
+                }
+
+                global->rx_bytes += n;
+                global->rx_packets++;
+        }
+
+        if (sock != global->server) {
+                socket_delete(sock);
+        }
+
+        free(buf);
+}
+
+//==============================================================================
+/**
+ * @brief  Function create server socket and start server thread.
+ *
+ * @param  protocol     protocol
+ *
+ * @return Server thread ID or 0 on error.
+ */
+//==============================================================================
+static tid_t server_start(NET_protocol_t protocol)
+{
+        NET_INET_sockaddr_t addr = {
+                .addr = NET_INET_IPv4_ANY,
+                .port = global->addr.port
+        };
+
+        global->rx_bytes   = 0;
+        global->rx_packets = 0;
+
+        global->server = socket_new(NET_FAMILY__INET, protocol);
+        if (global->server) {
+                // server is not blocked forever if client does not connect
+                socket_set_recv_timeout(global->server, global->test == TEST_UDP
+                                                        ? UDP_RECV_TIMEOUT : RTT_RECV_TIMEOUT);
+
+                if (socket_bind(global->server, &addr) == 0) {
+                        if (protocol == NET_PROTOCOL__UDP || socket_listen(global->server) == 0) {
+                                tid_t tid = thread_create(server_thread, &thread_attr, NULL);
+                                if (tid) {
+                                        return tid;
+                                }
+                        }
+                }
+
+                perror("Server");
+                socket_delete(global->server);
+                global->server = NULL;
+        } else {
+                perror("Server");
+        }
+
+        return 0;
+}
+
+//==============================================================================
+/**
+ * @brief  Function wait for server thread and close server socket.
+ *
+ * @param  tid          server thread ID
+ */
+//==============================================================================
+static void server_stop(tid_t tid)
+{
+        thread_join(tid);
+
+        socket_delete(global->server);
+        global->server = NULL;
+}
+
+//==============================================================================
+/**
+ * @brief  Function create client socket connected to server.
+ *
+ * @param  protocol     protocol
+ *
+ * @return Socket or NULL on error.
+ */
+//==============================================================================
+static SOCKET *client_connect(NET_protocol_t protocol)
+{
+        SOCKET *sock = socket_new(NET_FAMILY__INET, protocol);
+        if (sock) {
+                if (socket_connect(sock, &global->addr) == 0) {
+                        return sock;
+                }
+
+                socket_delete(sock);
+        }
+
+        perror("Client");
+        return NULL;
+}
+
+//==============================================================================
+/**
+ * @brief  Function print throughput.
+ *
+ * @param  bytes        number of bytes
+ * @param  time_ms      time in milliseconds
+ */
+//==============================================================================
+static void print_throughput(u64_t bytes, u32_t time_ms)
+{
+        u32_t kibps = cast(u32_t, (bytes * 1000 / max(time_ms, 1)) >> 10);
+
+        printf("  Time   : %u ms\n"
+               "  Speed  : %u KiB/s\n",
+               cast(uint, time_ms), cast(uint, kibps));
+}
+
+//==============================================================================
+/**
+ * @brief  TCP throughput test. Client sends data to server for selected time.
+ *         Result is calculated when all data is received.
+ *
+ * @param  buf          buffer to send
+ */
+//==============================================================================
+static void test_tcp(const char *buf)
+{
+        puts("TCP throughput");
+
+        tid_t tid = server_start(NET_PROTOCOL__TCP);
+        if (!tid) {
+                return;
+        }
+
+        u64_t tx_bytes = 0;
+
+        SOCKET *sock = client_connect(NET_PROTOCOL__TCP);
+        u32_t   t0   = get_time_ms();
+
+        if (sock) {
+                while (get_time_ms() - t0 < global->time * 1000) {
+                        int n = socket_send(sock, buf, global->size, NET_FLAGS__COPY);
+                        if (n <= 0) {
+                                perror("Send");
+                                break;
+                        }
+
+                        tx_bytes += n;
+                }
+
+                socket_delete(sock);
+        }
+
+        server_stop(tid);
+
+        u32_t t = get_time_ms() - t0;
+
+        printf("  Sent   : %u KiB\n"
+               "  Recv   : %u KiB\n",
+               cast(uint, tx_bytes >> 10),
+               cast(uint, global->rx_bytes >> 10));
+
+        print_throughput(global->rx_bytes, t);
+}
+
+//==============================================================================
+/**
+ * @brief  UDP throughput test. Client sends datagrams to server for selected
+ *         time. Datagrams not received by server are lost.
+ *
+ * @param  buf          buffer to send
+ */
+//==============================================================================
+static void test_udp(const char *buf)
+{
+        puts("UDP throughput");
+
+        tid_t tid = server_start(NET_PROTOCOL__UDP);
+        if (!tid) {
+                return;
+        }
+
+        u32_t tx_packets = 0;
+        u32_t t          = 0;
+
+        SOCKET *sock = client_connect(NET_PROTOCOL__UDP);
+        if (sock) {
+                u32_t t0 = get_time_ms();
+
+                while (get_time_ms() - t0 < global->time * 1000) {
+                        if (socket_send(sock, buf, global->size, NET_FLAGS__NOCOPY) > 0) {
+                                tx_packets++;
+                        }
+                }
+
+                t = get_time_ms() - t0;
+
+                socket_delete(sock);
+        }
+
+        server_stop(tid);
+
+        u32_t lost = tx_packets - min(tx_packets, global->rx_packets);
+
+        printf("  Sent   : %u datagrams\n"
+               "  Recv   : %u datagrams\n"
+               "  Lost   : %u (%u%%)\n",
+               cast(uint, tx_packets),
+               cast(uint, global->rx_packets),
+               cast(uint, lost),
+               cast(uint, tx_packets ? (lost * 100) / tx_packets : 0));
+
+        print_throughput(global->rx_bytes, t);
+}
+
+//==============================================================================
+/**
+ * @brief  Round-trip time test. Client sends buffer and waits for echo
+ *         selected number of times.
+ *
+ * @param  protocol     protocol
+ * @param  buf          buffer to send
+ * @param  rbuf         buffer for echo
+ */
+//==============================================================================
+static void test_rtt(NET_protocol_t protocol, const char *buf, char *rbuf)
+{
+        bool tcp = (protocol == NET_PROTOCOL__TCP);
+
+        printf("%s round-trip time\n", tcp ? "TCP" : "UDP");
+
+        global->test = tcp ? TEST_TCP_RTT : TEST_UDP_RTT;
+
+        tid_t tid = server_start(protocol);
+        if (!tid) {
+                return;
+        }
+
+        u32_t done = 0;
+        u32_t lost = 0;
+        u32_t t    = 0;
+
+        SOCKET *sock = client_connect(protocol);
+        if (sock) {
+                socket_set_recv_timeout(sock, RTT_RECV_TIMEOUT);
+
+                u32_t t0 = get_time_ms();
+
+                for (u32_t i = 0; i < global->count; i++) {
+                        if (socket_send(sock, buf, global->size,
+                                        tcp ? NET_FLAGS__COPY : NET_FLAGS__NOCOPY) <= 0) {
+                                perror("Send");
+                                break;
+                        }
+
+                        // TCP stream can be received in parts
+                        size_t len = 0;
+                        while (len < global->size) {
+                                int n = socket_recv(sock, rbuf + len, global->size - len,
+                                                    tcp ? NET_FLAGS__NONE : NET_FLAGS__FREEBUF);
+                                if (n <= 0) {
+                                        break;
+                                }
+
+                                len += n;
+                        }
+
+                        if (len == global->size) {
+                                done++;
+                        } else if (tcp) {
+                                perror("Recv");
+                                break;
+                        } else {
+                                lost++;
+                        }
+                }
+
+                t = get_time_ms() - t0;
+
+                socket_delete(sock);
+        }
+
+        server_stop(tid);
+
+        printf("  Echoes : %u (%u lost)\n"
+               "  Time   : %u ms\n"
+               "  RTT    : %u us\n",
+               cast(uint, done),
+               cast(uint, lost),
+               cast(uint, t),
+               cast(uint, done ? (cast(u64_t, t) * 1000) / done : 0));
+}
+
+//==============================================================================
+/**
+ * @brief Program main function
+ *
+ * @param  argc         count of arguments
+ * @param *argv[]       argument table
+ *
+ * @return program status
+ */
+//==============================================================================
+int_main(netbench, STACK_DEPTH_LOW, int argc, char *argv[])
+{
+        const char *test = NULL;
+
+        global->addr.addr = NET_INET_IPv4_LOOPBACK;
+        global->addr.port = DEFAULT_PORT;
+        global->size      = DEFAULT_SIZE;
+        global->time      = DEFAULT_TIME;
+        global->count     = DEFAULT_COUNT;
+
+        for (int i = 1; i < argc; i++) {
+                if (isstreq(argv[i], "-h") || isstreq(argv[i], "--help")) {
+                        print_help_msg(argv[0]);
+                        return EXIT_SUCCESS;
+
+                } else if (isstreq(argv[i], "-a") && (i + 1 < argc)) {
+                        int a = INT_MAX, b = INT_MAX, c = INT_MAX, d = INT_MAX;
+                        sscanf(argv[++i], "%4d.%4d.%4d.%4d", &a, &b, &c, &d);
+
+                        if ((a > 255) or (b > 255) or (c > 255) or (d > 255)) {
+                                fputs("Incorrect format of IP address.\n", stderr);
+                                return EXIT_FAILURE;
+                        }
+
+                        global->addr.addr = NET_INET_IPv4(a,b,c,d);
+
+                } else if (isstreq(argv[i], "-p") && (i + 1 < argc)) {
+                        global->addr.port = atoi(argv[++i]);
+
+                } else if (isstreq(argv[i], "-s") && (i + 1 < argc)) {
+                        global->size = atoi(argv[++i]);
+
+                } else if (isstreq(argv[i], "-t") && (i + 1 < argc)) {
+                        global->time = atoi(argv[++i]);
+
+                } else if (isstreq(argv[i], "-n") && (i + 1 < argc)) {
+                        global->count = atoi(argv[++i]);
+
+                } else {
+                        test = argv[i];
+                }
+        }
+
+        if (test == NULL) {
+                print_help_msg(argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        bool all = isstreq(test, "all");
+
+        if (!all && !isstreq(test, "tcp") && !isstreq(test, "udp") && !isstreq(test, "rtt")) {
+                fputs("Unknown test.\n", stderr);
+                return EXIT_FAILURE;
+        }
+
+        if (global->size == 0) {
+                fputs("Incorrect buffer size.\n", stderr);
+                return EXIT_FAILURE;
+        }
+
+        char *buf  = malloc(global->size);
+        char *rbuf = malloc(global->size);
+
+        if (buf && rbuf) {
+                for (size_t i = 0; i < global->size; i++) {
+                        buf[i] = i;
+                }
+
+                if (all || isstreq(test, "tcp")) {
+                        global->test = TEST_TCP;
+                        test_tcp(buf);
+                }
+
+                // datagrams bigger than maximum UDP payload are not sent
+                size_t size = global->size;
+                global->size = min(size, UDP_MAX_SIZE);
+
+                if (all || isstreq(test, "udp")) {
+                        global->test = TEST_UDP;
+                        test_udp(buf);
+                }
+
+                if (all || isstreq(test, "rtt")) {
+                        global->size = size;
+                        test_rtt(NET_PROTOCOL__TCP, buf, rbuf);
+
+                        global->size = min(size, UDP_MAX_SIZE);
+                        test_rtt(NET_PROTOCOL__UDP, buf, rbuf);
+                }
+        } else {
+                perror(NULL);
+        }
+
+        if (buf) {
+                free(buf);
+        }
+
+        if (rbuf) {
+                free(rbuf);
+        }
+
+        return EXIT_SUCCESS;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -36,9 +36,11 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/poll.h>
 #include <dnx/net.h>
 #include <dnx/thread.h>
 #include <dnx/os.h>
+#include <dnx/misc.h>
 
 /*==============================================================================
   Local symbolic constants/macros
@@ -198,36 +200,48 @@ static void telnet_thread(void *arg)
 
         socket_set_recv_timeout(sock, RECEIVE_TIMOUT);
         socket_set_send_timeout(sock, SEND_TIMEOUT);
+        ioctl(fout, IOCTL_VFS__NON_BLOCKING_RD_MODE);
+
+        // thread sleeps until client or program sends data, or program exits
+        struct pollfd fds[] = {
+                {.type = POLL_TYPE__SOCKET,  .socket = sock, .events = POLLIN},
+                {.type = POLL_TYPE__FILE,    .file   = fout, .events = POLLIN},
+                {.type = POLL_TYPE__PROCESS, .pid    = proc, .events = POLLIN},
+        };
 
         // handle telnet connection
-        while (true) {
-                // receive input packet from telnet client
-                errno = 0;
-                int len = socket_read(sock, buf, BUF_SIZE);
+        while (poll(fds, ARRAY_SIZE(fds), MAX_DELAY_MS) >= 0) {
+                int len;
 
-                if ((len == -1) && (errno != ETIME)) {
-                        break;
-                }
+                // receive input packet from telnet client
+                if (fds[0].revents) {
+                        errno = 0;
+                        len = socket_read(sock, buf, BUF_SIZE);
 
-                // write incoming data to running program
-                if (len > 0 && buf[0] != TELNET_CFG_BYTE) {
-                        replace_CRLF_by_LF(buf, len);
-                        len = strnlen(buf, len);
-                        fwrite(buf, 1, len, fin);
+                        if ((len == -1) && (errno != ETIME)) {
+                                break;
+                        }
 
+                        // write incoming data to running program
+                        if (len > 0 && buf[0] != TELNET_CFG_BYTE) {
+                                replace_CRLF_by_LF(buf, len);
+                                len = strnlen(buf, len);
+                                fwrite(buf, 1, len, fin);
+                        }
                 }
 
-                // send data from running program
-                do {
-                        ioctl(fout, IOCTL_VFS__NON_BLOCKING_RD_MODE);
-                        len = fread(buf, 1, BUF_SIZE, fout);
-                        if (len > 0) {
-                                len = socket_write(sock, buf, len);
-                        }
-                } while (len > 0);
+                // send data from running program (also after program exit)
+                if (fds[1].revents || fds[2].revents) {
+                        do {
+                                len = fread(buf, 1, BUF_SIZE, fout);
+                                if (len > 0) {
+                                        len = socket_write(sock, buf, len);
+                                }
+                        } while (len > 0);
+                }
 
                 // check if program is finished
-                if (process_wait(proc, NULL, 0) == 0) {
+                if (fds[2].revents) {
                         break;
                 }
         }
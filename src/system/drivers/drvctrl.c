@@ -54,10 +54,13 @@
 /*==============================================================================
   Local object types
 ==============================================================================*/
-typedef struct drvmem {
-        struct drvmem *next;
-        void          *mem;
-        dev_t          devid;
+typedef struct _drvinst {
+        struct _drvinst *next;
+        void            *mem;
+        dev_t            devid;
+        u16_t            modno;
+        u16_t            refcnt;                //!< number of opened instances
+        bool             release;               //!< release in progress
 } drvmem_t;
 
 /*==============================================================================
@@ -84,44 +87,57 @@ extern const size_t               _drvreg_number_of_modules;
 ==============================================================================*/
 //==============================================================================
 /**
- * @brief Check if device is running
+ * @brief Find driver instance. Function must be called when scheduler is
+ *        locked.
  *
  * @param [in]  id      driver ID
- * @param [out] modno   module number
- * @param [out] mem     module memory
+ * @param [out] drv     driver instance
  *
  * @return On success ESUCC, otherwise other values.
  */
 //==============================================================================
-static int driver__get_module_no_and_mem(dev_t id, u16_t *modno, void **mem)
+static int driver__find(dev_t id, drvmem_t **drv)
 {
         int err = EINVAL;
 
-        if (modno && mem && id != -1) {
+        if (drv && id != -1) {
                 err = ENODEV;
 
-                *modno = _dev_t__extract_modno(id);
+                u16_t modno = _dev_t__extract_modno(id);
 
-                if (*modno < _drvreg_number_of_modules) {
-                        _kernel_scheduler_lock();
-                        {
-                                for (drvmem_t *drv = drvmem[*modno];
-                                     drv != NULL && err == ENODEV;
-                                     drv = drv->next) {
-
-                                        if (drv->devid == id) {
-                                                *mem = drv->mem;
-                                                err  = ESUCC;
-                                        }
+                if (drvmem && modno < _drvreg_number_of_modules) {
+                        for (drvmem_t *d = drvmem[modno]; d; d = d->next) {
+                                if (d->devid == id) {
+                                        *drv = d;
+                                        err  = ESUCC;
+                                        break;
                                 }
                         }
-                        _kernel_scheduler_unlock();
                 }
         }
 
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Get driver instance of running device.
+ *
+ * @param [in]  id      driver ID
+ * @param [out] drv     driver instance
+ *
+ * @return On success ESUCC, otherwise other values.
+ */
+//==============================================================================
+static int driver__get(dev_t id, drvmem_t **drv)
+{
+        _kernel_scheduler_lock();
+        int err = driver__find(id, drv);
+        _kernel_scheduler_unlock();
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief  Register driver in system
@@ -158,6 +174,7 @@ static int driver__register(u16_t modno, u8_t major, u8_t minor, drvmem_t **drv)
                                 err = _kzalloc(_MM_KRN, sizeof(drvmem_t), cast(void *, drv));
                                 if (!err) {
                                         (*drv)->devid = _dev_t__create(modno, major, minor);
+                                        (*drv)->modno = modno;
                                         (*drv)->mem   = NULL;
                                         (*drv)->next  = NULL;
 
@@ -297,25 +314,25 @@ int _driver_init(const char *module, u8_t major, u8_t minor, const char *node_pa
 
                                 err = _vfs_mknod(&cpath, drv->devid);
                                 if (!err) {
-                                        printk(DRIVER_NAME" initialized as %s", DRIVER_NAME_ARGS, node_path);
+                                        printk_log(_PRINTK_LEVEL_INFO, _PRINTK_SUBSYS_DRIVER, DRIVER_NAME" initialized as %s", DRIVER_NAME_ARGS, node_path);
 
                                 } else {
                                         driver__release(modno, drv->mem);
                                         driver__remove(drv->devid);
-                                        printk(DRIVER_NAME" node create fail (%d)", DRIVER_NAME_ARGS, err);
+                                        printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_DRIVER, DRIVER_NAME" node create fail (%d)", DRIVER_NAME_ARGS, err);
                                 }
                         } else {
-                                printk(DRIVER_NAME" initialized", DRIVER_NAME_ARGS);
+                                printk_log(_PRINTK_LEVEL_INFO, _PRINTK_SUBSYS_DRIVER, DRIVER_NAME" initialized", DRIVER_NAME_ARGS);
                         }
 
                 } else {
                         driver__remove(drv->devid);
-                        printk(DRIVER_NAME" initialization error (%d)", DRIVER_NAME_ARGS, err);
+                        printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_DRIVER, DRIVER_NAME" initialization error (%d)", DRIVER_NAME_ARGS, err);
                 }
         } else {
                 switch (err) {
-                case EADDRINUSE: printk(DRIVER_NAME" already initialized", DRIVER_NAME_ARGS); break;
-                default        : printk(DRIVER_NAME" does not exist", DRIVER_NAME_ARGS); break;
+                case EADDRINUSE: printk_log(_PRINTK_LEVEL_WARNING, _PRINTK_SUBSYS_DRIVER, DRIVER_NAME" already initialized", DRIVER_NAME_ARGS); break;
+                default        : printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_DRIVER, DRIVER_NAME" does not exist", DRIVER_NAME_ARGS); break;
                 }
         }
 
@@ -333,23 +350,35 @@ int _driver_init(const char *module, u8_t major, u8_t minor, const char *node_pa
 //==============================================================================
 int _driver_release(dev_t id)
 {
-        u16_t modno;
-        void *mem;
+        drvmem_t *drv = NULL;
+
+        _kernel_scheduler_lock();
+
+        int err = driver__find(id, &drv);
+        if (!err) {
+                if (drv->refcnt > 0 || drv->release) {
+                        err = EBUSY;
+                } else {
+                        drv->release = true;
+                }
+        }
+
+        _kernel_scheduler_unlock();
 
-        int err = driver__get_module_no_and_mem(id, &modno, &mem);
         if (!err) {
 #if ((__OS_SYSTEM_MSG_ENABLE__ > 0) && (__OS_PRINTF_ENABLE__ > 0))
                 u8_t        major  = _dev_t__extract_major(id);
                 u8_t        minor  = _dev_t__extract_minor(id);
-                const char *module = _module_get_name(modno);
+                const char *module = _module_get_name(drv->modno);
 #endif
 
-                err = driver__release(modno, mem);
+                err = driver__release(drv->modno, drv->mem);
                 if (!err) {
                         driver__remove(id);
-                        printk(DRIVER_NAME" released", DRIVER_NAME_ARGS);
+                        printk_log(_PRINTK_LEVEL_INFO, _PRINTK_SUBSYS_DRIVER, DRIVER_NAME" released", DRIVER_NAME_ARGS);
                 } else {
-                        printk(DRIVER_NAME" release fail (%d)", DRIVER_NAME_ARGS, err);
+                        drv->release = false;
+                        printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_DRIVER, DRIVER_NAME" release fail (%d)", DRIVER_NAME_ARGS, err);
                 }
         }
 
@@ -358,27 +387,185 @@ int _driver_release(dev_t id)
 
 //==============================================================================
 /**
- * @brief Function open selected driver
+ * @brief Function open selected driver and return driver instance. Instance
+ *        is valid until is closed and is used to access driver without
+ *        device lookup. Driver cannot be released when is opened.
  *
- * @param id           module id
+ * @param id            module id
  * @param flags         flags
+ * @param inst          driver instance
  *
  * @return One of errno value (errno.h)
  */
 //==============================================================================
-int _driver_open(dev_t id, u32_t flags)
+int _drvinst_open(dev_t id, u32_t flags, drvinst_t **inst)
 {
-        u16_t modno;
-        void *mem;
+        if (!inst) {
+                return EINVAL;
+        }
+
+        drvmem_t *drv = NULL;
+
+        _kernel_scheduler_lock();
 
-        int err = driver__get_module_no_and_mem(id, &modno, &mem);
+        int err = driver__find(id, &drv);
         if (!err) {
-                err = _drvreg_module_table[modno].IF.drv_open(mem, vfs_filter_flags_for_device(flags));
+                if (drv->release || drv->refcnt == UINT16_MAX) {
+                        err = drv->release ? ENODEV : EMFILE;
+                } else {
+                        drv->refcnt++;
+                }
+        }
+
+        _kernel_scheduler_unlock();
+
+        if (!err) {
+                err = _drvreg_module_table[drv->modno].IF.drv_open(drv->mem,
+                                                                   vfs_filter_flags_for_device(flags));
+                if (!err) {
+                        *inst = drv;
+                } else {
+                        _kernel_scheduler_lock();
+                        drv->refcnt--;
+                        _kernel_scheduler_unlock();
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function close driver instance. Forced close always releases the
+ *        instance, even if driver close fails.
+ *
+ * @param inst          driver instance
+ * @param force         force close request
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _drvinst_close(drvinst_t *inst, bool force)
+{
+        if (!inst) {
+                return EINVAL;
+        }
+
+        int err = _drvreg_module_table[inst->modno].IF.drv_close(inst->mem, force);
+        if (!err || force) {
+                _kernel_scheduler_lock();
+                if (inst->refcnt > 0) {
+                        inst->refcnt--;
+                }
+                _kernel_scheduler_unlock();
         }
 
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Function write data to driver instance
+ *
+ * @param inst          driver instance
+ * @param src           data source
+ * @param count         buffer size
+ * @param fpos          file position
+ * @param wrcnt         number of written bytes
+ * @param fattr         file attributes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _drvinst_write(drvinst_t *inst, const u8_t *src, size_t count, fpos_t *fpos, size_t *wrcnt, struct vfs_fattr fattr)
+{
+        return _drvreg_module_table[inst->modno].IF.drv_write(inst->mem, src, count, fpos, wrcnt, fattr);
+}
+
+//==============================================================================
+/**
+ * @brief Function read data from driver instance
+ *
+ * @param inst          driver instance
+ * @param dst           data destination
+ * @param count         buffer size
+ * @param fpos          file position
+ * @param rdcnt         number of read bytes
+ * @param fattr         file attributes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _drvinst_read(drvinst_t *inst, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt, struct vfs_fattr fattr)
+{
+        return _drvreg_module_table[inst->modno].IF.drv_read(inst->mem, dst, count, fpos, rdcnt, fattr);
+}
+
+//==============================================================================
+/**
+ * @brief IO control of driver instance
+ *
+ * @param inst          driver instance
+ * @param request       io request
+ * @param arg           argument
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _drvinst_ioctl(drvinst_t *inst, int request, void *arg)
+{
+        return _drvreg_module_table[inst->modno].IF.drv_ioctl(inst->mem, request, arg);
+}
+
+//==============================================================================
+/**
+ * @brief Flush driver instance buffer (forces write)
+ *
+ * @param inst          driver instance
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _drvinst_flush(drvinst_t *inst)
+{
+        return _drvreg_module_table[inst->modno].IF.drv_flush(inst->mem);
+}
+
+//==============================================================================
+/**
+ * @brief Driver instance information
+ *
+ * @param inst          driver instance
+ * @param stat          status object
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _drvinst_stat(drvinst_t *inst, struct vfs_dev_stat *stat)
+{
+        stat->st_major = _dev_t__extract_major(inst->devid);
+        stat->st_minor = _dev_t__extract_minor(inst->devid);
+        stat->st_size  = 0;
+
+        return _drvreg_module_table[inst->modno].IF.drv_stat(inst->mem, stat);
+}
+
+//==============================================================================
+/**
+ * @brief Function open selected driver
+ *
+ * @param id           module id
+ * @param flags         flags
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _driver_open(dev_t id, u32_t flags)
+{
+        drvinst_t *inst;
+        return _drvinst_open(id, flags, &inst);
+}
+
 //==============================================================================
 /**
  * @brief Function close selected driver
@@ -391,12 +578,11 @@ int _driver_open(dev_t id, u32_t flags)
 //==============================================================================
 int _driver_close(dev_t id, bool force)
 {
-        u16_t modno;
-        void *mem;
+        drvmem_t *drv = NULL;
 
-        int err = driver__get_module_no_and_mem(id, &modno, &mem);
+        int err = driver__get(id, &drv);
         if (!err) {
-                err = _drvreg_module_table[modno].IF.drv_close(mem, force);
+                err = _drvinst_close(drv, force);
         }
 
         return err;
@@ -418,12 +604,11 @@ int _driver_close(dev_t id, bool force)
 //==============================================================================
 int _driver_write(dev_t id, const u8_t *src, size_t count, fpos_t *fpos, size_t *wrcnt, struct vfs_fattr fattr)
 {
-        u16_t modno;
-        void *mem;
+        drvmem_t *drv = NULL;
 
-        int err = driver__get_module_no_and_mem(id, &modno, &mem);
+        int err = driver__get(id, &drv);
         if (!err) {
-                err = _drvreg_module_table[modno].IF.drv_write(mem, src, count, fpos, wrcnt, fattr);
+                err = _drvinst_write(drv, src, count, fpos, wrcnt, fattr);
         }
 
         return err;
@@ -445,12 +630,11 @@ int _driver_write(dev_t id, const u8_t *src, size_t count, fpos_t *fpos, size_t
 //==============================================================================
 int _driver_read(dev_t id, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt, struct vfs_fattr fattr)
 {
-        u16_t modno;
-        void *mem;
+        drvmem_t *drv = NULL;
 
-        int err = driver__get_module_no_and_mem(id, &modno, &mem);
+        int err = driver__get(id, &drv);
         if (!err) {
-                err = _drvreg_module_table[modno].IF.drv_read(mem, dst, count, fpos, rdcnt, fattr);
+                err = _drvinst_read(drv, dst, count, fpos, rdcnt, fattr);
         }
 
         return err;
@@ -469,12 +653,11 @@ int _driver_read(dev_t id, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt,
 //==============================================================================
 int _driver_ioctl(dev_t id, int request, void *arg)
 {
-        u16_t modno;
-        void *mem;
+        drvmem_t *drv = NULL;
 
-        int err = driver__get_module_no_and_mem(id, &modno, &mem);
+        int err = driver__get(id, &drv);
         if (!err) {
-                err = _drvreg_module_table[modno].IF.drv_ioctl(mem, request, arg);
+                err = _drvinst_ioctl(drv, request, arg);
         }
 
         return err;
@@ -485,20 +668,17 @@ int _driver_ioctl(dev_t id, int request, void *arg)
  * @brief Flush device buffer (forces write)
  *
  * @param id            module id
- * @param request       io request
- * @param arg           argument
  *
  * @return One of errno value (errno.h)
  */
 //==============================================================================
 int _driver_flush(dev_t id)
 {
-        u16_t modno;
-        void *mem;
+        drvmem_t *drv = NULL;
 
-        int err = driver__get_module_no_and_mem(id, &modno, &mem);
+        int err = driver__get(id, &drv);
         if (!err) {
-                err = _drvreg_module_table[modno].IF.drv_flush(mem);
+                err = _drvinst_flush(drv);
         }
 
         return err;
@@ -516,15 +696,11 @@ int _driver_flush(dev_t id)
 //==============================================================================
 int _driver_stat(dev_t id, struct vfs_dev_stat *stat)
 {
-        u16_t modno;
-        void *mem;
+        drvmem_t *drv = NULL;
 
-        int err = driver__get_module_no_and_mem(id, &modno, &mem);
+        int err = driver__get(id, &drv);
         if (!err) {
-                stat->st_major = _dev_t__extract_major(id);
-                stat->st_minor = _dev_t__extract_minor(id);
-                stat->st_size  = 0;
-                err = _drvreg_module_table[modno].IF.drv_stat(mem, stat);
+                err = _drvinst_stat(drv, stat);
         }
 
         return err;
@@ -544,10 +720,15 @@ int _driver_stat(dev_t id, struct vfs_dev_stat *stat)
 //==============================================================================
 int _module_get_instance(const char *module_name, u8_t major, u8_t minor, void **mem)
 {
-        dev_t dev = _dev_t__create(_module_get_ID(module_name), major, minor);
+        dev_t     dev = _dev_t__create(_module_get_ID(module_name), major, minor);
+        drvmem_t *drv = NULL;
 
-        u16_t  modno = 0;
-        return driver__get_module_no_and_mem(dev, &modno, mem);
+        int err = mem ? driver__get(dev, &drv) : EINVAL;
+        if (!err) {
+                *mem = drv->mem;
+        }
+
+        return err;
 }
 
 //==============================================================================
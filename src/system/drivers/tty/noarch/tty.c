@@ -60,6 +60,7 @@ typedef struct {
        ttybfr_t        *screen;
        ttyedit_t       *editline;
        ttycmd_t        *vtcmd;
+       _poll_list_t     poll;
        u8_t             major;
 } tty_t;
 
@@ -81,7 +82,7 @@ static void     service_in              (void *arg);
 static void     send_cmd                (enum cmd cmd, u8_t arg);
 static void     vt100_init              ();
 static void     vt100_analyze           (const char c);
-static void     copy_string_to_queue    (const char *str, queue_t *queue, bool lfend, uint timeout);
+static void     copy_string_to_queue    (const char *str, tty_t *tty, bool lfend, uint timeout);
 static void     switch_terminal         (int term_no);
 
 /*==============================================================================
@@ -251,6 +252,7 @@ API_MOD_RELEASE(TTY, void *device_handle)
 
         int err = sys_mutex_trylock(tty->secure_mtx);
         if (!err) {
+                sys_poll_list_release(&tty->poll);
                 sys_mutex_destroy(tty->secure_mtx);
                 sys_queue_destroy(tty->queue_out);
                 ttybfr_destroy(tty->screen);
@@ -382,7 +384,7 @@ API_MOD_READ(TTY,
                 if (fattr.non_blocking_rd) {
                         if (sys_mutex_lock(tty->secure_mtx, 100) == ESUCC) {
                                 const char *str = ttyedit_get_value(tty->editline);
-                                copy_string_to_queue(str, tty->queue_out, false, 1);
+                                copy_string_to_queue(str, tty, false, 1);
                                 ttyedit_clear(tty->editline);
                                 sys_mutex_unlock(tty->secure_mtx);
                         } else {
@@ -484,6 +486,19 @@ API_MOD_IOCTL(TTY, void *device_handle, int request, void *arg)
                 err = ESUCC;
                 break;
 
+        case IOCTL_VFS__POLL: {
+                struct vfs_poll *poll = arg;
+                sys_poll_wait(&tty->poll, tty, poll->entry);
+
+                // input queue contains only complete lines
+                size_t items = 0;
+                sys_queue_get_number_of_items(tty->queue_out, &items);
+
+                poll->events = POLLOUT | (items > 0 ? POLLIN : 0);
+                err = ESUCC;
+                break;
+        }
+
         default:
                 err = EBADRQC;
                 break;
@@ -734,7 +749,7 @@ static void vt100_analyze(const char c)
                                 sys_fwrite(crlf, strlen(crlf), &wrcnt, tty_module->outfile);
                         }
 
-                        copy_string_to_queue(str, tty->queue_out, true, 0);
+                        copy_string_to_queue(str, tty, true, 0);
                         ttyedit_clear(tty->editline);
 
                         sys_mutex_unlock(tty->secure_mtx);
@@ -762,16 +777,16 @@ static void vt100_analyze(const char c)
                 break;
 
         case TTYCMD_KEY_ARROW_UP:
-                copy_string_to_queue(VT100_ARROW_UP_STDOUT, tty->queue_out, true, 0);
+                copy_string_to_queue(VT100_ARROW_UP_STDOUT, tty, true, 0);
                 break;
 
         case TTYCMD_KEY_ARROW_DOWN:
-                copy_string_to_queue(VT100_ARROW_DOWN_STDOUT, tty->queue_out, true, 0);
+                copy_string_to_queue(VT100_ARROW_DOWN_STDOUT, tty, true, 0);
                 break;
 
         case TTYCMD_KEY_TAB:
-                copy_string_to_queue(ttyedit_get_value(tty->editline), tty->queue_out, false, 0);
-                copy_string_to_queue(VT100_TAB, tty->queue_out, true, 0);
+                copy_string_to_queue(ttyedit_get_value(tty->editline), tty, false, 0);
+                copy_string_to_queue(VT100_TAB, tty, true, 0);
                 break;
 
         case TTYCMD_KEY_HOME:
@@ -793,26 +808,28 @@ static void vt100_analyze(const char c)
 
 //==============================================================================
 /**
- * @brief Copy string to queue
+ * @brief Copy string to input queue of terminal
  *
  * @param str           string
- * @param queue         queue
+ * @param tty           terminal
  * @param lfend         true: adds LF, false: without LF
  * @param timeout       operation timeout [ms]
  */
 //==============================================================================
-static void copy_string_to_queue(const char *str, queue_t *queue, bool lfend, uint timeout)
+static void copy_string_to_queue(const char *str, tty_t *tty, bool lfend, uint timeout)
 {
         for (uint i = 0; i < strlen(str); i++) {
-                if (sys_queue_send(queue, &str[i], timeout) != ESUCC) {
+                if (sys_queue_send(tty->queue_out, &str[i], timeout) != ESUCC) {
                         break;
                 }
         }
 
         if (lfend) {
                 const char lf = '\n';
-                sys_queue_send(queue, &lf, timeout);
+                sys_queue_send(tty->queue_out, &lf, timeout);
         }
+
+        sys_poll_notify(&tty->poll, tty);
 }
 
 //==============================================================================
@@ -359,6 +359,14 @@ static void IRQ_Rx_handle(u8_t major)
 
         /* receiver interrupt handler */
         int received = 0;
+
+#if defined(USART_IF_RXOF) && defined(USART_IFC_RXOF)
+        if (usart->IF & USART_IF_RXOF) {
+                usart->IFC = USART_IFC_RXOF;
+                _UART_mem[major]->Rx_FIFO.hw_overrun++;
+        }
+#endif
+
         while (usart->STATUS & USART_STATUS_RXDATAV) {
                 u8_t data = usart->RXDATA;
 
@@ -367,14 +375,22 @@ static void IRQ_Rx_handle(u8_t major)
                 }
         }
 
-        // set receive semaphore to number of received bytes
-        bool yield = received > 0;
+        // wake up reader if requested number of bytes is received
+        bool yield = false;
 
-        while (received--) {
+        if (received && _UART_FIFO__wakeup(&_UART_mem[major]->Rx_FIFO)) {
                 sys_semaphore_signal_from_ISR(_UART_mem[major]->data_read_sem, NULL);
+                yield = true;
+        }
+
+        // wake up threads that wait in poll()
+        if (received) {
+                bool woken = false;
+                sys_poll_notify_from_ISR(&_UART_mem[major]->poll, _UART_mem[major], &woken);
+                yield = yield || woken;
         }
 
-        /* yield thread if data received */
+        /* yield thread if reader woken up */
         sys_thread_yield_from_ISR(yield);
 }
 
@@ -323,7 +323,16 @@ static void IRQ_handle(u8_t major)
 
         /* receiver interrupt handler */
         int received = 0;
-        while ((DEV->UART->CR1 & USART_CR1_RXNEIE) && (DEV->UART->SR & (USART_SR_RXNE | USART_SR_ORE))) {
+        while (DEV->UART->CR1 & USART_CR1_RXNEIE) {
+                u32_t SR = DEV->UART->SR;
+                if (!(SR & (USART_SR_RXNE | USART_SR_ORE))) {
+                        break;
+                }
+
+                if (SR & USART_SR_ORE) {
+                        _UART_mem[major]->Rx_FIFO.hw_overrun++;
+                }
+
                 u8_t DR = DEV->UART->DR;
 
                 if (_UART_FIFO__write(&_UART_mem[major]->Rx_FIFO, &DR)) {
@@ -347,12 +356,19 @@ static void IRQ_handle(u8_t major)
                 }
         }
 
-        // set receive semaphore to number of received bytes
-        while (received--) {
+        // wake up reader if requested number of bytes is received
+        if (received && _UART_FIFO__wakeup(&_UART_mem[major]->Rx_FIFO)) {
                 sys_semaphore_signal_from_ISR(_UART_mem[major]->data_read_sem, NULL);
                 yield = true;
         }
 
+        // wake up threads that wait in poll()
+        if (received) {
+                bool woken = false;
+                sys_poll_notify_from_ISR(&_UART_mem[major]->poll, _UART_mem[major], &woken);
+                yield = yield || woken;
+        }
+
         /* yield thread if data send or received */
         sys_thread_yield_from_ISR(yield);
 }
@@ -0,0 +1,296 @@
+/*=========================================================================*//**
+File     uart_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test of UART Rx FIFO and read wakeup logic against fake LLD.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * The fake LLD receives bytes from a scripted line. The IRQ is simulated when
+ * the reader waits for data_read_sem: bytes are moved from the line to the
+ * FIFO one by one (as the Rx IRQ does) until the reader is woken up or the
+ * line has no more bytes, which is reported as timeout.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "drivers/driver.h"
+#include "../uart.h"
+#include "../uart_ioctl.h"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define LINE_SIZE               (70000)
+
+/*==============================================================================
+  Tested functions
+==============================================================================*/
+API_MOD_INIT(UART, void **device_handle, u8_t major, u8_t minor);
+API_MOD_RELEASE(UART, void *device_handle);
+API_MOD_READ(UART, void *device_handle, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt, struct vfs_fattr fattr);
+API_MOD_IOCTL(UART, void *device_handle, int request, void *arg);
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static struct {
+        u8_t   data[LINE_SIZE];
+        size_t len;
+        size_t pos;
+        size_t burst;           // bytes received at once before IRQ wakeup check
+} line;
+
+static struct sem {
+        int count;
+} sem_pool[4];
+
+static int  sem_used;
+static int  waits;
+static int  timeouts;
+static u8_t rxbuf[LINE_SIZE];
+
+/*==============================================================================
+  Fake kernel services
+==============================================================================*/
+int _module_get_ID(const char *name)
+{
+        UNUSED_ARG1(name);
+        return 0;
+}
+
+int sys_semaphore_create(const size_t cnt_max, const size_t cnt_init, sem_t **sem)
+{
+        UNUSED_ARG1(cnt_max);
+        HT_CHECK(sem_used < 4);
+        sem_pool[sem_used].count = cnt_init;
+        *sem = cast(sem_t*, &sem_pool[sem_used++]);
+        return ESUCC;
+}
+
+int sys_semaphore_destroy(sem_t *sem)
+{
+        UNUSED_ARG1(sem);
+        return ESUCC;
+}
+
+int sys_mutex_create(enum mutex_type type, mutex_t **mtx)
+{
+        UNUSED_ARG1(type);
+        *mtx = cast(mutex_t*, 1);
+        return ESUCC;
+}
+
+int sys_mutex_destroy(mutex_t *mtx)
+{
+        UNUSED_ARG1(mtx);
+        return ESUCC;
+}
+
+int _mutex_lock(mutex_t *mtx, const u32_t timeout)
+{
+        UNUSED_ARG2(mtx, timeout);
+        return ESUCC;
+}
+
+int _mutex_unlock(mutex_t *mtx)
+{
+        UNUSED_ARG1(mtx);
+        return ESUCC;
+}
+
+int _semaphore_wait(sem_t *sem, const u32_t timeout)
+{
+        UNUSED_ARG1(timeout);
+
+        struct sem      *s   = cast(struct sem*, sem);
+        struct UART_mem *hdl = _UART_mem[0];
+
+        waits++;
+
+        // simulated Rx IRQ while reader is blocked
+        while (s->count == 0 && line.pos < line.len) {
+                bool received = false;
+
+                for (size_t i = 0; i < line.burst && line.pos < line.len; i++) {
+                        received |= _UART_FIFO__write(&hdl->Rx_FIFO, &line.data[line.pos]);
+                        line.pos++;
+                }
+
+                if (received && _UART_FIFO__wakeup(&hdl->Rx_FIFO)) {
+                        s->count++;
+                }
+        }
+
+        if (s->count > 0) {
+                s->count--;
+                return ESUCC;
+        } else {
+                timeouts++;
+                return ETIME;
+        }
+}
+
+/*==============================================================================
+  Fake LLD
+==============================================================================*/
+int  _UART_LLD__turn_on(u8_t major)                                    { UNUSED_ARG1(major); return ESUCC; }
+int  _UART_LLD__turn_off(u8_t major)                                   { UNUSED_ARG1(major); return ESUCC; }
+void _UART_LLD__transmit(u8_t major)                                   { UNUSED_ARG1(major); }
+void _UART_LLD__abort_trasmission(u8_t major)                          { UNUSED_ARG1(major); }
+void _UART_LLD__rx_resume(u8_t major)                                  { UNUSED_ARG1(major); }
+void _UART_LLD__rx_hold(u8_t major)                                    { UNUSED_ARG1(major); }
+void _UART_LLD__configure(u8_t major, const struct UART_config *config) { UNUSED_ARG2(major, config); }
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+//==============================================================================
+/**
+ * @brief Prepare line with n bytes of pattern.
+ */
+//==============================================================================
+static void line_set(size_t n, size_t burst)
+{
+        for (size_t i = 0; i < n; i++) {
+                line.data[i] = cast(u8_t, (i * 7) ^ (i >> 8));
+        }
+
+        line.len   = n;
+        line.pos   = 0;
+        line.burst = burst;
+}
+
+//==============================================================================
+/**
+ * @brief Blocking read of count bytes from line of the same length.
+ */
+//==============================================================================
+static void test_read_full(void *hdl, size_t count, size_t burst)
+{
+        struct UART_mem *mem   = hdl;
+        struct vfs_fattr fattr = {.non_blocking_rd = false};
+        fpos_t           fpos  = 0;
+        size_t           rdcnt = 0;
+
+        line_set(count, burst);
+        mem->Rx_FIFO.fifo_overrun = 0;
+        timeouts = 0;
+
+        HT_CHECK_OK(_UART_read(hdl, rxbuf, count, &fpos, &rdcnt, fattr));
+        HT_CHECK(rdcnt == count);
+        HT_CHECK(memcmp(rxbuf, line.data, count) == 0);
+        HT_CHECK(mem->Rx_FIFO.fifo_overrun == 0);
+        HT_CHECK(timeouts == 0);
+}
+
+//==============================================================================
+/**
+ * @brief Test main function.
+ */
+//==============================================================================
+int main(void)
+{
+        void *hdl = NULL;
+        HT_CHECK_OK(_UART_init(&hdl, 0, 0));
+
+        struct UART_mem *mem   = hdl;
+        struct vfs_fattr fattr = {.non_blocking_rd = false};
+        fpos_t           fpos  = 0;
+        size_t           rdcnt = 0;
+
+        // reads smaller and larger than FIFO, also larger than u16_t range
+        test_read_full(hdl, 10, 1);
+        test_read_full(hdl, _UART_RX_BUFFER_SIZE, 1);
+        test_read_full(hdl, _UART_RX_BUFFER_SIZE + 1, 1);
+        test_read_full(hdl, 4096, 1);
+        test_read_full(hdl, 4096, 16);
+        test_read_full(hdl, 65536, 1);
+        test_read_full(hdl, 65536 + 100, 3);
+
+        // bytes received during reader wakeup latency fit into FIFO
+        for (size_t burst = 1; burst <= _UART_RX_BUFFER_SIZE / 4; burst++) {
+                test_read_full(hdl, 1000 + burst, burst);
+        }
+
+        // 4 KiB read waits once per FIFO fill, not once per byte
+        waits = 0;
+        test_read_full(hdl, 4096, 1);
+        HT_CHECK(waits <= 4096 / (_UART_RX_BUFFER_SIZE / 2));
+
+        // minimum number of bytes
+        struct UART_read_mode mode = {.min = 5, .idle_timeout = 0};
+        HT_CHECK_OK(_UART_ioctl(hdl, IOCTL_UART__SET_READ_MODE, &mode));
+        line_set(8, 1);
+        HT_CHECK_OK(_UART_read(hdl, rxbuf, 100, &fpos, &rdcnt, fattr));
+        HT_CHECK(rdcnt >= 5 && rdcnt <= 8);
+
+        // idle line: 3 bytes received then line is silent
+        mode.min = 200; mode.idle_timeout = 10;
+        HT_CHECK_OK(_UART_ioctl(hdl, IOCTL_UART__SET_READ_MODE, &mode));
+        mem->Rx_FIFO.read_index = mem->Rx_FIFO.write_index;
+        line_set(3, 1);
+        HT_CHECK_OK(_UART_read(hdl, rxbuf, 300, &fpos, &rdcnt, fattr));
+        HT_CHECK(rdcnt == 3);
+        HT_CHECK(memcmp(rxbuf, line.data, 3) == 0);
+
+        // without idle timeout silent line is a timeout error
+        mode.min = 0; mode.idle_timeout = 0;
+        HT_CHECK_OK(_UART_ioctl(hdl, IOCTL_UART__SET_READ_MODE, &mode));
+        line_set(3, 1);
+        HT_CHECK(_UART_read(hdl, rxbuf, 10, &fpos, &rdcnt, fattr) == ETIME);
+
+        // non-blocking read returns FIFO content only
+        mem->Rx_FIFO.read_index = mem->Rx_FIFO.write_index;
+        for (u8_t b = 0; b < 20; b++) {
+                HT_CHECK(_UART_FIFO__write(&mem->Rx_FIFO, &b));
+        }
+        fattr.non_blocking_rd = true;
+        HT_CHECK_OK(_UART_read(hdl, rxbuf, 100, &fpos, &rdcnt, fattr));
+        HT_CHECK(rdcnt == 20 && rxbuf[19] == 19);
+        fattr.non_blocking_rd = false;
+
+        // FIFO overrun when nobody reads
+        mem->Rx_FIFO.fifo_overrun = 0;
+        for (int i = 0; i < _UART_RX_BUFFER_SIZE + 10; i++) {
+                u8_t b = i;
+                _UART_FIFO__write(&mem->Rx_FIFO, &b);
+        }
+        HT_CHECK(mem->Rx_FIFO.fifo_overrun == 10);
+
+        struct UART_rx_stat stat;
+        HT_CHECK_OK(_UART_ioctl(hdl, IOCTL_UART__GET_RX_STAT, &stat));
+
+        HT_CHECK_OK(_UART_release(hdl));
+        HT_CHECK(ht_mem_blocks() == 0);
+
+        ht_print("uart: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
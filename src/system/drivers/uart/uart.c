@@ -39,6 +39,13 @@
 #define RELEASE_TIMEOUT                         100
 #define RX_WAIT_TIMEOUT                         MAX_DELAY_MS
 #define MTX_BLOCK_TIMEOUT                       MAX_DELAY_MS
+#define FIFO_SIZE                               (_UART_RX_BUFFER_SIZE + 1)
+
+/* reader wakeup level limit, the rest of FIFO receives bytes during wakeup */
+#define WAKEUP_LEVEL_MAX                        max(1, _UART_RX_BUFFER_SIZE - (_UART_RX_BUFFER_SIZE / 4))
+
+/* compiler barrier: FIFO data must be accessed before index is updated */
+#define barrier()                               __asm__ volatile("" ::: "memory")
 
 /*==============================================================================
   Local types, enums definitions
@@ -47,7 +54,8 @@
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
-static bool _UART_FIFO__read(struct Rx_FIFO *fifo, u8_t *data);
+static size_t _UART_FIFO__read(struct Rx_FIFO *fifo, u8_t *dst, size_t count);
+static size_t _UART_FIFO__level(struct Rx_FIFO *fifo);
 
 /*==============================================================================
   Local object definitions
@@ -101,7 +109,7 @@ API_MOD_INIT(UART, void **device_handle, u8_t major, u8_t minor)
                 if (err)
                         goto finish;
 
-                err = sys_semaphore_create(_UART_RX_BUFFER_SIZE, 0, &_UART_mem[major]->data_read_sem);
+                err = sys_semaphore_create(1, 0, &_UART_mem[major]->data_read_sem);
                 if (err)
                         goto finish;
 
@@ -131,8 +139,8 @@ API_MOD_INIT(UART, void **device_handle, u8_t major, u8_t minor)
                         if (_UART_mem[major]->write_ready_sem)
                                 sys_semaphore_destroy(_UART_mem[major]->write_ready_sem);
 
-                        if (_UART_mem[major]->write_ready_sem)
-                                sys_semaphore_destroy(_UART_mem[major]->write_ready_sem);
+                        if (_UART_mem[major]->data_read_sem)
+                                sys_semaphore_destroy(_UART_mem[major]->data_read_sem);
 
                         sys_free(device_handle);
                         _UART_mem[major] = NULL;
@@ -161,12 +169,14 @@ API_MOD_RELEASE(UART, void *device_handle)
                         sys_mutex_destroy(hdl->port_lock_rx_mtx);
                         sys_mutex_destroy(hdl->port_lock_tx_mtx);
 
-                        sys_semaphore_destroy(hdl->write_ready_sem);
-
                         _UART_LLD__turn_off(hdl->major);
 
+                        sys_semaphore_destroy(hdl->write_ready_sem);
+                        sys_semaphore_destroy(hdl->data_read_sem);
+                        sys_poll_list_release(&hdl->poll);
+
                         _UART_mem[hdl->major] = NULL;
-                        sys_free(device_handle);
+                        sys_free(&device_handle);
 
                         return ESUCC;
                 }
@@ -294,23 +304,51 @@ API_MOD_READ(UART,
              size_t          *rdcnt,
              struct vfs_fattr fattr)
 {
-        UNUSED_ARG2(fpos, fattr);
+        UNUSED_ARG1(fpos);
 
-        struct UART_mem *hdl = device_handle;
+        struct UART_mem *hdl  = device_handle;
+        struct Rx_FIFO  *fifo = &hdl->Rx_FIFO;
 
         int err = sys_mutex_lock(hdl->port_lock_rx_mtx, MTX_BLOCK_TIMEOUT);
         if (!err) {
+                u16_t  idle = hdl->read_mode.idle_timeout;
+                size_t need = hdl->read_mode.min ? min(count, hdl->read_mode.min) : count;
+
                 *rdcnt = 0;
 
-                while (count--) {
-                        err = sys_semaphore_wait(hdl->data_read_sem, RX_WAIT_TIMEOUT);
-                        if (!err) {
-                                _UART_LLD__rx_hold(hdl->major);
-                                if (_UART_FIFO__read(&hdl->Rx_FIFO, dst)) {
-                                        dst++;
-                                        (*rdcnt)++;
+                for (;;) {
+                        *rdcnt += _UART_FIFO__read(fifo, dst + *rdcnt, count - *rdcnt);
+
+                        if (*rdcnt >= need || fattr.non_blocking_rd) {
+                                break;
+                        }
+
+                        // IRQ wakes up reader when requested number of bytes
+                        // is received or FIFO is almost full; level is
+                        // checked again to not miss bytes received before
+                        // wakeup level was set
+                        u32_t received     = fifo->received;
+                        fifo->wakeup_level = min(need - *rdcnt, cast(size_t, WAKEUP_LEVEL_MAX));
+
+                        if (_UART_FIFO__level(fifo) < fifo->wakeup_level) {
+                                err = sys_semaphore_wait(hdl->data_read_sem,
+                                                         idle ? idle : RX_WAIT_TIMEOUT);
+                        }
+
+                        fifo->wakeup_level = 0;
+
+                        if (err && idle) {
+                                err = ESUCC;
+
+                                // line is idle: no bytes received during timeout
+                                if (*rdcnt > 0 && fifo->received == received) {
+                                        *rdcnt += _UART_FIFO__read(fifo, dst + *rdcnt,
+                                                                   count - *rdcnt);
+                                        break;
                                 }
-                                _UART_LLD__rx_resume(hdl->major);
+
+                        } else if (err) {
+                                break;
                         }
                 }
 
@@ -350,13 +388,51 @@ API_MOD_IOCTL(UART, void *device_handle, int request, void *arg)
                         break;
 
                 case IOCTL_UART__GET_CHAR_UNBLOCKING:
-                        if (!_UART_FIFO__read(&hdl->Rx_FIFO, arg)) {
-                                err = EAGAIN;
+                        err = sys_mutex_trylock(hdl->port_lock_rx_mtx);
+                        if (!err) {
+                                if (_UART_FIFO__read(&hdl->Rx_FIFO, arg, 1) == 0) {
+                                        err = EAGAIN;
+                                }
+
+                                sys_mutex_unlock(hdl->port_lock_rx_mtx);
                         } else {
-                                err = ESUCC;
+                                err = EAGAIN;
                         }
                         break;
 
+                case IOCTL_UART__SET_READ_MODE:
+                        hdl->read_mode = *cast(struct UART_read_mode *, arg);
+                        err = ESUCC;
+                        break;
+
+                case IOCTL_UART__GET_READ_MODE:
+                        *cast(struct UART_read_mode *, arg) = hdl->read_mode;
+                        err = ESUCC;
+                        break;
+
+                case IOCTL_UART__GET_RX_STAT: {
+                        struct UART_rx_stat *stat = arg;
+                        stat->received     = hdl->Rx_FIFO.received;
+                        stat->fifo_overrun = hdl->Rx_FIFO.fifo_overrun;
+                        stat->hw_overrun   = hdl->Rx_FIFO.hw_overrun;
+                        err = ESUCC;
+                        break;
+                }
+
+                case IOCTL_VFS__POLL: {
+                        struct vfs_poll *poll = arg;
+                        sys_poll_wait(&hdl->poll, hdl, poll->entry);
+
+                        poll->events = POLLOUT;
+
+                        if (_UART_FIFO__level(&hdl->Rx_FIFO) > 0) {
+                                poll->events |= POLLIN;
+                        }
+
+                        err = ESUCC;
+                        break;
+                }
+
                 default:
                         err = EBADRQC;
                         break;
@@ -396,67 +472,117 @@ API_MOD_STAT(UART, void *device_handle, struct vfs_dev_stat *device_stat)
 {
         struct UART_mem *hdl = device_handle;
 
-        _UART_LLD__rx_hold(hdl->major);
-        device_stat->st_size = hdl->Rx_FIFO.buffer_level;
-        _UART_LLD__rx_resume(hdl->major);
+        device_stat->st_size = _UART_FIFO__level(&hdl->Rx_FIFO);
 
         return ESUCC;
 }
 
 //==============================================================================
 /**
- * @brief Function write data to FIFO
+ * @brief Function write data to FIFO. Function is called from IRQ.
  *
  * @param fifo          fifo buffer
  * @param data          data to write
  *
- * @return true if success, false on error
+ * @return true if success, false on error (FIFO overrun)
  */
 //==============================================================================
 bool _UART_FIFO__write(struct Rx_FIFO *fifo, u8_t *data)
 {
-        if (fifo->buffer_level < _UART_RX_BUFFER_SIZE) {
-                fifo->buffer[fifo->write_index++] = *data;
+        u16_t wr   = fifo->write_index;
+        u16_t next = (wr + 1 < FIFO_SIZE) ? wr + 1 : 0;
 
-                if (fifo->write_index >= _UART_RX_BUFFER_SIZE) {
-                        fifo->write_index = 0;
-                }
-
-                fifo->buffer_level++;
+        if (next != fifo->read_index) {
+                fifo->buffer[wr] = *data;
+                barrier();
+                fifo->write_index = next;
+                fifo->received++;
 
                 return true;
         } else {
+                fifo->fifo_overrun++;
                 return false;
         }
 }
 
 //==============================================================================
 /**
- * @brief Function read data from FIFO
+ * @brief Function check if reader should be woken up. Function is called from
+ *        IRQ after data is written to FIFO.
  *
  * @param fifo          fifo buffer
- * @param data          data result
  *
- * @return true if success, false on error
+ * @return true if reader should be woken up, otherwise false.
  */
 //==============================================================================
-static bool _UART_FIFO__read(struct Rx_FIFO *fifo, u8_t *data)
+bool _UART_FIFO__wakeup(struct Rx_FIFO *fifo)
 {
-        if (fifo->buffer_level > 0) {
-                *data = fifo->buffer[fifo->read_index++];
-
-                if (fifo->read_index >= _UART_RX_BUFFER_SIZE) {
-                        fifo->read_index = 0;
-                }
-
-                fifo->buffer_level--;
+        u16_t level = fifo->wakeup_level;
 
+        if (level && _UART_FIFO__level(fifo) >= level) {
+                fifo->wakeup_level = 0;
                 return true;
         } else {
                 return false;
         }
 }
 
+//==============================================================================
+/**
+ * @brief Function return number of bytes in FIFO.
+ *
+ * @param fifo          fifo buffer
+ *
+ * @return Number of bytes.
+ */
+//==============================================================================
+static size_t _UART_FIFO__level(struct Rx_FIFO *fifo)
+{
+        u16_t wr = fifo->write_index;
+        u16_t rd = fifo->read_index;
+
+        return (wr >= rd) ? (wr - rd) : (FIFO_SIZE - rd + wr);
+}
+
+//==============================================================================
+/**
+ * @brief Function read data from FIFO. Data is copied in at most two blocks.
+ *
+ * @param fifo          fifo buffer
+ * @param dst           destination buffer
+ * @param count         number of bytes to read
+ *
+ * @return Number of read bytes.
+ */
+//==============================================================================
+static size_t _UART_FIFO__read(struct Rx_FIFO *fifo, u8_t *dst, size_t count)
+{
+        u16_t  wr = fifo->write_index;
+        u16_t  rd = fifo->read_index;
+        size_t n  = 0;
+
+        barrier();
+
+        while (n < count && rd != wr) {
+                size_t len = min(count - n, cast(size_t, ((wr > rd) ? wr : FIFO_SIZE) - rd));
+
+                memcpy(&dst[n], &fifo->buffer[rd], len);
+
+                n  += len;
+                rd += len;
+
+                if (rd >= FIFO_SIZE) {
+                        rd = 0;
+                }
+        }
+
+        barrier();
+
+        fifo->read_index = rd;
+
+        return n;
+}
+
 /*==============================================================================
   End of file
 ==============================================================================*/
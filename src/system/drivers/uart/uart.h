@@ -120,12 +120,15 @@ enum {
 
 /* USART handling structure */
 struct UART_mem {
-        // Rx FIFO
+        // Rx FIFO (single producer: IRQ, single consumer: read operation)
         struct Rx_FIFO {
-                u8_t            buffer[_UART_RX_BUFFER_SIZE];
-                u16_t           buffer_level;
-                u16_t           read_index;
-                u16_t           write_index;
+                u8_t            buffer[_UART_RX_BUFFER_SIZE + 1];
+                volatile u16_t  write_index;    // modified by IRQ only
+                volatile u16_t  read_index;     // modified by reader only
+                volatile u16_t  wakeup_level;   // reader wakeup level (0: no reader)
+                volatile u32_t  received;
+                volatile u32_t  fifo_overrun;
+                volatile u32_t  hw_overrun;
         } Rx_FIFO;
 
         // Tx FIFO
@@ -141,6 +144,8 @@ struct UART_mem {
         mutex_t                *port_lock_tx_mtx;
         u8_t                    major;
         struct UART_config      config;
+        struct UART_read_mode   read_mode;
+        _poll_list_t            poll;
 };
 
 /*==============================================================================
@@ -159,6 +164,7 @@ extern void _UART_LLD__rx_resume(u8_t major);
 extern void _UART_LLD__rx_hold(u8_t major);
 extern void _UART_LLD__configure(u8_t major, const struct UART_config *config);
 extern bool _UART_FIFO__write(struct Rx_FIFO *fifo, u8_t *data);
+extern bool _UART_FIFO__wakeup(struct Rx_FIFO *fifo);
 
 /*==============================================================================
   Exported inline functions
@@ -82,6 +82,28 @@ support not blocking character read by using ioctl() function (by using followin
 requests: @ref IOCTL_UART__GET_CHAR_UNBLOCKING or @ref IOCTL_VFS__NON_BLOCKING_RD_MODE
 with fread() function). File position is ignored because device handle stream.
 
+By default read operation waits for all requested bytes. By using
+@ref IOCTL_UART__SET_READ_MODE request the read operation can return when
+at least <i>min</i> bytes are received or when line is idle for
+<i>idle_timeout</i> milliseconds after at least one byte is received:
+
+@code
+// ...
+
+FILE *f = fopen("/dev/ttyS0", "r");
+if (f) {
+        UART_read_mode_t mode = {.min = 16, .idle_timeout = 10};
+        ioctl(f, IOCTL_UART__SET_READ_MODE, &mode);
+
+        u8_t buf[64];
+        size_t n = fread(buf, 1, sizeof(buf), f);
+
+        // ...
+}
+@endcode
+
+Number of lost bytes can be read by using @ref IOCTL_UART__GET_RX_STAT request.
+
 @{
 */
 
@@ -121,6 +143,27 @@ extern "C" {
  */
 #define IOCTL_UART__GET_CHAR_UNBLOCKING         _IOR(UART, 0x02, char*)
 
+/**
+ *  @brief  Set read mode (minimum number of bytes and idle line timeout).
+ *  @param  [WR] struct @ref UART_read_mode_t * read mode
+ *  @return On success 0 is returned, otherwise -1.
+ */
+#define IOCTL_UART__SET_READ_MODE               _IOW(UART, 0x03, struct UART_read_mode*)
+
+/**
+ *  @brief  Gets read mode.
+ *  @param  [RD] struct @ref UART_read_mode_t * read mode
+ *  @return On success 0 is returned, otherwise -1.
+ */
+#define IOCTL_UART__GET_READ_MODE               _IOR(UART, 0x04, struct UART_read_mode*)
+
+/**
+ *  @brief  Gets receiver statistics.
+ *  @param  [RD] struct @ref UART_rx_stat_t * receiver statistics
+ *  @return On success 0 is returned, otherwise -1.
+ */
+#define IOCTL_UART__GET_RX_STAT                 _IOR(UART, 0x05, struct UART_rx_stat*)
+
 /*==============================================================================
   Exported object types
 ==============================================================================*/
@@ -164,6 +207,23 @@ typedef struct UART_config {
         u32_t               baud;               /*!< Baudrate.*/
 } UART_config_t;
 
+/**
+ * Type represent read mode (similar to VMIN and VTIME of termios).
+ */
+typedef struct UART_read_mode {
+        u16_t               min;                /*!< Minimum number of bytes returned by read (0: all requested bytes).*/
+        u16_t               idle_timeout;       /*!< Read returns received data if line is idle for this time [ms] (0: disabled).*/
+} UART_read_mode_t;
+
+/**
+ * Type represent receiver statistics.
+ */
+typedef struct UART_rx_stat {
+        u32_t               received;           /*!< Number of bytes stored in Rx FIFO.*/
+        u32_t               fifo_overrun;       /*!< Number of bytes lost because Rx FIFO was full.*/
+        u32_t               hw_overrun;         /*!< Number of hardware overrun errors.*/
+} UART_rx_stat_t;
+
 /*==============================================================================
   Exported objects
 ==============================================================================*/
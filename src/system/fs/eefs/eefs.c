@@ -211,8 +211,12 @@ typedef struct dir_desc {
  */
 typedef struct file_desc {
         struct file_desc *next;
+        drvinst_t        *drv;          // opened driver (device node)
+        uint16_t         *index;        // data block numbers of file chain (1..index_len)
         uint32_t          magic;
         uint16_t          block_num;
+        uint16_t          index_len;    // number of indexed data blocks
+        uint16_t          index_size;   // size of index buffer
         uint8_t           flags;
 } file_desc_t;
 
@@ -233,6 +237,11 @@ typedef struct {
         dir_desc_t  *open_dirs;
         file_desc_t *open_files;
         uint16_t     root_dir_block;
+        uint16_t     blocks;            // number of blocks
+        uint16_t     blocks_used;       // number of used blocks
+        uint16_t     bmp_next;          // next-fit cursor of block allocation
+        uint8_t     *bmp;               // RAM copy of empty block bitmap
+        uint32_t    *wear;              // writes of each block since mount (NULL if disabled)
         block_buf_t  block;
         block_buf_t  tmpblock;
         u8_t         flag;
@@ -248,6 +257,7 @@ static tfile_t eefs2vfs_file_type(uint8_t eefs_file_type);
 static int block_load(EEFS_t *hdl, const char *path);
 static int block_load_by_type(EEFS_t *hdl, const char *path, uint32_t type);
 static int block_get_file_stat(EEFS_t *hdl, struct stat *stat);
+static int bmp_load(EEFS_t *hdl);
 static int bmp_block_find_empty(EEFS_t *hdl, uint16_t *blknum);
 static int bmp_block_alloc_ctrl(EEFS_t *hdl, uint16_t blknum, bool allocate);
 static int bmp_block_alloc(EEFS_t *hdl, uint16_t blknum);
@@ -266,8 +276,10 @@ static int dir_get_size(EEFS_t *hdl, u16_t *dirsize);
 static int dir_read_entry(EEFS_t *hdl, dir_desc_t *dd, dir_entry_t *eefs_entry, dirent_t *dirent);
 static int file_truncate(EEFS_t *hdl);
 static int file_add_chain(EEFS_t *hdl);
-static int file_write(EEFS_t *hdl, const u8_t *src, size_t count, fpos_t *fpos, size_t *wrcnt);
-static int file_read(EEFS_t *hdl, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt);
+static void file_index_add(file_desc_t *fd, u16_t chain, u16_t blknum);
+static int file_index_seek(EEFS_t *hdl, file_desc_t *fd, u16_t *chainpos, u16_t *chain);
+static int file_write(EEFS_t *hdl, file_desc_t *fd, const u8_t *src, size_t count, fpos_t *fpos, size_t *wrcnt);
+static int file_read(EEFS_t *hdl, file_desc_t *fd, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt);
 
 /*==============================================================================
   Local object definitions
@@ -280,6 +292,12 @@ static int file_read(EEFS_t *hdl, u8_t *dst, size_t count, fpos_t *fpos, size_t
 /**
  * @brief Initialize file system
  *
+ * Options:
+ * @li sync     cache write-through
+ * @li ro       read-only mount
+ * @li wear     count writes of each block (4 bytes of RAM per block),
+ *              see IOCTL_VFS__GET_BLOCK_WEAR
+ *
  * @param[out]          **fs_handle             file system allocated memory
  * @param[in ]           *src_path              file source path
  * @param[in ]           *opts                  file system options (can be NULL)
@@ -324,6 +342,13 @@ API_FS_INIT(eefs, void **fs_handle, const char *src_path, const char *opts)
                                                 DBG("readonly mount");
                                         }
                                 }
+
+                                err = bmp_load(hdl);
+
+                                if (!err && !isstrempty(opts) && strstr(opts, "wear")) {
+                                        err = sys_zalloc(hdl->blocks * sizeof(uint32_t),
+                                                         cast(void*, &hdl->wear));
+                                }
                         } else {
                                 err = EMEDIUMTYPE;
                         }
@@ -333,6 +358,14 @@ API_FS_INIT(eefs, void **fs_handle, const char *src_path, const char *opts)
                 if (err) {
                         DBG("init error %d", err);
 
+                        if (hdl->bmp) {
+                                sys_free(cast(void*, &hdl->bmp));
+                        }
+
+                        if (hdl->wear) {
+                                sys_free(cast(void*, &hdl->wear));
+                        }
+
                         if (hdl->srcdev) {
                                 sys_fclose(hdl->srcdev);
                         }
@@ -368,6 +401,12 @@ API_FS_RELEASE(eefs, void *fs_handle)
                         sys_cache_drop(hdl->srcdev);
                         sys_fclose(hdl->srcdev);
 
+                        sys_free(cast(void*, &hdl->bmp));
+
+                        if (hdl->wear) {
+                                sys_free(cast(void*, &hdl->wear));
+                        }
+
                         mutex_t *mtx = hdl->lock_mtx;
 
                         memset(hdl, 0, sizeof(EEFS_t));
@@ -962,17 +1001,12 @@ API_FS_STATFS(eefs, void *fs_handle, struct statfs *statfs)
 
         int err = sys_mutex_lock(hdl->lock_mtx, BUSY_TIMEOUT);
         if (!err) {
+                statfs->f_blocks = hdl->blocks;
 
-                hdl->block.num = 0;
-                err = block_read(hdl, &hdl->block);
+                u16_t blkused = 0;
+                err = bmp_get_used_blocks(hdl, &blkused);
                 if (!err) {
-                        statfs->f_blocks = hdl->block.buf.main.blocks;
-
-                        u16_t blkused = 0;
-                        err = bmp_get_used_blocks(hdl, &blkused);
-                        if (!err) {
-                                statfs->f_bfree = statfs->f_blocks - blkused;
-                        }
+                        statfs->f_bfree = statfs->f_blocks - blkused;
                 }
 
                 sys_mutex_unlock(hdl->lock_mtx);
@@ -1004,7 +1038,7 @@ API_FS_OPEN(eefs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path,
         if (!err) {
 
                 file_desc_t *fd;
-                err = sys_malloc(sizeof(file_desc_t), cast(void*, &fd));
+                err = sys_zalloc(sizeof(file_desc_t), cast(void*, &fd));
                 if (!err) {
 
                         err = block_load(hdl, path);
@@ -1029,7 +1063,7 @@ API_FS_OPEN(eefs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path,
                                                 if (block_is_node(hdl->block)) {
                                                         *fpos     = 0;
                                                         dev_t dev = hdl->block.buf.node.dev;
-                                                        err       = sys_driver_open(dev, flags);
+                                                        err       = sys_drvinst_open(dev, flags, &fd->drv);
 
                                                 } else if (block_is_file(hdl->block)) {
                                                         *fpos = !(flags & O_APPEND) ? 0
@@ -1090,18 +1124,13 @@ API_FS_CLOSE(eefs, void *fs_handle, void *fhdl, bool force)
 
                         while (file) {
                                 if (file == fd) {
-                                        dev_t dev = -1;
+                                        if (fd->drv) {
+                                                err = sys_drvinst_close(fd->drv, force);
 
-                                        hdl->block.num = fd->block_num;
-                                        err = block_read(hdl, &hdl->block);
-                                        if (!err) {
-                                                if (block_is_node(hdl->block)) {
-                                                        dev = hdl->block.buf.node.dev;
+                                                // instance is released by forced close
+                                                if (force) {
+                                                        err = ESUCC;
                                                 }
-                                        }
-
-                                        if (dev != -1) {
-                                                err = sys_driver_close(dev, force);
                                         } else {
                                                 err = ESUCC;
                                         }
@@ -1113,6 +1142,10 @@ API_FS_CLOSE(eefs, void *fs_handle, void *fhdl, bool force)
                                                         hdl->open_files = file->next;
                                                 }
 
+                                                if (fd->index) {
+                                                        sys_free(cast(void*, &fd->index));
+                                                }
+
                                                 memset(fd, 0, sizeof(file_desc_t));
 
                                                 sys_free(&fhdl);
@@ -1169,6 +1202,10 @@ API_FS_WRITE(eefs,
                 return err;
         }
 
+        if (fd->drv) {
+                return sys_drvinst_write(fd->drv, src, count, fpos, wrcnt, fattr);
+        }
+
         err = sys_mutex_lock(hdl->lock_mtx, BUSY_TIMEOUT);
         if (!err) {
 
@@ -1176,16 +1213,8 @@ API_FS_WRITE(eefs,
                 err = block_read(hdl, &hdl->block);
 
                 if (!err) {
-                        if (block_is_node(hdl->block)) {
-                                dev_t dev = hdl->block.buf.node.dev;
-                                sys_mutex_unlock(hdl->lock_mtx);
-
-                                err = sys_driver_write(dev, src, count,
-                                                       fpos, wrcnt, fattr);
-                                goto finish;
-
-                        } else if (block_is_file(hdl->block)) {
-                                err = file_write(hdl, src, count, fpos, wrcnt);
+                        if (block_is_file(hdl->block)) {
+                                err = file_write(hdl, fd, src, count, fpos, wrcnt);
 
                         } else {
                                 err = EILSEQ;
@@ -1195,7 +1224,6 @@ API_FS_WRITE(eefs,
 
         sys_mutex_unlock(hdl->lock_mtx);
 
-        finish:
         return err;
 }
 
@@ -1232,6 +1260,10 @@ API_FS_READ(eefs,
                 return err;
         }
 
+        if (fd->drv) {
+                return sys_drvinst_read(fd->drv, dst, count, fpos, rdcnt, fattr);
+        }
+
         err = sys_mutex_lock(hdl->lock_mtx, BUSY_TIMEOUT);
         if (!err) {
 
@@ -1239,16 +1271,8 @@ API_FS_READ(eefs,
                 err = block_read(hdl, &hdl->block);
 
                 if (!err) {
-                        if (block_is_node(hdl->block)) {
-                                dev_t dev = hdl->block.buf.node.dev;
-                                sys_mutex_unlock(hdl->lock_mtx);
-
-                                err = sys_driver_read(dev, dst, count,
-                                                      fpos, rdcnt, fattr);
-                                goto finish;
-
-                        } else if (block_is_file(hdl->block)) {
-                                err = file_read(hdl, dst, count, fpos, rdcnt);
+                        if (block_is_file(hdl->block)) {
+                                err = file_read(hdl, fd, dst, count, fpos, rdcnt);
 
                         } else {
                                 err = EILSEQ;
@@ -1258,7 +1282,6 @@ API_FS_READ(eefs,
 
         sys_mutex_unlock(hdl->lock_mtx);
 
-        finish:
         return err;
 }
 
@@ -1282,25 +1305,35 @@ API_FS_IOCTL(eefs, void *fs_handle, void *fhdl, int request, void *arg)
         int err = EILSEQ;
 
         if (fd->magic == FILE_DESC_MAGIC) {
+                if (fd->drv) {
+                        err = sys_drvinst_ioctl(fd->drv, request, arg);
 
-                err = sys_mutex_lock(hdl->lock_mtx, BUSY_TIMEOUT);
-                if (!err) {
-                        dev_t dev = -1;
+                } else if (request == IOCTL_VFS__GET_BLOCK_WEAR) {
+                        struct vfs_block_wear *wear = arg;
 
-                        hdl->block.num = fd->block_num;
-                        err = block_read(hdl, &hdl->block);
+                        if (!hdl->wear) {
+                                err = ENOTSUP;
 
-                        if (!err) {
-                                if (block_is_node(hdl->block)) {
-                                        dev = hdl->block.buf.node.dev;
-                                }
-                        }
+                        } else if (!wear || wear->block >= hdl->blocks) {
+                                err = EINVAL;
 
-                        sys_mutex_unlock(hdl->lock_mtx);
+                        } else {
+                                err = sys_mutex_lock(hdl->lock_mtx, BUSY_TIMEOUT);
+                                if (!err) {
+                                        wear->writes     = hdl->wear[wear->block];
+                                        wear->writes_max = 0;
+                                        wear->blocks     = hdl->blocks;
+
+                                        for (u16_t i = 0; i < hdl->blocks; i++) {
+                                                wear->writes_max = max(wear->writes_max,
+                                                                       hdl->wear[i]);
+                                        }
 
-                        if (dev != -1) {
-                                err = sys_driver_ioctl(dev, request, arg);
+                                        sys_mutex_unlock(hdl->lock_mtx);
+                                }
                         }
+                } else {
+                        err = ESUCC;
                 }
         }
 
@@ -1319,31 +1352,17 @@ API_FS_IOCTL(eefs, void *fs_handle, void *fhdl, int request, void *arg)
 //==============================================================================
 API_FS_FLUSH(eefs, void *fs_handle, void *fhdl)
 {
-        EEFS_t      *hdl = fs_handle;
+        UNUSED_ARG1(fs_handle);
+
         file_desc_t *fd  = fhdl;
 
         int err = EILSEQ;
 
         if (fd->magic == FILE_DESC_MAGIC) {
-
-                err = sys_mutex_lock(hdl->lock_mtx, BUSY_TIMEOUT);
-                if (!err) {
-                        dev_t dev = -1;
-
-                        hdl->block.num = fd->block_num;
-                        err = block_read(hdl, &hdl->block);
-
-                        if (!err) {
-                                if (block_is_node(hdl->block)) {
-                                        dev = hdl->block.buf.node.dev;
-                                }
-                        }
-
-                        sys_mutex_unlock(hdl->lock_mtx);
-
-                        if (dev != -1) {
-                                err = sys_driver_flush(dev);
-                        }
+                if (fd->drv) {
+                        err = sys_drvinst_flush(fd->drv);
+                } else {
+                        err = ESUCC;
                 }
         }
 
@@ -1398,6 +1417,10 @@ static int block_write(EEFS_t *hdl, const block_buf_t *blk)
                return EROFS;
 
         } else {
+                if (hdl->wear && blk->num < hdl->blocks) {
+                        hdl->wear[blk->num]++;
+                }
+
                 return sys_cache_write(hdl->srcdev, blk->num, sizeof(block_t), 1,
                                        cast(u8_t*, &blk->buf),
                                        hdl->flag & FLAG_SYNC ? CACHE_WRITE_THROUGH
@@ -1631,72 +1654,98 @@ static int block_get_file_stat(EEFS_t *hdl, struct stat *stat)
 
 //==============================================================================
 /**
- * @brief  Function find empty block by using bitmap.
+ * @brief  Function load empty block bitmap to RAM. Main block must be loaded
+ *         in block buffer. Bitmap is stored in main block and in additional
+ *         bitmap blocks (bit set: block is empty). RAM copy is used to find
+ *         empty blocks without media access.
  *
  * @param  hdl          EEFS handle
- * @param  blknum       found empty block
  *
  * @return One of errno value.
  */
 //==============================================================================
-static int bmp_block_find_empty(EEFS_t *hdl, uint16_t *blknum)
+static int bmp_load(EEFS_t *hdl)
 {
-        hdl->tmpblock.num = MAIN_BLOCK_ADDR;
-        int err = block_read(hdl, &hdl->tmpblock);
-        if (!err) {
+        hdl->blocks = hdl->block.buf.main.blocks;
 
-                if (hdl->tmpblock.buf.main.magic != BLOCK_MAGIC_MAIN) {
-                        err = EILSEQ;
-                        goto finish;
-                }
-
-                uint16_t blks    = hdl->tmpblock.buf.main.blocks;
-                uint16_t bmpblks = hdl->tmpblock.buf.main.bitmap_blocks;
-                uint8_t *bmp     = hdl->tmpblock.buf.main.bitmap;
-                uint8_t  bsz     = sizeof(hdl->tmpblock.buf.main.bitmap);
-                uint8_t  bmpnext = 1;
+        size_t bmpsz = CEILING(hdl->blocks, BLOCKS_IN_BYTE);
+        size_t mainsz = sizeof(hdl->block.buf.main.bitmap);
+        size_t blksz  = sizeof(hdl->block.buf.bitmap.map);
 
-                *blknum = 0;
+        if (bmpsz > mainsz + (hdl->block.buf.main.bitmap_blocks * blksz)) {
+                return EMEDIUMTYPE;
+        }
 
-                do {
-                        for (u8_t i = 0; i < bsz && blks > 0; i++, blks -= 8) {
-                                if (bmp[i] == 0) {
-                                        continue;
-                                }
+        int err = sys_malloc(bmpsz, cast(void*, &hdl->bmp));
+        if (!err) {
+                size_t pos = min(mainsz, bmpsz);
+                memcpy(hdl->bmp, hdl->block.buf.main.bitmap, pos);
 
-                                for (u8_t bit = 0; bit < 8; bit++) {
-                                        if ((bmp[i] >> bit) & 1) {
-                                                *blknum += (i * 8) + bit;
-                                                goto finish;
-                                        }
-                                }
+                for (u16_t blk = 1; !err && pos < bmpsz; blk++) {
+                        hdl->tmpblock.num = blk;
+                        err = block_read(hdl, &hdl->tmpblock);
+                        if (!err) {
+                                size_t sz = min(blksz, bmpsz - pos);
+                                memcpy(&hdl->bmp[pos], hdl->tmpblock.buf.bitmap.map, sz);
+                                pos += sz;
                         }
+                }
+        }
 
-                        if (bmpblks && blks > 0) {
-                                *blknum += (bsz * 8);
+        if (!err) {
+                hdl->blocks_used = 0;
 
-                                hdl->tmpblock.num = bmpnext;
-                                err = block_read(hdl, &hdl->tmpblock);
-                                if (!err) {
-                                        bmp = hdl->block.buf.bitmap.map;
-                                        bsz = sizeof(hdl->block.buf.bitmap.map);
-                                        bmpnext++;
-                                }
+                for (u16_t blk = 0; blk < hdl->blocks; blk++) {
+                        if (!(hdl->bmp[blk / BLOCKS_IN_BYTE] & (1 << (blk % BLOCKS_IN_BYTE)))) {
+                                hdl->blocks_used++;
                         }
+                }
 
-                        if (*blknum == 0) {
-                                err = ENOSPC;
-                        }
-                } while (!err && bmpblks--);
+                // start allocation at random point to spread wear between mounts
+                time_t time = 0;
+                sys_get_time(&time);
+                hdl->bmp_next = cast(u32_t, time) % hdl->blocks;
         }
 
-        finish:
         return err;
 }
 
 //==============================================================================
 /**
- * @brief  Function allocate/release block.
+ * @brief  Function find empty block by using RAM bitmap. Search starts at
+ *         block next to the last allocated one (next-fit), thus allocations
+ *         are spread over whole memory instead of the lowest free block.
+ *
+ * @param  hdl          EEFS handle
+ * @param  blknum       found empty block
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int bmp_block_find_empty(EEFS_t *hdl, uint16_t *blknum)
+{
+        u16_t blk = hdl->bmp_next;
+
+        for (u16_t n = 0; n < hdl->blocks; n++, blk++) {
+                if (blk >= hdl->blocks) {
+                        blk = 0;
+                }
+
+                if (  blk > hdl->root_dir_block
+                   && hdl->bmp[blk / BLOCKS_IN_BYTE] & (1 << (blk % BLOCKS_IN_BYTE))) {
+
+                        *blknum = blk;
+                        return ESUCC;
+                }
+        }
+
+        return ENOSPC;
+}
+
+//==============================================================================
+/**
+ * @brief  Function allocate/release block. Block is marked in RAM bitmap and
+ *         in bitmap stored in memory.
  *
  * @param  hdl          EEFS handle
  * @param  blknum       block number to allocate/release
@@ -1707,6 +1756,17 @@ static int bmp_block_find_empty(EEFS_t *hdl, uint16_t *blknum)
 //==============================================================================
 static int bmp_block_alloc_ctrl(EEFS_t *hdl, uint16_t blknum, bool allocate)
 {
+        if (blknum >= hdl->blocks) {
+                return ENOSPC;
+        }
+
+        u8_t *bmpram = &hdl->bmp[blknum / BLOCKS_IN_BYTE];
+        u8_t  bmpbit = (1 << (blknum % BLOCKS_IN_BYTE));
+
+        if (allocate && !(*bmpram & bmpbit)) {
+                return EADDRINUSE;
+        }
+
         hdl->tmpblock.num = MAIN_BLOCK_ADDR;
         int err = block_read(hdl, &hdl->tmpblock);
         if (!err) {
@@ -1716,13 +1776,8 @@ static int bmp_block_alloc_ctrl(EEFS_t *hdl, uint16_t blknum, bool allocate)
                         goto finish;
                 }
 
-                if (blknum >= hdl->tmpblock.buf.main.blocks) {
-                        err = ENOSPC;
-                        goto finish;
-                }
-
                 u16_t bmpblk = 0;
-                u8_t  blkidx = (blknum / 8);
+                u16_t blkidx = (blknum / 8);
                 u8_t  blkbit = (blknum % 8);
                 u8_t *bmp    = hdl->tmpblock.buf.main.bitmap;
 
@@ -1745,17 +1800,24 @@ static int bmp_block_alloc_ctrl(EEFS_t *hdl, uint16_t blknum, bool allocate)
                 }
 
                 if (!err) {
-                        if (allocate && !(bmp[blkidx] & (1 << blkbit))) {
-                                err = EADDRINUSE;
-
+                        if (allocate) {
+                                bmp[blkidx] &= ~(1 << blkbit);
                         } else {
-                                if (allocate) {
-                                        bmp[blkidx] &= ~(1 << blkbit);
-                                } else {
-                                        bmp[blkidx] |= (1 << blkbit);
-                                }
+                                bmp[blkidx] |= (1 << blkbit);
+                        }
 
-                                err = block_write(hdl, &hdl->tmpblock);
+                        err = block_write(hdl, &hdl->tmpblock);
+                }
+
+                if (!err) {
+                        if (allocate) {
+                                *bmpram &= ~bmpbit;
+                                hdl->blocks_used++;
+                                hdl->bmp_next = blknum + 1;
+
+                        } else if (!(*bmpram & bmpbit)) {
+                                *bmpram |= bmpbit;
+                                hdl->blocks_used--;
                         }
                 }
         }
@@ -1806,57 +1868,8 @@ static int bmp_block_free(EEFS_t *hdl, uint16_t blknum)
 //==============================================================================
 static int bmp_get_used_blocks(EEFS_t *hdl, uint16_t *blkused)
 {
-        hdl->tmpblock.num = MAIN_BLOCK_ADDR;
-        int err = block_read(hdl, &hdl->tmpblock);
-        if (!err) {
-
-                if (hdl->tmpblock.buf.main.magic != BLOCK_MAGIC_MAIN) {
-                        err = EILSEQ;
-                        goto finish;
-                }
-
-                uint16_t blks    = hdl->tmpblock.buf.main.blocks;
-                uint16_t bmpblks = hdl->tmpblock.buf.main.bitmap_blocks;
-                uint8_t *bmp     = hdl->tmpblock.buf.main.bitmap;
-                uint8_t  bsz     = sizeof(hdl->tmpblock.buf.main.bitmap);
-                uint8_t  bmpnext = 1;
-
-                do {
-                        for (u8_t i = 0; i < bsz && blks > 0; i++, blks -= 8) {
-                                u8_t ones;
-
-                                if (bmp[i] == 0xFF) {
-                                        ones = 8;
-                                } else if (bmp[i] == 0) {
-                                        ones = 0;
-                                } else {
-                                        ones = ((bmp[i] >> 7) & 1)
-                                             + ((bmp[i] >> 6) & 1)
-                                             + ((bmp[i] >> 5) & 1)
-                                             + ((bmp[i] >> 4) & 1)
-                                             + ((bmp[i] >> 3) & 1)
-                                             + ((bmp[i] >> 2) & 1)
-                                             + ((bmp[i] >> 1) & 1)
-                                             + ((bmp[i] >> 0) & 1);
-                                }
-
-                                *blkused += (8 - ones);
-                        }
-
-                        if (bmpblks) {
-                                hdl->tmpblock.num = bmpnext;
-                                err = block_read(hdl, &hdl->tmpblock);
-                                if (!err) {
-                                        bmp = hdl->tmpblock.buf.bitmap.map;
-                                        bsz = sizeof(hdl->tmpblock.buf.bitmap.map);
-                                        bmpnext++;
-                                }
-                        }
-                } while (!err && bmpblks--);
-        }
-
-        finish:
-        return err;
+        *blkused = hdl->blocks_used;
+        return ESUCC;
 }
 
 //==============================================================================
@@ -2545,6 +2558,13 @@ static int file_truncate(EEFS_t *hdl)
 
         if (block_is_file(hdl->block)) {
 
+                // block index of opened files is not valid after truncate
+                for (file_desc_t *fd = hdl->open_files; fd; fd = fd->next) {
+                        if (fd->block_num == hdl->block.num) {
+                                fd->index_len = 0;
+                        }
+                }
+
                 hdl->tmpblock.num = hdl->block.buf.file.data_next;
 
                 if (!(  hdl->block.buf.file.size      == 0
@@ -2636,11 +2656,86 @@ static int file_add_chain(EEFS_t *hdl)
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function add data block to file block index. Block is added only if
+ *         it is the next block of indexed part of the chain. If index cannot
+ *         be extended then chain is followed block by block.
+ *
+ * @param  fd           file descriptor
+ * @param  chain        chain number of block (1: first data block)
+ * @param  blknum       block number
+ */
+//==============================================================================
+static void file_index_add(file_desc_t *fd, u16_t chain, u16_t blknum)
+{
+        if (chain != fd->index_len + 1) {
+                return;
+        }
+
+        if (fd->index_len == fd->index_size) {
+                u16_t  size  = fd->index_size ? fd->index_size * 2 : 8;
+                u16_t *index = NULL;
+
+                if (sys_malloc(size * sizeof(u16_t), cast(void*, &index)) != ESUCC) {
+                        return;
+                }
+
+                if (fd->index) {
+                        memcpy(index, fd->index, fd->index_len * sizeof(u16_t));
+                        sys_free(cast(void*, &fd->index));
+                }
+
+                fd->index      = index;
+                fd->index_size = size;
+        }
+
+        fd->index[fd->index_len++] = blknum;
+}
+
+//==============================================================================
+/**
+ * @brief  Function load the nearest indexed data block on the way to selected
+ *         chain position. Chain position is reduced by number of skipped
+ *         blocks. If no block is indexed then block buffer is not changed.
+ *
+ * @param  hdl          EEFS handle
+ * @param  fd           file descriptor
+ * @param  chainpos     chain position to reach (relative to the file block)
+ * @param  chain        chain number of loaded block (0: file block)
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int file_index_seek(EEFS_t *hdl, file_desc_t *fd, u16_t *chainpos, u16_t *chain)
+{
+        int   err = ESUCC;
+        u16_t n   = min(*chainpos, fd->index_len);
+
+        *chain = 0;
+
+        if (n > 0) {
+                hdl->block.num = fd->index[n - 1];
+                err = block_read(hdl, &hdl->block);
+                if (!err) {
+                        if (block_is_file_data(hdl->block)) {
+                                *chain     = n;
+                                *chainpos -= n;
+                        } else {
+                                err = EILSEQ;
+                        }
+                }
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief  Function write data to file loaded in current block.
  *
  * @param  hdl          EEFS handle
+ * @param  fd           file descriptor
  * @param  src          source buffer
  * @param  count        number of bytes to write
  * @param  fpos         position in file
@@ -2649,7 +2744,7 @@ static int file_add_chain(EEFS_t *hdl)
  * @return One of errno value.
  */
 //==============================================================================
-static int file_write(EEFS_t *hdl, const u8_t *src, size_t count, fpos_t *fpos, size_t *wrcnt)
+static int file_write(EEFS_t *hdl, file_desc_t *fd, const u8_t *src, size_t count, fpos_t *fpos, size_t *wrcnt)
 {
         int err = ESUCC;
 
@@ -2669,6 +2764,14 @@ static int file_write(EEFS_t *hdl, const u8_t *src, size_t count, fpos_t *fpos,
                          - ((chainpos - 1) * sizeof(((block_file_data_t*)0)->data));
         }
 
+        // jump to the nearest indexed block
+        u16_t chain = 0;
+        err = file_index_seek(hdl, fd, &chainpos, &chain);
+        if (chain > 0) {
+                chainsz = sizeof(hdl->block.buf.file_data.data);
+                data    = hdl->block.buf.file_data.data;
+        }
+
         while (!err && count > 0) {
                 if (chainpos > 0) {
                         u16_t next = 0;
@@ -2693,6 +2796,10 @@ static int file_write(EEFS_t *hdl, const u8_t *src, size_t count, fpos_t *fpos,
                                 err = block_read(hdl, &hdl->block);
                         }
 
+                        if (!err) {
+                                file_index_add(fd, ++chain, hdl->block.num);
+                        }
+
                         chainpos--;
                 }
 
@@ -2737,6 +2844,7 @@ static int file_write(EEFS_t *hdl, const u8_t *src, size_t count, fpos_t *fpos,
  * @brief  Function read data from selected file loaded in current block.
  *
  * @param  hdl          EEFS handle
+ * @param  fd           file descriptor
  * @param  dst          destination buffer
  * @param  count        number of bytes to read
  * @param  fpos         file position
@@ -2745,7 +2853,7 @@ static int file_write(EEFS_t *hdl, const u8_t *src, size_t count, fpos_t *fpos,
  * @return One of errno value.
  */
 //==============================================================================
-static int file_read(EEFS_t *hdl, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt)
+static int file_read(EEFS_t *hdl, file_desc_t *fd, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt)
 {
         int err = ESUCC;
 
@@ -2772,6 +2880,14 @@ static int file_read(EEFS_t *hdl, u8_t *dst, size_t count, fpos_t *fpos, size_t
                          - ((chainpos - 1) * sizeof(((block_file_data_t*)0)->data));
         }
 
+        // jump to the nearest indexed block
+        u16_t chain = 0;
+        err = file_index_seek(hdl, fd, &chainpos, &chain);
+        if (chain > 0) {
+                chainsz = sizeof(hdl->block.buf.file_data.data);
+                data    = hdl->block.buf.file_data.data;
+        }
+
         while (!err && count > 0) {
                 if (chainpos > 0) {
                         u16_t next = 0;
@@ -2797,6 +2913,10 @@ static int file_read(EEFS_t *hdl, u8_t *dst, size_t count, fpos_t *fpos, size_t
                                 err = block_read(hdl, &hdl->block);
                         }
 
+                        if (!err) {
+                                file_index_add(fd, ++chain, hdl->block.num);
+                        }
+
                         chainpos--;
                 }
 
@@ -0,0 +1,348 @@
+/*=========================================================================*//**
+File     eefs_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test of EEFS on RAM device image.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Empty file system is created in RAM image of the device. Files are written
+ * interleaved and read at random positions by using file block index. Test
+ * checks that truncated file is not read by stale index of other descriptor,
+ * that allocation spreads writes of data blocks, and that RAM bitmap is
+ * consistent with the device after remount. Tested file is included to use
+ * file system structures.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "../eefs.c"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define BLOCKS                  512
+#define FILES                   3
+#define FILE_LEN                12000
+#define CHUNK                   300
+#define RANDOM_READS            3000
+#define CYCLES                  50
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static block_t img[BLOCKS];
+static int     dev;
+
+/*==============================================================================
+  Kernel services
+==============================================================================*/
+int sys_cache_read(FILE *file, u32_t blkpos, size_t blksz, size_t blkcnt, u8_t *buf)
+{
+        if ((blkpos + blkcnt) * blksz > sizeof(img)) {
+                return EIO;
+        }
+
+        memcpy(buf, cast(u8_t*, img) + (blkpos * blksz), blkcnt * blksz);
+        return ESUCC;
+}
+
+int sys_cache_write(FILE *file, u32_t blkpos, size_t blksz, size_t blkcnt, const u8_t *buf, enum cache_mode mode)
+{
+        if ((blkpos + blkcnt) * blksz > sizeof(img)) {
+                return EIO;
+        }
+
+        memcpy(cast(u8_t*, img) + (blkpos * blksz), buf, blkcnt * blksz);
+        return ESUCC;
+}
+
+int sys_cache_drop(FILE *file)
+{
+        return ESUCC;
+}
+
+int sys_fopen(const char *path, const char *mode, FILE **file)
+{
+        *file = cast(FILE*, &dev);
+        return ESUCC;
+}
+
+int sys_fclose(FILE *file)
+{
+        return ESUCC;
+}
+
+int sys_mutex_create(enum mutex_type type, mutex_t **mtx)
+{
+        return _kmalloc(_MM_KRN, sizeof(int), cast(void**, mtx));
+}
+
+int sys_mutex_destroy(mutex_t *mtx)
+{
+        return _kfree(_MM_KRN, cast(void**, &mtx));
+}
+
+int _mutex_lock(mutex_t *mtx, const u32_t timeout)
+{
+        return ESUCC;
+}
+
+int _mutex_unlock(mutex_t *mtx)
+{
+        return ESUCC;
+}
+
+int _gettime(time_t *timer)
+{
+        *timer = 12345;
+        return ESUCC;
+}
+
+int _driver_stat(dev_t dev, struct vfs_dev_stat *stat)
+{
+        return ENODEV;
+}
+
+int _drvinst_open(dev_t dev, u32_t mode, drvinst_t **drvinst)
+{
+        return ENODEV;
+}
+
+int _drvinst_close(drvinst_t *drvinst, bool force)
+{
+        return ENODEV;
+}
+
+int _drvinst_write(drvinst_t *drvinst, const u8_t *src, size_t count, fpos_t *fpos, size_t *wrcnt, struct vfs_fattr fattr)
+{
+        return ENODEV;
+}
+
+int _drvinst_read(drvinst_t *drvinst, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt, struct vfs_fattr fattr)
+{
+        return ENODEV;
+}
+
+int _drvinst_ioctl(drvinst_t *drvinst, int request, void *arg)
+{
+        return ENODEV;
+}
+
+int _drvinst_flush(drvinst_t *drvinst)
+{
+        return ENODEV;
+}
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Create empty file system: main block and root directory.
+ */
+//==============================================================================
+static void make_fs(void)
+{
+        memset(img, 0xFF, sizeof(img));
+
+        img[0].main.magic         = BLOCK_MAGIC_MAIN;
+        img[0].main.blocks        = BLOCKS;
+        img[0].main.bitmap_blocks = 0;
+        img[0].main.bitmap[0]    &= ~0x03;
+
+        img[1].dir.magic     = BLOCK_MAGIC_DIR;
+        img[1].dir.parent    = 0;
+        img[1].dir.next      = 0;
+        img[1].dir.all_items = 0;
+}
+
+//==============================================================================
+/**
+ * @brief  File content pattern.
+ */
+//==============================================================================
+static u8_t pattern(u32_t pos, int file)
+{
+        return (pos * 31) + (file * 7) + (pos >> 7);
+}
+
+//==============================================================================
+/**
+ * @brief  Return number of free blocks.
+ */
+//==============================================================================
+static u32_t free_blocks(void *fs)
+{
+        struct statfs stat;
+        HT_CHECK_OK(_eefs_statfs(fs, &stat));
+        HT_CHECK(stat.f_blocks == BLOCKS);
+        return stat.f_bfree;
+}
+
+//==============================================================================
+/**
+ * @brief  Return number of writes of block since mount.
+ */
+//==============================================================================
+static u32_t block_writes(void *fs, void *fhdl, u32_t blk)
+{
+        struct vfs_block_wear wear = {.block = blk};
+        HT_CHECK_OK(_eefs_ioctl(fs, fhdl, IOCTL_VFS__GET_BLOCK_WEAR, &wear));
+        HT_CHECK(wear.blocks == BLOCKS);
+        HT_CHECK(wear.writes <= wear.writes_max);
+        return wear.writes;
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        static u8_t buf[CHUNK * 2];
+        void       *fs;
+        void       *f[FILES];
+        void       *g;
+        fpos_t      pos;
+        size_t      n;
+        char        name[8] = "/f0";
+        struct vfs_fattr fattr = {.non_blocking_rd = false};
+
+        make_fs();
+        HT_CHECK_OK(_eefs_init(&fs, "/dev/ee", "wear"));
+
+        u32_t bfree = free_blocks(fs);
+        HT_CHECK(bfree == BLOCKS - 2);
+
+        // interleaved appends, data blocks of files are mixed
+        for (int k = 0; k < FILES; k++) {
+                name[2] = '0' + k;
+                HT_CHECK_OK(_eefs_open(fs, &f[k], &pos, name, O_CREAT | O_RDWR));
+        }
+
+        for (u32_t off = 0; off < FILE_LEN; off += CHUNK) {
+                for (int k = 0; k < FILES; k++) {
+                        for (int i = 0; i < CHUNK; i++) {
+                                buf[i] = pattern(off + i, k);
+                        }
+
+                        pos = off;
+                        HT_CHECK_OK(_eefs_write(fs, f[k], buf, CHUNK, &pos, &n, fattr));
+                        HT_CHECK(n == CHUNK);
+                }
+        }
+
+        HT_CHECK(free_blocks(fs) < bfree - FILES * (FILE_LEN / BLOCK_SIZE));
+
+        // random reads
+        ht_srand(3);
+        for (int i = 0; i < RANDOM_READS; i++) {
+                int   k   = ht_rand() % FILES;
+                u32_t off = ht_rand() % (FILE_LEN - 100);
+                u32_t len = 1 + ht_rand() % min(FILE_LEN - off, sizeof(buf));
+
+                pos = off;
+                HT_CHECK_OK(_eefs_read(fs, f[k], buf, len, &pos, &n, fattr));
+                HT_CHECK(n == len);
+
+                for (u32_t j = 0; j < len; j++) {
+                        HT_CHECK(buf[j] == pattern(off + j, k));
+                }
+        }
+
+        // file truncated by other descriptor is not read by stale index
+        HT_CHECK_OK(_eefs_open(fs, &g, &pos, "/f1", O_RDWR | O_TRUNC));
+        for (int i = 0; i < 500; i++) {
+                buf[i] = pattern(i, 9);
+        }
+
+        pos = 0;
+        HT_CHECK_OK(_eefs_write(fs, g, buf, 500, &pos, &n, fattr));
+        HT_CHECK_OK(_eefs_close(fs, g, false));
+
+        pos = 100;
+        HT_CHECK_OK(_eefs_read(fs, f[1], buf, 300, &pos, &n, fattr));
+        HT_CHECK(n == 300);
+        for (u32_t i = 0; i < n; i++) {
+                HT_CHECK(buf[i] == pattern(100 + i, 9));
+        }
+
+        for (int k = 0; k < FILES; k++) {
+                HT_CHECK_OK(_eefs_close(fs, f[k], false));
+                name[2] = '0' + k;
+                HT_CHECK_OK(_eefs_remove(fs, name));
+        }
+
+        HT_CHECK(free_blocks(fs) == bfree);
+
+        // created and removed files do not wear the same data blocks, file
+        // is used to get block statistics
+        void *q;
+        HT_CHECK_OK(_eefs_open(fs, &q, &pos, "/q", O_CREAT | O_RDWR));
+
+        u32_t before[BLOCKS];
+        for (u32_t blk = 0; blk < BLOCKS; blk++) {
+                before[blk] = block_writes(fs, q, blk);
+        }
+
+        for (int i = 0; i < CYCLES; i++) {
+                HT_CHECK_OK(_eefs_open(fs, &g, &pos, "/w", O_CREAT | O_RDWR));
+                pos = 0;
+                HT_CHECK_OK(_eefs_write(fs, g, buf, sizeof(buf), &pos, &n, fattr));
+                HT_CHECK_OK(_eefs_close(fs, g, false));
+                HT_CHECK_OK(_eefs_remove(fs, "/w"));
+        }
+
+        u32_t data_max = 0;
+        for (u32_t blk = 2; blk < BLOCKS; blk++) {
+                data_max = max(data_max, block_writes(fs, q, blk) - before[blk]);
+        }
+
+        ht_print("eefs: data block writes max %u in %d cycles\n", data_max, CYCLES);
+        HT_CHECK(data_max < CYCLES / 4);
+
+        HT_CHECK_OK(_eefs_close(fs, q, false));
+        HT_CHECK_OK(_eefs_remove(fs, "/q"));
+        HT_CHECK(free_blocks(fs) == bfree);
+        HT_CHECK_OK(_eefs_release(fs));
+
+        // bitmap of device is consistent with RAM bitmap
+        HT_CHECK_OK(_eefs_init(&fs, "/dev/ee", ""));
+        HT_CHECK(free_blocks(fs) == bfree);
+        HT_CHECK_OK(_eefs_release(fs));
+
+        HT_CHECK(ht_mem_blocks() == 0);
+
+        ht_print("eefs: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -77,6 +77,10 @@ static time_t time_fat2unix(uint32_t fattime);
 /**
  * @brief Initialize file system
  *
+ * Options:
+ * @li fbuf=N   N files can use own sector buffer (one sector of memory per
+ *              file). Files without buffer share the volume window. Default 0.
+ *
  * @param[out]          **fs_handle             file system allocated memory
  * @param[in ]           *src_path              file source path
  * @param[in ]           *opts                  file system options (can be NULL)
@@ -86,12 +90,18 @@ static time_t time_fat2unix(uint32_t fattime);
 //==============================================================================
 API_FS_INIT(fatfs, void **fs_handle, const char *src_path, const char *opts)
 {
-        UNUSED_ARG1(opts);
-
         int err = sys_zalloc(sizeof(struct fatfs), fs_handle);
         if (err == ESUCC) {
                 struct fatfs *hdl = *fs_handle;
 
+                if (!isstrempty(opts)) {
+                        const char *fbuf = strstr(opts, "fbuf=");
+                        if (fbuf) {
+                                i32_t n = sys_atoi(fbuf + 5);
+                                hdl->fatfs.fbuf_max = (n < 0) ? 0 : min(n, UINT16_MAX);
+                        }
+                }
+
                 err = sys_fopen(src_path, "r+", &hdl->fsfile);
                 if (err == ESUCC) {
                         err = faterr_2_errno(libfat_mount(hdl->fsfile, &hdl->fatfs));
@@ -184,6 +194,7 @@ API_FS_OPEN(fatfs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path,
         if (flags & O_APPEND) {
                 err = faterr_2_errno(libfat_lseek(fat_file, libfat_size(fat_file)));
                 if (err) {
+                        libfat_close(fat_file);
                         sys_free(fhdl);
                         return err;
                 }
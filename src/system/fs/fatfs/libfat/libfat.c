@@ -414,6 +414,12 @@ static uint32_t get_fat         (FATFS *fs, uint32_t clst);
 static FRESULT  put_fat         (FATFS *fs, uint32_t clst, uint32_t val);
 static FRESULT  remove_chain    (FATFS *fs, uint32_t clst);
 static uint32_t create_chain    (FATFS *fs, uint32_t clst);
+static void     clmt_add        (FATFILE *fp, uint32_t ci, uint32_t clst);
+static void     clmt_trim       (FATFILE *fp, uint32_t len);
+static void     clmt_free       (FATFILE *fp);
+static uint     clmt_find       (FATFILE *fp, uint32_t ci);
+static FRESULT  clmt_seek       (FATFILE *fp, uint32_t *ci, int stretch, uint32_t *clst);
+static FRESULT  clmt_span       (FATFILE *fp, uint csect, uint *cc, int stretch);
 static FRESULT  dir_sdi         (FATDIR *dj, uint16_t idx);
 static FRESULT  dir_next        (FATDIR *dj, int stretch);
 static FRESULT  dir_alloc       (FATDIR *dj, uint nent);
@@ -717,7 +723,10 @@ static FRESULT move_window(FATFS *fs, uint32_t sector)
 
 //==============================================================================
 /**
- * @brief Synchronize file system and storage device
+ * @brief Write cached FSInfo (free cluster count and next free cluster) to
+ *        the FSInfo sector. Allocation information is kept in RAM and is
+ *        written only when volume is synchronized, thus file flush does not
+ *        cost additional sector write.
  *
  * @param[in] *fs       File system object
  *
@@ -725,32 +734,50 @@ static FRESULT move_window(FATFS *fs, uint32_t sector)
  * @retval FR_DISK_ERR
  */
 //==============================================================================
-static FRESULT sync_fs(FATFS *fs)
+static FRESULT sync_fsinfo(FATFS *fs)
 {
         FRESULT res;
 
         res = sync_window(fs);
-        if (res == FR_OK) {
-                /* Update FSInfo sector if needed */
-                if (fs->fs_type == LIBFAT_FS_FAT32 && fs->fsi_flag) {
-                        fs->winsect = 0;
-
-                        /* Create FSInfo structure */
-                        memset(fs->win, 0, 512);
-                        STORE_UINT16(fs->win+BS_55AA, 0xAA55);
-                        STORE_UINT32(fs->win+FSI_LeadSig, 0x41615252);
-                        STORE_UINT32(fs->win+FSI_StrucSig, 0x61417272);
-                        STORE_UINT32(fs->win+FSI_Free_Count, fs->free_clust);
-                        STORE_UINT32(fs->win+FSI_Nxt_Free, fs->last_clust);
-
-                        /* Write it into the FSInfo sector */
-                        if (_libfat_disk_write(fs->srcfile, fs->win, fs->fsi_sector, 1) != RES_OK) {
-                                res = FR_DISK_ERR;
-                        }
-
+        if (res == FR_OK && fs->fs_type == LIBFAT_FS_FAT32 && fs->fsi_flag) {
+                fs->winsect = 0;
+
+                /* Create FSInfo structure */
+                memset(fs->win, 0, 512);
+                STORE_UINT16(fs->win+BS_55AA, 0xAA55);
+                STORE_UINT32(fs->win+FSI_LeadSig, 0x41615252);
+                STORE_UINT32(fs->win+FSI_StrucSig, 0x61417272);
+                STORE_UINT32(fs->win+FSI_Free_Count, fs->free_clust);
+                STORE_UINT32(fs->win+FSI_Nxt_Free, fs->last_clust);
+
+                /* Write it into the FSInfo sector */
+                if (_libfat_disk_write(fs->srcfile, fs->win, fs->fsi_sector, 1) != RES_OK) {
+                        res = FR_DISK_ERR;
+                } else {
                         fs->fsi_flag = 0;
                 }
+        }
+
+        return res;
+}
 
+//==============================================================================
+/**
+ * @brief Synchronize file system and storage device. FSInfo is not written
+ *        (see sync_fsinfo()).
+ *
+ * @param[in] *fs       File system object
+ *
+ * @retval FR_OK
+ * @retval FR_DISK_ERR
+ */
+//==============================================================================
+static FRESULT sync_fs(FATFS *fs)
+{
+        FRESULT res;
+
+        res = sync_window(fs);
+        if (res == FR_OK) {
                 /* Make sure that no pending write process in the physical drive */
                 if (_libfat_disk_ioctl(fs->srcfile, CTRL_SYNC, 0) != RES_OK) {
                         res = FR_DISK_ERR;
@@ -984,6 +1011,10 @@ static uint32_t create_chain(FATFS *fs, uint32_t clst)
         uint32_t cs, ncl, scl;
         FRESULT res;
 
+        /* Volume is full, FAT scan is not needed */
+        if (fs->free_clust == 0)
+                return 0;
+
         if (clst == 0) {
                 scl = fs->last_clust;
                 if (!scl || scl >= fs->n_fatent) scl = 1;
@@ -1037,6 +1068,238 @@ static uint32_t create_chain(FATFS *fs, uint32_t clst)
         return ncl;
 }
 
+//==============================================================================
+/**
+ * @brief Cluster link map - Add cluster to the map. Cluster is added only if
+ *        it is the next cluster of the mapped part of the chain. Contiguous
+ *        clusters extend the last run, thus unfragmented file needs one run.
+ *        If memory cannot be allocated then the map is not extended and chain
+ *        is followed on the FAT.
+ *
+ * @param[in] *fp       File object
+ * @param[in]  ci       Index of cluster in the file
+ * @param[in]  clst     Cluster number
+ */
+//==============================================================================
+static void clmt_add(FATFILE *fp, uint32_t ci, uint32_t clst)
+{
+        if (ci != fp->clmt_len)
+                return;
+
+        if (fp->clmt_runs) {
+                struct CLMT *run = &fp->clmt[fp->clmt_runs - 1];
+                if (run->clst + (ci - run->ci) == clst) {
+                        fp->clmt_len++;
+                        return;
+                }
+        }
+
+        if (fp->clmt_runs == fp->clmt_size) {
+                if (fp->clmt_size >= UINT16_MAX / 2)
+                        return;
+
+                uint16_t     size = fp->clmt_size ? fp->clmt_size * 2 : 4;
+                struct CLMT *clmt = _libfat_malloc(size * sizeof(struct CLMT));
+                if (!clmt)
+                        return;
+
+                if (fp->clmt) {
+                        memcpy(clmt, fp->clmt, fp->clmt_runs * sizeof(struct CLMT));
+                        _libfat_free(fp->clmt);
+                }
+
+                fp->clmt      = clmt;
+                fp->clmt_size = size;
+        }
+
+        fp->clmt[fp->clmt_runs].ci   = ci;
+        fp->clmt[fp->clmt_runs].clst = clst;
+        fp->clmt_runs++;
+        fp->clmt_len++;
+}
+
+//==============================================================================
+/**
+ * @brief Cluster link map - Cut the map to selected number of clusters
+ *
+ * @param[in] *fp       File object
+ * @param[in]  len      Number of clusters that stay in the map
+ */
+//==============================================================================
+static void clmt_trim(FATFILE *fp, uint32_t len)
+{
+        if (len < fp->clmt_len) {
+                while (fp->clmt_runs && fp->clmt[fp->clmt_runs - 1].ci >= len) {
+                        fp->clmt_runs--;
+                }
+
+                fp->clmt_len = len;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Cluster link map - Release the map
+ *
+ * @param[in] *fp       File object
+ */
+//==============================================================================
+static void clmt_free(FATFILE *fp)
+{
+        if (fp->clmt) {
+                _libfat_free(fp->clmt);
+        }
+
+        fp->clmt      = NULL;
+        fp->clmt_len  = 0;
+        fp->clmt_runs = 0;
+        fp->clmt_size = 0;
+}
+
+//==============================================================================
+/**
+ * @brief Cluster link map - Find run that contains selected cluster. Cluster
+ *        must be mapped.
+ *
+ * @param[in] *fp       File object
+ * @param[in]  ci       Index of cluster in the file
+ *
+ * @return Index of run.
+ */
+//==============================================================================
+static uint clmt_find(FATFILE *fp, uint32_t ci)
+{
+        uint lo = 0, hi = fp->clmt_runs - 1;
+
+        while (lo < hi) {
+                uint mid = (lo + hi + 1) / 2;
+                if (fp->clmt[mid].ci <= ci) {
+                        lo = mid;
+                } else {
+                        hi = mid - 1;
+                }
+        }
+
+        return lo;
+}
+
+//==============================================================================
+/**
+ * @brief Cluster link map - Get cluster of selected index. Mapped clusters are
+ *        found by binary search of runs. Not mapped part of the chain is
+ *        followed (or stretched) on the FAT starting from the last mapped
+ *        cluster and is added to the map.
+ *
+ * @param[in]     *fp       File object (sclust must be valid)
+ * @param[in,out] *ci       Index of cluster in the file. When disk gets full in
+ *                          stretch mode, index of the last cluster is returned
+ * @param[in]      stretch  0: follow chain, 1: stretch chain if needed
+ * @param[out]    *clst     Cluster number
+ *
+ * @retval FR_OK
+ * @retval FR_INT_ERR
+ * @retval FR_DISK_ERR
+ */
+//==============================================================================
+static FRESULT clmt_seek(FATFILE *fp, uint32_t *ci, int stretch, uint32_t *clst)
+{
+        uint32_t n, cl;
+
+        if (*ci < fp->clmt_len) {
+                struct CLMT *run = &fp->clmt[clmt_find(fp, *ci)];
+                *clst = run->clst + (*ci - run->ci);
+                return FR_OK;
+        }
+
+        if (fp->clmt_len) {
+                struct CLMT *run = &fp->clmt[fp->clmt_runs - 1];
+                n  = fp->clmt_len - 1;
+                cl = run->clst + (n - run->ci);
+        } else {
+                n  = 0;
+                cl = fp->sclust;
+                if (cl < 2 || cl >= fp->fs->n_fatent)
+                        return FR_INT_ERR;
+
+                clmt_add(fp, 0, cl);
+        }
+
+        while (n < *ci) {
+                uint32_t next = stretch ? create_chain(fp->fs, cl) : get_fat(fp->fs, cl);
+
+                if (stretch && next == 0) {
+                        /* Disk full */
+                        *ci = n;
+                        break;
+                }
+
+                if (next == 0xFFFFFFFF)
+                        return FR_DISK_ERR;
+
+                if (next <= 1 || next >= fp->fs->n_fatent)
+                        return FR_INT_ERR;
+
+                cl = next;
+                n++;
+                clmt_add(fp, n, cl);
+        }
+
+        *clst = cl;
+        return FR_OK;
+}
+
+//==============================================================================
+/**
+ * @brief Cluster link map - Extend direct transfer over contiguous clusters.
+ *        Clusters needed by transfer are mapped (or allocated in stretch
+ *        mode) and transfer is clipped at the end of contiguous run, thus
+ *        whole transfer can be handed to the disk in one request. Current
+ *        cluster is moved to the last cluster of the transfer.
+ *
+ * @param[in]     *fp       File object (fptr at sector boundary)
+ * @param[in]      csect    Sector offset in the current cluster
+ * @param[in,out] *cc       Number of sectors to transfer
+ * @param[in]      stretch  0: follow chain, 1: stretch chain if needed
+ *
+ * @retval FR_OK
+ * @retval FR_INT_ERR
+ * @retval FR_DISK_ERR
+ */
+//==============================================================================
+static FRESULT clmt_span(FATFILE *fp, uint csect, uint *cc, int stretch)
+{
+        uint32_t bcs, ci, last, clst, n;
+        FRESULT  res;
+
+        if (csect + *cc <= fp->fs->csize)
+                return FR_OK;
+
+        bcs  = (uint32_t)fp->fs->csize * SS(fp->fs);
+        ci   = fp->fptr / bcs;
+        last = (fp->fptr + (*cc - 1) * SS(fp->fs)) / bcs;
+
+        res = clmt_seek(fp, &last, stretch, &clst);
+        if (res != FR_OK)
+                return res;
+
+        /* Number of contiguous clusters from the current one */
+        n = 1;
+        if (ci < fp->clmt_len) {
+                uint r = clmt_find(fp, ci);
+                n = ((r + 1u < fp->clmt_runs) ? fp->clmt[r + 1].ci : fp->clmt_len) - ci;
+        }
+
+        if (n > last - ci + 1)
+                n = last - ci + 1;
+
+        if (csect + *cc > n * fp->fs->csize)
+                *cc = n * fp->fs->csize - csect;
+
+        fp->clust += (csect + *cc - 1) / fp->fs->csize;
+
+        return FR_OK;
+}
+
 //==============================================================================
 /**
  * @brief Directory handling - Set directory index
@@ -2425,6 +2688,13 @@ static FRESULT chk_mounted(FATFS *fs)
                                 fs->last_clust = LOAD_UINT32(fs->win+FSI_Nxt_Free);
                                 fs->free_clust = LOAD_UINT32(fs->win+FSI_Free_Count);
                 }
+
+                /* FSInfo is only a hint, out of range values are recalculated */
+                if (fs->free_clust > fs->n_fatent - 2)
+                        fs->free_clust = 0xFFFFFFFF;
+
+                if (fs->last_clust >= fs->n_fatent)
+                        fs->last_clust = 0;
         }
 
         /* FAT sub-type */
@@ -2525,8 +2795,16 @@ FRESULT libfat_umount(FATFS *fs)
 //==============================================================================
 FRESULT libfat_sync(FATFS *fs)
 {
-        fs->fsi_flag = 1;
-        return sync_fs(fs);
+        FRESULT res;
+
+        ENTER_FF(fs);
+
+        res = sync_fsinfo(fs);
+        if (res == FR_OK) {
+                res = sync_fs(fs);
+        }
+
+        LEAVE_FF(fs, res);
 }
 
 //==============================================================================
@@ -2682,6 +2960,21 @@ FRESULT libfat_open(FATFS *fs, FATFILE *fp, const TCHAR *path, uint8_t mode)
                 fp->fptr   = 0;                                 /* File pointer */
                 fp->dsect  = 0;
 
+                /* Cluster link map is built on demand */
+                fp->clmt      = NULL;
+                fp->clmt_len  = 0;
+                fp->clmt_runs = 0;
+                fp->clmt_size = 0;
+
+                /* Own sector buffer if allowed, otherwise win[] is used */
+                fp->buf = NULL;
+                if (dj.fs->fbuf_used < dj.fs->fbuf_max) {
+                        fp->buf = _libfat_malloc(SS(dj.fs));
+                        if (fp->buf) {
+                                dj.fs->fbuf_used++;
+                        }
+                }
+
                 /* Validate file object */
                 fp->fs = dj.fs;
                 fp->id = dj.fs->id;
@@ -2749,21 +3042,12 @@ FRESULT libfat_read(FATFILE *fp, void *buff, uint btr, uint *br)
 
                         /* On the cluster boundary? */
                         if (!csect) {
-                                /* On the top of the file? */
-                                if (fp->fptr == 0) {
-                                        /* Follow from the origin */
-                                        clst = fp->sclust;
-                                } else {
-                                        /* Follow cluster chain on the FAT */
-                                        clst = get_fat(fp->fs, fp->clust);
-                                }
+                                /* Follow cluster chain (by cluster link map if mapped) */
+                                uint32_t ci = fp->fptr / ((uint32_t)fp->fs->csize * SS(fp->fs));
 
-                                if (clst < 2) {
-                                        ABORT(fp->fs, FR_INT_ERR);
-                                }
-
-                                if (clst == 0xFFFFFFFF) {
-                                        ABORT(fp->fs, FR_DISK_ERR);
+                                res = clmt_seek(fp, &ci, 0, &clst);
+                                if (res != FR_OK) {
+                                        ABORT(fp->fs, res);
                                 }
 
                                 /* Update current cluster */
@@ -2782,30 +3066,32 @@ FRESULT libfat_read(FATFILE *fp, void *buff, uint btr, uint *br)
                         cc = btr / SS(fp->fs);
                         if (cc) {
                                 /* Read maximum contiguous sectors directly */
-                                if (csect + cc > fp->fs->csize) {
-                                        /* Clip at cluster boundary */
-                                        cc = fp->fs->csize - csect;
+                                res = clmt_span(fp, csect, &cc, 0);
+                                if (res != FR_OK) {
+                                        ABORT(fp->fs, res);
                                 }
 
-                                if (_libfat_disk_read(fp->fs->srcfile, rbuff, sect, (uint8_t)cc) != RES_OK) {
+                                if (_libfat_disk_read(fp->fs->srcfile, rbuff, sect, cc) != RES_OK) {
                                         ABORT(fp->fs, FR_DISK_ERR);
                                 }
-#if _LIBFAT_FS_TINY
-                                if (fp->fs->wflag && fp->fs->winsect - sect < cc) {
-                                        memcpy(rbuff + ((fp->fs->winsect - sect) * SS(fp->fs)), fp->fs->win, SS(fp->fs));
-                                }
-#else
-                                if ((fp->flag & LIBFAT_FA__DIRTY) && fp->dsect - sect < cc) {
-                                        memcpy(rbuff + ((fp->dsect - sect) * SS(fp->fs)), fp->buf, SS(fp->fs));
+
+                                if (!fp->buf) {
+                                        if (fp->fs->wflag && fp->fs->winsect - sect < cc) {
+                                                memcpy(rbuff + ((fp->fs->winsect - sect) * SS(fp->fs)), fp->fs->win, SS(fp->fs));
+                                        }
+                                } else {
+                                        if ((fp->flag & LIBFAT_FA__DIRTY) && fp->dsect - sect < cc) {
+                                                memcpy(rbuff + ((fp->dsect - sect) * SS(fp->fs)), fp->buf, SS(fp->fs));
+                                        }
                                 }
-#endif
+
                                 /* Number of bytes transferred */
                                 rcnt = SS(fp->fs) * cc;
                                 continue;
                         }
-#if !_LIBFAT_FS_TINY
+
                         /* Load data sector if not in cache */
-                        if (fp->dsect != sect) {
+                        if (fp->buf && fp->dsect != sect) {
 
                                 /* Write-back dirty sector cache */
                                 if (fp->flag & LIBFAT_FA__DIRTY) {
@@ -2821,7 +3107,7 @@ FRESULT libfat_read(FATFILE *fp, void *buff, uint btr, uint *br)
                                         ABORT(fp->fs, FR_DISK_ERR);
                                 }
                         }
-#endif
+
                         fp->dsect = sect;
                 }
 
@@ -2829,18 +3115,19 @@ FRESULT libfat_read(FATFILE *fp, void *buff, uint btr, uint *br)
                 rcnt = SS(fp->fs) - ((uint)fp->fptr % SS(fp->fs));
                 if (rcnt > btr)
                         rcnt = btr;
-#if _LIBFAT_FS_TINY
-                /* Move sector window */
-                if (move_window(fp->fs, fp->dsect)) {
-                        ABORT(fp->fs, FR_DISK_ERR);
-                }
 
-                /* Pick partial sector */
-                memcpy(rbuff, &fp->fs->win[fp->fptr % SS(fp->fs)], rcnt);
-#else
-                /* Pick partial sector */
-                memcpy(rbuff, &fp->buf[fp->fptr % SS(fp->fs)], rcnt);
-#endif
+                if (!fp->buf) {
+                        /* Move sector window */
+                        if (move_window(fp->fs, fp->dsect)) {
+                                ABORT(fp->fs, FR_DISK_ERR);
+                        }
+
+                        /* Pick partial sector */
+                        memcpy(rbuff, &fp->fs->win[fp->fptr % SS(fp->fs)], rcnt);
+                } else {
+                        /* Pick partial sector */
+                        memcpy(rbuff, &fp->buf[fp->fptr % SS(fp->fs)], rcnt);
+                }
         }
 
         LEAVE_FF(fp->fs, FR_OK);
@@ -2909,8 +3196,19 @@ FRESULT libfat_write(FATFILE *fp, const void *buff, uint btw, uint *bw)
                                                 fp->sclust = clst = create_chain(fp->fs, 0);
                                         }
                                 } else {
-                                        /* Follow or stretch cluster chain on the FAT */
-                                        clst = create_chain(fp->fs, fp->clust);
+                                        /* Follow or stretch cluster chain (by cluster link map if mapped) */
+                                        uint32_t ci = fp->fptr / ((uint32_t)fp->fs->csize * SS(fp->fs));
+                                        uint32_t ni = ci;
+
+                                        res = clmt_seek(fp, &ci, 1, &clst);
+                                        if (res != FR_OK) {
+                                                ABORT(fp->fs, res);
+                                        }
+
+                                        if (ci != ni) {
+                                                /* Disk full */
+                                                clst = 0;
+                                        }
                                 }
 
                                 if (clst == 0) {
@@ -2929,13 +3227,12 @@ FRESULT libfat_write(FATFILE *fp, const void *buff, uint btw, uint *bw)
                                 /* Update current cluster */
                                 fp->clust = clst;
                         }
-#if _LIBFAT_FS_TINY
-                        if (fp->fs->winsect == fp->dsect && sync_window(fp->fs)) {
-                                /* Write-back sector cache */
-                                ABORT(fp->fs, FR_DISK_ERR);
-                        }
-#else
-                        if (fp->flag & LIBFAT_FA__DIRTY) {
+                        if (!fp->buf) {
+                                if (fp->fs->winsect == fp->dsect && sync_window(fp->fs)) {
+                                        /* Write-back sector cache */
+                                        ABORT(fp->fs, FR_DISK_ERR);
+                                }
+                        } else if (fp->flag & LIBFAT_FA__DIRTY) {
                                 /* Write-back sector cache */
                                 if (_libfat_disk_write(fp->fs->srcfile, fp->buf, fp->dsect, 1) != RES_OK) {
                                         ABORT(fp->fs, FR_DISK_ERR);
@@ -2943,7 +3240,7 @@ FRESULT libfat_write(FATFILE *fp, const void *buff, uint btw, uint *bw)
 
                                 fp->flag &= ~LIBFAT_FA__DIRTY;
                         }
-#endif
+
                         /* Get current sector */
                         sect = clust2sect(fp->fs, fp->clust);
                         if (!sect) {
@@ -2957,48 +3254,51 @@ FRESULT libfat_write(FATFILE *fp, const void *buff, uint btw, uint *bw)
 
                         /* Write maximum contiguous sectors directly */
                         if (cc) {
-                                /* Clip at cluster boundary */
-                                if (csect + cc > fp->fs->csize) {
-                                        cc = fp->fs->csize - csect;
+                                res = clmt_span(fp, csect, &cc, 1);
+                                if (res != FR_OK) {
+                                        ABORT(fp->fs, res);
                                 }
 
-                                if (_libfat_disk_write(fp->fs->srcfile, wbuff, sect, (uint8_t)cc) != RES_OK) {
+                                if (_libfat_disk_write(fp->fs->srcfile, wbuff, sect, cc) != RES_OK) {
                                         ABORT(fp->fs, FR_DISK_ERR);
                                 }
-#if _LIBFAT_FS_TINY
-                                /* Refill sector cache if it gets invalidated by the direct write */
-                                if (fp->fs->winsect - sect < cc) {
-                                        memcpy(fp->fs->win, wbuff + ((fp->fs->winsect - sect) * SS(fp->fs)), SS(fp->fs));
-                                        fp->fs->wflag = 0;
-                                }
-#else
+
                                 /* Refill sector cache if it gets invalidated by the direct write */
-                                if (fp->dsect - sect < cc) {
-                                        memcpy(fp->buf, wbuff + ((fp->dsect - sect) * SS(fp->fs)), SS(fp->fs));
-                                        fp->flag &= ~LIBFAT_FA__DIRTY;
+                                if (!fp->buf) {
+                                        if (fp->fs->winsect - sect < cc) {
+                                                memcpy(fp->fs->win, wbuff + ((fp->fs->winsect - sect) * SS(fp->fs)), SS(fp->fs));
+                                                fp->fs->wflag = 0;
+                                        }
+                                } else {
+                                        if (fp->dsect - sect < cc) {
+                                                memcpy(fp->buf, wbuff + ((fp->dsect - sect) * SS(fp->fs)), SS(fp->fs));
+                                                fp->flag &= ~LIBFAT_FA__DIRTY;
+                                        }
                                 }
-#endif
+
                                 /* Number of bytes transferred */
                                 wcnt = SS(fp->fs) * cc;
                                 continue;
                         }
-#if _LIBFAT_FS_TINY
-                        /* Avoid silly cache filling at growing edge */
-                        if (fp->fptr >= fp->fsize) {
-                                if (sync_window(fp->fs)) {
-                                        ABORT(fp->fs, FR_DISK_ERR);
-                                }
 
-                                fp->fs->winsect = sect;
-                        }
-#else
-                        /* Fill sector cache with file data */
-                        if (fp->dsect != sect) {
-                                if (fp->fptr < fp->fsize && _libfat_disk_read(fp->fs->srcfile, fp->buf, sect, 1) != RES_OK) {
-                                        ABORT(fp->fs, FR_DISK_ERR);
+                        if (!fp->buf) {
+                                /* Avoid silly cache filling at growing edge */
+                                if (fp->fptr >= fp->fsize) {
+                                        if (sync_window(fp->fs)) {
+                                                ABORT(fp->fs, FR_DISK_ERR);
+                                        }
+
+                                        fp->fs->winsect = sect;
+                                }
+                        } else {
+                                /* Fill sector cache with file data */
+                                if (fp->dsect != sect) {
+                                        if (fp->fptr < fp->fsize && _libfat_disk_read(fp->fs->srcfile, fp->buf, sect, 1) != RES_OK) {
+                                                ABORT(fp->fs, FR_DISK_ERR);
+                                        }
                                 }
                         }
-#endif
+
                         fp->dsect = sect;
                 }
 
@@ -3006,20 +3306,21 @@ FRESULT libfat_write(FATFILE *fp, const void *buff, uint btw, uint *bw)
                 wcnt = SS(fp->fs) - ((uint)fp->fptr % SS(fp->fs));
                 if (wcnt > btw)
                         wcnt = btw;
-#if _LIBFAT_FS_TINY
-                /* Move sector window */
-                if (move_window(fp->fs, fp->dsect)) {
-                        ABORT(fp->fs, FR_DISK_ERR);
-                }
 
-                /* Fit partial sector */
-                memcpy(&fp->fs->win[fp->fptr % SS(fp->fs)], wbuff, wcnt);
-                fp->fs->wflag = 1;
-#else
-                /* Fit partial sector */
-                memcpy(&fp->buf[fp->fptr % SS(fp->fs)], wbuff, wcnt);
-                fp->flag |= LIBFAT_FA__DIRTY;
-#endif
+                if (!fp->buf) {
+                        /* Move sector window */
+                        if (move_window(fp->fs, fp->dsect)) {
+                                ABORT(fp->fs, FR_DISK_ERR);
+                        }
+
+                        /* Fit partial sector */
+                        memcpy(&fp->fs->win[fp->fptr % SS(fp->fs)], wbuff, wcnt);
+                        fp->fs->wflag = 1;
+                } else {
+                        /* Fit partial sector */
+                        memcpy(&fp->buf[fp->fptr % SS(fp->fs)], wbuff, wcnt);
+                        fp->flag |= LIBFAT_FA__DIRTY;
+                }
         }
 
         /* Update file size if needed */
@@ -3055,15 +3356,15 @@ FRESULT libfat_flush(FATFILE *fp)
         if (res == FR_OK) {
                 /* Has the file been written? */
                 if (fp->flag & LIBFAT_FA__WRITTEN) {
-#if !_LIBFAT_FS_TINY        /* Write-back dirty buffer */
-                        if (fp->flag & LIBFAT_FA__DIRTY) {
+                        /* Write-back dirty buffer */
+                        if (fp->buf && (fp->flag & LIBFAT_FA__DIRTY)) {
                                 if (_libfat_disk_write(fp->fs->srcfile, fp->buf, fp->dsect, 1) != RES_OK) {
                                         LEAVE_FF(fp->fs, FR_DISK_ERR);
                                 }
 
                                 fp->flag &= ~LIBFAT_FA__DIRTY;
                         }
-#endif
+
                         /* Update the directory entry */
                         res = move_window(fp->fs, fp->dir_sect);
                         if (res == FR_OK) {
@@ -3110,17 +3411,29 @@ FRESULT libfat_close(FATFILE *fp)
 
         /* Flush cached data */
         res = libfat_flush(fp);
-#if _LIBFAT_FS_LOCK
-        /* Decrement open counter */
         if (res == FR_OK) {
-                FATFS *fs = fp->fs;;
+                FATFS *fs = fp->fs;
                 res = validate(fp);
                 if (res == FR_OK) {
-                        res = dec_lock(fp->fs, fp->lockid);
+#if _LIBFAT_FS_LOCK
+                        /* Decrement open counter */
+                        res = dec_lock(fs, fp->lockid);
+#endif
+                        /* Release sector buffer and its slot under the same lock,
+                         * if the volume cannot be locked the file stays open */
+                        if (res == FR_OK && fp->buf) {
+                                fs->fbuf_used--;
+                                _libfat_free(fp->buf);
+                                fp->buf = NULL;
+                        }
+
                         unlock_fs(fs, FR_OK);
                 }
         }
-#endif
+
+        /* Release cluster link map (it is rebuilt on demand if file stays open) */
+        clmt_free(fp);
+
         if (res == FR_OK) {
                 /* Discard file object */
                 fp->fs = 0;
@@ -3155,78 +3468,54 @@ FRESULT libfat_lseek(FATFILE *fp, uint32_t ofs)
                 LEAVE_FF(fp->fs, FR_INT_ERR);
         }
 
-        uint32_t clst, bcs, nsect, ifptr;
+        uint32_t clst, bcs, nsect, ci;
 
         /* In read-only mode, clip offset with the file size */
         if (ofs > fp->fsize  && !(fp->flag & LIBFAT_FA_WRITE)) {
                 ofs = fp->fsize;
         }
 
-        ifptr = fp->fptr;
         fp->fptr = nsect = 0;
         if (ofs) {
                 /* Cluster size (byte) */
                 bcs = (uint32_t)fp->fs->csize * SS(fp->fs);
 
-                /* When seek to same or following cluster, */
-                if (ifptr > 0 && (ofs - 1) / bcs >= (ifptr - 1) / bcs) {
-                        /* start from the current cluster */
-                        fp->fptr = (ifptr - 1) & ~(bcs - 1);
-                        ofs -= fp->fptr;
-                        clst = fp->clust;
-                } else {
-                        /* start from the first cluster */
-                        clst = fp->sclust;
-
-                        /* If no cluster chain, create a new chain */
-                        if (clst == 0) {
-                                clst = create_chain(fp->fs, 0);
-                                if (clst == 1) {
-                                        ABORT(fp->fs, FR_INT_ERR);
-                                }
+                clst = fp->sclust;
 
-                                if (clst == 0xFFFFFFFF) {
-                                        ABORT(fp->fs, FR_DISK_ERR);
-                                }
+                /* If no cluster chain, create a new chain */
+                if (clst == 0) {
+                        clst = create_chain(fp->fs, 0);
+                        if (clst == 1) {
+                                ABORT(fp->fs, FR_INT_ERR);
+                        }
 
-                                fp->sclust = clst;
+                        if (clst == 0xFFFFFFFF) {
+                                ABORT(fp->fs, FR_DISK_ERR);
                         }
 
-                        fp->clust = clst;
+                        fp->sclust = clst;
+                        fp->clust  = clst;
                 }
 
                 if (clst != 0) {
-                        /* Cluster following loop */
-                        while (ofs > bcs) {
-
-                                /* Check if in write mode or not */
-                                if (fp->flag & LIBFAT_FA_WRITE) {
-                                        /* Force stretch if in write mode */
-                                        clst = create_chain(fp->fs, clst);
-                                        if (clst == 0) {
-                                                /* When disk gets full, clip file size */
-                                                ofs = bcs;
-                                                break;
-                                        }
-                                } else {
-                                        /* Follow cluster chain if not in write mode */
-                                        clst = get_fat(fp->fs, clst);
-                                }
-
-                                if (clst == 0xFFFFFFFF) {
-                                        ABORT(fp->fs, FR_DISK_ERR);
-                                }
-
-                                if (clst <= 1 || clst >= fp->fs->n_fatent) {
-                                        ABORT(fp->fs, FR_INT_ERR);
-                                }
+                        /* Get cluster of the offset by cluster link map, force
+                         * stretch if in write mode */
+                        ci  = (ofs - 1) / bcs;
+                        res = clmt_seek(fp, &ci, fp->flag & LIBFAT_FA_WRITE, &clst);
+                        if (res != FR_OK) {
+                                ABORT(fp->fs, res);
+                        }
 
-                                fp->clust = clst;
-                                fp->fptr += bcs;
-                                ofs      -= bcs;
+                        if ((ofs - 1) / bcs != ci) {
+                                /* When disk gets full, clip file size */
+                                ofs = (ci + 1) * bcs;
                         }
 
-                        fp->fptr += ofs;
+                        fp->clust = clst;
+                        fp->fptr  = ofs;
+
+                        /* Offset in the cluster */
+                        ofs -= ci * bcs;
                         if (ofs % SS(fp->fs)) {
                                 /* Current sector */
                                 nsect = clust2sect(fp->fs, clst);
@@ -3242,22 +3531,22 @@ FRESULT libfat_lseek(FATFILE *fp, uint32_t ofs)
 
         /* Fill sector cache if needed */
         if (fp->fptr % SS(fp->fs) && nsect != fp->dsect) {
-#if !_LIBFAT_FS_TINY
+                if (fp->buf) {
+                        /* Write-back dirty sector cache */
+                        if (fp->flag & LIBFAT_FA__DIRTY) {
+                                if (_libfat_disk_write(fp->fs->srcfile, fp->buf, fp->dsect, 1) != RES_OK) {
+                                        ABORT(fp->fs, FR_DISK_ERR);
+                                }
 
-                /* Write-back dirty sector cache */
-                if (fp->flag & LIBFAT_FA__DIRTY) {
-                        if (_libfat_disk_write(fp->fs->srcfile, fp->buf, fp->dsect, 1) != RES_OK) {
-                                ABORT(fp->fs, FR_DISK_ERR);
+                                fp->flag &= ~LIBFAT_FA__DIRTY;
                         }
 
-                        fp->flag &= ~LIBFAT_FA__DIRTY;
+                        /* Fill sector cache */
+                        if (_libfat_disk_read(fp->fs->srcfile, fp->buf, nsect, 1) != RES_OK) {
+                                ABORT(fp->fs, FR_DISK_ERR);
+                        }
                 }
 
-                /* Fill sector cache */
-                if (_libfat_disk_read(fp->fs->srcfile, fp->buf, nsect, 1) != RES_OK) {
-                        ABORT(fp->fs, FR_DISK_ERR);
-                }
-#endif
                 fp->dsect = nsect;
         }
 
@@ -3555,7 +3844,11 @@ FRESULT libfat_truncate(FATFILE *fp)
                                 /* When set file size to zero, remove entire cluster chain */
                                 res = remove_chain(fp->fs, fp->sclust);
                                 fp->sclust = 0;
+                                clmt_trim(fp, 0);
                         } else {
+                                /* Removed clusters are dropped from the cluster link map */
+                                clmt_trim(fp, (fp->fptr - 1) / ((uint32_t)fp->fs->csize * SS(fp->fs)) + 1);
+
                                 /* When truncate a part of the file, remove remaining clusters */
                                 ncl = get_fat(fp->fs, fp->clust);
                                 res = FR_OK;
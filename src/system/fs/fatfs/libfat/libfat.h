@@ -133,7 +133,9 @@ typedef struct FATFS {
         uint32_t        dirbase;                /* Root directory start sector (FAT32:Cluster#) */
         uint32_t        database;               /* Data start sector */
         uint32_t        winsect;                /* Current sector appearing in the win[] */
-        uint8_t         win[_LIBFAT_MAX_SS];    /* Disk access window for Directory, FAT (and Data on tiny cfg) */
+        uint16_t        fbuf_max;               /* Max number of files with own sector buffer (0:all files use win[]) */
+        uint16_t        fbuf_used;              /* Number of files with own sector buffer */
+        uint8_t         win[_LIBFAT_MAX_SS];    /* Disk access window for Directory, FAT (and Data of files without buffer) */
         /* File access control feature */
 #if _LIBFAT_FS_LOCK
         struct FILESEM {
@@ -160,12 +162,17 @@ typedef struct {
         uint32_t        dsect;                  /* Current data sector of fpter */
         uint32_t        dir_sect;               /* Sector containing the directory entry */
         uint8_t        *dir_ptr;                /* Pointer to the directory entry in the window */
+        struct CLMT {
+                uint32_t        ci;             /* Index of the first cluster of run in the file */
+                uint32_t        clst;           /* First cluster of run */
+        }              *clmt;                   /* Cluster link map table (runs of contiguous clusters, NULL:no map) */
+        uint32_t        clmt_len;               /* Number of mapped clusters of the file */
+        uint16_t        clmt_runs;              /* Number of used runs */
+        uint16_t        clmt_size;              /* Number of allocated runs */
 #if _LIBFAT_FS_LOCK
         uint            lockid;                 /* File lock ID (index of file semaphore table Files[]) */
 #endif
-#if !_FS_TINY
-        uint8_t         buf[_LIBFAT_MAX_SS];    /* File data read/write buffer */
-#endif
+        uint8_t        *buf;                    /* File data read/write buffer (NULL:win[] of file system is used) */
 } FATFILE;
 
 
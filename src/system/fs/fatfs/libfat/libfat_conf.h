@@ -33,11 +33,11 @@
  * Functions and Buffer Configurations
  * ---------------------------------------------------------------------------*/
 
-/* When _LIBFAT_FS_TINY is set to 1, libfat uses the sector buffer in the file system
- * object instead of the sector buffer in the individual file object for file
- * data transfer. This reduces memory consumption 512 bytes each file object.
+/* Sector buffer of the individual file object is allocated at file open when
+ * FATFS.fbuf_max is not reached (set at mount). Files without own buffer use
+ * the sector buffer in the file system object for file data transfer. Each
+ * buffer costs one sector (SS) of memory.
  */
-#define _LIBFAT_FS_TINY         1       /* 0:Normal or 1:Tiny */
 
 
 /*------------------------------------------------------------------------------
@@ -78,7 +78,7 @@
  * @retval RES_ERROR read error
  */
 //==============================================================================
-DRESULT _libfat_disk_read(FILE *srcfile, uint8_t *buff, uint32_t sector, uint8_t count)
+DRESULT _libfat_disk_read(FILE *srcfile, uint8_t *buff, uint32_t sector, uint count)
 {
         return sys_cache_read(srcfile, sector, _LIBFAT_MAX_SS, count, buff) == ESUCC ?
                RES_OK : RES_ERROR;
@@ -97,7 +97,7 @@ DRESULT _libfat_disk_read(FILE *srcfile, uint8_t *buff, uint32_t sector, uint8_t
  * @retval RES_ERROR write error
  */
 //==============================================================================
-DRESULT _libfat_disk_write(FILE *srcfile, const uint8_t *buff, uint32_t sector, uint8_t count)
+DRESULT _libfat_disk_write(FILE *srcfile, const uint8_t *buff, uint32_t sector, uint count)
 {
         return sys_cache_write(srcfile, sector, _LIBFAT_MAX_SS, count, buff, CACHE_WRITE_BACK) == ESUCC ?
                RES_OK : RES_ERROR;
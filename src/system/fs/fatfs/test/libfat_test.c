@@ -0,0 +1,354 @@
+/*=========================================================================*//**
+File     libfat_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test and benchmark of FAT library on RAM disk image.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * FAT32 volume (one sector per cluster) is created in RAM. Two files are
+ * written interleaved so clusters of each file are fragmented. Test checks
+ * data read at random positions and sequentially, truncate and the FSInfo
+ * free cluster count after remount. Test is run with files that share volume
+ * window and with files that use own sector buffer. Number of disk requests
+ * and time of sequential read are printed.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <string.h>
+#include "../libfat/libfat.h"
+#include "../libfat/libfat_user.h"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define SECTORS                 80000
+#define SECTOR_SIZE             512
+#define RSVD_SECTORS            32
+#define FAT_SIZE                ((SECTORS / 128) + 1)
+#define FILE_SIZE               (4 * 1024 * 1024)
+#define CHUNK                   1024
+#define RANDOM_READS            5000
+#define TRUNC_SIZE              100000
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static uint8_t *img;
+
+static struct {
+        u32_t rd_req;
+        u32_t rd_sect;
+        u32_t wr_req;
+        u32_t wr_sect;
+} disk;
+
+static uint8_t buf[65536];
+
+/*==============================================================================
+  Disk and system services
+==============================================================================*/
+DRESULT _libfat_disk_read(FILE *srcfile, uint8_t *buff, uint32_t sector, uint count)
+{
+        if (sector + count > SECTORS) {
+                return RES_ERROR;
+        }
+
+        memcpy(buff, img + (sector * SECTOR_SIZE), count * SECTOR_SIZE);
+        disk.rd_req++;
+        disk.rd_sect += count;
+        return RES_OK;
+}
+
+DRESULT _libfat_disk_write(FILE *srcfile, const uint8_t *buff, uint32_t sector, uint count)
+{
+        if (sector + count > SECTORS) {
+                return RES_ERROR;
+        }
+
+        memcpy(img + (sector * SECTOR_SIZE), buff, count * SECTOR_SIZE);
+        disk.wr_req++;
+        disk.wr_sect += count;
+        return RES_OK;
+}
+
+DRESULT _libfat_disk_ioctl(FILE *srcfile, uint8_t cmd, void *buff)
+{
+        return RES_OK;
+}
+
+int _libfat_create_mutex(_LIBFAT_MUTEX_t *sobj)
+{
+        static int mtx;
+        *sobj = (mutex_t*)&mtx;
+        return 1;
+}
+
+int _libfat_lock_access(_LIBFAT_MUTEX_t sobj)
+{
+        return 1;
+}
+
+void _libfat_unlock_access(_LIBFAT_MUTEX_t sobj)
+{
+}
+
+int _libfat_delete_mutex(_LIBFAT_MUTEX_t sobj)
+{
+        return 1;
+}
+
+uint32_t _libfat_get_fattime(void)
+{
+        return 0;
+}
+
+void *_libfat_malloc(uint size)
+{
+        return ht_malloc(size);
+}
+
+void _libfat_free(void *mem)
+{
+        ht_free(mem);
+}
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Store little endian values.
+ */
+//==============================================================================
+static void put16(uint8_t *p, uint16_t val)
+{
+        p[0] = val;
+        p[1] = val >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t val)
+{
+        put16(p, val);
+        put16(p + 2, val >> 16);
+}
+
+//==============================================================================
+/**
+ * @brief  Create empty FAT32 volume.
+ */
+//==============================================================================
+static void make_volume(void)
+{
+        memset(img, 0, SECTORS * SECTOR_SIZE);
+
+        uint8_t *bs = img;
+        bs[0] = 0xEB; bs[1] = 0x58; bs[2] = 0x90;
+        memcpy(&bs[3], "MSDOS5.0", 8);
+        put16(&bs[11], SECTOR_SIZE);
+        bs[13] = 1;                             // sectors per cluster
+        put16(&bs[14], RSVD_SECTORS);
+        bs[16] = 2;                             // number of FATs
+        bs[21] = 0xF8;                          // media
+        put32(&bs[32], SECTORS);
+        put32(&bs[36], FAT_SIZE);
+        put32(&bs[44], 2);                      // root directory cluster
+        put16(&bs[48], 1);                      // FSInfo sector
+        put16(&bs[50], 6);                      // backup boot sector
+        bs[66] = 0x29;
+        memcpy(&bs[82], "FAT32   ", 8);
+        put16(&bs[510], 0xAA55);
+
+        uint8_t *fsi = img + SECTOR_SIZE;
+        put32(&fsi[0], 0x41615252);
+        put32(&fsi[484], 0x61417272);
+        put32(&fsi[488], 0xFFFFFFFF);           // free count unknown
+        put32(&fsi[492], 2);
+        put16(&fsi[510], 0xAA55);
+
+        for (int i = 0; i < 2; i++) {
+                uint8_t *fat = img + ((RSVD_SECTORS + i * FAT_SIZE) * SECTOR_SIZE);
+                put32(&fat[0], 0x0FFFFFF8);
+                put32(&fat[4], 0x0FFFFFFF);
+                put32(&fat[8], 0x0FFFFFFF);     // root directory
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  File content pattern.
+ */
+//==============================================================================
+static uint8_t pattern(uint32_t pos)
+{
+        return (pos * 7) ^ (pos >> 11);
+}
+
+//==============================================================================
+/**
+ * @brief  Check file content.
+ */
+//==============================================================================
+static void check_data(const uint8_t *data, uint32_t pos, uint len)
+{
+        for (uint i = 0; i < len; i++) {
+                HT_CHECK(data[i] == pattern(pos + i));
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Test scenario.
+ *
+ * @param  fbuf_max     number of files with own sector buffer
+ */
+//==============================================================================
+static void test(uint16_t fbuf_max)
+{
+        static FATFS   fs;
+        static FATFILE a, b;
+        uint           n;
+
+        make_volume();
+        fs = (FATFS){.fbuf_max = fbuf_max};
+        HT_CHECK_OK(libfat_mount(NULL, &fs));
+
+        // interleaved writes, files are fragmented
+        HT_CHECK_OK(libfat_open(&fs, &a, "/a.bin", LIBFAT_FA_WRITE | LIBFAT_FA_READ | LIBFAT_FA_CREATE_ALWAYS));
+        HT_CHECK_OK(libfat_open(&fs, &b, "/b.bin", LIBFAT_FA_WRITE | LIBFAT_FA_READ | LIBFAT_FA_CREATE_ALWAYS));
+        HT_CHECK((a.buf != NULL) == (fbuf_max >= 1));
+        HT_CHECK((b.buf != NULL) == (fbuf_max >= 2));
+
+        for (uint32_t pos = 0; pos < FILE_SIZE; pos += CHUNK) {
+                for (int i = 0; i < CHUNK; i++) {
+                        buf[i] = pattern(pos + i);
+                }
+
+                HT_CHECK_OK(libfat_write(&a, buf, CHUNK, &n));
+                HT_CHECK(n == CHUNK);
+
+                if ((pos / CHUNK) % 3 == 0) {
+                        HT_CHECK_OK(libfat_write(&b, buf, CHUNK / 2, &n));
+                        HT_CHECK(n == CHUNK / 2);
+                }
+        }
+
+        HT_CHECK(libfat_size(&a) == FILE_SIZE);
+        HT_CHECK(a.clmt_runs > 1);
+
+        // random reads
+        ht_srand(1);
+        for (int i = 0; i < RANDOM_READS; i++) {
+                uint32_t pos = ht_rand() % (FILE_SIZE - 600);
+                uint     len = 1 + ht_rand() % 600;
+
+                HT_CHECK_OK(libfat_lseek(&a, pos));
+                HT_CHECK_OK(libfat_read(&a, buf, len, &n));
+                HT_CHECK(n == len);
+                check_data(buf, pos, len);
+        }
+
+        // sequential read
+        disk.rd_req  = 0;
+        disk.rd_sect = 0;
+        unsigned long long t = ht_clock_us();
+
+        HT_CHECK_OK(libfat_lseek(&a, 0));
+        for (uint32_t pos = 0; pos < FILE_SIZE; pos += sizeof(buf)) {
+                HT_CHECK_OK(libfat_read(&a, buf, sizeof(buf), &n));
+                HT_CHECK(n == sizeof(buf));
+                check_data(buf, pos, n);
+        }
+
+        t = ht_clock_us() - t;
+        HT_CHECK(disk.rd_sect >= FILE_SIZE / SECTOR_SIZE);
+        HT_CHECK(disk.rd_req * 2 < disk.rd_sect);
+
+        ht_print("libfat: fbuf=%u runs=%u sequential read %u requests, %u sectors, %llu us\n",
+                 fbuf_max, a.clmt_runs, disk.rd_req, disk.rd_sect, t);
+
+        // truncate and seek behind end of file
+        HT_CHECK_OK(libfat_lseek(&a, TRUNC_SIZE));
+        HT_CHECK_OK(libfat_truncate(&a));
+        HT_CHECK(libfat_size(&a) == TRUNC_SIZE);
+        HT_CHECK(a.clmt_len <= (TRUNC_SIZE + SECTOR_SIZE - 1) / SECTOR_SIZE);
+
+        HT_CHECK_OK(libfat_lseek(&a, TRUNC_SIZE * 3));
+        HT_CHECK_OK(libfat_lseek(&a, 50));
+        HT_CHECK_OK(libfat_read(&a, buf, 10, &n));
+        HT_CHECK(n == 10);
+        check_data(buf, 50, 10);
+
+        HT_CHECK_OK(libfat_close(&a));
+        HT_CHECK_OK(libfat_close(&b));
+        HT_CHECK(fs.fbuf_used == 0);
+
+        // read only access does not write FSInfo
+        u32_t wr = disk.wr_req;
+        HT_CHECK_OK(libfat_open(&fs, &a, "/a.bin", LIBFAT_FA_READ | LIBFAT_FA_OPEN_EXISTING));
+        HT_CHECK(libfat_size(&a) == TRUNC_SIZE * 3);
+        HT_CHECK_OK(libfat_close(&a));
+        HT_CHECK(disk.wr_req == wr);
+
+        // FSInfo is written at unmount
+        uint32_t free_clst;
+        HT_CHECK_OK(libfat_getfree(&fs, &free_clst));
+        HT_CHECK_OK(libfat_umount(&fs));
+
+        uint32_t fsi_free;
+        memcpy(&fsi_free, img + SECTOR_SIZE + 488, sizeof(fsi_free));
+        HT_CHECK(fsi_free == free_clst);
+
+        fs = (FATFS){.fbuf_max = fbuf_max};
+        HT_CHECK_OK(libfat_mount(NULL, &fs));
+        HT_CHECK_OK(libfat_getfree(&fs, &fsi_free));
+        HT_CHECK(fsi_free == free_clst);
+        HT_CHECK_OK(libfat_umount(&fs));
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        img = ht_malloc(SECTORS * SECTOR_SIZE);
+
+        test(0);
+        test(2);
+
+        ht_free(img);
+
+        ht_print("libfat: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
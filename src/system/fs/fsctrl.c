@@ -93,11 +93,13 @@ int _mount(const char            *FS_name,
                                                  &_FS_table[i].FS_if, opts);
 
                                 if (!err) {
-                                        printk("Filesystem '%s' mounted in %s",
-                                               FS_name, mount_point->PATH);
+                                        printk_log(_PRINTK_LEVEL_INFO, _PRINTK_SUBSYS_FS,
+                                                   "Filesystem '%s' mounted in %s",
+                                                   FS_name, mount_point->PATH);
                                 } else {
-                                        printk("Filesystem '%s' mount error (%d)",
-                                               FS_name, err);
+                                        printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_FS,
+                                                   "Filesystem '%s' mount error (%d)",
+                                                   FS_name, err);
                                 }
 
                                 break;
@@ -105,7 +107,7 @@ int _mount(const char            *FS_name,
                 }
 
                 if (err == ENOENT) {
-                        printk("Filesystem '%s' does not exist", FS_name);
+                        printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_FS, "Filesystem '%s' does not exist", FS_name);
                 }
         }
 
@@ -127,9 +129,9 @@ int _umount(const struct vfs_path *mount_point)
                 int err = _vfs_umount(mount_point);
 
                 if (err) {
-                        printk("Filesystem at '%s' unmount fail (%d)", mount_point->PATH, err);
+                        printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_FS, "Filesystem at '%s' unmount fail (%d)", mount_point->PATH, err);
                 } else {
-                        printk("Filesystem at '%s' unmounted", mount_point->PATH);
+                        printk_log(_PRINTK_LEVEL_INFO, _PRINTK_SUBSYS_FS, "Filesystem at '%s' unmounted", mount_point->PATH);
                 }
 
                 return err;
@@ -31,22 +31,32 @@
 ==============================================================================*/
 #include "config.h"
 #include <sys/types.h>
+#include <string.h>
 #include "dnx/misc.h"
 #include "libc/errno.h"
 #include "kernel/kwrapper.h"
+#include "kernel/kpoll.h"
 #include "fs/pipe.h"
 
 /*==============================================================================
   Local macros
 ==============================================================================*/
+#define PIPE_LENGTH             __OS_PIPE_LENGTH__
 
 /*==============================================================================
   Local object types
 ==============================================================================*/
 struct pipe {
-        queue_t     *queue;
-        struct pipe *self;
-        bool         closed;
+        struct pipe *self;              //!< object validation
+        mutex_t     *mtx;               //!< buffer access protection
+        sem_t       *rd_sem;            //!< signaled when data is available or pipe closed
+        sem_t       *wr_sem;            //!< signaled when space is available or pipe closed
+        size_t       head;              //!< write index
+        size_t       tail;              //!< read index
+        size_t       count;             //!< number of bytes in buffer
+        bool         closed;            //!< pipe closed (EOF)
+        _poll_list_t poll;              //!< poll() waiters
+        u8_t         buf[PIPE_LENGTH];  //!< ring buffer
 };
 
 /*==============================================================================
@@ -58,6 +68,7 @@ struct pipe {
 ==============================================================================*/
 static const u32_t PIPE_READ_TIMEOUT  = MAX_DELAY_MS;
 static const u32_t PIPE_WRITE_TIMEOUT = MAX_DELAY_MS;
+static const u32_t PIPE_MTX_TIMEOUT   = MAX_DELAY_MS;
 
 /*==============================================================================
   Exported objects
@@ -83,6 +94,58 @@ static bool is_valid(pipe_t *this)
         return this && this->self == this;
 }
 
+//==============================================================================
+/**
+ * @brief  Copy data from ring buffer. Data is copied in at most two chunks.
+ *         Function must be called when buffer is locked.
+ *
+ * @param  pipe         pipe object
+ * @param  dst          destination buffer
+ * @param  count        max number of bytes to read
+ *
+ * @return Number of read bytes.
+ */
+//==============================================================================
+static size_t ring_read(pipe_t *pipe, u8_t *dst, size_t count)
+{
+        size_t n = min(count, pipe->count);
+
+        size_t chunk = min(n, PIPE_LENGTH - pipe->tail);
+        memcpy(dst, &pipe->buf[pipe->tail], chunk);
+        memcpy(dst + chunk, &pipe->buf[0], n - chunk);
+
+        pipe->tail   = (pipe->tail + n) % PIPE_LENGTH;
+        pipe->count -= n;
+
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief  Copy data to ring buffer. Data is copied in at most two chunks.
+ *         Function must be called when buffer is locked.
+ *
+ * @param  pipe         pipe object
+ * @param  src          source buffer
+ * @param  count        max number of bytes to write
+ *
+ * @return Number of written bytes.
+ */
+//==============================================================================
+static size_t ring_write(pipe_t *pipe, const u8_t *src, size_t count)
+{
+        size_t n = min(count, PIPE_LENGTH - pipe->count);
+
+        size_t chunk = min(n, PIPE_LENGTH - pipe->head);
+        memcpy(&pipe->buf[pipe->head], src, chunk);
+        memcpy(&pipe->buf[0], src + chunk, n - chunk);
+
+        pipe->head   = (pipe->head + n) % PIPE_LENGTH;
+        pipe->count += n;
+
+        return n;
+}
+
 //==============================================================================
 /**
  * @brief Create pipe object
@@ -97,14 +160,31 @@ int _pipe_create(pipe_t **pipe)
         int err = EINVAL;
 
         if (pipe) {
-                err = _kmalloc(_MM_KRN, sizeof(pipe_t), cast(void**, pipe));
+                err = _kzalloc(_MM_KRN, sizeof(pipe_t), cast(void**, pipe));
                 if (err == ESUCC) {
+                        pipe_t *p = *pipe;
+
+                        err = _mutex_create(MUTEX_TYPE_NORMAL, &p->mtx);
+
+                        if (err == ESUCC) {
+                                err = _semaphore_create(1, 0, &p->rd_sem);
+                        }
 
-                        err = _queue_create(__OS_PIPE_LENGTH__, sizeof(u8_t), &(*pipe)->queue);
                         if (err == ESUCC) {
-                                (*pipe)->self   = *pipe;
-                                (*pipe)->closed = false;
+                                err = _semaphore_create(1, 0, &p->wr_sem);
+                        }
+
+                        if (err == ESUCC) {
+                                p->self = p;
                         } else {
+                                if (p->rd_sem) {
+                                        _semaphore_destroy(p->rd_sem);
+                                }
+
+                                if (p->mtx) {
+                                        _mutex_destroy(p->mtx);
+                                }
+
                                 _kfree(_MM_KRN, cast(void**, pipe));
                         }
                 }
@@ -125,7 +205,10 @@ int _pipe_create(pipe_t **pipe)
 int _pipe_destroy(pipe_t *pipe)
 {
         if (is_valid(pipe)) {
-                _queue_destroy(pipe->queue);
+                _poll_list_release(&pipe->poll);
+                _semaphore_destroy(pipe->wr_sem);
+                _semaphore_destroy(pipe->rd_sem);
+                _mutex_destroy(pipe->mtx);
                 pipe->self = NULL;
                 _kfree(_MM_KRN, cast(void**, &pipe));
                 return ESUCC;
@@ -147,7 +230,8 @@ int _pipe_destroy(pipe_t *pipe)
 int _pipe_get_length(pipe_t *pipe, size_t *len)
 {
         if (len && is_valid(pipe)) {
-                return _queue_get_number_of_items(pipe->queue, len);
+                *len = pipe->count;
+                return ESUCC;
         } else {
                 return EINVAL;
         }
@@ -155,7 +239,9 @@ int _pipe_get_length(pipe_t *pipe, size_t *len)
 
 //==============================================================================
 /**
- * @brief Read data from pipe
+ * @brief Read data from pipe. Function waits for at least one byte and returns
+ *        all data that is available in pipe (partial read). If pipe is closed
+ *        and empty then 0 bytes are read (EOF).
  *
  * @param pipe          a pipe object
  * @param buf           a destination buffer
@@ -168,22 +254,38 @@ int _pipe_get_length(pipe_t *pipe, size_t *len)
 //==============================================================================
 int _pipe_read(pipe_t *pipe, u8_t *buf, size_t count, size_t *rdcnt, bool non_blocking)
 {
-        if (is_valid(pipe) && buf && count) {
+        if (is_valid(pipe) && buf && count && rdcnt) {
 
                 size_t n = 0;
-                for (; n < count; n++) {
 
-                        size_t noitm = 0;
-                        _queue_get_number_of_items(pipe->queue, &noitm);
+                for (;;) {
+                        int err = _mutex_lock(pipe->mtx, PIPE_MTX_TIMEOUT);
+                        if (err) {
+                                return err;
+                        }
+
+                        n = ring_read(pipe, buf, count);
+
+                        bool data   = pipe->count > 0;
+                        bool closed = pipe->closed;
 
-                        if (pipe->closed && noitm == 0) {
-                                u8_t null = '\0';
-                                _queue_send(pipe->queue, &null, PIPE_WRITE_TIMEOUT);
+                        _mutex_unlock(pipe->mtx);
+
+                        if (n > 0) {
+                                _semaphore_signal(pipe->wr_sem);
+                                _poll_notify(&pipe->poll, pipe);
+                        }
+
+                        // wake up next reader if data left or pipe is closed
+                        if (data || closed) {
+                                _semaphore_signal(pipe->rd_sem);
+                        }
+
+                        if (n > 0 || closed || non_blocking) {
                                 break;
                         }
 
-                        u32_t tout = non_blocking || n ? 10 : PIPE_READ_TIMEOUT;
-                        if (_queue_receive(pipe->queue, &buf[n], tout) != ESUCC) {
+                        if (_semaphore_wait(pipe->rd_sem, PIPE_READ_TIMEOUT) != ESUCC) {
                                 break;
                         }
                 }
@@ -197,7 +299,8 @@ int _pipe_read(pipe_t *pipe, u8_t *buf, size_t count, size_t *rdcnt, bool non_bl
 
 //==============================================================================
 /**
- * @brief Read data from pipe
+ * @brief Write data to pipe. Function waits until all data is written, pipe is
+ *        closed, or (in non-blocking mode) pipe is full.
  *
  * @param pipe          a pipe object
  * @param buf           a destination buffer
@@ -210,20 +313,39 @@ int _pipe_read(pipe_t *pipe, u8_t *buf, size_t count, size_t *rdcnt, bool non_bl
 //==============================================================================
 int _pipe_write(pipe_t *pipe, const u8_t *buf, size_t count, size_t *wrcnt, bool non_blocking)
 {
-        if (is_valid(pipe) && buf && count) {
+        if (is_valid(pipe) && buf && count && wrcnt) {
 
                 size_t n = 0;
-                for (; n < count; n++) {
 
-                        size_t noitm = 0;
-                        _queue_get_number_of_items(pipe->queue, &noitm);
+                while (n < count) {
+                        int err = _mutex_lock(pipe->mtx, PIPE_MTX_TIMEOUT);
+                        if (err) {
+                                return err;
+                        }
+
+                        bool closed = pipe->closed;
+                        size_t wr   = closed ? 0 : ring_write(pipe, buf + n, count - n);
+                        bool space  = pipe->count < PIPE_LENGTH;
+
+                        _mutex_unlock(pipe->mtx);
+
+                        if (wr > 0) {
+                                _semaphore_signal(pipe->rd_sem);
+                                _poll_notify(&pipe->poll, pipe);
+                        }
 
-                        if (pipe->closed && noitm == 0) {
+                        // wake up next writer if space left or pipe is closed
+                        if (space || closed) {
+                                _semaphore_signal(pipe->wr_sem);
+                        }
+
+                        n += wr;
+
+                        if (closed || non_blocking || n == count) {
                                 break;
                         }
 
-                        u32_t tout = non_blocking ? 10 : PIPE_WRITE_TIMEOUT;
-                        if (_queue_send(pipe->queue, &buf[n], tout) != ESUCC) {
+                        if (_semaphore_wait(pipe->wr_sem, PIPE_WRITE_TIMEOUT) != ESUCC) {
                                 break;
                         }
                 }
@@ -237,7 +359,8 @@ int _pipe_write(pipe_t *pipe, const u8_t *buf, size_t count, size_t *wrcnt, bool
 
 //==============================================================================
 /**
- * @brief Close pipe
+ * @brief Close pipe. Readers read remaining data and then EOF. Writers stop
+ *        writing.
  *
  * @param pipe          a pipe object
  *
@@ -247,10 +370,17 @@ int _pipe_write(pipe_t *pipe, const u8_t *buf, size_t count, size_t *wrcnt, bool
 int _pipe_close(pipe_t *pipe)
 {
         if (is_valid(pipe)) {
-                pipe->closed = true;
+                int err = _mutex_lock(pipe->mtx, PIPE_MTX_TIMEOUT);
+                if (!err) {
+                        pipe->closed = true;
+                        _mutex_unlock(pipe->mtx);
+
+                        _semaphore_signal(pipe->rd_sem);
+                        _semaphore_signal(pipe->wr_sem);
+                        _poll_notify(&pipe->poll, pipe);
+                }
 
-                const u8_t nul = '\0';
-                return _queue_send(pipe->queue, &nul, PIPE_WRITE_TIMEOUT);
+                return err;
         } else {
                 return EINVAL;
         }
@@ -258,7 +388,7 @@ int _pipe_close(pipe_t *pipe)
 
 //==============================================================================
 /**
- * @brief  Clear pipe
+ * @brief  Clear pipe. Buffered data is dropped.
  *
  * @param  pipe         a pipe object
  *
@@ -268,7 +398,53 @@ int _pipe_close(pipe_t *pipe)
 int _pipe_clear(pipe_t *pipe)
 {
         if (is_valid(pipe)) {
-                return _queue_reset(pipe->queue);
+                int err = _mutex_lock(pipe->mtx, PIPE_MTX_TIMEOUT);
+                if (!err) {
+                        pipe->head  = 0;
+                        pipe->tail  = 0;
+                        pipe->count = 0;
+                        _mutex_unlock(pipe->mtx);
+
+                        _semaphore_signal(pipe->wr_sem);
+                        _poll_notify(&pipe->poll, pipe);
+                }
+
+                return err;
+        } else {
+                return EINVAL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function return pipe events. Pipe is readable when contains data or
+ *         is closed (EOF), and writable when contains free space.
+ *
+ * @param  pipe         a pipe object
+ * @param  events       pipe events (POLLIN, POLLOUT, POLLHUP)
+ * @param  entry        poll waiter entry (can be NULL)
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _pipe_poll(pipe_t *pipe, u32_t *events, struct _poll_entry *entry)
+{
+        if (is_valid(pipe) && events) {
+                _poll_wait(&pipe->poll, pipe, entry);
+
+                *events = 0;
+
+                if (pipe->count > 0 || pipe->closed) {
+                        *events |= POLLIN;
+                }
+
+                if (pipe->closed) {
+                        *events |= POLLHUP;
+                } else if (pipe->count < PIPE_LENGTH) {
+                        *events |= POLLOUT;
+                }
+
+                return ESUCC;
         } else {
                 return EINVAL;
         }
@@ -40,8 +40,14 @@
 #define PATH_ROOT_BIN                   "/bin"
 #define PATH_ROOT_PID                   "/pid"
 #define PATH_ROOT_CPUINFO               "/cpuinfo"
+#define PATH_ROOT_KWORKER               "/kworker"
+#define PATH_ROOT_CACHE                 "/cache"
+#define PATH_ROOT_HEAP                  "/heap"
+#define PATH_ROOT_SLAB                  "/slab"
+#define PATH_ROOT_STAT                  "/stat"
 
 #define FILE_BUFFER                     384
+#define FILE_BUFFER_MAX                 4096
 #define PID_STR_LEN                     12
 
 /*==============================================================================
@@ -57,12 +63,19 @@ enum path_content {
         FILE_CONTENT_BIN,
         FILE_CONTENT_PID,
         FILE_CONTENT_CPUINFO,
+        FILE_CONTENT_KWORKER,
+        FILE_CONTENT_CACHE,
+        FILE_CONTENT_HEAP,
+        FILE_CONTENT_SLAB,
+        FILE_CONTENT_STAT,
         _FILE_CONTENT_COUNT
 };
 
 struct file_info {
         enum path_content content;
         int16_t           arg;
+        char             *data;         // content snapshot created at open
+        size_t            size;         // snapshot size
 };
 
 struct dir_info {
@@ -74,10 +87,11 @@ struct dir_info {
   Local function prototypes
 ==============================================================================*/
 static int    procfs_readdir_root(struct procfs *hdl, DIR *dir);
-static int    procfs_readdir_pid (struct procfs *hdl, DIR *dir);
+static int    procfs_readdir_pid (struct procfs *hdl, DIR *dir, enum path_content content);
 static int    procfs_readdir_bin (struct procfs *hdl, DIR *dir);
 static int    add_file_to_list   (struct procfs *hdl, int16_t arg, enum path_content content, void **object);
 static size_t get_file_content   (struct file_info *file_info, char *buff, size_t size);
+static int    create_snapshot    (struct file_info *file_info);
 
 /*==============================================================================
   Local object definitions
@@ -207,6 +221,24 @@ API_FS_OPEN(procfs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path
                         err = ENOENT;
                 }
 
+        // "/stat" path
+        } else if (isstreq(path, PATH_ROOT_STAT)) {
+                return add_file_to_list(fsctx, -1, FILE_CONTENT_STAT, fhdl);
+
+        // "/stat/<pid>" path
+        } else if (isstreqn(path, PATH_ROOT_STAT"/", strlen(PATH_ROOT_STAT) + 1)) {
+                path += strlen(PATH_ROOT_STAT) + 1;
+
+                i32_t pid = 0;
+                sys_strtoi(path, 10, &pid);
+
+                process_stat_t stat;
+                if (sys_process_get_stat_pid(pid, &stat) == ESUCC) {
+                        return add_file_to_list(fsctx, pid, FILE_CONTENT_STAT, fhdl);
+                } else {
+                        err = ENOENT;
+                }
+
         // "/bin" path
         } else if (isstreq(path, PATH_ROOT_BIN)) {
                 return add_file_to_list(fsctx, -1, FILE_CONTENT_BIN, fhdl);
@@ -226,6 +258,22 @@ API_FS_OPEN(procfs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path
         } else if (isstreq(path, PATH_ROOT_CPUINFO)) {
                 return add_file_to_list(fsctx, 0, FILE_CONTENT_CPUINFO, fhdl);
 
+        // "/kworker" path
+        } else if (isstreq(path, PATH_ROOT_KWORKER)) {
+                return add_file_to_list(fsctx, 0, FILE_CONTENT_KWORKER, fhdl);
+
+        // "/cache" path
+        } else if (isstreq(path, PATH_ROOT_CACHE)) {
+                return add_file_to_list(fsctx, 0, FILE_CONTENT_CACHE, fhdl);
+
+        // "/heap" path
+        } else if (isstreq(path, PATH_ROOT_HEAP)) {
+                return add_file_to_list(fsctx, 0, FILE_CONTENT_HEAP, fhdl);
+
+        // "/slab" path
+        } else if (isstreq(path, PATH_ROOT_SLAB)) {
+                return add_file_to_list(fsctx, 0, FILE_CONTENT_SLAB, fhdl);
+
         } else {
                 err = ENOENT;
         }
@@ -248,12 +296,21 @@ API_FS_CLOSE(procfs, void *fs_handle, void *fhdl, bool force)
 {
         UNUSED_ARG1(force);
 
-        struct procfs *fsctx = fs_handle;
+        struct procfs    *fsctx = fs_handle;
+        struct file_info *file  = fhdl;
 
         int err = sys_mutex_lock(fsctx->resource_mtx, MAX_DELAY_MS);
         if (!err) {
                 int pos = sys_llist_find_begin(fsctx->file_list, fhdl);
-                err = sys_llist_erase(fsctx->file_list, pos) ? ESUCC : ENOENT;
+                if (pos >= 0) {
+                        if (file->data) {
+                                sys_free(cast(void**, &file->data));
+                        }
+
+                        err = sys_llist_erase(fsctx->file_list, pos) ? ESUCC : ENOENT;
+                } else {
+                        err = ENOENT;
+                }
 
                 sys_mutex_unlock(fsctx->resource_mtx);
         }
@@ -321,21 +378,16 @@ API_FS_READ(procfs,
 
         if (file && file->content < _FILE_CONTENT_COUNT) {
 
-                char *content;
-                err = sys_zalloc(FILE_BUFFER, cast(void**, &content));
-                if (!err) {
-                        size_t data_size = get_file_content(file, content, FILE_BUFFER);
-                        size_t seek      = min(*fpos, SIZE_MAX);
-                        if (seek > data_size) {
-                                *rdcnt = 0;
-                        } else {
-                                size_t n = (data_size - seek <= count) ? data_size - seek : count;
-                                strncpy((char *)dst, content + seek, n);
-                                *rdcnt = n;
-                        }
-
-                        sys_free(cast(void**, &content));
+                size_t seek = min(*fpos, SIZE_MAX);
+                if (seek >= file->size) {
+                        *rdcnt = 0;
+                } else {
+                        size_t n = min(file->size - seek, count);
+                        memcpy(dst, file->data + seek, n);
+                        *rdcnt = n;
                 }
+
+                err = ESUCC;
         }
 
         return err;
@@ -402,39 +454,30 @@ API_FS_FSTAT(procfs, void *fs_handle, void *fhdl, struct stat *stat)
         stat->st_gid   = 0;
         stat->st_uid   = 0;
 
-        char *content;
-        int err = sys_zalloc(FILE_BUFFER, cast(void**, &content));
-        if (!err) {
+        if (file->content < _FILE_CONTENT_COUNT) {
 
-                if (file->content < _FILE_CONTENT_COUNT) {
+                if (file->arg >= 0) {
+                        stat->st_size = file->size;
+                        stat->st_type = FILE_TYPE_REGULAR;
 
-                        if (file->arg >= 0) {
-                                stat->st_size = get_file_content(file, content, FILE_BUFFER);
-                                stat->st_type = FILE_TYPE_REGULAR;
+                        if (file->content != FILE_CONTENT_BIN) {
+                                time_t t = 0;
+                                sys_get_time(&t);
 
-                                if (  (file->content == FILE_CONTENT_PID)
-                                   || (file->content == FILE_CONTENT_CPUINFO) ) {
-
-                                        time_t t = 0;
-                                        sys_get_time(&t);
-
-                                        stat->st_mtime = t;
-                                        stat->st_ctime = t;
-                                }
+                                stat->st_mtime = t;
+                                stat->st_ctime = t;
+                        }
 
-                                if (file->content == FILE_CONTENT_BIN) {
-                                        stat->st_type  = FILE_TYPE_PROGRAM;
-                                        stat->st_mode |= S_IXUSR;
-                                }
-                        } else {
-                                stat->st_type = FILE_TYPE_DIR;
+                        if (file->content == FILE_CONTENT_BIN) {
+                                stat->st_type  = FILE_TYPE_PROGRAM;
+                                stat->st_mode |= S_IXUSR;
                         }
+                } else {
+                        stat->st_type = FILE_TYPE_DIR;
                 }
-
-                sys_free(cast(void**, &content));
         }
 
-        return err;
+        return ESUCC;
 }
 
 //==============================================================================
@@ -539,12 +582,16 @@ API_FS_OPENDIR(procfs, void *fs_handle, const char *path, DIR *dir)
 
                 if (isstreq(path, PATH_ROOT)) {
                         dirinfo->dir_name = PATH_ROOT;
-                        dir->d_items      = 3;
+                        dir->d_items      = 8;
 
                 } else if (isstreq(path, PATH_ROOT_PID"/")) {
                         dirinfo->dir_name = PATH_ROOT_PID;
                         dir->d_items      = sys_process_get_count();
 
+                } else if (isstreq(path, PATH_ROOT_STAT"/")) {
+                        dirinfo->dir_name = PATH_ROOT_STAT;
+                        dir->d_items      = sys_process_get_count();
+
                 } else if (isstreq(path, PATH_ROOT_BIN"/")) {
                         dirinfo->dir_name = PATH_ROOT_BIN;
                         dir->d_items      = sys_get_programs_table_size();
@@ -599,7 +646,10 @@ API_FS_READDIR(procfs, void *fs_handle, DIR *dir)
                         err = procfs_readdir_root(fs_handle, dir);
 
                 } else if (isstreq(dirinfo->dir_name, PATH_ROOT_PID)) {
-                        err = procfs_readdir_pid(fs_handle, dir);
+                        err = procfs_readdir_pid(fs_handle, dir, FILE_CONTENT_PID);
+
+                } else if (isstreq(dirinfo->dir_name, PATH_ROOT_STAT)) {
+                        err = procfs_readdir_pid(fs_handle, dir, FILE_CONTENT_STAT);
 
                 } else if (isstreq(dirinfo->dir_name, PATH_ROOT_BIN)) {
                         err = procfs_readdir_bin(fs_handle, dir);
@@ -751,6 +801,11 @@ static int procfs_readdir_root(struct procfs *hdl, DIR *dir)
                 dir->dirent.filetype = FILE_TYPE_DIR;
                 break;
 
+        case 7:
+                dir->dirent.name     = "stat";
+                dir->dirent.filetype = FILE_TYPE_DIR;
+                break;
+
         case 2: {
                 char *content;
                 err = sys_zalloc(FILE_BUFFER, cast(void**, &content));
@@ -765,6 +820,62 @@ static int procfs_readdir_root(struct procfs *hdl, DIR *dir)
                 break;
         }
 
+        case 3: {
+                char *content;
+                err = sys_zalloc(FILE_BUFFER, cast(void**, &content));
+                if (!err) {
+                        struct file_info file = {.content = FILE_CONTENT_KWORKER, .arg = 0};
+                        dir->dirent.name      = "kworker";
+                        dir->dirent.filetype  = FILE_TYPE_REGULAR;
+                        dir->dirent.size      = get_file_content(&file, content, FILE_BUFFER);
+
+                        sys_free(cast(void**, &content));
+                }
+                break;
+        }
+
+        case 4: {
+                char *content;
+                err = sys_zalloc(FILE_BUFFER, cast(void**, &content));
+                if (!err) {
+                        struct file_info file = {.content = FILE_CONTENT_CACHE, .arg = 0};
+                        dir->dirent.name      = "cache";
+                        dir->dirent.filetype  = FILE_TYPE_REGULAR;
+                        dir->dirent.size      = get_file_content(&file, content, FILE_BUFFER);
+
+                        sys_free(cast(void**, &content));
+                }
+                break;
+        }
+
+        case 5: {
+                char *content;
+                err = sys_zalloc(FILE_BUFFER, cast(void**, &content));
+                if (!err) {
+                        struct file_info file = {.content = FILE_CONTENT_HEAP, .arg = 0};
+                        dir->dirent.name      = "heap";
+                        dir->dirent.filetype  = FILE_TYPE_REGULAR;
+                        dir->dirent.size      = get_file_content(&file, content, FILE_BUFFER);
+
+                        sys_free(cast(void**, &content));
+                }
+                break;
+        }
+
+        case 6: {
+                char *content;
+                err = sys_zalloc(FILE_BUFFER, cast(void**, &content));
+                if (!err) {
+                        struct file_info file = {.content = FILE_CONTENT_SLAB, .arg = 0};
+                        dir->dirent.name      = "slab";
+                        dir->dirent.filetype  = FILE_TYPE_REGULAR;
+                        dir->dirent.size      = get_file_content(&file, content, FILE_BUFFER);
+
+                        sys_free(cast(void**, &content));
+                }
+                break;
+        }
+
         default:
                 err = ENOENT;
                 break;
@@ -779,11 +890,12 @@ static int procfs_readdir_root(struct procfs *hdl, DIR *dir)
  *
  * @param[in ]          *hdl                    file system allocated memory
  * @param[in,out]       *dir                    directory object
+ * @param[in ]           content                file content (PID or STAT)
  *
  * @return One of errno value (errno.h)
  */
 //==============================================================================
-static int procfs_readdir_pid(struct procfs *hdl, DIR *dir)
+static int procfs_readdir_pid(struct procfs *hdl, DIR *dir, enum path_content content)
 {
         UNUSED_ARG1(hdl);
 
@@ -791,23 +903,27 @@ static int procfs_readdir_pid(struct procfs *hdl, DIR *dir)
         int err = sys_process_get_stat_seek(dir->d_seek++, &stat);
         if (err == ESUCC) {
 
-                char *content;
-                err = sys_zalloc(FILE_BUFFER, cast(void**, &content));
-                if (!err) {
+                struct dir_info *dirinfo = dir->d_hdl;
 
-                        struct dir_info *dirinfo = dir->d_hdl;
+                sys_snprintf(dirinfo->name, sizeof(dirinfo->name),
+                             "%u", stat.pid);
 
-                        sys_snprintf(dirinfo->name, sizeof(dirinfo->name),
-                                     "%u", stat.pid);
+                dir->dirent.name      = dirinfo->name;
+                dir->dirent.filetype  = FILE_TYPE_REGULAR;
+                dir->dirent.dev       = 0;
 
-                        dir->dirent.name      = dirinfo->name;
-                        dir->dirent.filetype  = FILE_TYPE_REGULAR;
-                        dir->dirent.dev       = 0;
+                if (content == FILE_CONTENT_STAT) {
+                        dir->dirent.size = sizeof(process_stat_record_t);
 
-                        struct file_info file = {.arg = stat.pid, .content = FILE_CONTENT_PID};
-                        dir->dirent.size      = get_file_content(&file, content, FILE_BUFFER);
+                } else {
+                        char *buf;
+                        err = sys_zalloc(FILE_BUFFER, cast(void**, &buf));
+                        if (!err) {
+                                struct file_info file = {.arg = stat.pid, .content = content};
+                                dir->dirent.size      = get_file_content(&file, buf, FILE_BUFFER);
 
-                        err = sys_free(cast(void**, &content));
+                                err = sys_free(cast(void**, &buf));
+                        }
                 }
         }
 
@@ -861,22 +977,86 @@ static int add_file_to_list(struct procfs *hdl, int16_t arg,
                 file->content = content;
                 file->arg     = arg;
 
-                err = sys_mutex_lock(hdl->resource_mtx, MAX_DELAY_MS);
+                if (arg >= 0 && content != FILE_CONTENT_BIN) {
+                        err = create_snapshot(file);
+                }
+
                 if (!err) {
-                        if (sys_llist_push_back(hdl->file_list, file)) {
-                                *object = file;
-                        } else {
-                                sys_free(cast(void**, &file));
-                                err = ENOMEM;
+                        err = sys_mutex_lock(hdl->resource_mtx, MAX_DELAY_MS);
+                        if (!err) {
+                                if (sys_llist_push_back(hdl->file_list, file)) {
+                                        *object = file;
+                                } else {
+                                        err = ENOMEM;
+                                }
+
+                                sys_mutex_unlock(hdl->resource_mtx);
+                        }
+                }
+
+                if (err) {
+                        if (file->data) {
+                                sys_free(cast(void**, &file->data));
                         }
 
-                        sys_mutex_unlock(hdl->resource_mtx);
+                        sys_free(cast(void**, &file));
                 }
         }
 
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Function create snapshot of file content. The content is generated
+ *        once and all reads and seeks of opened file use this snapshot.
+ *        The buffer is enlarged when generated content does not fit.
+ *
+ * @param file          file information
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int create_snapshot(struct file_info *file)
+{
+        size_t size = FILE_BUFFER;
+        char  *buf  = NULL;
+        size_t len  = 0;
+        int    err;
+
+        while (true) {
+                err = sys_zalloc(size, cast(void**, &buf));
+                if (err) {
+                        return err;
+                }
+
+                len = get_file_content(file, buf, size);
+
+                // snprintf() truncates content to (size - 1) characters
+                if ((len + 1 < size) || (size >= FILE_BUFFER_MAX)) {
+                        break;
+                }
+
+                sys_free(cast(void**, &buf));
+                size *= 2;
+        }
+
+        if (len == 0) {
+                sys_free(cast(void**, &buf));
+
+        } else if (sys_malloc(len, cast(void**, &file->data)) == ESUCC) {
+                memcpy(file->data, buf, len);
+                sys_free(cast(void**, &buf));
+
+        } else {
+                file->data = buf;
+        }
+
+        file->size = len;
+
+        return ESUCC;
+}
+
 //==============================================================================
 /**
  * @brief Function return file content and size
@@ -960,6 +1140,125 @@ static size_t get_file_content(struct file_info *file, char *buff, size_t size)
                 }
                 break;
 
+        case FILE_CONTENT_KWORKER:
+                for (int i = 0; i < _SYSCALL_POOL_COUNT; i++) {
+                        _syscall_pool_stat_t pstat;
+                        if (sys_get_syscall_pool_stat(i, &pstat) == ESUCC) {
+                                u32_t rq = max(1, pstat.requests);
+
+                                len += sys_snprintf(buff + len, size - len,
+                                                    "%s: workers %u/%u, idle %u, queue %u (max %u)\n"
+                                                    "  requests %u, overflows %u, shrinks %u\n"
+                                                    "  wait avg %u ms, max %u ms\n"
+                                                    "  service avg %u ms, max %u ms\n",
+                                                    pstat.name,
+                                                    pstat.workers,
+                                                    pstat.max_workers,
+                                                    pstat.idle,
+                                                    pstat.queue_depth,
+                                                    pstat.queue_max,
+                                                    pstat.requests,
+                                                    pstat.overflows,
+                                                    pstat.shrinks,
+                                                    pstat.wait_time_ms / rq,
+                                                    pstat.wait_time_max_ms,
+                                                    pstat.service_time_ms / rq,
+                                                    pstat.service_time_max_ms);
+                        }
+                }
+                break;
+
+        case FILE_CONTENT_CACHE: {
+                _cache_dev_stat_t cstat;
+                for (size_t i = 0; sys_cache_get_dev_stat(i, &cstat) == ESUCC; i++) {
+                        len += sys_snprintf(buff + len, size - len,
+                                            "dev %u:%u:%u: hits %u, misses %u\n"
+                                            "  read-ahead %u (used %u)\n"
+                                            "  requests rd %u, wr %u\n",
+                                            _dev_t__extract_modno(cstat.dev),
+                                            _dev_t__extract_major(cstat.dev),
+                                            _dev_t__extract_minor(cstat.dev),
+                                            cstat.hits,
+                                            cstat.misses,
+                                            cstat.readahead,
+                                            cstat.readahead_hits,
+                                            cstat.rd_requests,
+                                            cstat.wr_requests);
+                }
+                break;
+        }
+
+        case FILE_CONTENT_HEAP: {
+                _heap_stat_t hstat;
+                for (size_t i = 0; sys_get_heap_stat(i, &hstat) == ESUCC; i++) {
+                        size_t free = hstat.size - hstat.used;
+                        u32_t  frag = 0;
+
+                        if (free > 0 && hstat.largest_free < free) {
+                                frag = 100 - ((hstat.largest_free * 100) / free);
+                        }
+
+                        len += sys_snprintf(buff + len, size - len,
+                                            "region %u: size %u, used %u (max %u)\n"
+                                            "  free blocks %u, largest %u, fragmentation %u%%\n"
+                                            "  longest search %u blocks\n",
+                                            i,
+                                            hstat.size,
+                                            hstat.used,
+                                            hstat.used_max,
+                                            hstat.free_blocks,
+                                            hstat.largest_free,
+                                            frag,
+                                            hstat.search_max);
+                }
+                break;
+        }
+
+        case FILE_CONTENT_SLAB: {
+                _slab_stat_t sstat;
+                for (size_t i = 0; sys_get_slab_stat(i, &sstat) == ESUCC; i++) {
+                        len += sys_snprintf(buff + len, size - len,
+                                            "%s: size %u, objects %u/%u (max %u), cached %u, pages %u x %u\n",
+                                            sstat.name,
+                                            sstat.obj_size,
+                                            sstat.objects,
+                                            sstat.capacity,
+                                            sstat.objects_max,
+                                            sstat.cached,
+                                            sstat.pages,
+                                            sstat.page_size);
+                }
+                break;
+        }
+
+        case FILE_CONTENT_STAT:
+                if (  (size >= sizeof(process_stat_record_t))
+                   && (sys_process_get_stat_pid(file->arg, &stat) == ESUCC) ) {
+
+                        process_stat_record_t *rec = cast(process_stat_record_t*, buff);
+                        memset(rec, 0, sizeof(process_stat_record_t));
+
+                        strncpy(rec->name, stat.name, sizeof(rec->name) - 1);
+                        rec->memory_usage       = stat.memory_usage;
+                        rec->pid                = stat.pid;
+                        rec->memory_block_count = stat.memory_block_count;
+                        rec->files_count        = stat.files_count;
+                        rec->dir_count          = stat.dir_count;
+                        rec->mutexes_count      = stat.mutexes_count;
+                        rec->semaphores_count   = stat.semaphores_count;
+                        rec->queue_count        = stat.queue_count;
+                        rec->socket_count       = stat.socket_count;
+                        rec->threads_count      = stat.threads_count;
+                        rec->CPU_load           = stat.CPU_load;
+                        rec->stack_size         = stat.stack_size;
+                        rec->stack_max_usage    = stat.stack_max_usage;
+                        rec->stack_min_free     = stat.stack_min_free;
+                        rec->priority           = stat.priority;
+
+                        len = sizeof(process_stat_record_t);
+                }
+                break;
+
         default:
                 break;
         }
@@ -38,16 +38,27 @@
 #define PIPE_LENGTH                     __OS_STREAM_BUFFER_LENGTH__
 #define PIPE_WRITE_TIMEOUT              1
 #define PIPE_READ_TIMEOUT               MAX_DELAY
-#define DATA_CHAIN_SIZE                 __RAMFS_FILE_CHAIN_SIZE__
+#define CHUNK_SIZE                      __RAMFS_FILE_CHAIN_SIZE__
+#define DIR_INDEX_MIN_CAPACITY          4
+#define CHUNK_TABLE_MIN_CAPACITY        4
 
 /*==============================================================================
   Local types, enums definitions
 ==============================================================================*/
-/** regular file data chain */
-typedef struct data_chain {
-        struct data_chain *next;
-        u8_t buf[DATA_CHAIN_SIZE];
-} data_chain_t;
+struct node;
+
+/** directory index, entries are sorted by name */
+typedef struct dir_index {
+        struct node    **entry;                 //!< sorted entries
+        size_t           count;                 //!< number of entries
+        size_t           capacity;              //!< entry table capacity
+} dir_index_t;
+
+/** regular file chunk table, NULL chunk is a hole (reads as zeros) */
+typedef struct chunk_table {
+        size_t           capacity;              //!< number of table entries
+        u8_t            *chunk[];               //!< chunk n contains file bytes from n*CHUNK_SIZE
+} chunk_table_t;
 
 /** node structure */
 typedef struct node {
@@ -61,10 +72,10 @@ typedef struct node {
         time_t           ctime;                 //!< time of creation
 
         union {
-                pipe_t       *pipe_t;
-                llist_t      *llist_t;
-                data_chain_t *data_chain_t;
-                dev_t         dev_t;
+                pipe_t        *pipe_t;
+                dir_index_t   *dir_t;
+                chunk_table_t *chunk_t;
+                dev_t          dev_t;
         } data;
 } node_t;
 
@@ -72,6 +83,7 @@ typedef struct node {
 struct opened_file_info {
         node_t          *child;                 //!< opened node
         node_t          *parent;                //!< base of opened node
+        drvinst_t       *drv;                   //!< opened driver (device file)
         bool             remove_at_close;       //!< file to remove after close
 };
 
@@ -87,11 +99,18 @@ struct RAMFS {
   Local function prototypes
 ==============================================================================*/
 static int  new_node                    (struct RAMFS *hdl, node_t *parent, char *filename, tfile_t type, i32_t *item, node_t **child);
-static int  delete_node                 (struct RAMFS *hdl, node_t *base, node_t *target, u32_t position);
+static int  delete_node                 (struct RAMFS *hdl, node_t *base, node_t *target);
 static int  get_node                    (const char *path, node_t *startnode, i32_t deep, i32_t *item, node_t **node);
+static int  dir_create                  (dir_index_t **dir);
+static void dir_destroy                 (dir_index_t **dir);
+static int  name_cmp                    (const char *name, const char *str, size_t len);
+static bool dir_find                    (dir_index_t *dir, const char *name, size_t len, size_t *pos);
+static int  dir_insert                  (dir_index_t *dir, size_t pos, node_t *node);
+static void dir_remove                  (dir_index_t *dir, size_t pos);
 static uint get_path_deep               (const char *path);
 static int  add_node_to_open_files_list (struct RAMFS *hdl, node_t *parent, node_t *child);
 static void clear_regular_file          (node_t *node);
+static int  grow_chunk_table            (node_t *node, size_t idx);
 static int  write_regular_file          (node_t *node, const u8_t *src, size_t count, fpos_t fpos, size_t *wrcnt);
 static int  read_regular_file           (node_t *node, u8_t *dst, size_t count, fpos_t fpos, size_t *rdcnt);
 
@@ -125,7 +144,7 @@ API_FS_INIT(ramfs, void **fs_handle, const char *src_path, const char *opts)
                 if (err)
                         goto finish;
 
-                err = sys_llist_create(NULL, NULL, cast(llist_t**, &hdl->root_dir.data.llist_t));
+                err = dir_create(&hdl->root_dir.data.dir_t);
                 if (err)
                         goto finish;
 
@@ -142,8 +161,8 @@ API_FS_INIT(ramfs, void **fs_handle, const char *src_path, const char *opts)
                         if (hdl->resource_mtx)
                                 sys_mutex_destroy(hdl->resource_mtx);
 
-                        if (hdl->root_dir.data.llist_t)
-                                sys_llist_destroy(hdl->root_dir.data.llist_t);
+                        if (hdl->root_dir.data.dir_t)
+                                dir_destroy(&hdl->root_dir.data.dir_t);
 
                         if (hdl->opended_files)
                                 sys_llist_destroy(hdl->opended_files);
@@ -336,7 +355,7 @@ API_FS_OPENDIR(ramfs, void *fs_handle, const char *path, DIR *dir)
                 err = get_node(path, &hdl->root_dir, 0, NULL, &parent);
                 if (!err) {
                         if (parent->type == FILE_TYPE_DIR) {
-                                dir->d_items    = sys_llist_size(parent->data.llist_t);
+                                dir->d_items    = parent->data.dir_t->count;
                                 dir->d_seek     = 0;
                                 dir->d_hdl      = parent;
                         } else {
@@ -384,8 +403,13 @@ API_FS_READDIR(ramfs, void *fs_handle, DIR *dir)
         int err = sys_mutex_lock(hdl->resource_mtx, MTX_TIMEOUT);
         if (!err) {
 
-                node_t *parent = dir->d_hdl;
-                node_t *child  = sys_llist_at(parent->data.llist_t, dir->d_seek++);
+                node_t      *parent = dir->d_hdl;
+                dir_index_t *index  = parent->data.dir_t;
+                node_t      *child  = NULL;
+
+                if (dir->d_seek < index->count) {
+                        child = index->entry[dir->d_seek++];
+                }
 
                 if (child) {
                         dir->dirent.filetype = child->type;
@@ -443,8 +467,8 @@ API_FS_REMOVE(ramfs, void *fs_handle, const char *path)
                         goto finish;
                 }
 
-                i32_t item; node_t *child;
-                err = get_node(path, &hdl->root_dir, 0, &item, &child);
+                node_t *child;
+                err = get_node(path, &hdl->root_dir, 0, NULL, &child);
                 if (err) {
                         goto finish;
                 }
@@ -474,7 +498,7 @@ API_FS_REMOVE(ramfs, void *fs_handle, const char *path)
 
                 /* remove node if possible */
                 if (remove_file == true) {
-                        err = delete_node(hdl, parent, child, item);
+                        err = delete_node(hdl, parent, child);
                 } else {
                         err = ESUCC;
                 }
@@ -508,24 +532,62 @@ API_FS_RENAME(ramfs, void *fs_handle, const char *old_name, const char *new_name
         int err = sys_mutex_lock(hdl->resource_mtx, MTX_TIMEOUT);
         if (!err) {
 
-                node_t *target;
-                err = get_node(old_name, &hdl->root_dir, 0, NULL, &target);
+                node_t *parent, *target;
+                err = get_node(old_name, &hdl->root_dir, -1, NULL, &parent);
                 if (!err) {
-                        char *basename = strrchr(new_name, '/') + 1;
+                        err = get_node(old_name, &hdl->root_dir, 0, NULL, &target);
+                }
+
+                if (!err && target == &hdl->root_dir) {
+                        err = EPERM;
+                }
+
+                if (!err) {
+                        char  *basename = strrchr(new_name, '/') + 1;
+                        size_t pos;
+
+                        if (dir_find(parent->data.dir_t, basename, strlen(basename), &pos)) {
+                                err = (parent->data.dir_t->entry[pos] == target) ? ESUCC : EEXIST;
+                                goto finish;
+                        }
 
                         char *newname;
                         err = sys_zalloc(strsize(basename), cast(void**, &newname));
                         if (!err) {
                                 strcpy(newname, basename);
 
-                                if (target->name) {
-                                        sys_free(cast(void**, target->name));
+                                // entry is moved to the new position of sorted index
+                                char *oldname = target->name;
+                                bool  linked  = dir_find(parent->data.dir_t, oldname,
+                                                         strlen(oldname), &pos);
+                                if (linked) {
+                                        dir_remove(parent->data.dir_t, pos);
                                 }
 
                                 target->name = newname;
+
+                                dir_find(parent->data.dir_t, newname, strlen(newname), &pos);
+                                err = dir_insert(parent->data.dir_t, pos, target);
+                                if (!err) {
+                                        sys_free(cast(void**, &oldname));
+
+                                } else {
+                                        // node is restored under the old name,
+                                        // slot released by dir_remove() is reused
+                                        target->name = oldname;
+                                        sys_free(cast(void**, &newname));
+
+                                        if (linked) {
+                                                dir_find(parent->data.dir_t, oldname,
+                                                         strlen(oldname), &pos);
+                                                dir_insert(parent->data.dir_t, pos, target);
+                                        }
+                                }
                         }
                 }
 
+                finish:
+
                 sys_mutex_unlock(hdl->resource_mtx);
         }
 
@@ -693,8 +755,7 @@ API_FS_FSTAT(ramfs, void *fs_handle, void *extra, struct stat *stat)
                                 stat->st_dev = opened_file->child->data.dev_t;
 
                                 struct vfs_dev_stat dev_stat;
-                                err = sys_driver_stat(opened_file->child->data.dev_t,
-                                                      &dev_stat);
+                                err = sys_drvinst_stat(opened_file->drv, &dev_stat);
                                 if (!err) {
                                         stat->st_size = dev_stat.st_size;
 
@@ -822,7 +883,9 @@ API_FS_OPEN(ramfs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path,
                         }
 
                 } else if (child->type == FILE_TYPE_DRV) {
-                        err = sys_driver_open(child->data.dev_t, flags);
+                        struct opened_file_info *opened_file = sys_llist_back(hdl->opended_files);
+
+                        err = sys_drvinst_open(child->data.dev_t, flags, &opened_file->drv);
                         if (!err) {
                                 *fpos = 0;
                         } else {
@@ -867,7 +930,12 @@ API_FS_CLOSE(ramfs, void *fs_handle, void *fhdl, bool force)
 
                         /* close device if file is driver type */
                         if (target->type == FILE_TYPE_DRV) {
-                                err = sys_driver_close(target->data.dev_t, force);
+                                err = sys_drvinst_close(opened_file->drv, force);
+
+                                // instance is released by forced close
+                                if (force) {
+                                        err = ESUCC;
+                                }
 
                         } else if (target->type == FILE_TYPE_PIPE) {
                                 err = sys_pipe_close(target->data.pipe_t);
@@ -878,7 +946,7 @@ API_FS_CLOSE(ramfs, void *fs_handle, void *fhdl, bool force)
                                         bool remove = true;
 
                                         sys_llist_foreach(struct opened_file_info*, file, hdl->opended_files) {
-                                                if (file->child == target) {
+                                                if (file != opened_file && file->child == target) {
                                                         remove = false;
                                                         break;
                                                 }
@@ -887,8 +955,7 @@ API_FS_CLOSE(ramfs, void *fs_handle, void *fhdl, bool force)
                                         if (remove) {
                                                 err = delete_node(hdl,
                                                                   opened_file->parent,
-                                                                  opened_file->child,
-                                                                  pos);
+                                                                  opened_file->child);
                                         }
                                 } else {
                                         err = ESUCC;
@@ -933,25 +1000,26 @@ API_FS_WRITE(ramfs,
              size_t          *wrcnt,
              struct vfs_fattr fattr)
 {
-        struct RAMFS *hdl = fs_handle;
+        struct RAMFS            *hdl         = fs_handle;
+        struct opened_file_info *opened_file = fhdl;
+
+        // device is accessed directly by using opened driver instance
+        if (opened_file && opened_file->drv) {
+                sys_get_time(&opened_file->child->mtime);
+                return sys_drvinst_write(opened_file->drv, src, count, fpos, wrcnt, fattr);
+        }
 
         int err = sys_mutex_lock(hdl->resource_mtx, MTX_TIMEOUT);
         if (!err) {
 
                 err = ENOENT;
 
-                struct opened_file_info *opened_file = fhdl;
                 if (opened_file && opened_file->child) {
                         node_t *node = opened_file->child;
 
                         sys_get_time(&node->mtime);
 
-                        if (node->type == FILE_TYPE_DRV) {
-                                sys_mutex_unlock(hdl->resource_mtx);
-                                return sys_driver_write(node->data.dev_t, src,
-                                                        count, fpos, wrcnt, fattr);
-
-                        } else if (node->type == FILE_TYPE_PIPE) {
+                        if (node->type == FILE_TYPE_PIPE) {
                                sys_mutex_unlock(hdl->resource_mtx);
 
                                err = sys_pipe_write(node->data.pipe_t, src,
@@ -1002,23 +1070,23 @@ API_FS_READ(ramfs,
             size_t          *rdcnt,
             struct vfs_fattr fattr)
 {
-        struct RAMFS *hdl = fs_handle;
+        struct RAMFS            *hdl         = fs_handle;
+        struct opened_file_info *opened_file = fhdl;
+
+        // device is accessed directly by using opened driver instance
+        if (opened_file && opened_file->drv) {
+                return sys_drvinst_read(opened_file->drv, dst, count, fpos, rdcnt, fattr);
+        }
 
         int err = sys_mutex_lock(hdl->resource_mtx, MTX_TIMEOUT);
         if (!err) {
 
                 err = ENOENT;
 
-                struct opened_file_info *opened_file = fhdl;
                 if (opened_file && opened_file->child) {
                         node_t *node = opened_file->child;
 
-                        if (node->type == FILE_TYPE_DRV) {
-                                sys_mutex_unlock(hdl->resource_mtx);
-                                return sys_driver_read(node->data.dev_t, dst,
-                                                       count, fpos, rdcnt, fattr);
-
-                        } else if (node->type == FILE_TYPE_PIPE) {
+                        if (node->type == FILE_TYPE_PIPE) {
                                 sys_mutex_unlock(hdl->resource_mtx);
 
                                 err = sys_pipe_read(node->data.pipe_t, dst,
@@ -1059,21 +1127,21 @@ API_FS_READ(ramfs,
 //==============================================================================
 API_FS_IOCTL(ramfs, void *fs_handle, void *fhdl, int request, void *arg)
 {
-        struct RAMFS *hdl = fs_handle;
+        struct RAMFS            *hdl         = fs_handle;
+        struct opened_file_info *opened_file = fhdl;
+
+        // device is accessed directly by using opened driver instance
+        if (opened_file && opened_file->drv) {
+                return sys_drvinst_ioctl(opened_file->drv, request, arg);
+        }
 
         int err = sys_mutex_lock(hdl->resource_mtx, MTX_TIMEOUT);
         if (!err) {
 
                 err = ENOENT;
 
-                struct opened_file_info *opened_file = fhdl;
                 if (opened_file && opened_file->child) {
-                        if (opened_file->child->type == FILE_TYPE_DRV) {
-                                sys_mutex_unlock(hdl->resource_mtx);
-                                return sys_driver_ioctl(opened_file->child->data.dev_t,
-                                                        request, arg);
-
-                        } else if (opened_file->child->type == FILE_TYPE_PIPE) {
+                        if (opened_file->child->type == FILE_TYPE_PIPE) {
 
                                 switch (request) {
                                 case IOCTL_PIPE__CLOSE:
@@ -1084,6 +1152,10 @@ API_FS_IOCTL(ramfs, void *fs_handle, void *fhdl, int request, void *arg)
                                         sys_mutex_unlock(hdl->resource_mtx);
                                         return sys_pipe_clear(opened_file->child->data.pipe_t);
 
+                                case IOCTL_VFS__POLL:
+                                        sys_mutex_unlock(hdl->resource_mtx);
+                                        return sys_pipe_poll(opened_file->child->data.pipe_t, arg);
+
                                 default:
                                         err = EBADRQC;
                                         break;
@@ -1109,19 +1181,19 @@ API_FS_IOCTL(ramfs, void *fs_handle, void *fhdl, int request, void *arg)
 //==============================================================================
 API_FS_FLUSH(ramfs, void *fs_handle, void *fhdl)
 {
-        struct RAMFS *hdl = fs_handle;
+        struct RAMFS            *hdl         = fs_handle;
+        struct opened_file_info *opened_file = fhdl;
+
+        // device is accessed directly by using opened driver instance
+        if (opened_file && opened_file->drv) {
+                return sys_drvinst_flush(opened_file->drv);
+        }
 
         int err = sys_mutex_lock(hdl->resource_mtx, MTX_TIMEOUT);
         if (!err) {
 
-                struct opened_file_info *opened_file = fhdl;
                 if (opened_file && opened_file->child) {
-                        if (opened_file->child->type == FILE_TYPE_DRV) {
-                                sys_mutex_unlock(hdl->resource_mtx);
-                                return sys_driver_flush(opened_file->child->data.dev_t);
-                        } else {
-                                err = ESUCC;
-                        }
+                        err = ESUCC;
                 } else {
                         err = ENOENT;
                 }
@@ -1153,19 +1225,24 @@ API_FS_SYNC(ramfs, void *fs_handle)
  *
  * @param[in] *base             base node
  * @param[in] *target           target node
- * @param[in]  position         item in base node that point to target
  *
  * @return One of errno value (errno.h)
  */
 //==============================================================================
-static int delete_node(struct RAMFS *hdl, node_t *base, node_t *target, u32_t position)
+static int delete_node(struct RAMFS *hdl, node_t *base, node_t *target)
 {
+        size_t pos;
+        if (  !dir_find(base->data.dir_t, target->name, strlen(target->name), &pos)
+           || base->data.dir_t->entry[pos] != target) {
+
+                return ENOENT;
+        }
+
         if (target->type == FILE_TYPE_DIR) {
-                if (sys_llist_size(target->data.llist_t) > 0) {
+                if (target->data.dir_t->count > 0) {
                         return ENOTEMPTY;
                 } else {
-                        sys_llist_destroy(target->data.llist_t);
-                        target->data.llist_t = NULL;
+                        dir_destroy(&target->data.dir_t);
                 }
 
         } else if (target->type == FILE_TYPE_PIPE) {
@@ -1178,17 +1255,166 @@ static int delete_node(struct RAMFS *hdl, node_t *base, node_t *target, u32_t po
                 clear_regular_file(target);
         }
 
+        dir_remove(base->data.dir_t, pos);
+
         if (target->name) {
                 sys_free(cast(void**, &target->name));
         }
 
-        sys_llist_erase(base->data.llist_t, position);
+        sys_free(cast(void**, &target));
 
         hdl->file_count--;
 
         return ESUCC;
 }
 
+//==============================================================================
+/**
+ * @brief Function create empty directory index.
+ *
+ * @param[out] dir              created index
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int dir_create(dir_index_t **dir)
+{
+        return sys_zalloc(sizeof(dir_index_t), cast(void**, dir));
+}
+
+//==============================================================================
+/**
+ * @brief Function release directory index. Entries are not released.
+ *
+ * @param[in,out] dir           index to release
+ */
+//==============================================================================
+static void dir_destroy(dir_index_t **dir)
+{
+        if ((*dir)->entry) {
+                sys_free(cast(void**, &(*dir)->entry));
+        }
+
+        sys_free(cast(void**, dir));
+}
+
+//==============================================================================
+/**
+ * @brief Function compare node name with not terminated string.
+ *
+ * @param[in] name              node name
+ * @param[in] str               string to compare
+ * @param[in] len               string length
+ *
+ * @return Less than, equal or greater than 0 like strcmp().
+ */
+//==============================================================================
+static int name_cmp(const char *name, const char *str, size_t len)
+{
+        int cmp = strncmp(name, str, len);
+
+        if (cmp == 0 && name[len] != '\0') {
+                cmp = 1;
+        }
+
+        return cmp;
+}
+
+//==============================================================================
+/**
+ * @brief Function find entry in directory index (binary search).
+ *
+ * @param[in]  dir              directory index
+ * @param[in]  name             searched name (not necessary terminated)
+ * @param[in]  len              name length
+ * @param[out] pos              position of found entry or position where
+ *                              entry should be inserted
+ *
+ * @return True if entry was found, otherwise false.
+ */
+//==============================================================================
+static bool dir_find(dir_index_t *dir, const char *name, size_t len, size_t *pos)
+{
+        size_t lo = 0;
+        size_t hi = dir->count;
+
+        while (lo < hi) {
+                size_t mid = lo + ((hi - lo) / 2);
+                int    cmp = name_cmp(dir->entry[mid]->name, name, len);
+
+                if (cmp == 0) {
+                        *pos = mid;
+                        return true;
+                } else if (cmp < 0) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+
+        *pos = lo;
+        return false;
+}
+
+//==============================================================================
+/**
+ * @brief Function insert entry to directory index at selected position.
+ *        Entry table is doubled when is full.
+ *
+ * @param[in] dir               directory index
+ * @param[in] pos               position (from dir_find())
+ * @param[in] node              inserted node
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int dir_insert(dir_index_t *dir, size_t pos, node_t *node)
+{
+        if (dir->count == dir->capacity) {
+                size_t capacity = max(DIR_INDEX_MIN_CAPACITY, dir->capacity * 2);
+
+                node_t **entry;
+                int err = sys_zalloc(capacity * sizeof(node_t*), cast(void**, &entry));
+                if (err) {
+                        return err;
+                }
+
+                if (dir->entry) {
+                        memcpy(entry, dir->entry, dir->count * sizeof(node_t*));
+                        sys_free(cast(void**, &dir->entry));
+                }
+
+                dir->entry    = entry;
+                dir->capacity = capacity;
+        }
+
+        memmove(&dir->entry[pos + 1], &dir->entry[pos],
+                (dir->count - pos) * sizeof(node_t*));
+
+        dir->entry[pos] = node;
+        dir->count++;
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief Function remove entry from directory index. Node is not released.
+ *
+ * @param[in] dir               directory index
+ * @param[in] pos               entry position
+ */
+//==============================================================================
+static void dir_remove(dir_index_t *dir, size_t pos)
+{
+        dir->count--;
+
+        memmove(&dir->entry[pos], &dir->entry[pos + 1],
+                (dir->count - pos) * sizeof(node_t*));
+
+        dir->entry[dir->count] = NULL;
+}
+
 //==============================================================================
 /**
  * @brief Check path deep
@@ -1259,36 +1485,21 @@ static int get_node(const char *path, node_t *startnode, i32_t deep, i32_t *item
                 char *path_end    = strchr(path, '/');
                 uint  path_length = !path_end ? strlen(path) : (size_t)path_end - (size_t)path;
 
-                /* get number of list items */
-                int list_size = sys_llist_size(current_node->data.llist_t);
+                /* only directory can contain objects */
+                if (current_node->type != FILE_TYPE_DIR) {
+                        current_node = NULL;
+                        break;
+                }
 
                 /* find that object exist ------------------------------------*/
-                int i = 0;
-                while (list_size > 0) {
-                        node_t *next_node = sys_llist_at(current_node->data.llist_t, i++);
-
-                        if (next_node == NULL) {
-                                dir_deep = 1 - deep;
-                                break;
-                        }
-
-                        if (  strlen(next_node->name) == path_length
-                           && strncmp(next_node->name, path, path_length) == 0 ) {
-
-                                current_node = next_node;
-
-                                if (item) {
-                                        *item = i - 1;
-                                }
+                size_t pos;
+                if (dir_find(current_node->data.dir_t, path, path_length, &pos)) {
+                        current_node = current_node->data.dir_t->entry[pos];
 
-                                break;
+                        if (item) {
+                                *item = pos;
                         }
-
-                        list_size--;
-                }
-
-                /* directory does not found or error */
-                if (list_size == 0 || current_node == NULL) {
+                } else {
                         current_node = NULL;
                         break;
                 }
@@ -1334,10 +1545,9 @@ static int new_node(struct RAMFS *hdl,
                 return ENOTDIR;
         }
 
-        sys_llist_foreach(node_t*, node, parent->data.llist_t) {
-                if (strncmp(node->name, filename, 255) == 0) {
-                        return EEXIST;
-                }
+        size_t pos;
+        if (dir_find(parent->data.dir_t, filename, strlen(filename), &pos)) {
+                return EEXIST;
         }
 
         node_t *node;
@@ -1348,7 +1558,7 @@ static int new_node(struct RAMFS *hdl,
                 sys_get_time(&tm);
 
                 node->name         = filename;
-                node->data.llist_t = NULL;
+                node->data.dir_t   = NULL;
                 node->gid          = 0;
                 node->uid          = 0;
                 node->mode         = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
@@ -1358,23 +1568,28 @@ static int new_node(struct RAMFS *hdl,
                 node->type         = type;
 
                 if (type == FILE_TYPE_DIR) {
-                        err = sys_llist_create(NULL, NULL, cast(llist_t**, &node->data));
+                        err = dir_create(&node->data.dir_t);
 
                 } else if (type == FILE_TYPE_PIPE) {
                         err = sys_pipe_create(cast(pipe_t**, &node->data));
                 }
 
                 if (!err) {
-                        if (sys_llist_push_back(parent->data.llist_t, node)) {
+                        err = dir_insert(parent->data.dir_t, pos, node);
+                        if (!err) {
                                 if (item) {
-                                        *item = sys_llist_size(parent->data.llist_t) - 1;
+                                        *item = pos;
                                 }
 
                                 *child = node;
 
                                 hdl->file_count++;
-                        } else {
-                                err = ENOMEM;
+
+                        } else if (type == FILE_TYPE_DIR) {
+                                dir_destroy(&node->data.dir_t);
+
+                        } else if (type == FILE_TYPE_PIPE) {
+                                sys_pipe_destroy(node->data.pipe_t);
                         }
                 }
 
@@ -1436,21 +1651,67 @@ static int add_node_to_open_files_list(struct RAMFS *hdl,
 //==============================================================================
 static void clear_regular_file(node_t *node)
 {
-        data_chain_t *chain = node->data.data_chain_t;
+        chunk_table_t *table = node->data.chunk_t;
+
+        if (table) {
+                for (size_t i = 0; i < table->capacity; i++) {
+                        if (table->chunk[i]) {
+                                sys_free(cast(void**, &table->chunk[i]));
+                        }
+                }
 
-        while (chain) {
-                data_chain_t *next = chain->next;
-                sys_free(cast(void**, &chain));
-                chain = next;
+                sys_free(cast(void**, &node->data.chunk_t));
         }
 
         node->size = 0;
-        node->data.data_chain_t = NULL;
 }
 
 //==============================================================================
 /**
- * @brief Function write data to regular file.
+ * @brief Function resize chunk table of regular file to contain selected
+ *        chunk. Table size is doubled to reduce number of reallocations.
+ *
+ * @param node                  file node
+ * @param idx                   chunk index that table must contain
+ *
+ * @retval One of errno value (errno.h)
+ */
+//==============================================================================
+static int grow_chunk_table(node_t *node, size_t idx)
+{
+        chunk_table_t *table    = node->data.chunk_t;
+        size_t         capacity = table ? table->capacity : 0;
+
+        if (idx < capacity) {
+                return ESUCC;
+        }
+
+        capacity = max(CHUNK_TABLE_MIN_CAPACITY, capacity * 2);
+        capacity = max(capacity, idx + 1);
+
+        chunk_table_t *new_table;
+        int err = sys_zalloc(sizeof(chunk_table_t) + (capacity * sizeof(u8_t*)),
+                             cast(void**, &new_table));
+        if (!err) {
+                new_table->capacity = capacity;
+
+                if (table) {
+                        memcpy(new_table->chunk, table->chunk,
+                               table->capacity * sizeof(u8_t*));
+
+                        sys_free(cast(void**, &node->data.chunk_t));
+                }
+
+                node->data.chunk_t = new_table;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function write data to regular file. Chunks are allocated only for
+ *        written area, so gap created by write beyond end of file is a hole.
  *
  * @param node                  node to write
  * @param src                   source buffer
@@ -1464,60 +1725,43 @@ static void clear_regular_file(node_t *node)
 static int write_regular_file(node_t *node, const u8_t *src,
                               size_t count, fpos_t fpos, size_t *wrcnt)
 {
-        int           err   = ESUCC;
-        data_chain_t *chain = node->data.data_chain_t;
-        size_t        depth = fpos / DATA_CHAIN_SIZE;
-        size_t        seek  = fpos - (depth * DATA_CHAIN_SIZE);
+        int    err  = ESUCC;
+        size_t idx  = fpos / CHUNK_SIZE;
+        size_t seek = fpos % CHUNK_SIZE;
 
-        if (chain == NULL) {
-                err = sys_zalloc(sizeof(data_chain_t), cast(void**, &chain));
-                if (!err) {
-                        node->data.data_chain_t = chain;
-                }
+        if (count > 0) {
+                err = grow_chunk_table(node, (fpos + count - 1) / CHUNK_SIZE);
         }
 
-        // travel to selected chain
-        while (!err && depth) {
-                if (chain->next == NULL) {
-                        err = sys_zalloc(sizeof(data_chain_t),
-                                         cast(void**, &chain->next));
-                }
+        while (!err && count) {
+                u8_t **chunk = &node->data.chunk_t->chunk[idx];
 
-                chain = chain->next;
-                depth--;
-        }
+                if (*chunk == NULL) {
+                        err = sys_zalloc(CHUNK_SIZE, cast(void**, chunk));
+                        if (err) {
+                                break;
+                        }
+                }
 
-        // at position
-        while (!err && count) {
-                size_t tocpy = min(DATA_CHAIN_SIZE - seek, count);
-                memcpy(&chain->buf[seek], src, tocpy);
+                size_t tocpy = min(CHUNK_SIZE - seek, count);
+                memcpy(&(*chunk)[seek], src, tocpy);
                 src    += tocpy;
                 fpos   += tocpy;
                 *wrcnt += tocpy;
                 count  -= tocpy;
                 seek    = 0;
-
-                if (count) {
-                        if (chain->next == NULL) {
-                                err = sys_zalloc(sizeof(data_chain_t),
-                                                 cast(void**, &chain->next));
-                        }
-
-                        chain = chain->next;
-                }
+                idx++;
         }
 
         // calculate file size
-        if (depth == 0) {
-                node->size = max(node->size, fpos);
-        }
+        node->size = max(node->size, fpos);
 
         return err;
 }
 
 //==============================================================================
 /**
- * @brief Function read data from regular file.
+ * @brief Function read data from regular file. Holes are read as zeros.
  *
  * @param node                  node to read
  * @param dst                   destination buffer
@@ -1531,29 +1775,29 @@ static int write_regular_file(node_t *node, const u8_t *src,
 static int read_regular_file(node_t *node, u8_t *dst,
                              size_t count, fpos_t fpos, size_t *rdcnt)
 {
-        int err = ESUCC;
-
-        data_chain_t *chain = node->data.data_chain_t;
-        size_t        depth = fpos / DATA_CHAIN_SIZE;
-        size_t        seek  = fpos - (depth * DATA_CHAIN_SIZE);
-
-        for (; chain && depth; chain = chain->next, depth--);
+        chunk_table_t *table = node->data.chunk_t;
+        size_t         idx   = fpos / CHUNK_SIZE;
+        size_t         seek  = fpos % CHUNK_SIZE;
 
-        while (chain && count && fpos < node->size) {
-                size_t tocpy = min(DATA_CHAIN_SIZE - seek, count);
+        while (table && count && fpos < node->size) {
+                size_t tocpy = min(CHUNK_SIZE - seek, count);
                        tocpy = min(tocpy, node->size - fpos);
 
-                memcpy(dst, &chain->buf[seek], tocpy);
+                if (idx < table->capacity && table->chunk[idx]) {
+                        memcpy(dst, &table->chunk[idx][seek], tocpy);
+                } else {
+                        memset(dst, 0, tocpy);
+                }
+
                 dst    += tocpy;
                 fpos   += tocpy;
                 *rdcnt += tocpy;
                 count  -= tocpy;
                 seek    = 0;
-
-                chain = chain->next;
+                idx++;
         }
 
-        return err;
+        return ESUCC;
 }
 
 /*==============================================================================
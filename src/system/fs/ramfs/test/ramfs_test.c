@@ -0,0 +1,368 @@
+/*=========================================================================*//**
+File     ramfs_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test and microbenchmark of RAM file system.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Files are created in random name order in one directory. Test checks that
+ * directory is read in sorted order and that each file is found, sparse file
+ * written at random positions reads holes as zeros, truncate releases file
+ * chunks and FIFO forwards data. Time of file creation, lookup and random
+ * reads is printed. Tested file is included to use file system structures.
+ * Number of read and written bytes is cleared by caller as VFS does.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "../ramfs.c"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define FILES                   1000
+#define LOOKUPS                 20000
+#define FILE_LEN                (64 * 1024)
+#define RANDOM_WRITES           300
+#define RANDOM_READS            20000
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static int  mtx;
+static int  sem_count[4];
+static int  sem_used;
+static u8_t ref[FILE_LEN];
+static u8_t buf[FILE_LEN];
+
+/*==============================================================================
+  Kernel services
+==============================================================================*/
+int sys_mutex_create(enum mutex_type type, mutex_t **mtx)
+{
+        return _kmalloc(_MM_KRN, sizeof(int), cast(void**, mtx));
+}
+
+int sys_mutex_destroy(mutex_t *mtx)
+{
+        return _kfree(_MM_KRN, cast(void**, &mtx));
+}
+
+int _mutex_create(enum mutex_type type, mutex_t **m)
+{
+        *m = cast(mutex_t*, &mtx);
+        return ESUCC;
+}
+
+int _mutex_destroy(mutex_t *mtx)
+{
+        return ESUCC;
+}
+
+int _mutex_lock(mutex_t *mtx, const u32_t timeout)
+{
+        return ESUCC;
+}
+
+int _mutex_unlock(mutex_t *mtx)
+{
+        return ESUCC;
+}
+
+int _semaphore_create(size_t cnt_max, size_t cnt_init, sem_t **sem)
+{
+        HT_CHECK(sem_used < cast(int, ARRAY_SIZE(sem_count)));
+        sem_count[sem_used] = cnt_init;
+        *sem = cast(sem_t*, &sem_count[sem_used++]);
+        return ESUCC;
+}
+
+int _semaphore_destroy(sem_t *sem)
+{
+        sem_used--;
+        return ESUCC;
+}
+
+int _semaphore_wait(sem_t *sem, const u32_t timeout)
+{
+        int *count = cast(int*, sem);
+        if (*count > 0) {
+                (*count)--;
+                return ESUCC;
+        }
+
+        return ETIME;
+}
+
+int _semaphore_signal(sem_t *sem)
+{
+        *cast(int*, sem) = 1;
+        return ESUCC;
+}
+
+void _poll_notify(_poll_list_t *list, const void *obj)
+{
+}
+
+int _gettime(time_t *timer)
+{
+        *timer = 12345;
+        return ESUCC;
+}
+
+size_t _mm_get_mem_free(void)
+{
+        return 1024 * 1024;
+}
+
+size_t _mm_get_mem_size(void)
+{
+        return 2 * 1024 * 1024;
+}
+
+int _driver_stat(dev_t dev, struct vfs_dev_stat *stat)
+{
+        return ENODEV;
+}
+
+int _drvinst_open(dev_t dev, u32_t mode, drvinst_t **drvinst)
+{
+        return ENODEV;
+}
+
+int _drvinst_close(drvinst_t *drvinst, bool force)
+{
+        return ENODEV;
+}
+
+int _drvinst_write(drvinst_t *drvinst, const u8_t *src, size_t count, fpos_t *fpos, size_t *wrcnt, struct vfs_fattr fattr)
+{
+        return ENODEV;
+}
+
+int _drvinst_read(drvinst_t *drvinst, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt, struct vfs_fattr fattr)
+{
+        return ENODEV;
+}
+
+int _drvinst_ioctl(drvinst_t *drvinst, int request, void *arg)
+{
+        return ENODEV;
+}
+
+int _drvinst_flush(drvinst_t *drvinst)
+{
+        return ENODEV;
+}
+
+int _drvinst_stat(drvinst_t *drvinst, struct vfs_dev_stat *stat)
+{
+        return ENODEV;
+}
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Return path of selected file.
+ */
+//==============================================================================
+static const char *file_path(int n)
+{
+        static char path[16] = "/d/f0000";
+
+        for (int i = 7; i >= 4; i--) {
+                path[i] = '0' + (n % 10);
+                n /= 10;
+        }
+
+        return path;
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        struct vfs_fattr fattr = {.non_blocking_rd = true, .non_blocking_wr = true};
+        struct stat      stat;
+        void            *fs;
+        void            *f;
+        fpos_t           pos;
+        size_t           n;
+
+        HT_CHECK_OK(_ramfs_init(&fs, "", NULL));
+        long blocks = ht_mem_blocks();
+
+        HT_CHECK_OK(_ramfs_mkdir(fs, "/d", 0777));
+        HT_CHECK(_ramfs_mkdir(fs, "/d", 0777) == EEXIST);
+
+        // file creation, names are not created in sorted order
+        unsigned long long t_create = ht_clock_us();
+
+        for (int i = 0; i < FILES; i++) {
+                int k = (i * 7919) % FILES;
+                HT_CHECK_OK(_ramfs_open(fs, &f, &pos, file_path(k), O_CREAT | O_RDWR));
+
+                pos = 0;
+                n = 0;
+                HT_CHECK_OK(_ramfs_write(fs, f, cast(u8_t*, &k), sizeof(k), &pos, &n, fattr));
+                HT_CHECK_OK(_ramfs_close(fs, f, false));
+        }
+
+        t_create = ht_clock_us() - t_create;
+
+        // directory is read in sorted order
+        DIR dir;
+        HT_CHECK_OK(_ramfs_opendir(fs, "/d", &dir));
+        HT_CHECK(dir.d_items == FILES);
+
+        for (int i = 0; i < FILES; i++) {
+                HT_CHECK_OK(_ramfs_readdir(fs, &dir));
+                HT_CHECK(strcmp(dir.dirent.name, file_path(i) + 3) == 0);
+                HT_CHECK(dir.dirent.size == sizeof(int));
+        }
+
+        HT_CHECK(_ramfs_readdir(fs, &dir) == ENOENT);
+        HT_CHECK_OK(_ramfs_closedir(fs, &dir));
+
+        // lookup
+        ht_srand(5);
+        unsigned long long t_lookup = ht_clock_us();
+
+        for (int i = 0; i < LOOKUPS; i++) {
+                HT_CHECK_OK(_ramfs_stat(fs, file_path(ht_rand() % FILES), &stat));
+                HT_CHECK(stat.st_size == sizeof(int));
+        }
+
+        t_lookup = ht_clock_us() - t_lookup;
+
+        HT_CHECK(_ramfs_stat(fs, "/d/f", &stat) == ENOENT);
+        HT_CHECK(_ramfs_stat(fs, "/d/f00000", &stat) == ENOENT);
+        HT_CHECK(_ramfs_stat(fs, "/d/f0001/x", &stat) == ENOENT);
+
+        // sparse file written at random positions
+        HT_CHECK_OK(_ramfs_open(fs, &f, &pos, "/big", O_CREAT | O_RDWR));
+
+        for (int i = 0; i < RANDOM_WRITES; i++) {
+                u32_t off = ht_rand() % (FILE_LEN - 200);
+                u32_t len = 1 + ht_rand() % 200;
+
+                for (u32_t j = 0; j < len; j++) {
+                        ref[off + j] = 1 + ht_rand() % 255;
+                }
+
+                pos = off;
+                n = 0;
+                HT_CHECK_OK(_ramfs_write(fs, f, &ref[off], len, &pos, &n, fattr));
+                HT_CHECK(n == len);
+        }
+
+        HT_CHECK_OK(_ramfs_fstat(fs, f, &stat));
+        size_t size = stat.st_size;
+
+        node_t *node = cast(struct opened_file_info*, f)->child;
+        size_t  chunks = 0;
+        for (size_t i = 0; i < node->data.chunk_t->capacity; i++) {
+                chunks += node->data.chunk_t->chunk[i] ? 1 : 0;
+        }
+
+        HT_CHECK(chunks < (size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+        // random reads, holes are zeros
+        unsigned long long t_read = ht_clock_us();
+
+        for (int i = 0; i < RANDOM_READS; i++) {
+                u32_t off = ht_rand() % FILE_LEN;
+                u32_t len = 1 + ht_rand() % 512;
+
+                pos = off;
+                n = 0;
+                HT_CHECK_OK(_ramfs_read(fs, f, buf, len, &pos, &n, fattr));
+                HT_CHECK(n == ((off >= size) ? 0 : min(len, size - off)));
+                HT_CHECK(memcmp(buf, &ref[off], n) == 0);
+        }
+
+        t_read = ht_clock_us() - t_read;
+
+        HT_CHECK_OK(_ramfs_close(fs, f, false));
+
+        // truncate releases file chunks
+        long file_blocks = ht_mem_blocks();
+        HT_CHECK_OK(_ramfs_open(fs, &f, &pos, "/big", O_RDWR | O_TRUNC));
+        HT_CHECK_OK(_ramfs_fstat(fs, f, &stat));
+        HT_CHECK(stat.st_size == 0);
+        HT_CHECK_OK(_ramfs_close(fs, f, false));
+        HT_CHECK(ht_mem_blocks() == file_blocks - cast(long, chunks) - 1);
+        HT_CHECK_OK(_ramfs_remove(fs, "/big"));
+
+        // FIFO
+        HT_CHECK_OK(_ramfs_mkfifo(fs, "/p", 0666));
+        HT_CHECK_OK(_ramfs_open(fs, &f, &pos, "/p", O_RDWR));
+        n = 0;
+        HT_CHECK_OK(_ramfs_write(fs, f, cast(u8_t*, "fifo"), 4, &pos, &n, fattr));
+        HT_CHECK(n == 4);
+        n = 0;
+        HT_CHECK_OK(_ramfs_read(fs, f, buf, sizeof(buf), &pos, &n, fattr));
+        HT_CHECK(n == 4 && memcmp(buf, "fifo", 4) == 0);
+        HT_CHECK_OK(_ramfs_close(fs, f, false));
+        HT_CHECK_OK(_ramfs_remove(fs, "/p"));
+
+        // all nodes are released
+        HT_CHECK(_ramfs_remove(fs, "/d") == ENOTEMPTY);
+
+        for (int i = 0; i < FILES; i++) {
+                HT_CHECK_OK(_ramfs_remove(fs, file_path(i)));
+        }
+
+        HT_CHECK_OK(_ramfs_remove(fs, "/d"));
+        // root directory keeps allocated index table
+        HT_CHECK(ht_mem_blocks() == blocks + 1);
+
+        // file system release is not supported, handle is freed by test
+        struct RAMFS *hdl = fs;
+        dir_destroy(&hdl->root_dir.data.dir_t);
+        sys_llist_destroy(hdl->opended_files);
+        sys_mutex_destroy(hdl->resource_mtx);
+        sys_free(&fs);
+        HT_CHECK(ht_mem_blocks() == 0);
+
+        ht_print("ramfs: create %d files %llu us, %d lookups %llu us, "
+                 "%d random reads %llu us\n",
+                 FILES, t_create, LOOKUPS, t_lookup, RANDOM_READS, t_read);
+
+        ht_print("ramfs: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
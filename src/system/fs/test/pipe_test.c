@@ -0,0 +1,331 @@
+/*=========================================================================*//**
+File     pipe_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test and throughput benchmark of pipes.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Test is single threaded: semaphores are counters and waiting on not
+ * signaled semaphore times out, thus blocking read or write returns when
+ * it would block. Test checks byte order through the ring buffer wrap,
+ * partial reads and writes, EOF after close, clear and poll events.
+ * Throughput of write/read pairs is printed for several chunk sizes.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "config.h"
+#include "kernel/kwrapper.h"
+#include "fs/pipe.h"
+#include "kernel/kpoll.h"
+#include "kernel/errno.h"
+#include "dnx/misc.h"
+#include "lib/cast.h"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define PIPE_LENGTH             __OS_PIPE_LENGTH__
+#define RANDOM_OPS              20000
+#define BENCH_BYTES             (4 * 1024 * 1024)
+#define SEM_COUNT               4
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static struct sem {
+        int     count;
+        bool    used;
+} sem_pool[SEM_COUNT];
+
+static struct mtx {
+        bool    locked;
+        bool    used;
+} mtx_pool[SEM_COUNT];
+
+static u32_t notifications;
+
+/*==============================================================================
+  Kernel services
+==============================================================================*/
+int _semaphore_create(size_t cnt_max, size_t cnt_init, sem_t **sem)
+{
+        for (int i = 0; i < SEM_COUNT; i++) {
+                if (!sem_pool[i].used) {
+                        sem_pool[i].used  = true;
+                        sem_pool[i].count = cnt_init;
+                        *sem = cast(sem_t*, &sem_pool[i]);
+                        return ESUCC;
+                }
+        }
+
+        return ENOMEM;
+}
+
+int _semaphore_destroy(sem_t *sem)
+{
+        cast(struct sem*, sem)->used = false;
+        return ESUCC;
+}
+
+int _semaphore_wait(sem_t *sem, const u32_t timeout)
+{
+        struct sem *s = cast(struct sem*, sem);
+        if (s->count > 0) {
+                s->count--;
+                return ESUCC;
+        }
+
+        return ETIME;
+}
+
+int _semaphore_signal(sem_t *sem)
+{
+        cast(struct sem*, sem)->count = 1;
+        return ESUCC;
+}
+
+int _mutex_create(enum mutex_type type, mutex_t **mtx)
+{
+        for (int i = 0; i < SEM_COUNT; i++) {
+                if (!mtx_pool[i].used) {
+                        mtx_pool[i].used   = true;
+                        mtx_pool[i].locked = false;
+                        *mtx = cast(mutex_t*, &mtx_pool[i]);
+                        return ESUCC;
+                }
+        }
+
+        return ENOMEM;
+}
+
+int _mutex_destroy(mutex_t *mtx)
+{
+        HT_CHECK(!cast(struct mtx*, mtx)->locked);
+        cast(struct mtx*, mtx)->used = false;
+        return ESUCC;
+}
+
+int _mutex_lock(mutex_t *mtx, const u32_t timeout)
+{
+        HT_CHECK(!cast(struct mtx*, mtx)->locked);
+        cast(struct mtx*, mtx)->locked = true;
+        return ESUCC;
+}
+
+int _mutex_unlock(mutex_t *mtx)
+{
+        HT_CHECK(cast(struct mtx*, mtx)->locked);
+        cast(struct mtx*, mtx)->locked = false;
+        return ESUCC;
+}
+
+void _poll_notify(_poll_list_t *list, const void *obj)
+{
+        notifications++;
+}
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Return pipe events.
+ */
+//==============================================================================
+static u32_t events(pipe_t *pipe)
+{
+        u32_t ev;
+        HT_CHECK_OK(_pipe_poll(pipe, &ev, NULL));
+        return ev;
+}
+
+//==============================================================================
+/**
+ * @brief  Return number of bytes in pipe.
+ */
+//==============================================================================
+static size_t length(pipe_t *pipe)
+{
+        size_t len;
+        HT_CHECK_OK(_pipe_get_length(pipe, &len));
+        return len;
+}
+
+//==============================================================================
+/**
+ * @brief  Transfer bytes by write/read pairs of selected chunk size.
+ *
+ * @return Transfer time [us].
+ */
+//==============================================================================
+static unsigned long long bench(pipe_t *pipe, size_t chunk)
+{
+        static u8_t src[PIPE_LENGTH];
+        static u8_t dst[PIPE_LENGTH];
+        size_t      n;
+
+        unsigned long long t = ht_clock_us();
+
+        for (u32_t i = 0; i < BENCH_BYTES; i += chunk) {
+                _pipe_write(pipe, src, chunk, &n, false);
+                _pipe_read(pipe, dst, chunk, &n, false);
+        }
+
+        return ht_clock_us() - t;
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        static u8_t buf[PIPE_LENGTH * 2];
+        pipe_t     *pipe;
+        size_t      n;
+
+        HT_CHECK(_pipe_create(NULL) == EINVAL);
+        HT_CHECK_OK(_pipe_create(&pipe));
+
+        // empty pipe, read would block
+        HT_CHECK(events(pipe) == POLLOUT);
+        HT_CHECK_OK(_pipe_read(pipe, buf, 10, &n, true));
+        HT_CHECK(n == 0);
+        HT_CHECK_OK(_pipe_read(pipe, buf, 10, &n, false));
+        HT_CHECK(n == 0);
+        HT_CHECK(_pipe_read(pipe, buf, 0, &n, false) == EINVAL);
+
+        // partial write of full pipe
+        for (size_t i = 0; i < sizeof(buf); i++) {
+                buf[i] = i;
+        }
+
+        HT_CHECK_OK(_pipe_write(pipe, buf, sizeof(buf), &n, false));
+        HT_CHECK(n == PIPE_LENGTH);
+        HT_CHECK(length(pipe) == PIPE_LENGTH);
+        HT_CHECK(events(pipe) == POLLIN);
+
+        HT_CHECK_OK(_pipe_write(pipe, buf, 1, &n, true));
+        HT_CHECK(n == 0);
+
+        // partial read returns available data
+        HT_CHECK_OK(_pipe_read(pipe, buf, 10, &n, false));
+        HT_CHECK(n == 10);
+        for (size_t i = 0; i < n; i++) {
+                HT_CHECK(buf[i] == i);
+        }
+
+        HT_CHECK_OK(_pipe_read(pipe, buf, sizeof(buf), &n, false));
+        HT_CHECK(n == PIPE_LENGTH - 10);
+        for (size_t i = 0; i < n; i++) {
+                HT_CHECK(buf[i] == 10 + i);
+        }
+
+        HT_CHECK(length(pipe) == 0);
+
+        // byte order is kept through ring buffer wrap
+        u32_t wr_seq = 0;
+        u32_t rd_seq = 0;
+
+        ht_srand(4);
+        for (int op = 0; op < RANDOM_OPS; op++) {
+                size_t len = 1 + ht_rand() % PIPE_LENGTH;
+
+                if (ht_rand() % 2) {
+                        for (size_t i = 0; i < len; i++) {
+                                buf[i] = wr_seq + i;
+                        }
+
+                        size_t space = PIPE_LENGTH - length(pipe);
+                        HT_CHECK_OK(_pipe_write(pipe, buf, len, &n, true));
+                        HT_CHECK(n == min(len, space));
+                        wr_seq += n;
+
+                } else {
+                        size_t data = length(pipe);
+                        HT_CHECK_OK(_pipe_read(pipe, buf, len, &n, true));
+                        HT_CHECK(n == min(len, data));
+
+                        for (size_t i = 0; i < n; i++) {
+                                HT_CHECK(buf[i] == cast(u8_t, rd_seq + i));
+                        }
+
+                        rd_seq += n;
+                }
+
+                HT_CHECK(length(pipe) == wr_seq - rd_seq);
+        }
+
+        HT_CHECK(rd_seq > RANDOM_OPS);
+
+        // clear drops data
+        HT_CHECK_OK(_pipe_clear(pipe));
+        HT_CHECK(length(pipe) == 0);
+
+        // remaining data is read after close, then EOF
+        HT_CHECK_OK(_pipe_write(pipe, buf, 20, &n, false));
+        HT_CHECK(n == 20);
+        HT_CHECK_OK(_pipe_close(pipe));
+        HT_CHECK(events(pipe) == (POLLIN | POLLHUP));
+
+        HT_CHECK_OK(_pipe_write(pipe, buf, 5, &n, false));
+        HT_CHECK(n == 0);
+
+        HT_CHECK_OK(_pipe_read(pipe, buf, sizeof(buf), &n, false));
+        HT_CHECK(n == 20);
+        HT_CHECK_OK(_pipe_read(pipe, buf, sizeof(buf), &n, false));
+        HT_CHECK(n == 0);
+        HT_CHECK(events(pipe) == (POLLIN | POLLHUP));
+
+        HT_CHECK(notifications > 0);
+        HT_CHECK_OK(_pipe_destroy(pipe));
+
+        // throughput
+        static const size_t chunk[] = {1, 4, 16, PIPE_LENGTH};
+
+        for (size_t i = 0; i < ARRAY_SIZE(chunk); i++) {
+                HT_CHECK_OK(_pipe_create(&pipe));
+                unsigned long long t = bench(pipe, chunk[i]);
+                HT_CHECK(length(pipe) == 0);
+                HT_CHECK_OK(_pipe_destroy(pipe));
+
+                ht_print("pipe: %u byte chunks, %u bytes in %llu us\n",
+                         cast(unsigned, chunk[i]), BENCH_BYTES, t);
+        }
+
+        HT_CHECK(ht_mem_blocks() == 0);
+
+        ht_print("pipe: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
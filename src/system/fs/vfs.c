@@ -37,13 +37,18 @@
 #include "lib/llist.h"
 #include "kernel/kwrapper.h"
 #include "kernel/process.h"
+#include "kernel/kpoll.h"
 #include "mm/cache.h"
+#include "mm/slab.h"
 
 /*==============================================================================
   Local symbolic constants/macros
 ==============================================================================*/
 #undef errno
 #define PATH_MAX_LEN             256
+#define FILE_BUF_FLUSH_TIMEOUT   1000
+#define COPY_BUF_MAX_SIZE        4096
+#define COPY_BUF_MIN_SIZE        512
 
 /*==============================================================================
   Local types, enums definitions
@@ -63,6 +68,10 @@ static bool         is_first_fs             (const char *mount_point);
 static int          new_FS_entry            (FS_entry_t *parent_FS, const char *fs_mount_point, const char *fs_src_file, const vfs_FS_itf_t *fs_interface, const char *opts, FS_entry_t **fs_entry);
 static int          delete_FS_entry         (FS_entry_t *this);
 static bool         is_file_valid           (FILE *file);
+static void         file_buf_sync           (FILE *file);
+static void         file_buf_free           (FILE *file);
+static void         file_buf_get_owner      (pid_t *pid, tid_t *tid);
+static void         file_buf_unlink         (struct vfs_file_buf *fbuf);
 static bool         is_dir_valid            (DIR *dir);
 static int          increase_task_priority  (void);
 static inline void  restore_priority        (int priority);
@@ -77,6 +86,9 @@ static int          new_absolute_path       (const struct vfs_path *path, enum p
 static struct {
         llist_t *mnt_list;
         mutex_t *resource_mtx;
+        _slab_t *file_slab;
+        _slab_t *dir_slab;
+        struct vfs_file_buf *fbuf_locked;
 } VFS;
 
 /*==============================================================================
@@ -97,6 +109,14 @@ int _vfs_init(void)
                 err = _mutex_create(MUTEX_TYPE_RECURSIVE, &VFS.resource_mtx);
         }
 
+        if (!err) {
+                err = _slab_create("file", sizeof(FILE), 0, _MM_KRN, &VFS.file_slab);
+        }
+
+        if (!err) {
+                err = _slab_create("dir", sizeof(DIR), 0, _MM_KRN, &VFS.dir_slab);
+        }
+
         return err;
 }
 
@@ -462,7 +482,7 @@ int _vfs_opendir(const struct vfs_path *path, DIR **dir)
                 return EINVAL;
         }
 
-        int err = _kmalloc(_MM_KRN, sizeof(DIR), cast(void**, dir));
+        int err = _slab_alloc(VFS.dir_slab, cast(void**, dir));
         if (!err) {
                 char *cwd_path;
                 err = new_absolute_path(path, ADD_SLASH, &cwd_path);
@@ -487,7 +507,7 @@ int _vfs_opendir(const struct vfs_path *path, DIR **dir)
                 if (!err) {
                         (*dir)->header.type = RES_TYPE_DIR;
                 } else {
-                        _kfree(_MM_KRN, cast(void**, dir));
+                        _slab_free(VFS.dir_slab, cast(void**, dir));
                 }
         }
 
@@ -511,7 +531,7 @@ int _vfs_closedir(DIR *dir)
                 err = dir->FS_if->fs_closedir(dir->FS_hdl, dir);
                 if (!err) {
                         dir->header.type = RES_TYPE_UNKNOWN;
-                        _kfree(_MM_KRN, cast(void**, &dir));
+                        _slab_free(VFS.dir_slab, cast(void**, &dir));
                 }
         }
 
@@ -903,7 +923,7 @@ int _vfs_fopen(const struct vfs_path *path, const char *mode, FILE **file)
         }
 
         FILE *file_obj = NULL;
-        err = _kzalloc(_MM_KRN, sizeof(FILE), cast(void**, &file_obj));
+        err = _slab_alloc(VFS.file_slab, cast(void**, &file_obj));
         if (!err && file_obj) {
 
                 const char *external_path;
@@ -938,6 +958,8 @@ int _vfs_fopen(const struct vfs_path *path, const char *mode, FILE **file)
                                         file_obj->f_lseek = stat.st_size;
                                 }
 
+                                f_flags.regular = (stat.st_type == FILE_TYPE_REGULAR);
+
                                 file_obj->FS_hdl      = fs->handle;
                                 file_obj->FS_if       = fs->interface;
                                 file_obj->f_flag      = f_flags;
@@ -956,7 +978,7 @@ int _vfs_fopen(const struct vfs_path *path, const char *mode, FILE **file)
                 if (file_obj->header.type == RES_TYPE_FILE) {
                         *file = file_obj;
                 } else {
-                        _kfree(_MM_KRN, cast(void**, &file_obj));
+                        _slab_free(VFS.file_slab, cast(void**, &file_obj));
                 }
         }
 
@@ -978,12 +1000,20 @@ int _vfs_fclose(FILE *file, bool force)
         int err = EINVAL;
 
         if (is_file_valid(file) && file->FS_if->fs_close) {
+                struct vfs_file_buf *fbuf = file->f_buf;
+
+                if (fbuf && _vfs_fbuf_lock(fbuf, FILE_BUF_FLUSH_TIMEOUT) == ESUCC) {
+                        file_buf_sync(file);
+                        _vfs_fbuf_unlock(fbuf);
+                }
+
                 err = file->FS_if->fs_close(file->FS_hdl, file->f_hdl, force);
                 if (!err) {
+                        file_buf_free(file);
                         file->header.type = RES_TYPE_UNKNOWN;
                         file->FS_hdl      = NULL;
                         file->FS_hdl      = NULL;
-                        _kfree(_MM_KRN, cast(void**, &file));
+                        _slab_free(VFS.file_slab, cast(void**, &file));
                 }
         }
 
@@ -1088,6 +1118,85 @@ int _vfs_fread(void *ptr, size_t size, size_t *rdcnt, FILE *file)
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Function copy data between files. Data is transferred by kernel
+ *        buffer, thus one request copies entire range. Copy is finished when
+ *        requested number of bytes is copied, end of source file is reached,
+ *        or destination file is full. Source must be a regular file: data not
+ *        accepted by destination is read again at the next copy, so source
+ *        position is moved back by not written bytes.
+ *
+ * @param[in]  src              source file
+ * @param[in]  dst              destination file
+ * @param[in]  count            number of bytes to copy
+ * @param[out] copied           number of copied bytes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_fcopy(FILE *src, FILE *dst, size_t count, size_t *copied)
+{
+        if (!is_file_valid(src) || !is_file_valid(dst) || src == dst || !copied) {
+                return EINVAL;
+        }
+
+        *copied = 0;
+
+        if (count == 0) {
+                return ESUCC;
+        }
+
+        // position of devices and pipes cannot be restored
+        struct stat stat;
+        int err = _vfs_fstat(src, &stat);
+        if (err) {
+                return err;
+
+        } else if (stat.st_type != FILE_TYPE_REGULAR) {
+                return ESPIPE;
+        }
+
+        u8_t  *buf  = NULL;
+        size_t size = (count < COPY_BUF_MAX_SIZE) ? count : COPY_BUF_MAX_SIZE;
+
+        while ((err = _kmalloc(_MM_FS, size, cast(void**, &buf))) != ESUCC) {
+                if (size <= COPY_BUF_MIN_SIZE) {
+                        return err;
+                }
+
+                size /= 2;
+        }
+
+        while (*copied < count) {
+                size_t chunk = count - *copied;
+                chunk = (chunk < size) ? chunk : size;
+
+                size_t rdcnt = 0;
+                err = _vfs_fread(buf, chunk, &rdcnt, src);
+                if (err || rdcnt == 0) {
+                        break;
+                }
+
+                size_t wrcnt = 0;
+                err = _vfs_fwrite(buf, rdcnt, &wrcnt, dst);
+                *copied += wrcnt;
+
+                if (wrcnt < rdcnt) {
+                        int serr = _vfs_fseek(src, -cast(i64_t, rdcnt - wrcnt), VFS_SEEK_CUR);
+                        err = err ? err : serr;
+                }
+
+                if (err || wrcnt < rdcnt || rdcnt < chunk) {
+                        break;
+                }
+        }
+
+        _kfree(_MM_FS, cast(void**, &buf));
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief Function set seek value
@@ -1229,6 +1338,45 @@ int _vfs_fstat(FILE *file, struct stat *stat)
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Function returns file events. Events are obtained from file system
+ *        (pipes) or driver by using @ref IOCTL_VFS__POLL request. Files that
+ *        not support this request are always ready.
+ *
+ * @param[in]  *file            file object
+ * @param[out] *events          file events (POLLIN, POLLOUT, ...)
+ * @param[in]  *entry           waiter entry linked to file wait list (can be NULL)
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_fpoll(FILE *file, u32_t *events, struct _poll_entry *entry)
+{
+        if (is_file_valid(file) && events) {
+                struct vfs_poll poll = {.events = 0, .entry = entry};
+
+                int err = file->FS_if->fs_ioctl(file->FS_hdl, file->f_hdl,
+                                                IOCTL_VFS__POLL, &poll);
+
+                *events = err ? (POLLIN | POLLOUT) : poll.events;
+
+                // buffer locked by other thread is skipped (I/O in progress)
+                struct vfs_file_buf *fbuf = file->f_buf;
+                if (fbuf && _vfs_fbuf_lock(fbuf, 0) == ESUCC) {
+                        if (!fbuf->wr && fbuf->pos < fbuf->len) {
+                                *events |= POLLIN;
+                        }
+
+                        _vfs_fbuf_unlock(fbuf);
+                }
+
+                return ESUCC;
+        } else {
+                return EINVAL;
+        }
+}
+
 //==============================================================================
 /**
  * @brief Function flush file data
@@ -1253,6 +1401,229 @@ int _vfs_fflush(FILE *file)
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Function set file stream buffer. Buffer is used by stdio library
+ *        to reduce number of system calls. Data to write is written and
+ *        read-ahead data is dropped before buffer change. Buffer memory is
+ *        always allocated by VFS because file can be shared by processes
+ *        and can outlive the process that set the buffer.
+ *
+ * @param[in] *file     file
+ * @param[in]  mode     buffer mode (VFS_BUF_FULL, VFS_BUF_LINE, VFS_BUF_NONE,
+ *                      or VFS_BUF_DEFAULT: full buffering for regular files,
+ *                      line buffering for other)
+ * @param[in]  size     buffer size
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_fsetvbuf(FILE *file, int mode, size_t size)
+{
+        if (  !is_file_valid(file)
+           || mode < VFS_BUF_FULL || mode > VFS_BUF_DEFAULT
+           || (mode != VFS_BUF_NONE && size == 0) ) {
+
+                return EINVAL;
+        }
+
+        struct stat stat;
+        int err = _vfs_fstat(file, &stat);
+        if (err) {
+                return err;
+        }
+
+        if (mode == VFS_BUF_DEFAULT) {
+                mode = (stat.st_type == FILE_TYPE_REGULAR) ? VFS_BUF_FULL : VFS_BUF_LINE;
+        }
+
+        if (!file->f_buf) {
+                struct vfs_file_buf *fbuf;
+                err = _kzalloc(_MM_FS, sizeof(struct vfs_file_buf), cast(void**, &fbuf));
+                if (err) {
+                        return err;
+                }
+
+                err = _semaphore_create(1, 0, &fbuf->lock);
+                if (err) {
+                        _kfree(_MM_FS, cast(void**, &fbuf));
+                        return err;
+                }
+
+                file->f_buf = fbuf;
+        }
+
+        struct vfs_file_buf *fbuf = file->f_buf;
+
+        err = _vfs_fbuf_lock(fbuf, MAX_DELAY_MS);
+        if (!err) {
+                file_buf_sync(file);
+
+                if (fbuf->data) {
+                        _kfree(_MM_FS, cast(void**, &fbuf->data));
+                }
+
+                fbuf->data = NULL;
+                fbuf->size = 0;
+
+                if (mode != VFS_BUF_NONE) {
+                        err = _kmalloc(_MM_FS, size, cast(void**, &fbuf->data));
+                        if (!err) {
+                                fbuf->size = size;
+                        }
+                }
+
+                fbuf->mode   = err ? VFS_BUF_NONE : mode;
+                fbuf->stream = (stat.st_type != FILE_TYPE_REGULAR);
+                fbuf->rd     = (  stat.st_type == FILE_TYPE_REGULAR
+                               || stat.st_type == FILE_TYPE_PIPE );
+
+                _vfs_fbuf_unlock(fbuf);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function write data stored in file stream buffer. Function is used
+ *        by kernel when process exits.
+ *
+ * @param[in] *file     file
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_fbuf_flush(FILE *file)
+{
+        int err = EINVAL;
+
+        if (is_file_valid(file)) {
+                err = ESUCC;
+
+                struct vfs_file_buf *fbuf = file->f_buf;
+
+                if (fbuf && fbuf->wr) {
+                        err = _vfs_fbuf_lock(fbuf, FILE_BUF_FLUSH_TIMEOUT);
+                        if (!err) {
+                                file_buf_sync(file);
+                                _vfs_fbuf_unlock(fbuf);
+                        }
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function lock file stream buffer. Lock owner is recorded together
+ *        with lock, thus lock of killed thread is released by
+ *        _vfs_fbuf_release(). Semaphore only wakes up waiting threads.
+ *
+ * @param[in] *fbuf     file buffer
+ * @param[in]  timeout  lock timeout
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_fbuf_lock(struct vfs_file_buf *fbuf, u32_t timeout)
+{
+        if (!fbuf) {
+                return EINVAL;
+        }
+
+        pid_t pid = 0;
+        tid_t tid = 0;
+        file_buf_get_owner(&pid, &tid);
+
+        u32_t t0 = _kernel_get_time_ms();
+
+        for (;;) {
+                bool taken = false;
+
+                _kernel_scheduler_lock();
+                {
+                        if (!fbuf->locked) {
+                                fbuf->locked    = true;
+                                fbuf->lock_pid  = pid;
+                                fbuf->lock_tid  = tid;
+                                fbuf->lock_next = VFS.fbuf_locked;
+                                VFS.fbuf_locked = fbuf;
+                                taken = true;
+                        }
+                }
+                _kernel_scheduler_unlock();
+
+                if (taken) {
+                        return ESUCC;
+                }
+
+                u32_t elapsed = _kernel_get_time_ms() - t0;
+
+                if (timeout == MAX_DELAY_MS) {
+                        _semaphore_wait(fbuf->lock, MAX_DELAY_MS);
+
+                } else if (elapsed < timeout) {
+                        _semaphore_wait(fbuf->lock, timeout - elapsed);
+
+                } else {
+                        return ETIME;
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function unlock file stream buffer.
+ *
+ * @param[in] *fbuf     file buffer
+ */
+//==============================================================================
+void _vfs_fbuf_unlock(struct vfs_file_buf *fbuf)
+{
+        if (fbuf) {
+                _kernel_scheduler_lock();
+                {
+                        file_buf_unlink(fbuf);
+                }
+                _kernel_scheduler_unlock();
+
+                _semaphore_signal(fbuf->lock);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function release file stream buffers locked by killed thread or
+ *        process. Buffer data is left as is.
+ *
+ * @param[in] pid       process ID
+ * @param[in] tid       thread ID or VFS_ALL_THREADS
+ */
+//==============================================================================
+void _vfs_fbuf_release(pid_t pid, tid_t tid)
+{
+        _kernel_scheduler_lock();
+        {
+                struct vfs_file_buf *fbuf = VFS.fbuf_locked;
+
+                while (fbuf) {
+                        struct vfs_file_buf *next = fbuf->lock_next;
+
+                        if (  fbuf->lock_pid == pid
+                           && (tid == VFS_ALL_THREADS || fbuf->lock_tid == tid)) {
+
+                                file_buf_unlink(fbuf);
+                                _semaphore_signal(fbuf->lock);
+                        }
+
+                        fbuf = next;
+                }
+        }
+        _kernel_scheduler_unlock();
+}
+
 //==============================================================================
 /**
  * @brief Function check end of file
@@ -1443,6 +1814,107 @@ static bool is_file_valid(FILE *file)
                && file->FS_if->fs_magic == _VFS_FILE_SYSTEM_MAGIC_NO);
 }
 
+//==============================================================================
+/**
+ * @brief Function write data to write from file stream buffer and drop
+ *        read-ahead data (file position is moved back).
+ *
+ * @param file  file object
+ */
+//==============================================================================
+static void file_buf_sync(FILE *file)
+{
+        struct vfs_file_buf *fbuf = file->f_buf;
+
+        if (fbuf->wr) {
+                size_t wrcnt = 0;
+                if (fbuf->pos) {
+                        _vfs_fwrite(fbuf->data, fbuf->pos, &wrcnt, file);
+                }
+
+        } else if (fbuf->len > fbuf->pos && !fbuf->stream) {
+                _vfs_fseek(file, -cast(i64_t, fbuf->len - fbuf->pos), VFS_SEEK_CUR);
+        }
+
+        fbuf->wr  = false;
+        fbuf->pos = 0;
+        fbuf->len = 0;
+}
+
+//==============================================================================
+/**
+ * @brief Function free file stream buffer.
+ *
+ * @param file  file object
+ */
+//==============================================================================
+static void file_buf_free(FILE *file)
+{
+        struct vfs_file_buf *fbuf = file->f_buf;
+
+        if (fbuf) {
+                _kernel_scheduler_lock();
+                {
+                        file_buf_unlink(fbuf);
+                }
+                _kernel_scheduler_unlock();
+
+                _semaphore_destroy(fbuf->lock);
+
+                if (fbuf->data) {
+                        _kfree(_MM_FS, cast(void**, &fbuf->data));
+                }
+
+                _kfree(_MM_FS, cast(void**, &file->f_buf));
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function return process and thread of calling task.
+ *
+ * @param pid   process ID
+ * @param tid   thread ID
+ */
+//==============================================================================
+static void file_buf_get_owner(pid_t *pid, tid_t *tid)
+{
+        _process_t *proc = NULL;
+        _task_get_process_container(_THIS_TASK, &proc, tid);
+
+        if (_process_get_pid(proc, pid) != ESUCC) {
+                *pid = 0;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function remove file buffer from list of locked buffers and clear
+ *        lock. Function is called with scheduler locked.
+ *
+ * @param fbuf  file buffer
+ */
+//==============================================================================
+static void file_buf_unlink(struct vfs_file_buf *fbuf)
+{
+        if (fbuf->locked) {
+                struct vfs_file_buf **pp = &VFS.fbuf_locked;
+
+                while (*pp) {
+                        if (*pp == fbuf) {
+                                *pp = fbuf->lock_next;
+                                break;
+                        }
+
+                        pp = &(*pp)->lock_next;
+                }
+
+                fbuf->locked    = false;
+                fbuf->lock_next = NULL;
+                fbuf->lock_pid  = 0;
+        }
+}
+
 //==============================================================================
 /**
  * @brief Check if dir object is valid
@@ -93,6 +93,9 @@ struct _module_entry {
  */
 typedef pid_t dev_lock_t;
 
+/** opened driver instance (see _drvinst_open()) */
+typedef struct _drvinst drvinst_t;
+
 /*==============================================================================
   Exported objects
 ==============================================================================*/
@@ -109,6 +112,13 @@ extern int         _driver_read                   (dev_t, u8_t*, size_t, fpos_t*
 extern int         _driver_ioctl                  (dev_t, int, void*);
 extern int         _driver_flush                  (dev_t);
 extern int         _driver_stat                   (dev_t, struct vfs_dev_stat*);
+extern int         _drvinst_open                  (dev_t, u32_t, drvinst_t**);
+extern int         _drvinst_close                 (drvinst_t*, bool);
+extern int         _drvinst_write                 (drvinst_t*, const u8_t*, size_t, fpos_t*, size_t*, struct vfs_fattr);
+extern int         _drvinst_read                  (drvinst_t*, u8_t*, size_t, fpos_t*, size_t*, struct vfs_fattr);
+extern int         _drvinst_ioctl                 (drvinst_t*, int, void*);
+extern int         _drvinst_flush                 (drvinst_t*);
+extern int         _drvinst_stat                  (drvinst_t*, struct vfs_dev_stat*);
 extern int         _module_get_instance           (const char*, u8_t, u8_t, void**);
 extern const char *_module_get_name               (size_t);
 extern size_t      _module_get_count              (void);
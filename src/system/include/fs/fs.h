@@ -815,6 +815,146 @@ static inline int sys_driver_stat(dev_t id, struct vfs_dev_stat *stat)
         return _driver_stat(id, stat);
 }
 
+//==============================================================================
+/**
+ * @brief Function open selected driver and return driver instance. Instance
+ *        should be stored in file handle and used for next file operations.
+ *        Driver cannot be released until instance is closed.
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param id            module id
+ * @param flags         flags
+ * @param inst          driver instance
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_drvinst_open(dev_t id, u32_t flags, drvinst_t **inst)
+{
+        return _drvinst_open(id, flags, inst);
+}
+
+//==============================================================================
+/**
+ * @brief Function close driver instance
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param inst          driver instance
+ * @param force         force close request
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_drvinst_close(drvinst_t *inst, bool force)
+{
+        return _drvinst_close(inst, force);
+}
+
+//==============================================================================
+/**
+ * @brief Function write data to driver instance
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param inst          driver instance
+ * @param src           data source
+ * @param count         buffer size
+ * @param fpos          file position
+ * @param wrcnt         number of written bytes
+ * @param fattr         file attributes
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_drvinst_write(drvinst_t       *inst,
+                                    const u8_t      *src,
+                                    size_t           count,
+                                    fpos_t          *fpos,
+                                    size_t          *wrcnt,
+                                    struct vfs_fattr fattr)
+{
+        return _drvinst_write(inst, src, count, fpos, wrcnt, fattr);
+}
+
+//==============================================================================
+/**
+ * @brief Function read data from driver instance
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param inst          driver instance
+ * @param dst           data destination
+ * @param count         buffer size
+ * @param fpos          file position
+ * @param rdcnt         number of read bytes
+ * @param fattr         file attributes
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_drvinst_read(drvinst_t       *inst,
+                                   u8_t            *dst,
+                                   size_t           count,
+                                   fpos_t          *fpos,
+                                   size_t          *rdcnt,
+                                   struct vfs_fattr fattr)
+{
+        return _drvinst_read(inst, dst, count, fpos, rdcnt, fattr);
+}
+
+//==============================================================================
+/**
+ * @brief IO control of driver instance
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param inst          driver instance
+ * @param request       io request
+ * @param arg           argument
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_drvinst_ioctl(drvinst_t *inst, int request, void *arg)
+{
+        return _drvinst_ioctl(inst, request, arg);
+}
+
+//==============================================================================
+/**
+ * @brief Flush driver instance buffer (forces write)
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param inst          driver instance
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_drvinst_flush(drvinst_t *inst)
+{
+        return _drvinst_flush(inst);
+}
+
+//==============================================================================
+/**
+ * @brief Driver instance information
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param inst          driver instance
+ * @param stat          status object
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_drvinst_stat(drvinst_t *inst, struct vfs_dev_stat *stat)
+{
+        return _drvinst_stat(inst, stat);
+}
+
 //==============================================================================
 /**
  * @brief Create pipe object
@@ -936,6 +1076,23 @@ static inline int sys_pipe_clear(pipe_t *pipe)
         return _pipe_clear(pipe);
 }
 
+//==============================================================================
+/**
+ * @brief  Return pipe events (used by poll request @ref IOCTL_VFS__POLL)
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param  pipe         a pipe object
+ * @param  poll         poll request (events and waiter entry)
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_pipe_poll(pipe_t *pipe, struct vfs_poll *poll)
+{
+        return _pipe_poll(pipe, &poll->events, poll->entry);
+}
+
 //==============================================================================
 /**
  * @brief  Function return size of programs table (number of programs)
@@ -47,6 +47,7 @@ extern "C" {
   Exported object types
 ==============================================================================*/
 typedef struct pipe pipe_t;
+struct _poll_entry;
 
 /*==============================================================================
   Exported objects
@@ -62,6 +63,7 @@ extern int  _pipe_read      (pipe_t*, u8_t*, size_t, size_t*, bool);
 extern int  _pipe_write     (pipe_t*, const u8_t*, size_t, size_t*, bool);
 extern int  _pipe_close     (pipe_t*);
 extern int  _pipe_clear     (pipe_t*);
+extern int  _pipe_poll      (pipe_t*, u32_t*, struct _poll_entry*);
 
 /*==============================================================================
   Exported inline functions
@@ -55,6 +55,15 @@ extern "C" {
 /* set position to EOF plus offset */
 #define VFS_SEEK_END                            2
 
+/* file buffer modes (values are the same as _IOFBF, _IOLBF and _IONBF) */
+#define VFS_BUF_FULL                            0
+#define VFS_BUF_LINE                            1
+#define VFS_BUF_NONE                            2
+#define VFS_BUF_DEFAULT                         3       /* selected by file type */
+
+/* all threads of process (see _vfs_fbuf_release()) */
+#define VFS_ALL_THREADS                         UINT8_MAX
+
 /* translate functions to STDC */
 #ifndef SEEK_SET
 #define SEEK_SET                                VFS_SEEK_SET
@@ -122,6 +131,8 @@ extern "C" {
 #define IOCTL_VFS__NON_BLOCKING_WR_MODE         _IO(VFS,  0x03)
 #define IOCTL_VFS__DEFAULT_WR_MODE              _IO(VFS,  0x04)
 #define IOCTL_VFS__IS_NON_BLOCKING_WR_MODE      _IO(VFS,  0x05)
+#define IOCTL_VFS__POLL                         _IOWR(VFS, 0x06, struct vfs_poll*)
+#define IOCTL_VFS__GET_BLOCK_WEAR               _IOWR(VFS, 0x07, struct vfs_block_wear*)
 
 /* file system identificator */
 #define _VFS_FILE_SYSTEM_MAGIC_NO               0xD9EFD24F
@@ -139,6 +150,20 @@ struct vfs_dev_stat {
         u8_t  st_minor;                 /**< device minor number  */
 };
 
+/** file events (@ref IOCTL_VFS__POLL) */
+struct vfs_poll {
+        u32_t               events;     /**< [out] file events (POLLIN, POLLOUT, ...) */
+        struct _poll_entry *entry;      /**< [in]  waiter entry to link in file wait list (can be NULL) */
+};
+
+/** block write statistics (@ref IOCTL_VFS__GET_BLOCK_WEAR) */
+struct vfs_block_wear {
+        u32_t block;                    /**< [in]  block number */
+        u32_t writes;                   /**< [out] number of writes of block since mount */
+        u32_t writes_max;               /**< [out] the highest number of writes of all blocks */
+        u32_t blocks;                   /**< [out] number of blocks of file system */
+};
+
 /** file write/read attributtes. Doxygen documentation in fs/fs.h */
 struct vfs_fattr {
         bool non_blocking_rd:1;         /**< non-blocking file read access */
@@ -196,9 +221,27 @@ typedef struct vfs_file_flags {
         bool                eof    :1;          //! end of file
         bool                error  :1;          //! error occurred
         bool                seekmod:1;          //! file position modified
+        bool                regular:1;          //! regular file (stream buffer is created at first I/O)
         struct vfs_fattr    fattr;
 } vfs_file_flags_t;
 
+/** file stream buffer (used by stdio library, see setvbuf()) */
+struct vfs_file_buf {
+        sem_t              *lock;           //!< wakeup of lock waiters (see _vfs_fbuf_lock())
+        struct vfs_file_buf *lock_next;     //!< next locked buffer (see _vfs_fbuf_release())
+        pid_t               lock_pid;       //!< lock owner process
+        tid_t               lock_tid;       //!< lock owner thread
+        bool                locked;         //!< buffer is locked
+        u8_t               *data;           //!< buffer memory
+        size_t              size;           //!< buffer size
+        size_t              pos;            //!< read position or number of bytes to write
+        size_t              len;            //!< number of read bytes in buffer
+        u8_t                mode;           //!< buffer mode (VFS_BUF_FULL/LINE/NONE)
+        bool                wr    :1;       //!< buffer contains data to write
+        bool                rd    :1;       //!< read buffering is allowed
+        bool                stream:1;       //!< file is a stream (read returns available data)
+};
+
 /** file type */
 struct vfs_file {
         res_header_t        header;
@@ -207,6 +250,7 @@ struct vfs_file {
         void               *f_hdl;
         fpos_t              f_lseek;
         vfs_file_flags_t    f_flag;
+        struct vfs_file_buf *f_buf;
 };
 
 typedef struct vfs_file FILE;
@@ -265,14 +309,21 @@ extern int  _vfs_fopen      (const struct vfs_path*, const char*, FILE**);
 extern int  _vfs_fclose     (FILE*, bool);
 extern int  _vfs_fwrite     (const void*, size_t, size_t*, FILE*);
 extern int  _vfs_fread      (void*, size_t, size_t*, FILE*);
+extern int  _vfs_fcopy      (FILE*, FILE*, size_t, size_t*);
 extern int  _vfs_fseek      (FILE*, i64_t, int);
 extern int  _vfs_ftell      (FILE*, i64_t*);
 extern int  _vfs_vfioctl    (FILE*, int, va_list);
 extern int  _vfs_fstat      (FILE*, struct stat*);
 extern int  _vfs_fflush     (FILE*);
+extern int  _vfs_fsetvbuf   (FILE*, int, size_t);
+extern int  _vfs_fbuf_flush (FILE*);
+extern int  _vfs_fbuf_lock  (struct vfs_file_buf*, u32_t);
+extern void _vfs_fbuf_unlock(struct vfs_file_buf*);
+extern void _vfs_fbuf_release(pid_t, tid_t);
 extern int  _vfs_feof       (FILE*, int*);
 extern int  _vfs_clearerr   (FILE*);
 extern int  _vfs_ferror     (FILE*, int*);
+extern int  _vfs_fpoll      (FILE*, u32_t*, struct _poll_entry*);
 extern void _vfs_sync       (void);
 
 /*==============================================================================
@@ -0,0 +1,122 @@
+/*=========================================================================*//**
+@file    kpoll.h
+
+@author  Daniel Zorychta
+
+@brief   Waiting for readiness of files, sockets and processes.
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+#ifndef _KPOLL_H_
+#define _KPOLL_H_
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <sys/types.h>
+#include "fs/vfs.h"
+#include "kernel/kwrapper.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+/** USERSPACE/KERNELSPACE: poll events */
+#define POLLIN                  0x0001          //!< data can be read without blocking
+#define POLLOUT                 0x0004          //!< data can be written without blocking
+#define POLLERR                 0x0008          //!< error condition (returned only)
+#define POLLHUP                 0x0010          //!< hang up or process finished (returned only)
+#define POLLNVAL                0x0020          //!< invalid object (returned only)
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+/** USERSPACE/KERNELSPACE: type of polled object */
+typedef enum {
+        POLL_TYPE__FILE,                        //!< file (pipe, device, regular file)
+        POLL_TYPE__SOCKET,                      //!< network socket
+        POLL_TYPE__PROCESS                      //!< process (exit event)
+} poll_type_t;
+
+/** USERSPACE/KERNELSPACE: polled object */
+struct pollfd {
+        poll_type_t             type;           //!< object type
+        union {
+                FILE           *file;           //!< file to poll
+                struct socket  *socket;         //!< socket to poll
+                pid_t           pid;            //!< process to poll
+        };
+        u16_t                   events;         //!< requested events
+        u16_t                   revents;        //!< returned events
+};
+
+/** KERNELSPACE: poll waiter (one per thread) */
+typedef struct _poll_waiter {
+        sem_t                  *sem;            //!< signaled when polled object changed state
+        struct _poll_entry     *entry;          //!< entries of polled objects (one per object)
+        size_t                  entries;        //!< number of allocated entries
+} _poll_waiter_t;
+
+/** KERNELSPACE: wait list of polled object */
+typedef struct _poll_list {
+        struct _poll_entry     *head;           //!< first entry
+} _poll_list_t;
+
+/** KERNELSPACE: waiter link in wait list of polled object */
+typedef struct _poll_entry {
+        struct _poll_entry     *next;           //!< next entry of wait list
+        _poll_list_t           *list;           //!< wait list (NULL: entry not linked)
+        _poll_waiter_t         *waiter;         //!< signaled waiter
+        const void             *obj;            //!< polled object (lists can be shared)
+} _poll_entry_t;
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+extern int  _poll_scan(struct pollfd*, size_t, _poll_waiter_t*, size_t*);
+extern int  _poll_arm(_poll_waiter_t*, size_t);
+extern void _poll_disarm(_poll_waiter_t*);
+extern void _poll_release(_poll_waiter_t*);
+extern void _poll_wait(_poll_list_t*, const void*, _poll_entry_t*);
+extern void _poll_notify(_poll_list_t*, const void*);
+extern void _poll_notify_from_ISR(_poll_list_t*, const void*, bool*);
+extern void _poll_list_release(_poll_list_t*);
+
+/*==============================================================================
+  Exported inline functions
+==============================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _KPOLL_H_ */
+/*==============================================================================
+  End of file
+==============================================================================*/
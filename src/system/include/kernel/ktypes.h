@@ -68,6 +68,8 @@ typedef enum {
 /** KERNELSPACE: object header (must be the first in object) */
 typedef struct res_header {
         struct res_header *next;
+        struct res_header *prev;
+        struct _process   *owner;       //!< process that registered object (NULL: not registered)
         res_type_t         type;
 } res_header_t;
 
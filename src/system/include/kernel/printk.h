@@ -33,6 +33,7 @@
   Include files
 ==============================================================================*/
 #include "config.h"
+#include <sys/types.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -45,6 +46,30 @@ extern "C" {
 /*==============================================================================
   Exported object types
 ==============================================================================*/
+/** USERSPACE: system log message level */
+enum _printk_level {
+        _PRINTK_LEVEL_ERROR,                    //!< error messages
+        _PRINTK_LEVEL_WARNING,                  //!< warnings
+        _PRINTK_LEVEL_INFO,                     //!< informational messages
+        _PRINTK_LEVEL_DEBUG,                    //!< debug messages
+};
+
+/** USERSPACE: system log message source */
+enum _printk_subsys {
+        _PRINTK_SUBSYS_KERNEL,                  //!< kernel messages
+        _PRINTK_SUBSYS_MM,                      //!< memory management
+        _PRINTK_SUBSYS_FS,                      //!< file systems
+        _PRINTK_SUBSYS_DRIVER,                  //!< drivers
+        _PRINTK_SUBSYS_NET,                     //!< network
+};
+
+/** USERSPACE: system log statistics */
+typedef struct {
+        u32_t written;                          //!< number of logged messages
+        u32_t dropped;                          //!< number of lost messages
+        u8_t  level;                            //!< current message level
+        u32_t filter;                           //!< enabled subsystems mask
+} _printk_stat_t;
 
 /*==============================================================================
   Exported objects
@@ -57,10 +82,18 @@ extern "C" {
 size_t _printk_read(char *str, size_t len, u32_t *timestamp_ms);
 void   _printk_clear(void);
 void   _printk(const char*, ...);
+void   _printk_log(enum _printk_level, enum _printk_subsys, const char*, ...);
+void   _printk_set_level(enum _printk_level level);
+void   _printk_set_filter(u32_t subsys_mask);
+void   _printk_get_stat(_printk_stat_t *stat);
 #else
 #define _printk(...)
+#define _printk_log(...)
 #define _printk_read(str, len, timestamp_ms)
 #define _printk_clear()
+#define _printk_set_level(level)
+#define _printk_set_filter(subsys_mask)
+#define _printk_get_stat(stat)
 #endif
 
 /*==============================================================================
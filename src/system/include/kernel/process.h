@@ -105,6 +105,10 @@ typedef struct _process _process_t;
 /** KERNELSPACE: thread descriptor */
 typedef struct _thread _thread_t;
 
+/** KERNELSPACE: poll waiter (kpoll.h) */
+struct _poll_waiter;
+struct _poll_entry;
+
 /** KERNELSPACE: program attributes. Doxygen documentation in fs.h. */
 struct _prog_data {
         const char     *name;           //!< program name
@@ -142,9 +146,30 @@ typedef struct {
         u16_t       CPU_load;           //!< CPU load (1% = 10)
         u16_t       stack_size;         //!< stack size
         u16_t       stack_max_usage;    //!< max stack usage
+        u16_t       stack_min_free;     //!< the lowest free stack of all threads
         i16_t       priority;           //!< priority
 } process_stat_t;
 
+/** USERSPACE: binary process statistics record (procfs: /stat/<pid>) */
+typedef struct {
+        char        name[16];           //!< process name (can be truncated)
+        u32_t       memory_usage;       //!< memory usage (allocated by process)
+        u16_t       pid;                //!< process ID
+        u16_t       memory_block_count; //!< number of used memory blocks
+        u16_t       files_count;        //!< number of opened files
+        u16_t       dir_count;          //!< number of opened directories
+        u16_t       mutexes_count;      //!< number of used mutexes
+        u16_t       semaphores_count;   //!< number of used semaphores
+        u16_t       queue_count;        //!< number of used queues
+        u16_t       socket_count;       //!< number of used sockets
+        u16_t       threads_count;      //!< number of threads
+        u16_t       CPU_load;           //!< CPU load (1% = 10)
+        u16_t       stack_size;         //!< main thread stack size
+        u16_t       stack_max_usage;    //!< main thread max stack usage
+        u16_t       stack_min_free;     //!< the lowest free stack of all threads
+        i16_t       priority;           //!< priority
+} process_stat_record_t;
+
 /** USERSPACE: thread attributes */
 typedef struct {
         size_t stack_depth;             //!< stack depth
@@ -174,7 +199,9 @@ extern const int                _prog_table_size;
 /*==============================================================================
   Exported function prototypes
 ==============================================================================*/
-extern void        _process_clean_up_killed_processes   (void);
+extern int         _process_clean_up_killed_processes   (void);
+extern void        _process_syscall_begin               (_process_t*);
+extern void        _process_syscall_end                 (_process_t*);
 extern int         _process_create                      (const char*, const process_attr_t*, pid_t*);
 extern int         _process_kill                        (pid_t);
 extern void        _process_remove_zombie               (_process_t*, int*);
@@ -189,6 +216,7 @@ extern FILE       *_process_get_stderr                  (_process_t*);
 extern const char *_process_get_name                    (_process_t*);
 extern size_t      _process_get_count                   (void);
 extern _process_t *_process_get_active                  (void);
+extern _process_t *_process_get_current                 (void);
 extern int         _process_get_pid                     (_process_t*, pid_t*);
 extern int         _process_get_event_flags             (_process_t*, flag_t**);
 extern int         _process_get_priority                (pid_t, int*);
@@ -200,6 +228,8 @@ extern u8_t        _process_get_max_threads             (_process_t*);
 extern int         _process_thread_create               (_process_t*, thread_func_t, const thread_attr_t*, void*, tid_t*);
 extern int         _process_thread_kill                 (_process_t*, tid_t);
 extern task_t     *_process_thread_get_task             (_process_t *proc, tid_t tid);
+extern int         _process_thread_get_poll_waiter      (_process_t*, tid_t, struct _poll_waiter**);
+extern int         _process_poll                        (pid_t, u32_t*, struct _poll_entry*);
 extern void        _task_switched_in                    (task_t *task, void *task_tag);
 extern void        _task_switched_out                   (task_t *task, void *task_tag);
 extern void        _calculate_CPU_load                  (void);
@@ -123,9 +123,12 @@ typedef enum {// NAME                      | RETURN TYPE    | ARG 1
         SYSCALL_FCLOSE,                 // | int            | FILE *file                |                                     |                           |                           |                                           |
         SYSCALL_FWRITE,                 // | size_t         | const void *src           | size_t *size                        | size_t *count             | FILE *file                |                                           |
         SYSCALL_FREAD,                  // | size_t         | void *dst                 | size_t *size                        | size_t *count             | FILE *file                |                                           |
+        SYSCALL_FCOPY,                  // | size_t         | FILE *src                 | FILE *dst                           | size_t *count             |                           |                                           |
         SYSCALL_FSEEK,                  // | int            | FILE *file                | i64_t  *seek                        | int    *origin            |                           |                                           |
         SYSCALL_IOCTL,                  // | int            | FILE *file                | int *request                        | va_list *arg              |                           |                                           |
         SYSCALL_FFLUSH,                 // | int            | FILE *file                |                                     |                           |                           |                                           |
+        SYSCALL_FSETVBUF,               // | int            | FILE *file                | char *buf                           | int *mode                 | size_t *size              |                                           |
+        SYSCALL_POLL,                   // | int            | struct pollfd *fds        | size_t *nfds                        | sem_t **sem               |                           |                                           |
         SYSCALL_SYNC,                   // | void           |                           |                                     |                           |                           |                                           |
     #if __OS_ENABLE_TIMEMAN__ == _YES_
         SYSCALL_GETTIME,                // | time_t         |                           |                                     |                           |                           |                                           |
@@ -155,11 +158,36 @@ typedef enum {// NAME                      | RETURN TYPE    | ARG 1
         SYSCALL_NETSENDTO,              // | int            | SOCKET *socket            | const void *buf                     | size_t *len               | NET_flags_t *flags        | const NET_generic_sockaddr_t *to_sockaddr |
         SYSCALL_NETRECVFROM,            // | int            | SOCKET *socket            | void *buf                           | size_t *len               | NET_flags_t *flags        | NET_generic_sockaddr_t *from_sockaddr     |
         SYSCALL_NETGETADDRESS,          // | int            | SOCKET *socket            | NET_generic_sockaddr_t *addr        |                           |                           |                                           |
+        SYSCALL_NETSENDFILE,            // | int            | SOCKET *socket            | FILE *file                          | size_t *len               |                           |                                           |
     #endif
 #define _SYSCALL_GROUP_2_NET_BLOCKING     _SYSCALL_COUNT // network group --------------+-------------------------------------+---------------------------+---------------------------+-------------------------------------------+
         _SYSCALL_COUNT
 } syscall_t;
 
+/** KERNELSPACE: syscall worker pools */
+enum _syscall_pool {
+        _SYSCALL_POOL_FS,               //!< file system blocking syscalls
+        _SYSCALL_POOL_NET,              //!< network blocking syscalls
+        _SYSCALL_POOL_COUNT
+};
+
+/** KERNELSPACE: syscall worker pool statistics */
+typedef struct {
+        const char *name;               //!< pool name
+        u8_t        workers;            //!< number of running workers
+        u8_t        idle;               //!< number of idle workers
+        u8_t        max_workers;        //!< number of persistent workers (pool size)
+        u8_t        queue_depth;        //!< number of pending requests
+        u8_t        queue_max;          //!< the highest number of pending requests
+        u32_t       requests;           //!< number of served requests
+        u32_t       wait_time_ms;       //!< total time of requests spent in queue
+        u32_t       wait_time_max_ms;   //!< the longest time of request spent in queue
+        u32_t       service_time_ms;    //!< total time of requests service
+        u32_t       service_time_max_ms;//!< the longest request service
+        u32_t       overflows;          //!< number of workers created over pool size
+        u32_t       shrinks;            //!< number of workers released by lack of memory
+} _syscall_pool_stat_t;
+
 /*==============================================================================
   Exported objects
 ==============================================================================*/
@@ -172,6 +200,7 @@ extern pid_t _syscall_client_PID[__OS_TASK_MAX_SYSTEM_THREADS__];
 extern void syscall(syscall_t syscall, void *retptr, ...);
 extern int  _syscall_init();
 extern int  _syscall_kworker_process(int, char**);
+extern int  _syscall_get_pool_stat(enum _syscall_pool, _syscall_pool_stat_t*);
 
 /*==============================================================================
   Exported inline functions
@@ -58,7 +58,9 @@
 #include "kernel/time.h"
 #include "kernel/process.h"
 #include "kernel/syscall.h"
+#include "kernel/kpoll.h"
 #include "mm/cache.h"
+#include "mm/slab.h"
 #include "fs/vfs.h"
 #include "drivers/drvctrl.h"
 #include "portable/cpuctl.h"
@@ -1845,14 +1847,15 @@ static inline int sys_btree_predecessor(btree_t *tree, void *key, void *ret)
 
 //==============================================================================
 /**
- * @brief  Function insert object to BTree.
+ * @brief  Function insert object to BTree. Object is not inserted when equal
+ *         object (compare functor returns 0) already exists in the tree.
  *
  * @note Function can be used only by file system or driver code.
  *
  * @param  tree         BTree object
  * @param  data         object to insert to
  *
- * @return One of errno value.
+ * @return One of errno value, EEXIST if equal object already exists.
  *
  * @b Example
  * @code
@@ -1981,6 +1984,146 @@ static inline int sys_btree_remove(btree_t *tree, void *data)
         return _btree_remove(tree, data);
 }
 
+//==============================================================================
+/**
+ * @brief  Function set cursor at object with minimum value.
+ *
+ * Cursor visits objects in order without searching tree from the root,
+ * therefore entire tree traversal takes linear time. Cursor is valid until
+ * pointed object is removed.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor to set
+ * @param  ret          first object
+ *
+ * @return One of errno value.
+ *
+ * @b Example
+ * @code
+        // ...
+
+        btree_cursor_t cursor;
+        bt_obj_t       obj;
+
+        int err = sys_btree_cursor_first(bt, &cursor, &obj);
+        while (!err) {
+                // ...
+
+                err = sys_btree_cursor_next(bt, &cursor, &obj);
+        }
+
+        // ...
+   @endcode
+ *
+ * @see sys_btree_cursor_next()
+ */
+//==============================================================================
+static inline int sys_btree_cursor_first(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        return _btree_cursor_first(tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function set cursor at object with maximum value.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor to set
+ * @param  ret          last object
+ *
+ * @return One of errno value.
+ *
+ * @see sys_btree_cursor_prev()
+ */
+//==============================================================================
+static inline int sys_btree_cursor_last(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        return _btree_cursor_last(tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function move cursor to the next object.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor
+ * @param  ret          next object
+ *
+ * @return One of errno value. ENOENT when cursor reached end of tree.
+ *
+ * @see sys_btree_cursor_first()
+ */
+//==============================================================================
+static inline int sys_btree_cursor_next(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        return _btree_cursor_next(tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function move cursor to the previous object.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor
+ * @param  ret          previous object
+ *
+ * @return One of errno value. ENOENT when cursor reached begin of tree.
+ *
+ * @see sys_btree_cursor_last()
+ */
+//==============================================================================
+static inline int sys_btree_cursor_prev(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        return _btree_cursor_prev(tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function build balanced BTree from sorted array of objects.
+ *
+ * Function is faster than insertion of each object separately because
+ * tree is build in linear time. BTree must be empty.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param  tree         BTree object
+ * @param  data         array of unique objects sorted in ascending order
+ * @param  count        number of objects in array
+ *
+ * @return One of errno value. EINVAL if objects are not sorted, EBUSY if
+ *         tree is not empty.
+ *
+ * @b Example
+ * @code
+        // ...
+
+        static const bt_obj_t obj[] = {{.value = 1}, {.value = 3}, {.value = 5}};
+
+        btree_t *bt = NULL;
+        int err = sys_btree_create(sizeof(bt_obj_t), cmp, NULL, &bt);
+        if (!err) {
+                err = sys_btree_build(bt, obj, ARRAY_SIZE(obj));
+
+                // ...
+        }
+
+        // ...
+   @endcode
+ */
+//==============================================================================
+static inline int sys_btree_build(btree_t *tree, const void *data, size_t count)
+{
+        return _btree_build(tree, data, count);
+}
+
 //==============================================================================
 /**
  * @brief  Function destroy BTree.
@@ -3269,6 +3412,43 @@ static inline void sys_sync()
 static inline void printk(const char *format, ...);
 #endif
 
+//==============================================================================
+/**
+ * @brief Function put message of selected level and subsystem to kernel log.
+ *
+ * The function works as printk() but message is stored only if <i>level</i>
+ * is not higher than current log level and <i>subsys</i> is not filtered out.
+ * Arguments are stored in binary form and message is formatted when log is
+ * read, so the <i>format</i> must be a string literal. Function can be used
+ * in interrupts.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param level         message level (_PRINTK_LEVEL_*)
+ * @param subsys        message subsystem (_PRINTK_SUBSYS_*)
+ * @param format        formatting string
+ * @param ...           argument sequence
+ *
+ * @return None
+ *
+ * @b Example
+ * @code
+        // ...
+
+        printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_DRIVER, "UART%d: overrun", major);
+
+        // ...
+   @endcode
+ *
+ * @see printk()
+ */
+//==============================================================================
+#ifndef DOXYGEN
+#define printk_log(...) _printk_log(__VA_ARGS__)
+#else
+static inline void printk_log(enum _printk_level level, enum _printk_subsys subsys, const char *format, ...);
+#endif
+
 //==============================================================================
 /**
  * @brief Function prints message according to format to buffer.
@@ -5014,6 +5194,40 @@ static inline size_t sys_get_mem_size()
         return _mm_get_mem_size();
 }
 
+//==============================================================================
+/**
+ * @brief  Function return statistics of selected heap region.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param  seek     region seek (start from 0)
+ * @param  stat     heap statistics
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_get_heap_stat(size_t seek, _heap_stat_t *stat)
+{
+        return _mm_get_heap_stat(seek, stat);
+}
+
+//==============================================================================
+/**
+ * @brief  Function return statistics of selected object cache (slab).
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param  seek     cache seek (start from 0)
+ * @param  stat     cache statistics
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_get_slab_stat(size_t seek, _slab_stat_t *stat)
+{
+        return _slab_get_stat(seek, stat);
+}
+
 //==============================================================================
 /**
  * @brief Function return OS time in milliseconds.
@@ -5119,6 +5333,40 @@ static inline size_t sys_process_get_count(void)
         return _process_get_count();
 }
 
+//==============================================================================
+/**
+ * @brief  Function return statistics of selected syscall worker pool.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param  pool     pool number
+ * @param  stat     pool statistics
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_get_syscall_pool_stat(enum _syscall_pool pool, _syscall_pool_stat_t *stat)
+{
+        return _syscall_get_pool_stat(pool, stat);
+}
+
+//==============================================================================
+/**
+ * @brief  Function return statistics of cached device.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param  seek     device seek (start from 0)
+ * @param  stat     device statistics
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_cache_get_dev_stat(size_t seek, _cache_dev_stat_t *stat)
+{
+        return _cache_get_dev_stat(seek, stat);
+}
+
 //==============================================================================
 /**
  * @brief Function create new thread (task), and if enabled, add to monitor list.
@@ -5419,6 +5667,81 @@ static inline void sys_context_switch_unlock()
         _kernel_scheduler_unlock();
 }
 
+//==============================================================================
+/**
+ * @brief Function link poll() waiter to the wait list of object. Function
+ *        should be called by poll request (@ref IOCTL_VFS__POLL) before
+ *        object events are read.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param list          wait list of object
+ * @param obj           polled object
+ * @param entry         waiter entry (from poll request, can be NULL)
+ *
+ * @see sys_poll_notify(), sys_poll_list_release()
+ */
+//==============================================================================
+static inline void sys_poll_wait(_poll_list_t *list, const void *obj, struct _poll_entry *entry)
+{
+        _poll_wait(list, obj, entry);
+}
+
+//==============================================================================
+/**
+ * @brief Function wake up threads that wait in poll() for selected object.
+ *        Function should be called when object become readable or writable,
+ *        or was closed.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param list          wait list of object
+ * @param obj           object which state changed
+ *
+ * @see sys_poll_notify_from_ISR()
+ */
+//==============================================================================
+static inline void sys_poll_notify(_poll_list_t *list, const void *obj)
+{
+        _poll_notify(list, obj);
+}
+
+//==============================================================================
+/**
+ * @brief Function wake up threads that wait in poll() for selected object.
+ *        Function can be called only from interrupt.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param list          wait list of object
+ * @param obj           object which state changed
+ * @param task_woken    true if higher priority task was woken (can be NULL)
+ *
+ * @see sys_poll_notify()
+ */
+//==============================================================================
+static inline void sys_poll_notify_from_ISR(_poll_list_t *list, const void *obj, bool *task_woken)
+{
+        _poll_notify_from_ISR(list, obj, task_woken);
+}
+
+//==============================================================================
+/**
+ * @brief Function wake up and remove all poll() waiters of object. Function
+ *        must be called before object is freed.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param list          wait list of object
+ *
+ * @see sys_poll_wait()
+ */
+//==============================================================================
+static inline void sys_poll_list_release(_poll_list_t *list)
+{
+        _poll_list_release(list);
+}
+
 //==============================================================================
 /**
  * @brief Function put to sleep thread for milliseconds.
@@ -53,14 +53,14 @@ extern "C" {
   Exported macros
 ==============================================================================*/
 #define _btree_foreach(_type, _val, _btree) \
-        for (int _err = 0; !_err;)\
-                for (_type _val; !_err;)\
-                        for (_err = _btree_minimum(_btree, &_val); !_err; _err = _btree_successor(_btree, &_val, &_val))
+        for (btree_cursor_t _cur = {NULL, false}; !_cur.end; _cur.end = true)\
+                for (_type _val; !_cur.end; _cur.end = true)\
+                        for (int _err = _btree_cursor_first(_btree, &_cur, &_val); !_err; _err = _btree_cursor_next(_btree, &_cur, &_val))
 
 #define _btree_foreach_reverse(_type, _val, _btree) \
-        for (int _err = 0; !_err;)\
-                for (_type _val; !_err;)\
-                        for (_err = _btree_maximum(_btree, &_val); !_err; _err = _btree_predecessor(_btree, &_val, &_val))
+        for (btree_cursor_t _cur = {NULL, false}; !_cur.end; _cur.end = true)\
+                for (_type _val; !_cur.end; _cur.end = true)\
+                        for (int _err = _btree_cursor_last(_btree, &_cur, &_val); !_err; _err = _btree_cursor_prev(_btree, &_cur, &_val))
 
 /*==============================================================================
   Exported object types
@@ -71,6 +71,12 @@ typedef void  (*btree_obj_dtor_t)(void *obj);
 typedef void *(*btree_malloc_t)(size_t size);
 typedef void  (*btree_free_t)(void *mem);
 
+/** BTree cursor (iterator), valid until pointed object is removed */
+typedef struct {
+        void *node;                     //!< current node
+        bool  end;                      //!< foreach loop end flag
+} btree_cursor_t;
+
 /*==============================================================================
   Exported objects
 ==============================================================================*/
@@ -103,8 +109,13 @@ extern int  _btree_maximum(btree_t *tree, void *ret);
 extern bool _btree_is_empty(btree_t *tree);
 extern int  _btree_successor(btree_t *tree, void *key, void *ret);
 extern int  _btree_predecessor(btree_t *tree, void *key, void *ret);
+extern int  _btree_cursor_first(btree_t *tree, btree_cursor_t *cursor, void *ret);
+extern int  _btree_cursor_last(btree_t *tree, btree_cursor_t *cursor, void *ret);
+extern int  _btree_cursor_next(btree_t *tree, btree_cursor_t *cursor, void *ret);
+extern int  _btree_cursor_prev(btree_t *tree, btree_cursor_t *cursor, void *ret);
 extern int  _btree_insert(btree_t *tree, void *data);
 extern int  _btree_remove(btree_t *tree, void *data);
+extern int  _btree_build(btree_t *tree, const void *data, size_t count);
 extern void _btree_destroy(btree_t *tree);
 
 /*==============================================================================
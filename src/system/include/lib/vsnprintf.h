@@ -48,6 +48,8 @@ extern "C" {
 /*==============================================================================
   Exported object types
 ==============================================================================*/
+/** output function of formatter, returns number of accepted characters */
+typedef size_t (*vprintf_put_t)(void *ctx, const char *str, size_t len);
 
 /*==============================================================================
   Exported objects
@@ -56,6 +58,7 @@ extern "C" {
 /*==============================================================================
   Exported functions
 ==============================================================================*/
+extern int _vprintf_put(vprintf_put_t put, void *ctx, const char *format, va_list arg);
 extern int _vsnprintf(char *buf, size_t size, const char *format, va_list arg);
 extern int _snprintf(char *bfr, size_t size, const char *format, ...);
 
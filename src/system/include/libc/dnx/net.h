@@ -214,6 +214,7 @@ extern "C" {
   Include files
 ==============================================================================*/
 #include <stdint.h>
+#include <stdio.h>
 #include <kernel/syscall.h>
 #include <kernel/builtinfunc.h>
 #include <stddef.h>
@@ -644,6 +645,62 @@ static inline int socket_write(SOCKET *socket, const void *buf, size_t len)
 #endif
 }
 
+//==============================================================================
+/**
+ * @brief  The function send data of file directly to the socket. Data is
+ *         read and sent by the system, without user space buffer. Data is
+ *         read from the current file position.
+ *
+ * @note   File must be a regular file, otherwise errno is set to ESPIPE. Stream
+ *         buffer of the file is synchronized before transfer. Data not
+ *         accepted by the socket stays unread in the file.
+ *
+ * @param  socket       The socket to use to send the data.
+ * @param  file         The file to send.
+ * @param  len          The number of bytes to send.
+ *
+ * @return Number of bytes actually sent on the socket, or -1 on error and
+ *         @ref errno value is set appropriately.
+ *
+ * @b Example
+ * @code
+        #include <stdio.h>
+        #include <sys/stat.h>
+        #include <dnx/net.h>
+
+        // ...
+
+        FILE *file = fopen("/foo/index.html", "r");
+        if (file) {
+                struct stat st;
+                if (fstat(file, &st) == 0) {
+                        socket_sendfile(socket, file, st.st_size);
+                }
+
+                fclose(file);
+        }
+
+        // ...
+   @endcode
+ *
+ * @see socket_write(), socket_send()
+ */
+//==============================================================================
+static inline int socket_sendfile(SOCKET *socket, FILE *file, size_t len)
+{
+#if __ENABLE_NETWORK__ == _YES_
+        int result = -1;
+        if (fseek(file, 0, SEEK_CUR) == 0) {
+                syscall(SYSCALL_NETSENDFILE, &result, socket, file, &len);
+        }
+        return result;
+#else
+        UNUSED_ARG3(socket, file, len);
+        _errno = ENOTSUP;
+        return -1;
+#endif
+}
+
 //==============================================================================
 /**
  * @brief  The function is used to transmit a message to another transport
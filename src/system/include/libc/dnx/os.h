@@ -990,6 +990,95 @@ static inline void syslog_clear(void)
         _builtinfunc(printk_clear);
 }
 
+//==============================================================================
+/**
+ * @brief Function set system log level.
+ *
+ * The function syslog_set_level() set maximum level of messages stored in
+ * the system log. Messages of higher level are not stored.
+ *
+ * @param  level        message level (_PRINTK_LEVEL_*)
+ *
+ * @b Example
+ * @code
+        #include <dnx/os.h>
+
+        // ...
+
+        syslog_set_level(_PRINTK_LEVEL_WARNING);
+
+        // ...
+
+   @endcode
+ */
+//==============================================================================
+static inline void syslog_set_level(enum _printk_level level)
+{
+        (void)level;
+        _builtinfunc(printk_set_level, level);
+}
+
+//==============================================================================
+/**
+ * @brief Function set subsystems stored in the system log.
+ *
+ * The function syslog_set_filter() set mask of subsystems which messages
+ * are stored in the system log. Bit number is the _PRINTK_SUBSYS_* value.
+ *
+ * @param  subsys_mask  enabled subsystems
+ *
+ * @b Example
+ * @code
+        #include <dnx/os.h>
+
+        // ...
+
+        syslog_set_filter(~(1 << _PRINTK_SUBSYS_MM));
+
+        // ...
+
+   @endcode
+ */
+//==============================================================================
+static inline void syslog_set_filter(u32_t subsys_mask)
+{
+        (void)subsys_mask;
+        _builtinfunc(printk_set_filter, subsys_mask);
+}
+
+//==============================================================================
+/**
+ * @brief Function read system log statistics.
+ *
+ * The function syslog_get_stat() read number of logged and dropped messages
+ * and current log configuration.
+ *
+ * @param  stat         statistics container
+ *
+ * @b Example
+ * @code
+        #include <dnx/os.h>
+
+        // ...
+
+        _printk_stat_t stat;
+        syslog_get_stat(&stat);
+        printf("Dropped messages: %u\n", stat.dropped);
+
+        // ...
+
+   @endcode
+ */
+//==============================================================================
+static inline void syslog_get_stat(_printk_stat_t *stat)
+{
+#if ((__OS_SYSTEM_MSG_ENABLE__ > 0) && (__OS_PRINTF_ENABLE__ > 0))
+        _builtinfunc(printk_get_stat, stat);
+#else
+        *stat = (_printk_stat_t){0};
+#endif
+}
+
 //==============================================================================
 /**
  * @brief Function is used to detect occurred kernel panic.
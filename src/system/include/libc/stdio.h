@@ -355,12 +355,7 @@ static inline FILE *freopen(const char *path, const char *mode, FILE *file)
  * @see fread()
  */
 //==============================================================================
-static inline size_t fwrite(const void *ptr, size_t size, size_t count, FILE *file)
-{
-        size_t s = 0;
-        syscall(SYSCALL_FWRITE, &s, ptr, &size, &count, file);
-        return s;
-}
+extern size_t fwrite(const void *ptr, size_t size, size_t count, FILE *file);
 
 //==============================================================================
 /**
@@ -406,12 +401,51 @@ static inline size_t fwrite(const void *ptr, size_t size, size_t count, FILE *fi
  * @see fwrite()
  */
 //==============================================================================
-static inline size_t fread(void *ptr, size_t size, size_t count, FILE *file)
-{
-        size_t s = 0;
-        syscall(SYSCALL_FREAD, &s, ptr, &size, &count, file);
-        return s;
-}
+extern size_t fread(void *ptr, size_t size, size_t count, FILE *file);
+
+//==============================================================================
+/**
+ * @brief Function copies data between streams.
+ *
+ * The function copy_file_range() copies up to <i>count</i> bytes from the
+ * stream <i>fin</i> to the stream <i>fout</i>. Data is transferred by the
+ * system in a single request, without user space buffer. Data already
+ * buffered in <i>fin</i> is copied first. Copy stops at the end of the
+ * source file. Data not accepted by <i>fout</i> stays unread in <i>fin</i>.
+ * Devices and pipes are copied by program buffer of BUFSIZ bytes.
+ *
+ * @param fin           source stream
+ * @param fout          destination stream
+ * @param count         number of bytes to copy
+ *
+ * @exception | @ref EINVAL
+ * @exception | @ref ENOMEM
+ * @exception | @ref ENOSPC
+ *
+ * @return On success, the number of copied bytes is returned (<b>0</b> at the
+ * end of file). On error, <b>-1</b> is returned, and <b>errno</b> is set
+ * appropriately.
+ *
+ * @b Example
+ * @code
+        #include <stdio.h>
+
+        // ...
+
+        FILE *src = fopen("/foo/bar", "r");
+        FILE *dst = fopen("/foo/baz", "w");
+
+        if (src && dst) {
+               while (copy_file_range(src, dst, 65536) > 0);
+        }
+
+        // ...
+   @endcode
+ *
+ * @see fread(), fwrite()
+ */
+//==============================================================================
+extern ssize_t copy_file_range(FILE *fin, FILE *fout, size_t count);
 
 //==============================================================================
 /**
@@ -459,12 +493,7 @@ static inline size_t fread(void *ptr, size_t size, size_t count, FILE *file)
  * @see fsetpos(), fgetpos(), ftell()
  */
 //==============================================================================
-static inline int fseek(FILE *file, i64_t offset, int mode)
-{
-        size_t r = 1;
-        syscall(SYSCALL_FSEEK, &r, file, &offset, &mode);
-        return r;
-}
+extern int fseek(FILE *file, i64_t offset, int mode);
 
 //==============================================================================
 /**
@@ -599,12 +628,7 @@ static inline void rewind(FILE *file)
  * @see fseek(), fsetpos(), fgetpos()
  */
 //==============================================================================
-static inline i64_t ftell(FILE *file)
-{
-        i64_t lseek = 0;
-        _errno = _builtinfunc(vfs_ftell, file, &lseek);
-        return lseek;
-}
+extern i64_t ftell(FILE *file);
 
 //==============================================================================
 /**
@@ -698,12 +722,7 @@ static inline int fgetpos(FILE *file, fpos_t *pos)
    @endcode
  */
 //==============================================================================
-static inline int fflush(FILE *file)
-{
-        int r = EOF;
-        syscall(SYSCALL_FFLUSH, &r, file);
-        return r;
-}
+extern int fflush(FILE *file);
 
 //==============================================================================
 /**
@@ -746,12 +765,7 @@ static inline int fflush(FILE *file)
  * @see clearerr()
  */
 //==============================================================================
-static inline int feof(FILE *file)
-{
-        int eof = 0;
-        _errno = _builtinfunc(vfs_feof, file, &eof);
-        return _errno | eof;
-}
+extern int feof(FILE *file);
 
 //==============================================================================
 /**
@@ -890,15 +904,27 @@ extern void perror(const char *s);
 
 //==============================================================================
 /**
- * @brief Function sets stream buffer mode.
- *
- * The routine exist in dnx RTOS only for compatible reasons. Function in this
- * case do nothing.
- *
- * @note Function not supported.
+ * @brief Function sets stream buffer mode. Buffer is kept together with
+ *        stream object so it is shared by all processes that use selected
+ *        stream. For this reason buffer is always allocated by system with
+ *        selected size and the <i>buffer</i> argument is not used (stream
+ *        can outlive the caller's buffer). Pending data is written before
+ *        buffer is changed. Read-ahead is
+ *        used only for regular files and pipes, other streams are buffered
+ *        only in write direction.
+ *
+ * @note Regular files are fully buffered by default (buffer of @ref BUFSIZ
+ *       bytes is allocated at first read or write). Other files (e.g.
+ *       terminals, pipes) and the stderr stream are unbuffered until
+ *       setvbuf() is called.
  *
  * @param file      stream
- * @param buffer    buffer
+ * @param buffer    not used (buffer is allocated by system)
+ * @param mode      buffer mode (@ref _IONBF, @ref _IOLBF, @ref _IOFBF)
+ * @param size      buffer size
+ *
+ * @return On success 0 is returned, otherwise other value and @ref errno
+ *         is set.
  *
  * @b Example
  * @code
@@ -908,36 +934,26 @@ extern void perror(const char *s);
 
         FILE *file = fopen("/foo/bar", "r");
         if (file) {
-               char buffer[100];
-               setbuf(file, buffer);
+               setvbuf(file, NULL, _IOFBF, 100);
 
                // ...
         }
         // ...
    @endcode
  *
- * @see setvbuf()
+ * @see setbuf()
  */
 //==============================================================================
-static inline void setbuf(FILE *file, char *buffer)
-{
-        (void) file;
-        (void) buffer;
-}
+extern int setvbuf(FILE *file, char *buffer, int mode, size_t size);
 
 //==============================================================================
 /**
- * @brief Function sets stream buffer mode.
- *
- * The routine exist in dnx RTOS only for compatible reasons. Function in this
- * case do nothing.
- *
- * @note Function not supported.
+ * @brief Function sets stream buffer. If buffer is NULL then stream is
+ *        set to unbuffered mode, otherwise the stream is fully buffered
+ *        and system buffer of size @ref BUFSIZ is used.
  *
  * @param file      stream
- * @param buffer    buffer
- * @param mode      buffer mode (@ref _IONBF, @ref _IOLBF, @ref _IOFBF)
- * @param size      buffer size
+ * @param buffer    NULL for unbuffered mode (buffer is not used)
  *
  * @b Example
  * @code
@@ -947,25 +963,20 @@ static inline void setbuf(FILE *file, char *buffer)
 
         FILE *file = fopen("/foo/bar", "r");
         if (file) {
-               char buffer[100];
-               setvbuf(file, buffer, _IOFBF, 100);
+               static char buffer[BUFSIZ];
+               setbuf(file, buffer);
 
                // ...
         }
         // ...
    @endcode
  *
- * @see setbuf()
+ * @see setvbuf()
  */
 //==============================================================================
-static inline int setvbuf(FILE *file, char *buffer, int mode, size_t size)
+static inline void setbuf(FILE *file, char *buffer)
 {
-        (void) file;
-        (void) buffer;
-        (void) mode;
-        (void) size;
-
-        return 0;
+        setvbuf(file, buffer, buffer ? _IOFBF : _IONBF, BUFSIZ);
 }
 
 //==============================================================================
@@ -106,6 +106,19 @@ extern "C" {
  * @see   ioctl()
  */
 #define IOCTL_VFS__DEFAULT_WR_MODE
+
+/**
+ * @brief Request return number of writes of selected file system block.
+ *
+ * Request is supported by file systems that track block wear (e.g. eefs
+ * mounted with <i>wear</i> option). Counters are kept from mount.
+ *
+ * @param  [WR,RD] struct vfs_block_wear * block number and statistics
+ * @return On success 0 is returned, otherwise -1.
+ *
+ * @see   ioctl()
+ */
+#define IOCTL_VFS__GET_BLOCK_WEAR
 #endif
 
 /*==============================================================================
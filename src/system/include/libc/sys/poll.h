@@ -0,0 +1,153 @@
+/*==============================================================================
+File     poll.h
+
+Author   Daniel Zorychta
+
+Brief    Waiting for readiness of files, sockets and processes.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/**
+@defgroup sys-poll-h <sys/poll.h>
+
+The library is used to wait for several objects at once. Objects can be files
+(pipes, devices), sockets, and processes (exit event).
+*/
+/**@{*/
+
+#ifndef _POLL_H_
+#define _POLL_H_
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <kernel/syscall.h>
+#include <kernel/kpoll.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+
+/*==============================================================================
+  Exported inline functions
+==============================================================================*/
+//==============================================================================
+/**
+ * @brief Function wait for events of selected objects.
+ *
+ * The poll() function checks objects pointed by <i>fds</i>. Function returns
+ * when at least one object has requested event or when <i>timeout</i>
+ * expires. Returned events are stored in <i>revents</i> field of each object.
+ * Events POLLERR, POLLHUP, and POLLNVAL are always returned. Files that do not
+ * support polling are always readable and writable. Process object is
+ * readable when process is finished.
+ *
+ * Thread waits in own context, thus syscall workers are not blocked during
+ * wait.
+ *
+ * @param fds           objects to poll
+ * @param nfds          number of objects
+ * @param timeout       timeout in milliseconds (0: no wait, MAX_DELAY_MS:
+ *                      wait forever)
+ *
+ * @exception | EINVAL
+ * @exception | ENOMEM
+ *
+ * @return On success, number of objects with returned events is returned
+ * (<b>0</b> on timeout). On error, <b>-1</b> is returned, and <b>errno</b>
+ * is set appropriately.
+ *
+ * @b Example
+ * @code
+        #include <stdio.h>
+        #include <sys/poll.h>
+
+        // ...
+
+        struct pollfd fds[2] = {
+                {.type = POLL_TYPE__FILE,    .file = stdin, .events = POLLIN},
+                {.type = POLL_TYPE__PROCESS, .pid  = pid,   .events = POLLIN},
+        };
+
+        while (poll(fds, 2, 1000) >= 0) {
+                if (fds[0].revents & POLLIN) {
+                        // read stdin
+                }
+
+                if (fds[1].revents & POLLHUP) {
+                        break;
+                }
+        }
+
+        // ...
+
+   @endcode
+ */
+//==============================================================================
+static inline int poll(struct pollfd *fds, size_t nfds, u32_t timeout)
+{
+        u32_t start = _builtinfunc(kernel_get_time_ms);
+        int   r     = -1;
+
+        for (;;) {
+                u32_t elapsed = _builtinfunc(kernel_get_time_ms) - start;
+                u32_t left    = (timeout == MAX_DELAY_MS) ? MAX_DELAY_MS
+                              : (elapsed < timeout) ? (timeout - elapsed) : 0;
+
+                sem_t *sem = NULL;
+                syscall(SYSCALL_POLL, &r, fds, &nfds, left ? &sem : NULL);
+
+                if (r != 0 || sem == NULL) {
+                        break;
+                }
+
+                _builtinfunc(semaphore_wait, sem, left);
+        }
+
+        return r;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _POLL_H_ */
+
+/**@}*/
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -86,6 +86,19 @@ enum cache_mode {
         CACHE_WRITE_BACK
 };
 
+/**
+ * Cached device statistics.
+ */
+typedef struct {
+        dev_t   dev;                    //!< device ID
+        u32_t   hits;                   //!< number of blocks read from cache
+        u32_t   misses;                 //!< number of blocks read from device
+        u32_t   readahead;              //!< number of blocks read in advance
+        u32_t   readahead_hits;         //!< number of used blocks read in advance
+        u32_t   rd_requests;            //!< number of device read requests
+        u32_t   wr_requests;            //!< number of device write requests
+} _cache_dev_stat_t;
+
 /*==============================================================================
   Exported objects
 ==============================================================================*/
@@ -101,6 +114,8 @@ extern void _cache_sync(void);
 extern void _cache_drop(void);
 extern void _cache_reduce(size_t);
 extern bool _cache_is_sync_needed(void);
+extern void _cache_writeback_thread(void*);
+extern int  _cache_get_dev_stat(size_t, _cache_dev_stat_t*);
 
 /*==============================================================================
   Exported inline functions
@@ -69,10 +69,16 @@ extern "C" {
 ==============================================================================*/
 #include <sys/types.h>
 #include <stddef.h>
+#include "config.h"
 
 /*==============================================================================
   Exported symbolic constants/macros
 ==============================================================================*/
+/** first-fit allocator (lwIP) */
+#define _HEAP_ALLOCATOR_FIRST_FIT       0
+
+/** two-level segregated fit allocator (TLSF) */
+#define _HEAP_ALLOCATOR_TLSF            1
 
 /*==============================================================================
   Exported types, enums definitions
@@ -84,8 +90,16 @@ typedef struct {
         /** the last entry, always unused! */
         struct mem *end;
 
+#if __HEAP_ALLOCATOR__ == _HEAP_ALLOCATOR_TLSF
+        /** free lists and bitmaps (placed at the beginning of the heap) */
+        struct heap_ctrl *ctrl;
+
+        /** number of free blocks */
+        size_t free_blocks;
+#else
         /** pointer to the lowest free block, this is used for faster search */
         struct mem *lfree;
+#endif
 
         /** aligned heap size */
         size_t size;
@@ -95,8 +109,20 @@ typedef struct {
 
         /** heap amx usage */
         size_t used_max;
+
+        /** the longest free block search (number of checked blocks) */
+        u32_t search_max;
 } _heap_t;
 
+typedef struct {
+        size_t size;                    /**< heap size                          */
+        size_t used;                    /**< heap usage                         */
+        size_t used_max;                /**< heap max usage                     */
+        size_t free_blocks;             /**< number of free blocks              */
+        size_t largest_free;            /**< the largest free block             */
+        u32_t  search_max;              /**< the longest free block search      */
+} _heap_stat_t;
+
 /*==============================================================================
   Exported object declarations
 ==============================================================================*/
@@ -111,6 +137,7 @@ extern size_t _heap_get_free(_heap_t*);
 extern size_t _heap_get_used(_heap_t*);
 extern size_t _heap_get_size(_heap_t*);
 extern size_t _heap_get_block_size(_heap_t*, void*);
+extern int    _heap_get_stat(_heap_t*, _heap_stat_t*);
 
 #ifdef __cplusplus
 }
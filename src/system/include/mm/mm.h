@@ -32,6 +32,7 @@
 /*==============================================================================
   Include files
 ==============================================================================*/
+#include <stdbool.h>
 #include "sys/types.h"
 #include "heap.h"
 
@@ -86,9 +87,11 @@ extern int    _mm_register_region(_mm_region_t*, void*, size_t);
 extern int    _mm_get_mem_usage_details(_mm_mem_usage_t*);
 extern int    _mm_get_module_mem_usage(uint module, i32_t *usage);
 extern size_t _mm_get_block_size(void*);
+extern bool   _mm_is_object_in_heap(const void*, size_t);
 extern size_t _mm_get_mem_free(void);
 extern size_t _mm_get_mem_usage(void);
 extern size_t _mm_get_mem_size(void);
+extern int    _mm_get_heap_stat(size_t, _heap_stat_t*);
 extern int    _kzalloc(enum _mm_mem, const size_t, void**, ...);
 extern int    _kmalloc(enum _mm_mem, const size_t, void**, ...);
 extern int    _kfree(enum _mm_mem, void**, ...);
@@ -0,0 +1,101 @@
+/*=========================================================================*//**
+File     slab.h
+
+Author   Daniel Zorychta
+
+Brief    Fixed-size object caches (slab allocator).
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/**
+@defgroup SLAB_H_ SLAB_H_
+
+Detailed Doxygen description.
+*/
+/**@{*/
+
+#ifndef _MM_SLAB_H_
+#define _MM_SLAB_H_
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stddef.h>
+#include "mm/mm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+/**
+ * Object cache (slab).
+ */
+typedef struct _slab _slab_t;
+
+/**
+ * Object cache statistics.
+ */
+typedef struct {
+        const char *name;               //!< cache name
+        size_t      obj_size;           //!< object size
+        size_t      objects;            //!< number of allocated objects
+        size_t      objects_max;        //!< max number of allocated objects
+        size_t      cached;             //!< number of free objects in magazine
+        size_t      capacity;           //!< number of objects in allocated pages
+        size_t      pages;              //!< number of allocated pages
+        size_t      page_size;          //!< page size
+} _slab_stat_t;
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+extern int _slab_create(const char*, size_t, size_t, enum _mm_mem, _slab_t**);
+extern int _slab_destroy(_slab_t*);
+extern int _slab_alloc(_slab_t*, void**);
+extern int _slab_free(_slab_t*, void**);
+extern int _slab_get_stat(size_t, _slab_stat_t*);
+
+/*==============================================================================
+  Exported inline functions
+==============================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MM_SLAB_H_ */
+
+/**@}*/
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -87,6 +87,8 @@ extern int   INET_socket_set_send_timeout(INET_socket_t*, uint32_t);
 extern int   INET_socket_get_recv_timeout(INET_socket_t*, uint32_t*);
 extern int   INET_socket_get_send_timeout(INET_socket_t*, uint32_t*);
 extern int   INET_socket_getaddress(INET_socket_t*, NET_INET_sockaddr_t*);
+extern int   INET_socket_poll(INET_socket_t*, u32_t*, struct _poll_entry*);
+extern int   INET_socket_sendfile(INET_socket_t*, struct vfs_file*, size_t, size_t*);
 extern u16_t INET_hton_u16(u16_t);
 extern u32_t INET_hton_u32(u32_t);
 extern u64_t INET_hton_u64(u64_t);
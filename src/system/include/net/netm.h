@@ -123,6 +123,12 @@ typedef void NET_generic_status_t;
 /** Socket object definition. Protected object fields. */
 typedef struct socket SOCKET;
 
+/** File object (vfs.h). */
+struct vfs_file;
+
+/** Poll waiter entry (kpoll.h). */
+struct _poll_entry;
+
 /*------------------------------------------------------------------------------
   INET NETWORK FAMILY
 ------------------------------------------------------------------------------*/
@@ -141,7 +147,8 @@ typedef enum {
         NET_INET_STATE__STATIC_IP,              //!< Static IP configuration.
         NET_INET_STATE__DHCP_CONFIGURING,       //!< DHCP address is configuring.
         NET_INET_STATE__DHCP_CONFIGURED,        //!< DHCP address configured.
-        NET_INET_STATE__LINK_DISCONNECTED       //!< Network interface not connected.
+        NET_INET_STATE__LINK_DISCONNECTED,      //!< Network interface not connected.
+        NET_INET_STATE__LOOPBACK                //!< Loopback interface configured.
 } NET_INET_state_t;
 
 /** INET configuration mode. */
@@ -150,16 +157,35 @@ typedef enum {
         NET_INET_MODE__DHCP_START,              //!< Start DHCP client.
         NET_INET_MODE__DHCP_INFORM,             //!< Inform DHCP server.
         NET_INET_MODE__DHCP_RENEW,              //!< Renew DHCP connection.
+        NET_INET_MODE__LOOPBACK,                //!< Configure loopback interface (no hardware).
 } NET_INET_mode_t;
 
 /** INET configuration. */
 typedef struct {
         NET_INET_mode_t mode;                   /*!< Configuration mode.*/
-        NET_INET_IPv4_t address;                /*!< Address if static mode selected.*/
-        NET_INET_IPv4_t mask;                   /*!< Network mask if static mode selected.*/
+        NET_INET_IPv4_t address;                /*!< Address if static or loopback mode selected.*/
+        NET_INET_IPv4_t mask;                   /*!< Network mask if static or loopback mode selected.*/
         NET_INET_IPv4_t gateway;                /*!< Gateway address if static mode selected.*/
+        u16_t           mtu;                    /*!< MTU if loopback mode selected (0: default).*/
 } NET_INET_config_t;
 
+/** INET memory pools (used only if dedicated pools are enabled). */
+typedef enum {
+        NET_INET_POOL__PBUF,                    //!< Packet buffers (PBUF_POOL).
+        NET_INET_POOL__TCP_SEG,                 //!< Queued TCP segments.
+        NET_INET_POOL__NETBUF,                  //!< Network buffers.
+        _NET_INET_POOL__COUNT
+} NET_INET_pool_t;
+
+/** INET memory pool statistics. */
+typedef struct {
+        u16_t            size;                  /*!< Object size.*/
+        u16_t            total;                 /*!< Number of objects in pool (0 if pool is disabled).*/
+        u16_t            used;                  /*!< Number of used objects.*/
+        u16_t            used_max;              /*!< Maximum number of used objects.*/
+        u32_t            fails;                 /*!< Number of failed allocations.*/
+} NET_INET_pool_stat_t;
+
 /** INET status. */
 typedef struct {
         NET_INET_state_t state;                 /*!< Connection state.*/
@@ -171,6 +197,7 @@ typedef struct {
         u64_t            rx_bytes;              /*!< Number of received bytes.*/
         u64_t            tx_packets;            /*!< Number of transmitted packets.*/
         u64_t            rx_packets;            /*!< Number of received packets.*/
+        NET_INET_pool_stat_t pool[_NET_INET_POOL__COUNT]; /*!< Memory pool statistics.*/
 } NET_INET_status_t;
 
 /*==============================================================================
@@ -202,6 +229,8 @@ extern int   _net_socket_connect(SOCKET*, const NET_generic_sockaddr_t*);
 extern int   _net_socket_disconnect(SOCKET*);
 extern int   _net_socket_shutdown(SOCKET*, NET_shut_t);
 extern int   _net_socket_getaddress(SOCKET*, NET_generic_sockaddr_t*);
+extern int   _net_socket_poll(SOCKET*, u32_t*, struct _poll_entry*);
+extern int   _net_socket_sendfile(SOCKET*, struct vfs_file*, size_t, size_t*);
 extern u16_t _net_hton_u16(NET_family_t, u16_t);
 extern u32_t _net_hton_u32(NET_family_t, u32_t);
 extern u64_t _net_hton_u64(NET_family_t, u64_t);
@@ -78,10 +78,20 @@
 extern void  vApplicationSwitchedIn (void);
 extern void  vApplicationSwitchedOut(void);
 
+#if __OS_TICKLESS_IDLE__ > 0
+extern void  vPortSuppressTicksAndSleep(uint32_t xExpectedIdleTime);
+extern void  _kernel_tickless_sleep (uint32_t idle_ticks);
+extern void  _kernel_tickless_step  (uint32_t ticks);
+#endif
+
 /* Application specific definitions */
 #define configUSE_PREEMPTION                    1
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#if __OS_TICKLESS_IDLE__ > 0
+#define configUSE_TICKLESS_IDLE                 1
+#else
 #define configUSE_TICKLESS_IDLE                 0
+#endif
 #define configCPU_CLOCK_HZ                      _CPU_START_FREQUENCY_
 #define configTICK_RATE_HZ                      __OS_TASK_SCHED_FREQ__
 #define configMAX_PRIORITIES                    __OS_TASK_MAX_PRIORITIES__
@@ -156,6 +166,11 @@ extern void  vApplicationSwitchedOut(void);
 #define traceTASK_SWITCHED_OUT()                _task_switched_out(pxCurrentTCB, pxCurrentTCB->pxTaskTag)
 #define traceTASK_SWITCHED_IN()                 _task_switched_in(pxCurrentTCB, pxCurrentTCB->pxTaskTag)
 
+#if __OS_TICKLESS_IDLE__ > 0
+#define portSUPPRESS_TICKS_AND_SLEEP(x)         _kernel_tickless_sleep(x)
+#define traceINCREASE_TICK_COUNT(x)             _kernel_tickless_step(x)
+#endif
+
 #if __OS_ENABLE_SYS_ASSERT__ > 0
 extern void _assert_hook(bool assert);
 #define configASSERT(x)                         _assert_hook(x)
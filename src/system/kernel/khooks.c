@@ -41,6 +41,7 @@
 /*==============================================================================
   Local symbolic constants/macros
 ==============================================================================*/
+#define TICK_PERIOD_COUNTS      (configCPU_CLOCK_HZ / configTICK_RATE_HZ)
 
 /*==============================================================================
   Local types, enums definitions
@@ -49,12 +50,21 @@
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
+static void uptime_step(u32_t ticks);
 
 /*==============================================================================
   Local object definitions
 ==============================================================================*/
 static u32_t sec_divider;
 
+#if (__OS_TICKLESS_IDLE__ > 0)
+static volatile bool tickless_sleep;
+static u32_t         tickless_ticks;
+#if (__OS_MONITOR_CPU_LOAD__ > 0)
+static u32_t         tick_CPU_time;
+#endif
+#endif
+
 /*==============================================================================
   Exported object definitions
 ==============================================================================*/
@@ -81,7 +91,8 @@ void vApplicationIdleHook(void)
         vTaskPrioritySet(xTaskGetIdleTaskHandle(), 0);
 
         /*
-         * Sleep CPU for single tick to save energy.
+         * Sleep CPU for single tick to save energy. When tickless idle is
+         * enabled then longer sleep is realized by the kernel after this hook.
          */
         #if (__OS_SLEEP_ON_IDLE__ > 0)
         _cpuctl_sleep();
@@ -105,16 +116,107 @@ void vApplicationStackOverflowHook(TaskHandle_t taskHdl, char *taskName)
  */
 //==============================================================================
 void vApplicationTickHook(void)
+{
+        u32_t ticks = 1;
+
+#if (__OS_TICKLESS_IDLE__ > 0)
+        /*
+         * Tick timer is reprogrammed during tickless sleep thus counter delta
+         * is not valid. First tick after sleep counts whole sleep time from
+         * the last tick (sleep ended by other interrupt is not counted by
+         * _kernel_tickless_step()).
+         */
+        if (tickless_sleep) {
+                ticks         += tickless_ticks;
+                tickless_ticks = 0;
+                tickless_sleep = false;
+
+#if (__OS_MONITOR_CPU_LOAD__ > 0)
+                _cpuctl_get_CPU_load_counter_delta();
+                _CPU_total_time = tick_CPU_time + ticks * TICK_PERIOD_COUNTS;
+#endif
+        } else
+#endif
+        {
+#if (__OS_MONITOR_CPU_LOAD__ > 0)
+                _CPU_total_time += _cpuctl_get_CPU_load_counter_delta();
+#endif
+        }
+
+        uptime_step(ticks);
+}
+
+#if (__OS_TICKLESS_IDLE__ > 0)
+//==============================================================================
+/**
+ * @brief Function suppress system tick and sleep CPU. Function is called by
+ *        the idle task when the scheduler is suspended. Sleep time is
+ *        calculated by the kernel from the nearest timeout of the blocked
+ *        tasks.
+ *
+ * @param idle_ticks    expected idle time [ticks]
+ */
+//==============================================================================
+void _kernel_tickless_sleep(u32_t idle_ticks)
 {
 #if (__OS_MONITOR_CPU_LOAD__ > 0)
         _CPU_total_time += _cpuctl_get_CPU_load_counter_delta();
 #endif
 
-        if (++sec_divider >= configTICK_RATE_HZ) {
-                sec_divider = 0;
-                _uptime_counter_sec++;
+        tickless_sleep = true;
+        vPortSuppressTicksAndSleep(idle_ticks);
+}
+
+//==============================================================================
+/**
+ * @brief Function compensate ticks that were suppressed by tickless sleep.
+ *        Function is called by the kernel in the critical section when tick
+ *        timer is started again. When sleep was ended by the tick interrupt
+ *        then ticks are counted at once, otherwise at the next tick.
+ *
+ * @param ticks         number of suppressed ticks
+ */
+//==============================================================================
+void _kernel_tickless_step(u32_t ticks)
+{
+#if (__OS_MONITOR_CPU_LOAD__ > 0)
+        // counter is synchronized with restarted tick timer
+        _cpuctl_get_CPU_load_counter_delta();
+#endif
+
+        if (tickless_sleep) {
+                tickless_ticks += ticks;
+
+        } else {
+#if (__OS_MONITOR_CPU_LOAD__ > 0)
+                _CPU_total_time += ticks * TICK_PERIOD_COUNTS;
+#endif
+                uptime_step(ticks);
+        }
+}
+#endif
+
+//==============================================================================
+/**
+ * @brief Function advance uptime counter. CPU load is calculated every
+ *        second.
+ *
+ * @param ticks         number of ticks
+ */
+//==============================================================================
+static void uptime_step(u32_t ticks)
+{
+        sec_divider += ticks;
+
+        if (sec_divider >= configTICK_RATE_HZ) {
+                _uptime_counter_sec += sec_divider / configTICK_RATE_HZ;
+                sec_divider         %= configTICK_RATE_HZ;
                 _calculate_CPU_load();
         }
+
+#if (__OS_TICKLESS_IDLE__ > 0) && (__OS_MONITOR_CPU_LOAD__ > 0)
+        tick_CPU_time = _CPU_total_time;
+#endif
 }
 
 //==============================================================================
@@ -168,7 +270,7 @@ u32_t _get_uptime_counter(void)
 void _assert_hook(bool assert)
 {
         if (!assert) {
-                _printk("System assert occurred!");
+                _printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_KERNEL, "System assert occurred!");
         }
 }
 #endif
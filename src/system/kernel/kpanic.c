@@ -119,9 +119,10 @@ bool _kernel_panic_detect(FILE *file)
                         && kernel_panic_descriptor->valid2 == _KERNEL_PANIC_DESC_VALID2 );
 
         if (occurred) {
-                printk("KERNEL PANIC in %s: %d:%d:%s", kernel_panic_descriptor->name,
-                       kernel_panic_descriptor->pid, kernel_panic_descriptor->tid,
-                       cause[kernel_panic_descriptor->cause]);
+                printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_KERNEL,
+                           "KERNEL PANIC in %s: %d:%d:%s", kernel_panic_descriptor->name,
+                           kernel_panic_descriptor->pid, kernel_panic_descriptor->tid,
+                           cause[kernel_panic_descriptor->cause]);
 
                 if (file) {
                         if (kernel_panic_descriptor->cause > _KERNEL_PANIC_DESC_CAUSE_UNKNOWN) {
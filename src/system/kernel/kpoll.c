@@ -0,0 +1,353 @@
+/*=========================================================================*//**
+@file    kpoll.c
+
+@author  Daniel Zorychta
+
+@brief   Waiting for readiness of files, sockets and processes.
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "config.h"
+#include "kernel/kpoll.h"
+#include "kernel/kwrapper.h"
+#include "kernel/process.h"
+#include "kernel/errno.h"
+#include "mm/mm.h"
+#include "net/netm.h"
+#include "lib/cast.h"
+
+/*==============================================================================
+  Local symbolic constants/macros
+==============================================================================*/
+/* events that are always reported */
+#define POLL_ALWAYS             (POLLERR | POLLHUP | POLLNVAL)
+
+/*==============================================================================
+  Local types, enums definitions
+==============================================================================*/
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local object definitions
+==============================================================================*/
+
+/*==============================================================================
+  Exported object definitions
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Function return current events of selected object. If entry is
+ *         set then entry is linked to the wait list of object before events
+ *         are read, thus state change after read is signaled.
+ *
+ * @param  pfd          polled object
+ * @param  entry        entry of waiter (can be NULL)
+ *
+ * @return Object events.
+ */
+//==============================================================================
+static u16_t get_events(struct pollfd *pfd, _poll_entry_t *entry)
+{
+        u32_t events = 0;
+        int   err    = EINVAL;
+
+        switch (pfd->type) {
+        case POLL_TYPE__FILE:
+                err = _vfs_fpoll(pfd->file, &events, entry);
+                break;
+
+        case POLL_TYPE__SOCKET:
+#if __ENABLE_NETWORK__ == _YES_
+                err = _net_socket_poll(pfd->socket, &events, entry);
+#endif
+                break;
+
+        case POLL_TYPE__PROCESS:
+                err = _process_poll(pfd->pid, &events, entry);
+                break;
+        }
+
+        return err ? POLLNVAL : events;
+}
+
+//==============================================================================
+/**
+ * @brief  Function check readiness of all objects. Returned events are set
+ *         in each object. If waiter is set (armed) then waiter is linked to
+ *         wait list of each object.
+ *
+ * @param  fds          objects to check
+ * @param  nfds         number of objects
+ * @param  waiter       armed waiter (can be NULL)
+ * @param  ready        number of objects with returned events
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _poll_scan(struct pollfd *fds, size_t nfds, _poll_waiter_t *waiter, size_t *ready)
+{
+        if (!fds || !nfds || !ready || (waiter && waiter->entries < nfds)) {
+                return EINVAL;
+        }
+
+        *ready = 0;
+
+        for (size_t i = 0; i < nfds; i++) {
+                _poll_entry_t *entry = waiter ? &waiter->entry[i] : NULL;
+
+                fds[i].revents = get_events(&fds[i], entry) & (fds[i].events | POLL_ALWAYS);
+
+                if (fds[i].revents) {
+                        (*ready)++;
+                }
+        }
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief  Function prepare waiter to wait for selected number of objects.
+ *         Entries of previous wait are unlinked and signal left from previous
+ *         wait is dropped. Waiter must be armed before objects are scanned.
+ *
+ * @param  waiter       waiter object
+ * @param  nfds         number of objects
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _poll_arm(_poll_waiter_t *waiter, size_t nfds)
+{
+        if (!waiter || !nfds) {
+                return EINVAL;
+        }
+
+        if (!waiter->sem) {
+                int err = _semaphore_create(1, 0, &waiter->sem);
+                if (err) {
+                        return err;
+                }
+        }
+
+        _poll_disarm(waiter);
+
+        if (waiter->entries < nfds) {
+                if (waiter->entry) {
+                        _kfree(_MM_KRN, cast(void**, &waiter->entry));
+                        waiter->entries = 0;
+                }
+
+                int err = _kzalloc(_MM_KRN, nfds * sizeof(_poll_entry_t),
+                                   cast(void**, &waiter->entry));
+                if (err) {
+                        return err;
+                }
+
+                waiter->entries = nfds;
+        }
+
+        for (size_t i = 0; i < waiter->entries; i++) {
+                waiter->entry[i].waiter = waiter;
+        }
+
+        // drop signal that left from previous wait
+        _semaphore_wait(waiter->sem, 0);
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief  Function remove waiter from wait lists of all objects.
+ *
+ * @param  waiter       waiter object
+ */
+//==============================================================================
+void _poll_disarm(_poll_waiter_t *waiter)
+{
+        if (waiter) {
+                for (size_t i = 0; i < waiter->entries; i++) {
+                        _poll_entry_t *entry = &waiter->entry[i];
+
+                        _critical_section_begin();
+                        {
+                                if (entry->list) {
+                                        _poll_entry_t **e = &entry->list->head;
+
+                                        for (; *e; e = &(*e)->next) {
+                                                if (*e == entry) {
+                                                        *e = entry->next;
+                                                        break;
+                                                }
+                                        }
+
+                                        entry->next = NULL;
+                                        entry->list = NULL;
+                                }
+                        }
+                        _critical_section_end();
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function release waiter resources.
+ *
+ * @param  waiter       waiter object
+ */
+//==============================================================================
+void _poll_release(_poll_waiter_t *waiter)
+{
+        if (waiter) {
+                _poll_disarm(waiter);
+
+                if (waiter->entry) {
+                        _kfree(_MM_KRN, cast(void**, &waiter->entry));
+                        waiter->entries = 0;
+                }
+
+                if (waiter->sem) {
+                        _semaphore_destroy(waiter->sem);
+                        waiter->sem = NULL;
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function link waiter entry to the wait list of object. Function is
+ *         called by object poll function before object state is read.
+ *
+ * @param  list         wait list of object
+ * @param  obj          polled object
+ * @param  entry        waiter entry (NULL: object is not waited)
+ */
+//==============================================================================
+void _poll_wait(_poll_list_t *list, const void *obj, _poll_entry_t *entry)
+{
+        if (list && entry) {
+                _critical_section_begin();
+                {
+                        if (!entry->list) {
+                                entry->obj  = obj;
+                                entry->list = list;
+                                entry->next = list->head;
+                                list->head  = entry;
+                        }
+                }
+                _critical_section_end();
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function wake up waiters of selected object. Function is called by
+ *         object when data become available, space become available, or
+ *         object is closed.
+ *
+ * @param  list         wait list of object
+ * @param  obj          object which state changed (NULL: all waiters of list)
+ */
+//==============================================================================
+void _poll_notify(_poll_list_t *list, const void *obj)
+{
+        if (list && list->head) {
+                _critical_section_begin();
+                {
+                        for (_poll_entry_t *e = list->head; e; e = e->next) {
+                                if (!obj || e->obj == obj) {
+                                        _semaphore_signal(e->waiter->sem);
+                                }
+                        }
+                }
+                _critical_section_end();
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function wake up waiters of selected object. Function is called
+ *         from IRQs. Lists are modified by tasks only in critical section,
+ *         thus IRQ can walk through the list without locking.
+ *
+ * @param  list         wait list of object
+ * @param  obj          object which state changed (NULL: all waiters of list)
+ * @param  task_woken   true if higher priority task was woken (can be NULL)
+ */
+//==============================================================================
+void _poll_notify_from_ISR(_poll_list_t *list, const void *obj, bool *task_woken)
+{
+        for (_poll_entry_t *e = list ? list->head : NULL; e; e = e->next) {
+                if (!obj || e->obj == obj) {
+                        bool woken = false;
+                        _semaphore_signal_from_ISR(e->waiter->sem, &woken);
+
+                        if (woken && task_woken) {
+                                *task_woken = true;
+                        }
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function wake up and unlink all waiters of object. Function must be
+ *         called before object with wait list is freed.
+ *
+ * @param  list         wait list of object
+ */
+//==============================================================================
+void _poll_list_release(_poll_list_t *list)
+{
+        if (list) {
+                _critical_section_begin();
+                {
+                        while (list->head) {
+                                _poll_entry_t *e = list->head;
+                                list->head = e->next;
+
+                                e->next = NULL;
+                                e->list = NULL;
+
+                                _semaphore_signal(e->waiter->sem);
+                        }
+                }
+                _critical_section_end();
+        }
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -37,6 +37,7 @@
 #include "mm/mm.h"
 #include "dnx/misc.h"
 #include "lib/vsnprintf.h"
+#include "lib/cast.h"
 #include "libc/errno.h"
 
 #if ((__OS_SYSTEM_MSG_ENABLE__ > 0) && (__OS_PRINTF_ENABLE__ > 0))
@@ -44,19 +45,41 @@
 /*==============================================================================
   Local macros
 ==============================================================================*/
+#define ARGS_MAX                8
+#define STR_NONE                0xFF
+
+#define SEQ_WRITE(_n)           (((_n) * 2) + 1)
+#define SEQ_DONE(_n)            (((_n) * 2) + 2)
 
 /*==============================================================================
   Local object types
 ==============================================================================*/
+/**
+ * Message is stored in binary form: the format pointer and raw arguments.
+ * String arguments are copied to the message because can be temporary.
+ * The message is formatted when is read.
+ */
 typedef struct {
-        struct {
-                u32_t timestamp;
-                char  str[__OS_SYSTEM_MSG_COLS__];
-        } msg[__OS_SYSTEM_MSG_ROWS__];
-
-        uint8_t wridx;
-        uint8_t rdidx;
-        uint8_t size;
+        u32_t       seq;                        //!< SEQ_WRITE() or SEQ_DONE() of message
+        u32_t       skip;                       //!< SEQ_DONE() of message dropped by writer
+        u32_t       timestamp;                  //!< message timestamp
+        const char *format;                     //!< message format
+        u8_t        level;                      //!< message level
+        u8_t        subsys;                     //!< message subsystem
+        u8_t        argc;                       //!< number of used argument words
+        u8_t        strlen;                     //!< used string buffer
+        u32_t       arg[ARGS_MAX];              //!< raw arguments
+        char        str[__OS_SYSTEM_MSG_COLS__];//!< copied string arguments
+} printk_msg_t;
+
+typedef struct {
+        printk_msg_t msg[__OS_SYSTEM_MSG_ROWS__];
+        u32_t        head;                      //!< sequence of next written message
+        u32_t        tail;                      //!< sequence of next read message
+        u32_t        written;                   //!< written messages counter
+        u32_t        dropped;                   //!< dropped messages counter (reader side)
+        u32_t        filter;                    //!< enabled subsystems
+        u8_t         level;                     //!< maximum stored level
 } printk_log_t;
 
 /*==============================================================================
@@ -66,7 +89,10 @@ typedef struct {
 /*==============================================================================
   Local objects
 ==============================================================================*/
-static printk_log_t log_buf;
+static printk_log_t log_buf = {
+        .filter = UINT32_MAX,
+        .level  = __OS_SYSTEM_MSG_LEVEL__
+};
 
 /*==============================================================================
   Exported objects
@@ -82,38 +108,322 @@ static printk_log_t log_buf;
 
 //==============================================================================
 /**
- * @brief Function send kernel message on terminal
+ * @brief Function parse conversion modifiers in the same way as printf
+ *        formatter does.
  *
- * @param *format             formated text
- * @param ...                 format arguments
+ * @param format        pointer to character after '%' (updated)
+ * @param star          argument size passed by argument (%.*)
+ * @param prec          precision value (-1 if not used)
+ *
+ * @return Conversion character, '\0' if format is incorrect or finished.
  */
 //==============================================================================
-void _printk(const char *format, ...)
+static char parse_conversion(const char **format, bool *star, int *prec)
 {
-        _kernel_scheduler_lock();
-        {
-                if (log_buf.size >= __OS_SYSTEM_MSG_ROWS__) {
-                        log_buf.size = __OS_SYSTEM_MSG_ROWS__;
-                        if (++log_buf.rdidx >= __OS_SYSTEM_MSG_ROWS__) {
-                                log_buf.rdidx = 0;
+        const char *f = *format;
+
+        *star = false;
+        *prec = -1;
+
+        if (*f == '0') {
+                f++;
+        }
+
+        if (*f == '.') {
+                f++;
+
+                if (*f == '*') {
+                        *star = true;
+                        f++;
+
+                } else if (*f >= '0' && *f <= '9') {
+                        *prec = 0;
+                        while (*f >= '0' && *f <= '9') {
+                                *prec = (*prec * 10) + (*f++ - '0');
                         }
                 } else {
-                        log_buf.size++;
+                        return '\0';
+                }
+        } else {
+                while (*f >= '0' && *f <= '9') {
+                        f++;
+                }
+        }
+
+        if (*f == 'l') {
+                f++;
+        }
+
+        *format = f;
+
+        return *f;
+}
+
+//==============================================================================
+/**
+ * @brief Function store raw arguments of message. Arguments are stored until
+ *        the message space is available.
+ *
+ * @param msg           message
+ * @param args          argument list
+ */
+//==============================================================================
+static void store_args(printk_msg_t *msg, va_list *args)
+{
+        const char *f = msg->format;
+
+        while ((f = strchr(f, '%'))) {
+                f++;
+
+                bool star;
+                int  prec;
+                char conv = parse_conversion(&f, &star, &prec);
+                if (conv == '\0') {
+                        break;
+                }
+
+                f++;
+
+                if (star) {
+                        if (msg->argc >= ARGS_MAX) {
+                                break;
+                        }
+
+                        prec = va_arg(*args, int);
+                        msg->arg[msg->argc++] = prec;
+                }
+
+                switch (conv) {
+                case 'c': case 'd': case 'i': case 'u':
+                case 'x': case 'X': case 'p':
+                        if (msg->argc >= ARGS_MAX) {
+                                return;
+                        }
+
+                        msg->arg[msg->argc++] = va_arg(*args, int);
+                        break;
+
+                case 's': {
+                        if (msg->argc >= ARGS_MAX) {
+                                return;
+                        }
+
+                        const char *str = va_arg(*args, const char*);
+                        size_t      len = strlen(str ? str : "");
+                        size_t      sz  = sizeof(msg->str) - msg->strlen;
+
+                        if (prec > 0) {
+                                len = min(len, cast(size_t, prec));
+                        }
+
+                        if (sz > 0) {
+                                len = min(len, sz - 1);
+                                memcpy(&msg->str[msg->strlen], str ? str : "", len);
+                                msg->str[msg->strlen + len] = '\0';
+                                msg->arg[msg->argc++] = msg->strlen;
+                                msg->strlen += len + 1;
+                        } else {
+                                msg->arg[msg->argc++] = STR_NONE;
+                        }
+                        break;
                 }
 
-                va_list args;
-                va_start(args, format);
-                _vsnprintf(log_buf.msg[log_buf.wridx].str,
-                           __OS_SYSTEM_MSG_COLS__, format, args);
-                va_end(args);
+                case 'f': case 'F':
+                        if (msg->argc + 2 > ARGS_MAX) {
+                                return;
+                        }
 
-                log_buf.msg[log_buf.wridx].timestamp = _kernel_get_time_ms();
+                        double val = va_arg(*args, double);
+                        memcpy(&msg->arg[msg->argc], &val, sizeof(double));
+                        msg->argc += 2;
+                        break;
 
-                if (++log_buf.wridx >= __OS_SYSTEM_MSG_ROWS__) {
-                        log_buf.wridx = 0;
+                default:
+                        break;
                 }
         }
-        _kernel_scheduler_unlock();
+}
+
+//==============================================================================
+/**
+ * @brief Function store message in the log. Slot is reserved atomically so
+ *        function can be used by many tasks and interrupts at the same time.
+ *        If slot is still used by other writer (ring overrun) then the message
+ *        is dropped (it is counted when reader passes the message).
+ *
+ * @param level         message level
+ * @param subsys        message subsystem
+ * @param format        message format
+ * @param args          argument list
+ */
+//==============================================================================
+static void log_message(enum _printk_level level, enum _printk_subsys subsys,
+                        const char *format, va_list *args)
+{
+        if (  (level > log_buf.level)
+           || !(log_buf.filter & (1 << subsys)) ) {
+                return;
+        }
+
+        u32_t         n   = __atomic_fetch_add(&log_buf.head, 1, __ATOMIC_SEQ_CST);
+        printk_msg_t *msg = &log_buf.msg[n % __OS_SYSTEM_MSG_ROWS__];
+        u32_t         seq = __atomic_load_n(&msg->seq, __ATOMIC_ACQUIRE);
+
+        if (  (seq & 1)
+           || (cast(i32_t, seq - SEQ_DONE(n)) >= 0 && seq != 0)
+           || !__atomic_compare_exchange_n(&msg->seq, &seq, SEQ_WRITE(n), false,
+                                           __ATOMIC_SEQ_CST, __ATOMIC_RELAXED) ) {
+
+                // slot can be still used by older message, reader counts this
+                // message as dropped
+                __atomic_store_n(&msg->skip, SEQ_DONE(n), __ATOMIC_RELEASE);
+                return;
+        }
+
+        msg->timestamp = _kernel_get_time_ms();
+        msg->format    = format;
+        msg->level     = level;
+        msg->subsys    = subsys;
+        msg->argc      = 0;
+        msg->strlen    = 0;
+
+        store_args(msg, args);
+
+        __atomic_store_n(&msg->seq, SEQ_DONE(n), __ATOMIC_RELEASE);
+        __atomic_fetch_add(&log_buf.written, 1, __ATOMIC_RELAXED);
+}
+
+//==============================================================================
+/**
+ * @brief Function format message to the string.
+ *
+ * @param msg           message
+ * @param str           destination buffer
+ * @param len           destination buffer length
+ *
+ * @return Number of characters written to the buffer.
+ */
+//==============================================================================
+static size_t format_message(const printk_msg_t *msg, char *str, size_t len)
+{
+        const char *f    = msg->format;
+        size_t      n    = 0;
+        u8_t        argi = 0;
+
+        while (*f && (n + 1 < len)) {
+
+                if (*f != '%') {
+                        str[n++] = *f++;
+                        continue;
+                }
+
+                const char *spec = f++;
+
+                bool star;
+                int  prec;
+                char conv = parse_conversion(&f, &star, &prec);
+                if (conv == '\0') {
+                        break;
+                }
+
+                f++;
+
+                char   fmt[12];
+                size_t fmtlen = min(cast(size_t, f - spec), sizeof(fmt) - 1);
+                memcpy(fmt, spec, fmtlen);
+                fmt[fmtlen] = '\0';
+
+                if (star) {
+                        if (argi >= msg->argc) {
+                                break;
+                        }
+
+                        prec = msg->arg[argi++];
+                }
+
+                int argn = (conv == 'f' || conv == 'F') ? 2
+                         : strchr("cdiuxXps", conv)     ? 1 : 0;
+
+                if (argi + argn > msg->argc) {
+                        break;
+                }
+
+                char  *dst = &str[n];
+                size_t sz  = len - n;
+
+                switch (argn) {
+                case 2: {
+                        double val;
+                        memcpy(&val, &msg->arg[argi], sizeof(double));
+                        n += star ? _snprintf(dst, sz, fmt, prec, val)
+                                  : _snprintf(dst, sz, fmt, val);
+                        break;
+                }
+
+                case 1:
+                        if (conv == 's') {
+                                u32_t       off = msg->arg[argi];
+                                const char *s   = (off == STR_NONE) ? "" : &msg->str[off];
+
+                                n += star ? _snprintf(dst, sz, fmt, prec, s)
+                                          : _snprintf(dst, sz, fmt, s);
+                        } else {
+                                int val = msg->arg[argi];
+
+                                n += star ? _snprintf(dst, sz, fmt, prec, val)
+                                          : _snprintf(dst, sz, fmt, val);
+                        }
+                        break;
+
+                default:
+                        n += star ? _snprintf(dst, sz, fmt, prec)
+                                  : _snprintf(dst, sz, fmt);
+                        break;
+                }
+
+                argi += argn;
+        }
+
+        str[n] = '\0';
+
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief Function send kernel message on terminal
+ *
+ * @param *format             formated text
+ * @param ...                 format arguments
+ */
+//==============================================================================
+void _printk(const char *format, ...)
+{
+        va_list args;
+        va_start(args, format);
+        log_message(_PRINTK_LEVEL_INFO, _PRINTK_SUBSYS_KERNEL, format, &args);
+        va_end(args);
+}
+
+//==============================================================================
+/**
+ * @brief Function send kernel message of selected level and subsystem.
+ *        Message is not stored if level is higher than current log level or
+ *        subsystem is filtered out. Function can be used in interrupts.
+ *
+ * @param level               message level
+ * @param subsys              message subsystem
+ * @param *format             formated text (must exist during system runtime)
+ * @param ...                 format arguments
+ */
+//==============================================================================
+void _printk_log(enum _printk_level level, enum _printk_subsys subsys,
+                 const char *format, ...)
+{
+        va_list args;
+        va_start(args, format);
+        log_message(level, subsys, format, &args);
+        va_end(args);
 }
 
 //==============================================================================
@@ -132,26 +442,64 @@ size_t _printk_read(char *str, size_t len, u32_t *timestamp_ms)
         size_t n = 0;
 
         if (str && len) {
+                printk_msg_t msg;
+                bool         found = false;
+
                 _kernel_scheduler_lock();
                 {
-                        if (log_buf.size > 0) {
-                                log_buf.size--;
+                        u32_t head = __atomic_load_n(&log_buf.head, __ATOMIC_ACQUIRE);
+
+                        if (head - log_buf.tail > __OS_SYSTEM_MSG_ROWS__) {
+                                log_buf.dropped += head - log_buf.tail - __OS_SYSTEM_MSG_ROWS__;
+                                log_buf.tail     = head - __OS_SYSTEM_MSG_ROWS__;
+                        }
+
+                        while (!found && (log_buf.tail != head)) {
+                                u32_t         t    = log_buf.tail;
+                                printk_msg_t *slot = &log_buf.msg[t % __OS_SYSTEM_MSG_ROWS__];
+                                u32_t         seq  = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
 
-                                strlcpy(str, log_buf.msg[log_buf.rdidx].str, len);
+                                // message is not finished yet or was dropped because
+                                // slot is used by older message
+                                if (  (seq == SEQ_WRITE(t))
+                                   || (cast(i32_t, seq - SEQ_WRITE(t)) < 0) ) {
 
-                                n = min(len, strnlen(log_buf.msg[log_buf.rdidx].str,
-                                                     __OS_SYSTEM_MSG_COLS__));
+                                        if (__atomic_load_n(&slot->skip, __ATOMIC_ACQUIRE) == SEQ_DONE(t)) {
+                                                log_buf.tail++;
+                                                log_buf.dropped++;
+                                                continue;
+                                        }
 
-                                if (timestamp_ms) {
-                                        *timestamp_ms = log_buf.msg[log_buf.rdidx].timestamp;
+                                        break;
                                 }
 
-                                if (++log_buf.rdidx >= __OS_SYSTEM_MSG_ROWS__) {
-                                        log_buf.rdidx = 0;
+                                log_buf.tail++;
+
+                                // message dropped by writer
+                                if (seq != SEQ_DONE(t)) {
+                                        log_buf.dropped++;
+                                        continue;
+                                }
+
+                                memcpy(&msg, slot, sizeof(printk_msg_t));
+
+                                // message overwritten during copy
+                                if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) == seq) {
+                                        found = true;
+                                } else {
+                                        log_buf.dropped++;
                                 }
                         }
                 }
                 _kernel_scheduler_unlock();
+
+                if (found) {
+                        n = format_message(&msg, str, len);
+
+                        if (timestamp_ms) {
+                                *timestamp_ms = msg.timestamp;
+                        }
+                }
         }
 
         return n;
@@ -166,11 +514,63 @@ void _printk_clear(void)
 {
         _kernel_scheduler_lock();
         {
-                memset(&log_buf, 0, sizeof(log_buf));
+                log_buf.tail = __atomic_load_n(&log_buf.head, __ATOMIC_ACQUIRE);
         }
         _kernel_scheduler_unlock();
 }
 
+//==============================================================================
+/**
+ * Function set maximum level of stored messages.
+ *
+ * @param level         message level
+ */
+//==============================================================================
+void _printk_set_level(enum _printk_level level)
+{
+        log_buf.level = min(level, _PRINTK_LEVEL_DEBUG);
+}
+
+//==============================================================================
+/**
+ * Function set subsystems that are stored in the log.
+ *
+ * @param subsys_mask   mask of enabled subsystems (bit number is the
+ *                      enum _printk_subsys value)
+ */
+//==============================================================================
+void _printk_set_filter(u32_t subsys_mask)
+{
+        log_buf.filter = subsys_mask;
+}
+
+//==============================================================================
+/**
+ * Function return log statistics.
+ *
+ * @param stat          statistics container
+ */
+//==============================================================================
+void _printk_get_stat(_printk_stat_t *stat)
+{
+        if (stat) {
+                _kernel_scheduler_lock();
+                {
+                        // messages overwritten before read are counted here
+                        // because reader can be not active
+                        u32_t head = __atomic_load_n(&log_buf.head, __ATOMIC_ACQUIRE);
+                        u32_t lost = head - log_buf.tail;
+                        lost       = (lost > __OS_SYSTEM_MSG_ROWS__) ? lost - __OS_SYSTEM_MSG_ROWS__ : 0;
+
+                        stat->written = log_buf.written;
+                        stat->dropped = log_buf.dropped + lost;
+                        stat->level   = log_buf.level;
+                        stat->filter  = log_buf.filter;
+                }
+                _kernel_scheduler_unlock();
+        }
+}
+
 #endif
 
 /*==============================================================================
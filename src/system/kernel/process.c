@@ -41,10 +41,12 @@
 #include "kernel/printk.h"
 #include "kernel/sysfunc.h"
 #include "kernel/khooks.h"
+#include "kernel/kpoll.h"
 #include "lib/llist.h"
 #include "lib/cast.h"
 #include "dnx/misc.h"
 #include "mm/shm.h"
+#include "mm/slab.h"
 
 /*==============================================================================
   Local symbolic constants/macros
@@ -67,21 +69,31 @@
 
 #define FLAG_DETACHED                   (1 << 0)
 #define FLAG_KWORKER                    (1 << 1)
+#define FLAG_DESTROYED                  (1 << 2)
 
 /*==============================================================================
   Local types, enums definitions
 ==============================================================================*/
 typedef struct _prog_data pdata_t;
 
+struct _thread {
+        _process_t      *proc;          //!< thread owner
+        tid_t            tid;           //!< thread ID
+        _poll_waiter_t   poll;          //!< poll() waiter of thread
+};
+
 struct _process {
         res_header_t     header;        //!< resource header
         task_t          **task;         //!< process tasks
+        _thread_t       *thread;        //!< thread tags (task tag points to entry)
         flag_t          *event;         //!< events for exit indicator and syscall finish
         FILE            *f_stdin;       //!< stdin file
         FILE            *f_stdout;      //!< stdout file
         FILE            *f_stderr;      //!< stderr file
         void            *globals;       //!< address to global variables
         res_header_t    *res_list;      //!< list of used resources
+        mutex_t         *res_mtx;       //!< resource list protection
+        _poll_list_t     poll;          //!< poll() waiters of process exit
         char            *cwd;           //!< current working path
         const pdata_t   *pdata;         //!< program data
         char            **argv;         //!< program arguments
@@ -92,6 +104,7 @@ struct _process {
         u16_t            CPU_load;      //!< CPU load (10 = 1%)
         i8_t             status;        //!< program status (return value)
         u8_t             flag;          //!< control flags
+        u8_t             syscalls;      //!< number of syscalls in progress
 };
 
 typedef struct {
@@ -105,6 +118,7 @@ typedef struct {
 static void process_code(void *mainfn);
 static void thread_code(void *args);
 static void process_destroy_all_resources(_process_t *proc);
+static void process_free(_process_t **proc);
 static int  resource_destroy(res_header_t *resource);
 static int  argtab_create(const char *str, u8_t *argc, char **argv[]);
 static void argtab_destroy(char **argv);
@@ -133,6 +147,8 @@ static u32_t          CPU_total_time_last;
 static avg_CPU_load_t avg_CPU_load_calc;
 static avg_CPU_load_t avg_CPU_load_result;
 static mutex_t       *process_mtx;
+static _slab_t       *process_slab;
+static _slab_t       *thread_args_slab;
 
 /*==============================================================================
   Exported object definitions
@@ -181,6 +197,8 @@ KERNELSPACE int _process_create(const char *cmd, const process_attr_t *attr, pid
 {
         if (!process_mtx) {
                 _assert(_mutex_create(MUTEX_TYPE_RECURSIVE, &process_mtx) == ESUCC);
+                _assert(_slab_create("process", sizeof(_process_t), 0, _MM_KRN, &process_slab) == ESUCC);
+                _assert(_slab_create("thread", sizeof(thread_args_t), 0, _MM_KRN, &thread_args_slab) == ESUCC);
         }
 
         if (!cmd) {
@@ -189,10 +207,13 @@ KERNELSPACE int _process_create(const char *cmd, const process_attr_t *attr, pid
 
         char       *cmdarg = NULL;
         _process_t *proc   = NULL;
-        int err = _kzalloc(_MM_KRN, sizeof(_process_t), cast(void**, &proc));
+        int err = _slab_alloc(process_slab, cast(void**, &proc));
         if (!err) {
                 proc->header.type = RES_TYPE_PROCESS;
 
+                err = _mutex_create(MUTEX_TYPE_NORMAL, &proc->res_mtx);
+                if (err) goto finish;
+
                 err = process_apply_attributes(proc, attr);
                 if (err) goto finish;
 
@@ -236,16 +257,25 @@ KERNELSPACE int _process_create(const char *cmd, const process_attr_t *attr, pid
                         proc->flag |= FLAG_KWORKER;
                 }
 
-                err = _kzalloc(_MM_KRN, sizeof(task_t*) * PROC_MAX_THREADS(proc),
+                // task tags are allocated in the same block as task table
+                u8_t threads = PROC_MAX_THREADS(proc);
+                err = _kzalloc(_MM_KRN, (sizeof(task_t*) + sizeof(_thread_t)) * threads,
                                cast(void*, &proc->task));
                 if (err) goto finish;
 
+                proc->thread = cast(_thread_t*, &proc->task[threads]);
+
+                for (tid_t tid = 0; tid < threads; tid++) {
+                        proc->thread[tid].proc = proc;
+                        proc->thread[tid].tid  = tid;
+                }
+
                 ATOMIC {
                         err = _task_create(process_code,
                                            proc->pdata->name,
                                            *proc->pdata->stack_depth,
                                            proc->pdata->main,
-                                           proc,
+                                           &proc->thread[0],
                                            &proc->task[0]);
                         if (!err) {
                                 if (attr) {
@@ -278,7 +308,7 @@ KERNELSPACE int _process_create(const char *cmd, const process_attr_t *attr, pid
 
                 if (proc) {
                         process_destroy_all_resources(proc);
-                        _kfree(_MM_KRN, cast(void**, &proc));
+                        process_free(&proc);
                 }
         }
 
@@ -288,29 +318,88 @@ KERNELSPACE int _process_create(const char *cmd, const process_attr_t *attr, pid
 //==============================================================================
 /**
  * Function clean up killed processes. If process has parent then is moved to
- * the zombie list. Only parent can remove zombie process.
+ * the zombie list. Only parent can remove zombie process. Resources are
+ * released at once, but process object is freed when all its syscalls are
+ * finished because workers still use the object.
+ *
+ * @return ESUCC if all killed processes are released, EBUSY if some process
+ *         waits for syscalls in progress.
  */
 //==============================================================================
-KERNELSPACE void _process_clean_up_killed_processes(void)
+KERNELSPACE int _process_clean_up_killed_processes(void)
 {
+        int err = ESUCC;
+
         ATOMIC {
-                while (destroy_process_list) {
-                        _process_t *proc = destroy_process_list;
+                _process_t *prev = NULL;
+                _process_t *proc = destroy_process_list;
 
-                        process_destroy_all_resources(proc);
+                while (proc) {
+                        _process_t *next = cast(_process_t*, proc->header.next);
+
+                        if (not (proc->flag & FLAG_DESTROYED)) {
+                                process_destroy_all_resources(proc);
+                        }
+
+                        if (proc->syscalls > 0) {
+                                err  = EBUSY;
+                                prev = proc;
 
-                        if (not (proc->flag & FLAG_DETACHED)) {
+                        } else if (not (proc->flag & FLAG_DETACHED)) {
                                 process_move_list(proc,
                                                   &destroy_process_list,
                                                   &zombie_process_list);
                         } else {
-                                destroy_process_list = cast(_process_t *, proc->header.next);
+                                if (prev) {
+                                        prev->header.next = cast(res_header_t*, next);
+                                } else {
+                                        destroy_process_list = next;
+                                }
+
                                 _flag_destroy(proc->event);
                                 proc->event = NULL;
-                                _kfree(_MM_KRN, cast(void*, &proc));
+                                process_free(&proc);
                         }
+
+                        proc = next;
                 }
         }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function mark that syscall of selected process is in progress.
+ *         Process object is not freed until syscall is finished.
+ *
+ * @param  proc         process container
+ */
+//==============================================================================
+KERNELSPACE void _process_syscall_begin(_process_t *proc)
+{
+        if (is_proc_valid(proc)) {
+                _kernel_scheduler_lock();
+                proc->syscalls++;
+                _kernel_scheduler_unlock();
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function mark that syscall of selected process is finished. Process
+ *         object cannot be used after this call.
+ *
+ * @param  proc         process container
+ */
+//==============================================================================
+KERNELSPACE void _process_syscall_end(_process_t *proc)
+{
+        if (is_proc_valid(proc)) {
+                _kernel_scheduler_lock();
+                proc->syscalls--;
+                _kernel_scheduler_unlock();
+        }
 }
 
 //==============================================================================
@@ -347,12 +436,18 @@ KERNELSPACE int _process_kill(pid_t pid)
                                                   &active_process_list,
                                                   &destroy_process_list);
 
+                                _poll_notify(&proc->poll, proc);
+
                                 err = ESUCC;
                                 break;
                         }
                 }
         }
 
+        if (!err) {
+                _vfs_fbuf_release(pid, VFS_ALL_THREADS);
+        }
+
         return err;
 }
 
@@ -385,7 +480,7 @@ KERNELSPACE void _process_remove_zombie(_process_t *proc, int *status)
                                 }
 
                                 _flag_destroy(proc->event);
-                                _kfree(_MM_KRN, cast(void*, &proc));
+                                process_free(&proc);
 
                                 break;
                         } else {
@@ -407,8 +502,16 @@ KERNELSPACE void _process_remove_zombie(_process_t *proc, int *status)
 KERNELSPACE void _process_exit(_process_t *proc, int status)
 {
         if (is_proc_valid(proc)) {
+                pid_t pid    = proc->pid;
                 proc->status = status;
 
+                // write data buffered by stdio library
+                _vfs_fbuf_flush(proc->f_stdout);
+
+                if (proc->f_stderr != proc->f_stdout) {
+                        _vfs_fbuf_flush(proc->f_stderr);
+                }
+
                 va_list none;
                 if (proc->f_stdin) {
                         _vfs_vfioctl(proc->f_stdin, IOCTL_VFS__DEFAULT_RD_MODE, none);
@@ -442,8 +545,13 @@ KERNELSPACE void _process_exit(_process_t *proc, int status)
                         process_move_list(proc, &active_process_list, &destroy_process_list);
 
                         proc->task[0] = NULL;
+
+                        // process is not freed until process_mtx is unlocked
+                        _poll_notify(&proc->poll, proc);
                 }
 
+                _vfs_fbuf_release(pid, VFS_ALL_THREADS);
+
                 _task_exit();
         } else {
                 _assert(is_proc_valid(proc));
@@ -463,6 +571,8 @@ KERNELSPACE void _process_abort(_process_t *proc)
         if (is_proc_valid(proc)) {
                 static const char *aborted = "Aborted\n";
                 size_t wrcnt;
+                _vfs_fbuf_flush(proc->f_stdout);
+                _vfs_fbuf_flush(proc->f_stderr);
                 _vfs_fwrite(aborted, strlen(aborted), &wrcnt, proc->f_stderr);
                 _process_exit(proc, -1);
         } else {
@@ -707,6 +817,22 @@ KERNELSPACE _process_t *_process_get_active(void)
         return active_process;
 }
 
+//==============================================================================
+/**
+ * @brief  Function return process of the calling task. Process is read from
+ *         the task tag, so the result does not depend on the context switch
+ *         hook state.
+ *
+ * @return Process object of the calling task.
+ */
+//==============================================================================
+KERNELSPACE _process_t *_process_get_current(void)
+{
+        _process_t *proc = NULL;
+        _task_get_process_container(_THIS_TASK, &proc, NULL);
+        return proc;
+}
+
 //==============================================================================
 /**
  * @brief Function return PID of selected process.
@@ -753,6 +879,42 @@ KERNELSPACE int _process_get_event_flags(_process_t *proc, flag_t **flag)
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function return events of selected process. Process is readable
+ *         when is finished (exit code can be read without blocking).
+ *
+ * @param  pid          process ID
+ * @param  events       process events (POLLIN, POLLHUP)
+ * @param  entry        poll waiter entry (can be NULL)
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+KERNELSPACE int _process_poll(pid_t pid, u32_t *events, _poll_entry_t *entry)
+{
+        int err = EINVAL;
+
+        if (events) {
+                ATOMIC {
+                        _process_t *proc = NULL;
+
+                        err = _process_get_container(pid, &proc);
+                        if (!err) {
+                                _poll_wait(&proc->poll, proc, entry);
+
+                                *events = 0;
+
+                                if (proc->event && (_flag_get(proc->event) & _PROCESS_EXIT_FLAG(0))) {
+                                        *events = POLLIN | POLLHUP;
+                                }
+                        }
+                }
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief  Function return priority of selected process.
@@ -890,16 +1052,26 @@ u8_t _process_get_max_threads(_process_t *proc)
 KERNELSPACE int _process_register_resource(_process_t *proc, res_header_t *resource)
 {
         if (is_proc_valid(proc)) {
-                ATOMIC {
-                        if (proc->res_list == NULL) {
-                                proc->res_list = resource;
-                        } else {
-                                resource->next = proc->res_list;
-                                proc->res_list = resource;
+                int err = _mutex_lock(proc->res_mtx, MAX_DELAY_MS);
+                if (!err && (proc->flag & FLAG_DESTROYED)) {
+                        _mutex_unlock(proc->res_mtx);
+                        err = ESRCH;
+
+                } else if (!err) {
+                        resource->prev  = NULL;
+                        resource->next  = proc->res_list;
+                        resource->owner = proc;
+
+                        if (proc->res_list) {
+                                proc->res_list->prev = resource;
                         }
+
+                        proc->res_list = resource;
+
+                        _mutex_unlock(proc->res_mtx);
                 }
 
-                return ESUCC;
+                return err;
         } else {
                 return ESRCH;
         }
@@ -908,6 +1080,9 @@ KERNELSPACE int _process_register_resource(_process_t *proc, res_header_t *resou
 //==============================================================================
 /**
  * @brief  Function release selected resource of selected type (type is confirmation).
+ *         Resource is unlinked in constant time by using its list links.
+ *         Object is accepted only when it was registered by selected process
+ *         (owner field); links are not used before this check.
  *
  * @param  proc         process container
  * @param  resource     resource address to release
@@ -922,37 +1097,65 @@ KERNELSPACE int _process_release_resource(_process_t *proc, res_header_t *resour
 
         if (is_proc_valid(proc)) {
                 err = ENOENT;
+
+                // object is read only when is placed in heap, all resources
+                // are allocated in heap
+                if (  !resource
+                   || (cast(uintptr_t, resource) & (sizeof(void*) - 1))
+                   || !_mm_is_object_in_heap(resource, sizeof(res_header_t)) ) {
+                        return err;
+                }
+
                 res_header_t *obj_to_destroy = NULL;
 
-                ATOMIC {
-                        res_header_t *prev     = NULL;
-                        int           max_deep = 1024;
-
-                        foreach_resource(curr, proc->res_list) {
-                                if (curr == resource) {
-                                        if (curr->type == type) {
-                                                if (proc->res_list == curr) {
-                                                        proc->res_list = proc->res_list->next;
-                                                } else {
-                                                        prev->next = curr->next;
-                                                }
-
-                                                obj_to_destroy = curr;
-                                        } else {
-                                                err = EFAULT;
-                                        }
+                if (_mutex_lock(proc->res_mtx, MAX_DELAY_MS) == ESUCC) {
 
-                                        break;
-                                } else {
+                        // owner and type are checked before links are used;
+                        // objects of other processes are rejected because
+                        // they are protected by other list lock
+                        bool owned = (resource->owner == proc);
+
+                        // resources are released by process destroy
+                        if (proc->flag & FLAG_DESTROYED) {
+                                owned = false;
+                                err   = ESRCH;
+                        }
 
-                                        prev = curr;
+                        // links must point to resource, otherwise list is
+                        // corrupted or object is not a resource
+                        bool linked = owned
+                                   && (resource->prev ? resource->prev->next == resource
+                                                      : proc->res_list == resource)
+                                   && (!resource->next || resource->next->prev == resource);
 
-                                        if (--max_deep == 0) {
-                                                _assert(max_deep > 0);
-                                                _kernel_panic_report(_KERNEL_PANIC_DESC_CAUSE_INTERNAL);
-                                        }
+                        if (!owned) {
+                                err = (err == ESRCH) ? ESRCH : ENOENT;
+
+                        } else if (resource->type != type) {
+                                err = EFAULT;
+
+                        } else if (!linked) {
+                                err = ENOENT;
+
+                        } else {
+                                if (resource->prev) {
+                                        resource->prev->next = resource->next;
+                                } else {
+                                        proc->res_list = resource->next;
                                 }
+
+                                if (resource->next) {
+                                        resource->next->prev = resource->prev;
+                                }
+
+                                resource->next  = NULL;
+                                resource->prev  = NULL;
+                                resource->owner = NULL;
+
+                                obj_to_destroy = resource;
                         }
+
+                        _mutex_unlock(proc->res_mtx);
                 }
 
                 if (obj_to_destroy) {
@@ -1003,7 +1206,7 @@ KERNELSPACE int _process_thread_create(_process_t          *proc,
                 if (id < threads) {
 
                         thread_args_t *args = NULL;
-                        err = _kmalloc(_MM_KRN, sizeof(thread_args_t), cast(void*, &args));
+                        err = _slab_alloc(thread_args_slab, cast(void*, &args));
                         if (!err) {
 
                                 args->func = func;
@@ -1011,7 +1214,8 @@ KERNELSPACE int _process_thread_create(_process_t          *proc,
 
                                 err = _task_create(thread_code, "",
                                                    (attr ? attr->stack_depth : STACK_DEPTH_LOW),
-                                                   args, proc, &proc->task[id]);
+                                                   args, &proc->thread[id],
+                                                   &proc->task[id]);
                                 if (!err) {
 
                                         if (proc->event) {
@@ -1030,7 +1234,7 @@ KERNELSPACE int _process_thread_create(_process_t          *proc,
                                         }
 
                                 } else {
-                                        _kfree(_MM_KRN, cast(void*, &args));
+                                        _slab_free(thread_args_slab, cast(void*, &args));
                                 }
                         }
                 }
@@ -1064,6 +1268,33 @@ KERNELSPACE int _process_thread_kill(_process_t *proc, tid_t tid)
 
                         err = ESUCC;
                 }
+
+                _vfs_fbuf_release(proc->pid, tid);
+                _poll_disarm(&proc->thread[tid].poll);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * Function return poll() waiter of selected thread. Waiter is a part of the
+ * thread slot, thus is released together with process.
+ *
+ * @param  proc         process
+ * @param  tid          thread ID
+ * @param  waiter       poll waiter
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+KERNELSPACE int _process_thread_get_poll_waiter(_process_t *proc, tid_t tid, _poll_waiter_t **waiter)
+{
+        int err = EINVAL;
+
+        if (is_proc_valid(proc) && is_tid_in_range(proc, tid) && waiter) {
+                *waiter = &proc->thread[tid].poll;
+                err     = ESUCC;
         }
 
         return err;
@@ -1110,22 +1341,15 @@ KERNELSPACE void _task_get_process_container(task_t *taskhdl, _process_t **proc,
                 taskhdl = taskhdl ? taskhdl : _task_get_handle();
                 _assert(taskhdl);
 
-                _process_t *p = _task_get_tag(taskhdl);
-                _assert(p);
+                _thread_t *thread = _task_get_tag(taskhdl);
+                _assert(thread);
 
                 if (proc) {
-                        *proc = p;
+                        *proc = thread->proc;
                 }
 
-                u8_t threads = PROC_MAX_THREADS(p);
-
-                for (int i = 0; i < threads; i++) {
-                        if (p->task[i] == taskhdl) {
-                                if (tid) {
-                                        *tid = i;
-                                }
-                                break;
-                        }
+                if (tid) {
+                        *tid = thread->tid;
                 }
         }
 }
@@ -1206,7 +1430,8 @@ USERSPACE static void process_code(void *mainfn)
         _assert(mainfn);
 
         process_func_t  funcmain = mainfn;
-        _process_t     *proc     = _task_get_tag(_THIS_TASK);
+        _thread_t      *thread   = _task_get_tag(_THIS_TASK);
+        _process_t     *proc     = thread->proc;
 
         proc->status = funcmain(proc->argc, proc->argv);
 
@@ -1225,7 +1450,7 @@ USERSPACE static void thread_code(void *arg)
         _assert(arg);
 
         thread_args_t args = *cast(thread_args_t*, arg);
-        _kfree(_MM_KRN, cast(void*, &arg));
+        _slab_free(thread_args_slab, cast(void*, &arg));
 
         _assert(args.func);
         args.func(args.arg);
@@ -1293,6 +1518,9 @@ static void process_destroy_all_resources(_process_t *proc)
 {
         u8_t threads = PROC_MAX_THREADS(proc);
 
+        // NOTE: task table is freed together with process object because
+        //       task tags point to this memory and destroyed task can be
+        //       still switched by kernel.
         if (proc->task) {
                 for (tid_t tid = 0; tid < threads; tid++) {
                         if (proc->task[tid]) {
@@ -1300,8 +1528,6 @@ static void process_destroy_all_resources(_process_t *proc)
                                 proc->task[tid] = NULL;
                         }
                 }
-
-                _kfree(_MM_KRN, cast(void*, &proc->task));
         }
 
         if (proc->argv) {
@@ -1310,14 +1536,34 @@ static void process_destroy_all_resources(_process_t *proc)
                 proc->argc = 0;
         }
 
+        // resource list is taken at once; resources registered or released
+        // by workers after this point are rejected
+        res_header_t *res_list = NULL;
+
+        if (proc->res_mtx && _mutex_lock(proc->res_mtx, MAX_DELAY_MS) == ESUCC) {
+                res_list        = proc->res_list;
+                proc->res_list  = NULL;
+                proc->flag     |= FLAG_DESTROYED;
+
+                foreach_resource(res, res_list) {
+                        res->owner = NULL;
+                }
+
+                _mutex_unlock(proc->res_mtx);
+        }
+
         // free all resources
-        while (proc->res_list) {
-                res_header_t *resource = proc->res_list;
-                proc->res_list = resource->next;
+        while (res_list) {
+                res_header_t *resource = res_list;
+                res_list = resource->next;
+
+                resource->next = NULL;
+                resource->prev = NULL;
 
                 int err = resource_destroy(resource);
                 if (err != ESUCC) {
-                        printk("PROCESS: PID %d: unknown object %p\n", proc->pid, resource);
+                        printk_log(_PRINTK_LEVEL_WARNING, _PRINTK_SUBSYS_KERNEL,
+                                   "PROCESS: PID %d: unknown object %p\n", proc->pid, resource);
                 }
         }
 
@@ -1330,13 +1576,43 @@ static void process_destroy_all_resources(_process_t *proc)
         _shm_detach_anywhere(proc->pid);
 #endif
 
-        proc->res_list = NULL;
         proc->f_stdin  = NULL;
         proc->f_stdout = NULL;
         proc->f_stderr = NULL;
         proc->globals  = NULL;
 }
 
+//==============================================================================
+/**
+ * @brief  Function free process object. Process resources must be released
+ *         before.
+ *
+ * @param  proc     process to free
+ */
+//==============================================================================
+static void process_free(_process_t **proc)
+{
+        _poll_list_release(&(*proc)->poll);
+
+        if ((*proc)->res_mtx) {
+                _mutex_destroy((*proc)->res_mtx);
+                (*proc)->res_mtx = NULL;
+        }
+
+        if ((*proc)->task) {
+                u8_t threads = PROC_MAX_THREADS(*proc);
+
+                for (tid_t tid = 0; tid < threads; tid++) {
+                        _poll_release(&(*proc)->thread[tid].poll);
+                }
+
+                _kfree(_MM_KRN, cast(void*, &(*proc)->task));
+                (*proc)->thread = NULL;
+        }
+
+        _slab_free(process_slab, cast(void**, proc));
+}
+
 //==============================================================================
 /**
  * @brief  Function gets process statistics.
@@ -1360,13 +1636,24 @@ static void process_get_stat(_process_t *proc, process_stat_t *stat)
         stat->socket_count    = 0;
         stat->threads_count   = 0;
 
+        stat->stack_min_free  = UINT16_MAX;
+
         u8_t threads = PROC_MAX_THREADS(proc);
         for (tid_t tid = 0; tid < threads; tid++) {
                 if (proc->task[tid]) {
                         stat->threads_count++;
+
+                        int free = _task_get_free_stack(proc->task[tid]);
+                        stat->stack_min_free = min(stat->stack_min_free, free);
                 }
         }
 
+        if (stat->threads_count == 0) {
+                stat->stack_min_free = 0;
+        }
+
+        _mutex_lock(proc->res_mtx, MAX_DELAY_MS);
+
         foreach_resource(res, proc->res_list) {
                 switch (res->type) {
                 case RES_TYPE_FILE:
@@ -1400,6 +1687,8 @@ static void process_get_stat(_process_t *proc, process_stat_t *stat)
                 }
         }
 
+        _mutex_unlock(proc->res_mtx);
+
         stat->memory_usage = _mm_align(stat->memory_usage);
 }
 
@@ -1957,21 +2246,15 @@ KERNELSPACE void _task_switched_in(task_t *task, void *task_tag)
         _CPU_total_time    += _cpuctl_get_CPU_load_counter_delta();
         CPU_total_time_last = _CPU_total_time;
 #endif
-        active_process = task_tag;
-        active_thread  = -1;
+        _thread_t *thread = task_tag;
 
-        if (active_process) {
-                u8_t threads = PROC_MAX_THREADS(active_process);
-
-                // NOTE: there is possibility to not find selected thread of
-                //       process, this mean that thread was removed but is still
-                //       in memory thus can be switched by kernel.
-                for (int i = 0; i < threads; i++) {
-                        if (active_process->task[i] == task) {
-                                active_thread = i;
-                                break;
-                        }
-                }
+        if (thread) {
+                active_process = thread->proc;
+
+                // NOTE: thread can be removed but is still in memory thus can
+                //       be switched by kernel.
+                active_thread  = (active_process->task[thread->tid] == task)
+                               ? thread->tid : -1;
 
                 stdin  = active_process->f_stdin;
                 stdout = active_process->f_stdout;
@@ -1979,6 +2262,9 @@ KERNELSPACE void _task_switched_in(task_t *task, void *task_tag)
                 global = active_process->globals;
                 _errno = active_process->errnov;
         } else {
+                active_process = NULL;
+                active_thread  = -1;
+
                 stdin  = NULL;
                 stdout = NULL;
                 stderr = NULL;
@@ -41,10 +41,12 @@
 #include "kernel/errno.h"
 #include "kernel/time.h"
 #include "kernel/khooks.h"
+#include "kernel/kpoll.h"
 #include "lib/cast.h"
 #include "lib/unarg.h"
 #include "lib/strlcat.h"
 #include "lib/strlcpy.h"
+#include "dnx/misc.h"
 #include "net/netm.h"
 #include "mm/shm.h"
 #include "mm/cache.h"
@@ -53,13 +55,30 @@
   Local macros
 ==============================================================================*/
 #define SYSCALL_QUEUE_LENGTH            8
+#define SYSCALL_POOL_QUEUE_LENGTH       8
+#define WORKER_IDLE_TIMEOUT_MS          1000
+#define WORKER_RETRY_PERIOD_MS          10
+#define WORKER_MEMORY_LOW               (__OS_SYSTEM_CACHE_MIN_FREE__)
+
+#if __ENABLE_NETWORK__ == _YES_
+#define NET_WORKERS                     (__OS_SYSCALL_NET_WORKERS__)
+#else
+#define NET_WORKERS                     0
+#endif
 
 #if __OS_SYSTEM_FS_CACHE_ENABLE__ > 0
-#define SYNC_PERIOD_MS                  (1000 * __OS_SYSTEM_CACHE_SYNC_PERIOD__)
+#define WRITEBACK_THREADS               1
 #else
-#define SYNC_PERIOD_MS                  MAX_DELAY_MS
+#define WRITEBACK_THREADS               0
 #endif
 
+#if ((__OS_SYSCALL_FS_WORKERS__ + NET_WORKERS + WRITEBACK_THREADS) >= __OS_TASK_MAX_SYSTEM_THREADS__)
+#error "Number of syscall workers must be lower than number of system threads!"
+#endif
+
+/* all pools together, kworker main thread and writeback thread are excluded */
+#define WORKERS_LIMIT                   (__OS_TASK_MAX_SYSTEM_THREADS__ - 1 - WRITEBACK_THREADS)
+
 #define GETARG(type, var)               type var = va_arg(rq->args, type)
 #define LOADARG(type)                   va_arg(rq->args, type)
 #define GETRETURN(type, var)            type var = rq->retptr
@@ -77,21 +96,39 @@
 /*==============================================================================
   Local object types
 ==============================================================================*/
-typedef struct {
-        void       *retptr;
-        _process_t *client_proc;
-        tid_t       client_thread;
-        syscall_t   syscall_no;
-        va_list     args;
-        int         err;
+typedef struct syscallrq {
+        void             *retptr;
+        _process_t       *client_proc;
+        tid_t             client_thread;
+        syscall_t         syscall_no;
+        va_list           args;
+        int               err;
+        u32_t             timestamp;
+        struct syscallrq *next;
 } syscallrq_t;
 
+typedef struct {
+        queue_t              *queue;            //!< pending requests
+        syscallrq_t          *deferred;         //!< requests not fit in queue
+        syscallrq_t          *deferred_last;    //!< last deferred request
+        const thread_attr_t  *thread_attr;      //!< worker thread attributes
+        u32_t                 reap_time;        //!< time of last worker spawn or release
+        _syscall_pool_stat_t  stat;             //!< pool statistics
+} syscall_pool_t;
+
 typedef void (*syscallfunc_t)(syscallrq_t*);
 
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
 static void syscall_do(void *rq);
+static void syscall_worker(void *arg);
+static int  syscall_pool_spawn_worker(syscall_pool_t *pool);
+static int  syscall_pool_balance(syscall_pool_t *pool);
+static u32_t syscall_pool_reap(syscall_pool_t *pool);
+static size_t syscall_pool_get_total_workers(void);
+static void syscall_pool_dispatch(syscall_pool_t *pool, syscallrq_t *rq);
+static bool syscall_pool_send_deferred(syscall_pool_t *pool);
 static void syscall_mount(syscallrq_t *rq);
 static void syscall_umount(syscallrq_t *rq);
 #if __OS_ENABLE_STATFS__ == _YES_
@@ -132,9 +169,12 @@ static void syscall_fopen(syscallrq_t *rq);
 static void syscall_fclose(syscallrq_t *rq);
 static void syscall_fwrite(syscallrq_t *rq);
 static void syscall_fread(syscallrq_t *rq);
+static void syscall_fcopy(syscallrq_t *rq);
 static void syscall_fseek(syscallrq_t *rq);
 static void syscall_ioctl(syscallrq_t *rq);
 static void syscall_fflush(syscallrq_t *rq);
+static void syscall_fsetvbuf(syscallrq_t *rq);
+static void syscall_poll(syscallrq_t *rq);
 static void syscall_sync(syscallrq_t *rq);
 #if __OS_ENABLE_TIMEMAN__ == _YES_
 static void syscall_gettime(syscallrq_t *rq);
@@ -189,6 +229,7 @@ static void syscall_netshutdown(syscallrq_t *rq);
 static void syscall_netsendto(syscallrq_t *rq);
 static void syscall_netrecvfrom(syscallrq_t *rq);
 static void syscall_netgetaddress(syscallrq_t *rq);
+static void syscall_netsendfile(syscallrq_t *rq);
 #endif
 #if __OS_ENABLE_SHARED_MEMORY__ == _YES_
 static void syscall_shmcreate(syscallrq_t *rq);
@@ -203,8 +244,33 @@ static void syscall_shmdestroy(syscallrq_t *rq);
 ==============================================================================*/
 static queue_t *call_request;
 
+static const thread_attr_t fs_worker_attr = {
+        .stack_depth = STACK_DEPTH_CUSTOM(__OS_FILE_SYSTEM_STACK_DEPTH__),
+        .priority    = PRIORITY_NORMAL,
+        .detached    = true
+};
+
+static const thread_attr_t net_worker_attr = {
+        .stack_depth = STACK_DEPTH_CUSTOM(__OS_NETWORK_STACK_DEPTH__),
+        .priority    = PRIORITY_NORMAL,
+        .detached    = true
+};
+
+static syscall_pool_t pool[_SYSCALL_POOL_COUNT] = {
+        [_SYSCALL_POOL_FS ] = {.thread_attr = &fs_worker_attr,
+                               .stat        = {.name = "fs", .max_workers = __OS_SYSCALL_FS_WORKERS__}},
+        [_SYSCALL_POOL_NET] = {.thread_attr = &net_worker_attr,
+                               .stat        = {.name = "net", .max_workers = NET_WORKERS}},
+};
+
 #if __OS_SYSTEM_FS_CACHE_ENABLE__ > 0
-static u32_t sync_period_ref;
+static const thread_attr_t writeback_attr = {
+        .stack_depth = STACK_DEPTH_CUSTOM(__OS_FILE_SYSTEM_STACK_DEPTH__),
+        .priority    = PRIORITY_NORMAL,
+        .detached    = true
+};
+
+static bool writeback_started;
 #endif
 
 /* syscall table */
@@ -257,9 +323,12 @@ static const syscallfunc_t syscalltab[] = {
         [SYSCALL_FCLOSE] = syscall_fclose,
         [SYSCALL_FWRITE] = syscall_fwrite,
         [SYSCALL_FREAD ] = syscall_fread,
+        [SYSCALL_FCOPY ] = syscall_fcopy,
         [SYSCALL_FSEEK ] = syscall_fseek,
         [SYSCALL_IOCTL ] = syscall_ioctl,
         [SYSCALL_FFLUSH] = syscall_fflush,
+        [SYSCALL_FSETVBUF] = syscall_fsetvbuf,
+        [SYSCALL_POLL  ] = syscall_poll,
         [SYSCALL_SYNC  ] = syscall_sync,
         #if __OS_ENABLE_TIMEMAN__ == _YES_
         [SYSCALL_GETTIME] = syscall_gettime,
@@ -317,6 +386,7 @@ static const syscallfunc_t syscalltab[] = {
         [SYSCALL_NETSENDTO        ] = syscall_netsendto,
         [SYSCALL_NETRECVFROM      ] = syscall_netrecvfrom,
         [SYSCALL_NETGETADDRESS    ] = syscall_netgetaddress,
+        [SYSCALL_NETSENDFILE      ] = syscall_netsendfile,
         #endif
 };
 
@@ -356,6 +426,11 @@ int _syscall_init()
         int err = ESUCC;
 
         err |= _queue_create(SYSCALL_QUEUE_LENGTH, sizeof(syscallrq_t*), &call_request);
+
+        for (int i = 0; i < _SYSCALL_POOL_COUNT; i++) {
+                err |= _queue_create(SYSCALL_POOL_QUEUE_LENGTH, sizeof(syscallrq_t*), &pool[i].queue);
+        }
+
         err |= _process_create("kworker", &attr, NULL);
         err |= _process_create(__OS_INIT_PROG__, &attr, NULL);
 
@@ -391,7 +466,9 @@ void syscall(syscall_t syscall, void *retptr, ...)
                                 .client_proc    = proc,
                                 .client_thread  = tid,
                                 .retptr         = retptr,
-                                .err            = ESUCC
+                                .err            = ESUCC,
+                                .timestamp      = _kernel_get_time_ms(),
+                                .next           = NULL
                         };
 
                         va_start(syscallrq.args, retptr);
@@ -423,6 +500,10 @@ void syscall(syscall_t syscall, void *retptr, ...)
 /**
  * @brief  Main syscall process (master) [KERNELSPACE].
  *
+ * Non-blocking syscalls are realized directly by this thread. Blocking syscalls
+ * are passed to the worker pool selected by syscall group. Dirty caches are
+ * synchronized by separate writeback thread started by this process.
+ *
  * @param  argc         argument count
  * @param  argv         arguments
  *
@@ -433,73 +514,76 @@ int _syscall_kworker_process(int argc, char *argv[])
 {
         UNUSED_ARG2(argc, argv);
 
-        static const thread_attr_t fs_blocking_thread_attr = {
-                .stack_depth = STACK_DEPTH_CUSTOM(__OS_FILE_SYSTEM_STACK_DEPTH__),
-                .priority    = PRIORITY_NORMAL,
-                .detached    = true
-        };
-
-        static const thread_attr_t net_blocking_thread_attr = {
-                .stack_depth = STACK_DEPTH_CUSTOM(__OS_NETWORK_STACK_DEPTH__),
-                .priority    = PRIORITY_NORMAL,
-                .detached    = true
-        };
-
         _task_get_process_container(_THIS_TASK, &_kworker_proc, NULL);
         _assert(_kworker_proc);
 
+        for (int i = 0; i < _SYSCALL_POOL_COUNT; i++) {
+                while (  pool[i].stat.workers < pool[i].stat.max_workers
+                      && syscall_pool_spawn_worker(&pool[i]) == ESUCC);
+        }
+
+        u32_t timeout = MAX_DELAY_MS;
+
+#if __OS_SYSTEM_FS_CACHE_ENABLE__ > 0
+        writeback_started = _process_thread_create(_kworker_proc, _cache_writeback_thread,
+                                                   &writeback_attr, NULL, NULL) == ESUCC;
+        if (!writeback_started) {
+                timeout = WORKER_RETRY_PERIOD_MS;
+        }
+#endif
+
         for (;;) {
                 syscallrq_t *rq;
-                if (_queue_receive(call_request, &rq, SYNC_PERIOD_MS) == ESUCC) {
+                bool received = _queue_receive(call_request, &rq, timeout) == ESUCC;
 
-                        _process_clean_up_killed_processes();
+                // requests can wait for worker if there was lack of memory
+                timeout = MAX_DELAY_MS;
+
+                if (received) {
+                        _process_syscall_begin(rq->client_proc);
+                }
 
+                // killed process is freed when its syscalls are finished
+                if (_process_clean_up_killed_processes() != ESUCC) {
+                        timeout = WORKER_RETRY_PERIOD_MS;
+                }
+
+                if (received) {
                         if (rq->syscall_no <= _SYSCALL_GROUP_0_OS_NON_BLOCKING) {
                                 syscall_do(rq);
+
+                        } else if (rq->syscall_no <= _SYSCALL_GROUP_1_FS_BLOCKING) {
+                                syscall_pool_dispatch(&pool[_SYSCALL_POOL_FS], rq);
+
+                        } else if (rq->syscall_no <= _SYSCALL_GROUP_2_NET_BLOCKING) {
+                                syscall_pool_dispatch(&pool[_SYSCALL_POOL_NET], rq);
+
                         } else {
-                                /* select stack size according to syscall group */
-                                const thread_attr_t *thread_attr = NULL;
-                                if (rq->syscall_no <= _SYSCALL_GROUP_1_FS_BLOCKING) {
-                                        thread_attr = &fs_blocking_thread_attr;
-                                } else if (rq->syscall_no <= _SYSCALL_GROUP_2_NET_BLOCKING) {
-                                        thread_attr = &net_blocking_thread_attr;
-                                } else {
-                                        _kernel_panic_report(_KERNEL_PANIC_DESC_CAUSE_INTERNAL);
-                                        continue;
-                                }
+                                _kernel_panic_report(_KERNEL_PANIC_DESC_CAUSE_INTERNAL);
+                        }
+                }
 
-                                _kernel_release_resources();
-
-                                /* create new syscall task */
-                                switch (_process_thread_create(_kworker_proc,
-                                                               syscall_do,
-                                                               thread_attr,
-                                                               rq, NULL) ) {
-                                case ESUCC:
-                                        _task_yield();
-                                        break;
-
-                                // destroy top process to get free memory
-                                case ENOMEM:
-                                        _assert(false);
-                                        _process_clean_up_killed_processes();
-                                        _kernel_release_resources();
-                                        _vfs_sync();
-                                        _cache_sync();
-                                        // go through
-
-                                default:
-                                        _queue_send(call_request, &rq, MAX_DELAY_MS);
-                                        _sleep_ms(5);
-                                        break;
-                                }
+                for (int i = 0; i < _SYSCALL_POOL_COUNT; i++) {
+                        if (!syscall_pool_send_deferred(&pool[i])) {
+                                timeout = WORKER_RETRY_PERIOD_MS;
+                        }
+
+                        if (syscall_pool_balance(&pool[i]) != ESUCC) {
+                                timeout = WORKER_RETRY_PERIOD_MS;
                         }
+
+                        timeout = min(timeout, syscall_pool_reap(&pool[i]));
                 }
-#if __OS_SYSTEM_FS_CACHE_ENABLE__ > 0
-                if ( (_kernel_get_time_ms() - sync_period_ref) >= SYNC_PERIOD_MS) {
 
-                        _cache_sync();
-                        sync_period_ref = _kernel_get_time_ms();
+#if __OS_SYSTEM_FS_CACHE_ENABLE__ > 0
+                if (!writeback_started) {
+                        writeback_started = _process_thread_create(_kworker_proc,
+                                                                   _cache_writeback_thread,
+                                                                   &writeback_attr,
+                                                                   NULL, NULL) == ESUCC;
+                        if (!writeback_started) {
+                                timeout = WORKER_RETRY_PERIOD_MS;
+                        }
                 }
 #endif
         }
@@ -507,6 +591,313 @@ int _syscall_kworker_process(int argc, char *argv[])
         return -1;
 }
 
+//==============================================================================
+/**
+ * @brief  Function return statistics of selected syscall worker pool.
+ *
+ * @param  pool_no      pool number
+ * @param  stat         statistics container
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _syscall_get_pool_stat(enum _syscall_pool pool_no, _syscall_pool_stat_t *stat)
+{
+        int err = EINVAL;
+
+        if (pool_no < _SYSCALL_POOL_COUNT && stat) {
+                syscall_pool_t *p = &pool[pool_no];
+
+                size_t pending = 0;
+                _queue_get_number_of_items(p->queue, &pending);
+
+                _kernel_scheduler_lock();
+                {
+                        p->stat.queue_depth = pending;
+                        *stat = p->stat;
+                }
+                _kernel_scheduler_unlock();
+
+                err = ESUCC;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function create new worker in selected pool.
+ *
+ * @param  pool         worker pool
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int syscall_pool_spawn_worker(syscall_pool_t *pool)
+{
+        _kernel_scheduler_lock();
+        {
+                pool->stat.workers++;
+                pool->stat.idle++;
+        }
+        _kernel_scheduler_unlock();
+
+        _kernel_release_resources();
+
+        int err = _process_thread_create(_kworker_proc, syscall_worker,
+                                         pool->thread_attr, pool, NULL);
+        if (!err) {
+                pool->reap_time = _kernel_get_time_ms();
+
+        } else {
+                _kernel_scheduler_lock();
+                {
+                        pool->stat.workers--;
+                        pool->stat.idle--;
+                }
+                _kernel_scheduler_unlock();
+
+                // release killed processes to get free memory
+                if (err == ENOMEM) {
+                        _process_clean_up_killed_processes();
+                        _kernel_release_resources();
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function return number of workers of all pools.
+ *
+ * @return Number of workers.
+ */
+//==============================================================================
+static size_t syscall_pool_get_total_workers(void)
+{
+        size_t total = 0;
+
+        for (int i = 0; i < _SYSCALL_POOL_COUNT; i++) {
+                total += pool[i].stat.workers;
+        }
+
+        return total;
+}
+
+//==============================================================================
+/**
+ * @brief  Function create new worker if there are more pending requests than
+ *         idle workers. Workers over pool size are created when all workers
+ *         are busy; they are released by syscall_pool_reap().
+ *
+ * @param  pool         worker pool
+ *
+ * @return If there are pending requests and no worker can be created then
+ *         error is returned, otherwise ESUCC.
+ */
+//==============================================================================
+static int syscall_pool_balance(syscall_pool_t *pool)
+{
+        int    err      = ESUCC;
+        bool   spawn    = false;
+        bool   overflow = false;
+        size_t pending  = 0;
+
+        _kernel_scheduler_lock();
+        {
+                _queue_get_number_of_items(pool->queue, &pending);
+
+                pool->stat.queue_depth = pending;
+                pool->stat.queue_max   = max(pool->stat.queue_max, pool->stat.queue_depth);
+
+                // blocking requests (e.g. pipe or tty read) can occupy all
+                // pooled workers, so overflow workers are created up to the
+                // limit of system threads
+                spawn = (pending > pool->stat.idle)
+                     && (syscall_pool_get_total_workers() < WORKERS_LIMIT);
+                overflow = (pool->stat.workers >= pool->stat.max_workers);
+        }
+        _kernel_scheduler_unlock();
+
+        if (spawn) {
+                err = syscall_pool_spawn_worker(pool);
+
+                if (!err && overflow) {
+                        _kernel_scheduler_lock();
+                        pool->stat.overflows++;
+                        _kernel_scheduler_unlock();
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function release idle worker when pool has more workers than its
+ *         size or there is lack of free memory. Worker is released when
+ *         there was no spawn or release in the pool for
+ *         WORKER_IDLE_TIMEOUT_MS. Idle workers wait for requests without
+ *         timeout, so worker is released by NULL request.
+ *
+ * @param  pool         worker pool
+ *
+ * @return Time after which function should be called again.
+ */
+//==============================================================================
+static u32_t syscall_pool_reap(syscall_pool_t *pool)
+{
+        bool  excess  = false;
+        bool  reap    = false;
+        bool  lowmem  = _mm_get_mem_free() < WORKER_MEMORY_LOW;
+        u32_t elapsed = _kernel_get_time_ms() - pool->reap_time;
+
+        _kernel_scheduler_lock();
+        {
+                size_t pending = 0;
+                _queue_get_number_of_items(pool->queue, &pending);
+
+                excess = (pending == 0) && (pool->stat.idle > 0)
+                      && (lowmem || pool->stat.workers > pool->stat.max_workers);
+
+                if (excess && elapsed >= WORKER_IDLE_TIMEOUT_MS) {
+                        pool->stat.workers--;
+                        pool->stat.idle--;
+                        pool->stat.shrinks += lowmem ? 1 : 0;
+                        reap = true;
+                }
+        }
+        _kernel_scheduler_unlock();
+
+        if (reap) {
+                syscallrq_t *rq = NULL;
+
+                if (_queue_send(pool->queue, &rq, 0) != ESUCC) {
+                        _kernel_scheduler_lock();
+                        {
+                                pool->stat.workers++;
+                                pool->stat.idle++;
+                                pool->stat.shrinks -= lowmem ? 1 : 0;
+                        }
+                        _kernel_scheduler_unlock();
+                }
+
+                pool->reap_time = _kernel_get_time_ms();
+                elapsed         = 0;
+        }
+
+        return excess ? (WORKER_IDLE_TIMEOUT_MS - elapsed) : MAX_DELAY_MS;
+}
+
+//==============================================================================
+/**
+ * @brief  Function pass request to the selected worker pool. If pool queue is
+ *         full then request is deferred and sent later by kworker, so kworker
+ *         never waits for pool and other requests are still realized.
+ *
+ * @param  pool         worker pool
+ * @param  rq           request
+ */
+//==============================================================================
+static void syscall_pool_dispatch(syscall_pool_t *pool, syscallrq_t *rq)
+{
+        // deferred requests are sent first to keep order of requests
+        if (!syscall_pool_send_deferred(pool) || _queue_send(pool->queue, &rq, 0) != ESUCC) {
+
+                rq->next = NULL;
+
+                if (pool->deferred_last) {
+                        pool->deferred_last->next = rq;
+                } else {
+                        pool->deferred = rq;
+                }
+
+                pool->deferred_last = rq;
+        }
+
+        syscall_pool_balance(pool);
+}
+
+//==============================================================================
+/**
+ * @brief  Function send deferred requests to the pool queue.
+ *
+ * @param  pool         worker pool
+ *
+ * @return If all deferred requests are sent then true is returned, otherwise
+ *         false.
+ */
+//==============================================================================
+static bool syscall_pool_send_deferred(syscall_pool_t *pool)
+{
+        while (pool->deferred) {
+                syscallrq_t *rq   = pool->deferred;
+                syscallrq_t *next = rq->next;
+
+                // request object is not valid when is sent
+                if (_queue_send(pool->queue, &rq, 0) == ESUCC) {
+                        pool->deferred = next;
+
+                        if (pool->deferred == NULL) {
+                                pool->deferred_last = NULL;
+                        }
+                } else {
+                        break;
+                }
+        }
+
+        return pool->deferred == NULL;
+}
+
+//==============================================================================
+/**
+ * @brief  Syscall worker thread. Worker realize requests of selected pool.
+ *         Idle worker waits for request without timeout. Worker is released
+ *         by kworker (NULL request) and is created again when needed.
+ *
+ * @param  arg          worker pool
+ */
+//==============================================================================
+static void syscall_worker(void *arg)
+{
+        syscall_pool_t *pool = arg;
+
+        for (;;) {
+                syscallrq_t *rq = NULL;
+                if (_queue_receive(pool->queue, &rq, MAX_DELAY_MS) == ESUCC) {
+
+                        // worker released by syscall_pool_reap()
+                        if (rq == NULL) {
+                                break;
+                        }
+
+                        u32_t start = _kernel_get_time_ms();
+                        u32_t wait  = start - rq->timestamp;
+
+                        _kernel_scheduler_lock();
+                        pool->stat.idle--;
+                        _kernel_scheduler_unlock();
+
+                        // request object is not valid after this call
+                        syscall_do(rq);
+
+                        u32_t service = _kernel_get_time_ms() - start;
+
+                        _kernel_scheduler_lock();
+                        {
+                                pool->stat.idle++;
+                                pool->stat.requests++;
+                                pool->stat.wait_time_ms       += wait;
+                                pool->stat.wait_time_max_ms    = max(pool->stat.wait_time_max_ms, wait);
+                                pool->stat.service_time_ms    += service;
+                                pool->stat.service_time_max_ms = max(pool->stat.service_time_max_ms, service);
+                        }
+                        _kernel_scheduler_unlock();
+                }
+        }
+}
+
 //==============================================================================
 /**
  * @brief  Function is called in thread and realize requested syscall.
@@ -517,6 +908,7 @@ int _syscall_kworker_process(int argc, char *argv[])
 static void syscall_do(void *rq)
 {
         syscallrq_t *sysrq = rq;
+        _process_t  *proc  = sysrq->client_proc;
 
         tid_t tid = _process_get_active_thread();
         _assert(is_tid_in_range(_process_get_active(), tid));
@@ -536,14 +928,7 @@ static void syscall_do(void *rq)
                 _assert(false);
         }
 
-        // If there is lack of memory and FS sync is required then thread
-        // synchronize all file systems to reduce cache size.
-        if (  _cache_is_sync_needed()
-           && sysrq->syscall_no <= _SYSCALL_GROUP_1_FS_BLOCKING) {
-
-                _vfs_sync();
-                _cache_sync();
-        }
+        _process_syscall_end(proc);
 }
 
 //==============================================================================
@@ -975,6 +1360,24 @@ static void syscall_fread(syscallrq_t *rq)
         SETRETURN(size_t, rdcnt / (*size));
 }
 
+//==============================================================================
+/**
+ * @brief  This syscall copy data between files without user space buffer.
+ *
+ * @param  rq                   syscall request
+ */
+//==============================================================================
+static void syscall_fcopy(syscallrq_t *rq)
+{
+        GETARG(FILE *, src);
+        GETARG(FILE *, dst);
+        GETARG(size_t *, count);
+
+        size_t copied = 0;
+        SETERRNO(_vfs_fcopy(src, dst, *count, &copied));
+        SETRETURN(size_t, copied);
+}
+
 //==============================================================================
 /**
  * @brief  This syscall move file pointer.
@@ -1021,6 +1424,68 @@ static void syscall_fflush(syscallrq_t *rq)
         SETRETURN(int, GETERRNO() == ESUCC ? 0 : -1);
 }
 
+//==============================================================================
+/**
+ * @brief  This syscall set stream buffer of selected file.
+ *
+ * @param  rq                   syscall request
+ */
+//==============================================================================
+static void syscall_fsetvbuf(syscallrq_t *rq)
+{
+        GETARG(FILE *, file);
+        LOADARG(char *);        // user buffer is not used, see setvbuf()
+        GETARG(int *, mode);
+        GETARG(size_t *, size);
+        SETERRNO(_vfs_fsetvbuf(file, *mode, *size));
+        SETRETURN(int, GETERRNO() == ESUCC ? 0 : -1);
+}
+
+//==============================================================================
+/**
+ * @brief  This syscall check readiness of selected objects. If no object is
+ *         ready and semaphore is requested then thread's waiter stay armed and
+ *         caller waits for semaphore in own context, thus syscall workers are
+ *         not blocked.
+ *
+ * @param  rq                   syscall request
+ */
+//==============================================================================
+static void syscall_poll(syscallrq_t *rq)
+{
+        GETARG(struct pollfd *, fds);
+        GETARG(size_t *, nfds);
+        GETARG(sem_t **, sem);
+
+        size_t          ready  = 0;
+        _poll_waiter_t *waiter = NULL;
+
+        int err = _process_thread_get_poll_waiter(GETPROCESS(), rq->client_thread, &waiter);
+
+        if (!err && sem) {
+                // waiter is linked to objects before their state is read,
+                // thus any change is not lost
+                err = _poll_arm(waiter, *nfds);
+        }
+
+        if (!err) {
+                err = _poll_scan(fds, *nfds, sem ? waiter : NULL, &ready);
+        }
+
+        if (!sem || err || ready > 0) {
+                _poll_disarm(waiter);
+
+                if (sem) {
+                        *sem = NULL;
+                }
+        } else {
+                *sem = waiter->sem;
+        }
+
+        SETERRNO(err);
+        SETRETURN(int, err ? -1 : cast(int, ready));
+}
+
 //==============================================================================
 /**
  * @brief  This syscall synchronize all buffers of filesystems.
@@ -1904,6 +2369,24 @@ static void syscall_netgetaddress(syscallrq_t *rq)
         SETERRNO(_net_socket_getaddress(socket, sockaddr));
         SETRETURN(int, GETERRNO() == ESUCC ? 0 : -1);
 }
+
+//==============================================================================
+/**
+ * @brief  This syscall send file data to socket without user space buffer.
+ *
+ * @param  rq                   syscall request
+ */
+//==============================================================================
+static void syscall_netsendfile(syscallrq_t *rq)
+{
+        GETARG(SOCKET *, socket);
+        GETARG(FILE *, file);
+        GETARG(size_t *, len);
+
+        size_t sent = 0;
+        SETERRNO(_net_socket_sendfile(socket, file, *len, &sent));
+        SETRETURN(int, (GETERRNO() == ESUCC || sent > 0) ? cast(int, sent) : -1);
+}
 #endif
 
 #if __OS_ENABLE_SHARED_MEMORY__ == _YES_
@@ -0,0 +1,342 @@
+/*=========================================================================*//**
+File     khooks_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test of tickless idle compensation.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * SysTick timer is simulated at register level. Load counter is read as by
+ * the Cortex-M port of cpuctl and vPortSuppressTicksAndSleep() programs the
+ * timer as the ARM_CM3 port of the kernel does. Test checks that uptime and
+ * CPU total time follow the simulated time when sleep is ended by the tick
+ * interrupt or earlier by other interrupt. Tickless idle is enabled for this
+ * test only, thus tested file is included.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "config.h"
+
+#undef  __OS_TICKLESS_IDLE__
+#define __OS_TICKLESS_IDLE__ _YES_
+
+#include "../khooks.c"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define PERIOD                  TICK_PERIOD_COUNTS
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static struct {
+        u32_t   load;
+        u32_t   val;
+        bool    countflag;
+        bool    pending;        // interrupt pending (masked during sleep)
+        bool    cleared;        // VAL register written
+} systick;
+
+static u64_t sim_counts;        // simulated time
+static u32_t sim_drift;         // counts lost by timer restarts (port drift)
+static u32_t sim_ticks;         // kernel tick count
+static u64_t cpu_time;          // CPU time accumulated by load calculation
+static u32_t load_calls;
+static u32_t wake_counts;       // sleep ended by other interrupt (0: by tick)
+
+u32_t _CPU_total_time;
+
+/*==============================================================================
+  Simulated timer
+==============================================================================*/
+//==============================================================================
+/**
+ * @brief  Tick interrupt: the kernel counts tick and calls tick hook.
+ */
+//==============================================================================
+static void systick_isr(void)
+{
+        systick.pending = false;
+        sim_ticks++;
+        vApplicationTickHook();
+}
+
+//==============================================================================
+/**
+ * @brief  Run timer for selected number of counts. When interrupts are
+ *         masked then timer is stopped at first interrupt.
+ *
+ * @return Number of counts that timer run.
+ */
+//==============================================================================
+static u32_t systick_run(u32_t counts, bool masked)
+{
+        u32_t done = 0;
+
+        while (done < counts && !(masked && systick.pending)) {
+                u32_t n = min(counts - done, systick.val);
+                systick.val -= n;
+                done        += n;
+
+                // counter is reloaded at next count, interrupt is handled
+                // after reload; reload after VAL write is not counted
+                if (systick.val == 0 && done < counts) {
+                        systick.val = systick.load;
+                        done++;
+
+                        if (systick.cleared) {
+                                systick.cleared = false;
+                                sim_drift++;
+                        } else {
+                                systick.countflag = true;
+                                systick.pending   = true;
+
+                                if (!masked) {
+                                        systick_isr();
+                                }
+                        }
+                }
+        }
+
+        sim_counts += done;
+
+        return done;
+}
+
+//==============================================================================
+/**
+ * @brief  Read CTRL register (count flag is cleared).
+ */
+//==============================================================================
+static bool systick_ctrl_countflag(void)
+{
+        bool flag = systick.countflag;
+        systick.countflag = false;
+        return flag;
+}
+
+/*==============================================================================
+  Fake kernel and port services
+==============================================================================*/
+void vTaskPrioritySet(TaskHandle_t task, UBaseType_t prio)
+{
+        UNUSED_ARG2(task, prio);
+}
+
+TaskHandle_t xTaskGetIdleTaskHandle(void)
+{
+        return NULL;
+}
+
+void _kernel_panic_report(enum _kernel_panic_desc_cause cause)
+{
+        UNUSED_ARG1(cause);
+}
+
+void _calculate_CPU_load(void)
+{
+        load_calls++;
+        cpu_time        += _CPU_total_time;
+        _CPU_total_time  = 0;
+}
+
+u32_t _cpuctl_get_CPU_load_counter_delta(void)
+{
+        static u32_t last;
+        bool  ovf = systick_ctrl_countflag();
+        u32_t now = systick.val;
+
+        u32_t delta;
+        if (ovf) {
+                delta = ((systick.load + 1) - now) + last;
+        } else {
+                delta = last - now;
+        }
+
+        last = now;
+
+        return delta;
+}
+
+//==============================================================================
+/**
+ * @brief  Sleep as ARM_CM3 port. Sleep is ended by other interrupt after
+ *         wake_counts or by the tick interrupt when wake_counts is 0.
+ */
+//==============================================================================
+void vPortSuppressTicksAndSleep(TickType_t expected)
+{
+        u32_t complete;
+        u32_t reload = systick.val + (PERIOD * (expected - 1));
+
+        systick.load      = reload;
+        systick.val       = 0;
+        systick.cleared   = true;
+        systick.countflag = false;
+
+        systick_run(wake_counts ? wake_counts : UINT32_MAX, true);
+
+        bool countflag = systick_ctrl_countflag();
+
+        // interrupts enabled: pending tick is handled
+        if (systick.pending) {
+                systick_isr();
+        }
+
+        if (countflag) {
+                u32_t calc = (PERIOD - 1) - (reload - systick.val);
+
+                if (calc > PERIOD) {
+                        calc = PERIOD - 1;
+                }
+
+                systick.load = calc;
+                complete     = expected - 1;
+
+        } else {
+                u32_t decrements = (expected * PERIOD) - systick.val;
+                complete         = decrements / PERIOD;
+                systick.load     = ((complete + 1) * PERIOD) - decrements;
+        }
+
+        systick.val     = 0;
+        systick.cleared = true;
+        systick_run(1, true);
+
+        // vTaskStepTick()
+        sim_ticks += complete;
+        _kernel_tickless_step(complete);
+
+        systick.load = PERIOD - 1;
+}
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+//==============================================================================
+/**
+ * @brief  Idle task enters tickless sleep in the middle of tick period.
+ *
+ * @param  expected     expected idle time [ticks]
+ * @param  wake         counts after which other interrupt ends sleep
+ *                      (0: sleep is ended by tick interrupt)
+ */
+//==============================================================================
+static void sim_sleep(u32_t expected, u32_t wake)
+{
+        systick_run(PERIOD / 3, false);
+
+        wake_counts = wake;
+        _kernel_tickless_sleep(expected);
+}
+
+//==============================================================================
+/**
+ * @brief  Return CPU time counted by kernel.
+ */
+//==============================================================================
+static u64_t cpu_total(void)
+{
+        return cpu_time + _CPU_total_time + _cpuctl_get_CPU_load_counter_delta();
+}
+
+//==============================================================================
+/**
+ * @brief  Check that kernel time follows simulated time. Kernel time does
+ *         not include counts lost by timer restarts.
+ */
+//==============================================================================
+static void check_time(int line)
+{
+        u64_t time = sim_counts - sim_drift;
+        u64_t cpu  = cpu_total();
+
+        if (  sim_ticks != time / PERIOD
+           || _get_uptime_counter() != sim_ticks / configTICK_RATE_HZ
+           || cpu != time) {
+
+                ht_print("line %d: ticks %u (expected %u), uptime %u, cpu %u/%u\n",
+                         line, sim_ticks, cast(u32_t, time / PERIOD),
+                         _get_uptime_counter(),
+                         cast(u32_t, cpu), cast(u32_t, time));
+
+                HT_CHECK(false);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Test main function.
+ */
+//==============================================================================
+int main(void)
+{
+        HT_CHECK(PERIOD > 100);
+
+        systick.load = PERIOD - 1;
+        systick.val  = PERIOD - 1;
+        _cpuctl_get_CPU_load_counter_delta();
+
+        // normal ticks
+        systick_run(PERIOD * (configTICK_RATE_HZ / 2), false);
+        check_time(__LINE__);
+
+        // sleep ended by tick interrupt, across second boundary
+        sim_sleep(configTICK_RATE_HZ * 3, 0);
+        check_time(__LINE__);
+        HT_CHECK(load_calls > 0);
+
+        systick_run(PERIOD / 2, false);
+        check_time(__LINE__);
+
+        // sleep ended by other interrupt, time is counted at next tick
+        sim_sleep(configTICK_RATE_HZ * 10, PERIOD * (configTICK_RATE_HZ + 7) + PERIOD / 2);
+        systick_run(systick.val + 1, false);
+        check_time(__LINE__);
+
+        systick_run(PERIOD * 3, false);
+        check_time(__LINE__);
+
+        // short sleeps do not lose time
+        for (int i = 0; i < 200; i++) {
+                systick_run(PERIOD * 2 + PERIOD / 5, false);
+                sim_sleep(5, (i & 1) ? 0 : PERIOD * 2);
+        }
+        check_time(__LINE__);
+
+        // normal ticks after sleep
+        systick_run(PERIOD * configTICK_RATE_HZ * 2, false);
+        check_time(__LINE__);
+
+        ht_print("khooks: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
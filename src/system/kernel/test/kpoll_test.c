@@ -0,0 +1,329 @@
+/*=========================================================================*//**
+File     kpoll_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test of poll wait lists.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Files are fake objects with own wait list and events. Semaphores are
+ * counters, thus test checks which waiters are signaled by object.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "config.h"
+#include "kernel/kpoll.h"
+#include "kernel/errno.h"
+#include "kernel/process.h"
+#include "lib/cast.h"
+#include "lib/unarg.h"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define SEM_COUNT               8
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+struct fake_obj {
+        _poll_list_t    poll;
+        u32_t           events;
+        bool            valid;
+};
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static struct sem {
+        int     count;
+        bool    used;
+} sem_pool[SEM_COUNT];
+
+static int critical;
+
+/*==============================================================================
+  Fake kernel services
+==============================================================================*/
+int _semaphore_create(size_t cnt_max, size_t cnt_init, sem_t **sem)
+{
+        UNUSED_ARG1(cnt_max);
+
+        for (int i = 0; i < SEM_COUNT; i++) {
+                if (!sem_pool[i].used) {
+                        sem_pool[i].used  = true;
+                        sem_pool[i].count = cnt_init;
+                        *sem = cast(sem_t*, &sem_pool[i]);
+                        return ESUCC;
+                }
+        }
+
+        return ENOMEM;
+}
+
+int _semaphore_destroy(sem_t *sem)
+{
+        cast(struct sem*, sem)->used = false;
+        return ESUCC;
+}
+
+int _semaphore_wait(sem_t *sem, const u32_t timeout)
+{
+        UNUSED_ARG1(timeout);
+
+        struct sem *s = cast(struct sem*, sem);
+        if (s->count > 0) {
+                s->count--;
+                return ESUCC;
+        }
+
+        return ETIME;
+}
+
+int _semaphore_signal(sem_t *sem)
+{
+        struct sem *s = cast(struct sem*, sem);
+        s->count = 1;
+        return ESUCC;
+}
+
+int _semaphore_signal_from_ISR(sem_t *sem, bool *task_woken)
+{
+        *task_woken = true;
+        return _semaphore_signal(sem);
+}
+
+void _critical_section_begin(void)
+{
+        HT_CHECK(critical == 0);
+        critical++;
+}
+
+void _critical_section_end(void)
+{
+        HT_CHECK(critical == 1);
+        critical--;
+}
+
+int _vfs_fpoll(FILE *file, u32_t *events, struct _poll_entry *entry)
+{
+        struct fake_obj *obj = cast(struct fake_obj*, file);
+
+        if (!obj->valid) {
+                return EINVAL;
+        }
+
+        _poll_wait(&obj->poll, obj, entry);
+        *events = obj->events;
+
+        return ESUCC;
+}
+
+int _process_poll(pid_t pid, u32_t *events, struct _poll_entry *entry)
+{
+        UNUSED_ARG3(pid, events, entry);
+        return ESRCH;
+}
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+//==============================================================================
+/**
+ * @brief  Return number of entries in wait list.
+ */
+//==============================================================================
+static int list_length(_poll_list_t *list)
+{
+        int n = 0;
+        for (_poll_entry_t *e = list->head; e; e = e->next) {
+                n++;
+        }
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief  Return true if waiter was signaled (signal is consumed).
+ */
+//==============================================================================
+static bool signaled(_poll_waiter_t *waiter)
+{
+        return _semaphore_wait(waiter->sem, 0) == ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief  Arm waiter and scan selected objects, as poll syscall does.
+ */
+//==============================================================================
+static size_t wait_for(_poll_waiter_t *waiter, struct pollfd *fds, size_t nfds)
+{
+        size_t ready = 0;
+        HT_CHECK_OK(_poll_arm(waiter, nfds));
+        HT_CHECK_OK(_poll_scan(fds, nfds, waiter, &ready));
+        return ready;
+}
+
+//==============================================================================
+/**
+ * @brief  Test main function.
+ */
+//==============================================================================
+int main(void)
+{
+        struct fake_obj obj[4] = {
+                {.valid = true}, {.valid = true}, {.valid = true}, {.valid = true}
+        };
+
+        _poll_waiter_t w1 = {.sem = NULL};
+        _poll_waiter_t w2 = {.sem = NULL};
+
+        struct pollfd fd1[2] = {
+                {.type = POLL_TYPE__FILE, .file = cast(FILE*, &obj[0]), .events = POLLIN},
+                {.type = POLL_TYPE__FILE, .file = cast(FILE*, &obj[1]), .events = POLLIN},
+        };
+
+        struct pollfd fd2[1] = {
+                {.type = POLL_TYPE__FILE, .file = cast(FILE*, &obj[2]), .events = POLLIN},
+        };
+
+        // nothing ready: waiters are linked to own objects only
+        HT_CHECK(wait_for(&w1, fd1, 2) == 0);
+        HT_CHECK(wait_for(&w2, fd2, 1) == 0);
+        HT_CHECK(list_length(&obj[0].poll) == 1);
+        HT_CHECK(list_length(&obj[1].poll) == 1);
+        HT_CHECK(list_length(&obj[2].poll) == 1);
+        HT_CHECK(list_length(&obj[3].poll) == 0);
+
+        // object wakes only own waiters
+        _poll_notify(&obj[1].poll, &obj[1]);
+        HT_CHECK(signaled(&w1));
+        HT_CHECK(!signaled(&w2));
+
+        _poll_notify(&obj[3].poll, &obj[3]);
+        HT_CHECK(!signaled(&w1));
+        HT_CHECK(!signaled(&w2));
+
+        bool woken = false;
+        _poll_notify_from_ISR(&obj[2].poll, &obj[2], &woken);
+        HT_CHECK(woken);
+        HT_CHECK(!signaled(&w1));
+        HT_CHECK(signaled(&w2));
+
+        // scan after wakeup returns events, next arm drops old links
+        obj[1].events = POLLIN | POLLOUT;
+        HT_CHECK(wait_for(&w1, fd1, 2) == 1);
+        HT_CHECK(fd1[0].revents == 0);
+        HT_CHECK(fd1[1].revents == POLLIN);
+        HT_CHECK(list_length(&obj[0].poll) == 1);
+        HT_CHECK(list_length(&obj[1].poll) == 1);
+
+        // disarmed waiter is not signaled
+        _poll_disarm(&w1);
+        HT_CHECK(list_length(&obj[0].poll) == 0);
+        HT_CHECK(list_length(&obj[1].poll) == 0);
+        _poll_notify(&obj[0].poll, &obj[0]);
+        HT_CHECK(!signaled(&w1));
+
+        // scan without waiter does not link
+        size_t ready = 0;
+        HT_CHECK_OK(_poll_scan(fd1, 2, NULL, &ready));
+        HT_CHECK(ready == 1);
+        HT_CHECK(list_length(&obj[0].poll) == 0);
+
+        // released object wakes and unlinks waiters; disarm is safe later
+        _poll_list_release(&obj[2].poll);
+        HT_CHECK(signaled(&w2));
+        HT_CHECK(w2.entry[0].list == NULL);
+        _poll_disarm(&w2);
+
+        // invalid object
+        obj[2].valid = false;
+        HT_CHECK(wait_for(&w2, fd2, 1) == 1);
+        HT_CHECK(fd2[0].revents == POLLNVAL);
+        obj[2].valid = true;
+
+        // shared list: waiters are selected by object
+        _poll_list_t shared = {.head = NULL};
+        HT_CHECK_OK(_poll_arm(&w1, 1));
+        HT_CHECK_OK(_poll_arm(&w2, 1));
+        _poll_wait(&shared, &obj[0], w1.entry);
+        _poll_wait(&shared, &obj[1], w2.entry);
+        _poll_wait(&shared, &obj[1], w2.entry);
+        HT_CHECK(list_length(&shared) == 2);
+
+        _poll_notify(&shared, &obj[1]);
+        HT_CHECK(!signaled(&w1));
+        HT_CHECK(signaled(&w2));
+
+        _poll_notify(&shared, NULL);
+        HT_CHECK(signaled(&w1));
+        HT_CHECK(signaled(&w2));
+
+        _poll_disarm(&w2);
+        HT_CHECK(list_length(&shared) == 1 && shared.head == w1.entry);
+        _poll_disarm(&w1);
+        HT_CHECK(list_length(&shared) == 0);
+
+        // entries grow with number of objects
+        struct pollfd fd4[4];
+        for (int i = 0; i < 4; i++) {
+                fd4[i] = (struct pollfd){.type   = POLL_TYPE__FILE,
+                                         .file   = cast(FILE*, &obj[i]),
+                                         .events = POLLOUT};
+                obj[i].events = 0;
+        }
+        HT_CHECK(wait_for(&w1, fd4, 4) == 0);
+        HT_CHECK(w1.entries == 4);
+        for (int i = 0; i < 4; i++) {
+                HT_CHECK(list_length(&obj[i].poll) == 1);
+        }
+
+        // process objects are reported by own poll function
+        struct pollfd pfd = {.type = POLL_TYPE__PROCESS, .pid = 1, .events = POLLIN};
+        HT_CHECK(wait_for(&w2, &pfd, 1) == 1);
+        HT_CHECK(pfd.revents == POLLNVAL);
+
+        _poll_release(&w1);
+        _poll_release(&w2);
+
+        for (int i = 0; i < 4; i++) {
+                HT_CHECK(list_length(&obj[i].poll) == 0);
+        }
+
+        HT_CHECK(w1.sem == NULL && w2.sem == NULL);
+        HT_CHECK(ht_mem_blocks() == 0);
+        HT_CHECK(critical == 0);
+
+        ht_print("kpoll: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
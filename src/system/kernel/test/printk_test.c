@@ -0,0 +1,219 @@
+/*=========================================================================*//**
+File     printk_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test of kernel log buffer.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Writer interrupted by other writers is simulated by reserving the message
+ * slot directly in the log buffer, thus tested file is included. Test checks
+ * that message dropped because its slot is still used by older writer does
+ * not stall the reader.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "../printk.c"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define ROWS                    __OS_SYSTEM_MSG_ROWS__
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static u32_t time_ms;
+
+/*==============================================================================
+  Kernel services
+==============================================================================*/
+u32_t _kernel_get_time_ms(void)
+{
+        return time_ms;
+}
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Compare strings.
+ */
+//==============================================================================
+static bool str_eq(const char *a, const char *b)
+{
+        while (*a && (*a == *b)) {
+                a++;
+                b++;
+        }
+
+        return *a == *b;
+}
+
+//==============================================================================
+/**
+ * @brief  Read message and check it against expected number.
+ */
+//==============================================================================
+static void check_read(int num)
+{
+        char str[__OS_SYSTEM_MSG_COLS__];
+        char exp[__OS_SYSTEM_MSG_COLS__];
+
+        _snprintf(exp, sizeof(exp), "msg %d", num);
+
+        HT_CHECK(_printk_read(str, sizeof(str), NULL) > 0);
+        HT_CHECK(str_eq(str, exp));
+}
+
+//==============================================================================
+/**
+ * @brief  Reserve slot of next message as writer that did not finish yet.
+ *
+ * @return Message sequence.
+ */
+//==============================================================================
+static u32_t stall_writer(void)
+{
+        u32_t n = __atomic_fetch_add(&log_buf.head, 1, __ATOMIC_SEQ_CST);
+
+        printk_msg_t *msg = &log_buf.msg[n % ROWS];
+        msg->seq    = SEQ_WRITE(n);
+        msg->format = "stalled";
+        msg->argc   = 0;
+        msg->strlen = 0;
+
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief  Return number of dropped messages.
+ */
+//==============================================================================
+static u32_t dropped(void)
+{
+        _printk_stat_t stat;
+        _printk_get_stat(&stat);
+        return stat.dropped;
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        char  str[__OS_SYSTEM_MSG_COLS__];
+        u32_t ts = 0;
+
+        // message formatted at read
+        char arg[] = "temp";
+        time_ms = 1234;
+        _printk("%s %d %.*s 0x%x", arg, -5, 2, "abc", 0x1F);
+        arg[0] = '\0';
+
+        HT_CHECK(_printk_read(str, sizeof(str), &ts) > 0);
+        HT_CHECK(str_eq(str, "temp -5 ab 0x1f"));
+        HT_CHECK(ts == 1234);
+        HT_CHECK(_printk_read(str, sizeof(str), &ts) == 0);
+
+        // filtered messages are not stored
+        _printk_set_level(_PRINTK_LEVEL_WARNING);
+        _printk("msg %d", 0);
+        HT_CHECK(_printk_read(str, sizeof(str), NULL) == 0);
+        _printk_set_level(_PRINTK_LEVEL_INFO);
+
+        // reader waits for unfinished message
+        u32_t drop = dropped();
+        u32_t n    = stall_writer();
+        _printk("msg %d", 1);
+        HT_CHECK(_printk_read(str, sizeof(str), NULL) == 0);
+
+        log_buf.msg[n % ROWS].seq = SEQ_DONE(n);
+        HT_CHECK(_printk_read(str, sizeof(str), NULL) > 0);
+        HT_CHECK(str_eq(str, "stalled"));
+        check_read(1);
+        HT_CHECK(dropped() == drop);
+
+        // message dropped because slot is used by older writer that finishes
+        // before reader reaches the slot; stalled message is overrun
+        n = stall_writer();
+        for (int i = 1; i < ROWS; i++) {
+                _printk("msg %d", i);
+        }
+
+        _printk("msg %d", ROWS);
+        HT_CHECK(log_buf.msg[n % ROWS].seq == SEQ_WRITE(n));
+        log_buf.msg[n % ROWS].seq = SEQ_DONE(n);
+
+        for (int i = 1; i < ROWS; i++) {
+                check_read(i);
+        }
+
+        HT_CHECK(_printk_read(str, sizeof(str), NULL) == 0);
+        HT_CHECK(dropped() == drop + 2);
+
+        // new messages are read after dropped message
+        _printk("msg %d", 100);
+        check_read(100);
+
+        // message dropped while older writer is still active, the reader
+        // passes the dropped message and reads next messages
+        drop = dropped();
+        n    = stall_writer();
+        for (int i = 1; i <= ROWS + 2; i++) {
+                _printk("msg %d", i);
+        }
+
+        for (int i = 3; i < ROWS; i++) {
+                check_read(i);
+        }
+
+        check_read(ROWS + 1);
+        check_read(ROWS + 2);
+        HT_CHECK(_printk_read(str, sizeof(str), NULL) == 0);
+        HT_CHECK(dropped() == drop + 4);
+
+        // older writer finishes after reader passed its slot
+        log_buf.msg[n % ROWS].seq = SEQ_DONE(n);
+        HT_CHECK(_printk_read(str, sizeof(str), NULL) == 0);
+
+        _printk("msg %d", 200);
+        check_read(200);
+        HT_CHECK(dropped() == drop + 4);
+
+        ht_print("printk: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
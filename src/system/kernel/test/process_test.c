@@ -0,0 +1,506 @@
+/*=========================================================================*//**
+File     process_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test and benchmark of process thread identification.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Process with all threads is created on fake tasks that keep the task
+ * function and tag. Test checks that context switch hook and task container lookup return
+ * process and thread of each task, that exited thread is not identified and
+ * that task without tag clears process context. Cost of the hook is compared
+ * with the hook used before that searched thread in task table (first and
+ * last thread are switched). Tested file is included to use process
+ * structures.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "../process.c"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define TASKS                   16
+#define SWITCHES                1000000
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+struct fake_task {
+        task_func_t func;
+        void       *arg;
+        void       *tag;
+        bool        used;
+};
+
+struct ctx {
+        _process_t *proc;
+        tid_t       tid;
+        FILE       *in;
+        FILE       *out;
+        FILE       *err;
+        void       *global;
+};
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static struct fake_task task_pool[TASKS];
+static struct fake_task *current;
+static int              mtx;
+static FILE            *f_in  = cast(FILE*, &task_pool[0]);
+static FILE            *f_out = cast(FILE*, &task_pool[1]);
+static FILE            *f_err = cast(FILE*, &task_pool[2]);
+
+static const size_t app_globals = sizeof(res_header_t) + 16;
+static const size_t app_stack   = 256;
+
+/*==============================================================================
+  Program table
+==============================================================================*/
+static int app_main(int argc, char **argv)
+{
+        return 0;
+}
+
+const struct _prog_data _prog_table[] = {
+        {.name = "app", .globals_size = &app_globals, .stack_depth = &app_stack, .main = app_main}
+};
+
+const int _prog_table_size = ARRAY_SIZE(_prog_table);
+
+/*==============================================================================
+  Kernel services
+==============================================================================*/
+u32_t _uptime_counter_sec;
+
+u32_t _cpuctl_get_CPU_load_counter_delta(void)
+{
+        return 0;
+}
+
+int _task_create(task_func_t func, const char *name, const size_t stack_depth,
+                 void *arg, void *tag, task_t **task)
+{
+        for (int i = 0; i < TASKS; i++) {
+                if (!task_pool[i].used) {
+                        task_pool[i].used = true;
+                        task_pool[i].func = func;
+                        task_pool[i].arg  = arg;
+                        task_pool[i].tag  = tag;
+                        *task = cast(task_t*, &task_pool[i]);
+                        return ESUCC;
+                }
+        }
+
+        return ENOMEM;
+}
+
+void _task_destroy(task_t *task)
+{
+        cast(struct fake_task*, task)->used = false;
+}
+
+void _task_exit(void)
+{
+}
+
+int _task_get_priority(task_t *task)
+{
+        return 0;
+}
+
+void _task_set_priority(task_t *task, const int prio)
+{
+}
+
+int _task_get_free_stack(task_t *task)
+{
+        return 0;
+}
+
+task_t *_task_get_handle(void)
+{
+        return cast(task_t*, current);
+}
+
+void *_task_get_tag(task_t *task)
+{
+        return cast(struct fake_task*, task)->tag;
+}
+
+int _syscall_kworker_process(int argc, char **argv)
+{
+        return 0;
+}
+
+int _mutex_create(enum mutex_type type, mutex_t **m)
+{
+        *m = cast(mutex_t*, &mtx);
+        return ESUCC;
+}
+
+int _mutex_destroy(mutex_t *mtx)
+{
+        return ESUCC;
+}
+
+int _mutex_lock(mutex_t *mtx, const u32_t timeout)
+{
+        return ESUCC;
+}
+
+int _mutex_unlock(mutex_t *mtx)
+{
+        return ESUCC;
+}
+
+int _semaphore_destroy(sem_t *sem)
+{
+        return ESUCC;
+}
+
+int _queue_destroy(queue_t *queue)
+{
+        return ESUCC;
+}
+
+int _flag_create(flag_t **flag)
+{
+        *flag = cast(flag_t*, &mtx);
+        return ESUCC;
+}
+
+int _flag_destroy(flag_t *flag)
+{
+        return ESUCC;
+}
+
+int _flag_set(flag_t *flag, u32_t bits)
+{
+        return ESUCC;
+}
+
+int _flag_clear(flag_t *flag, u32_t bits)
+{
+        return ESUCC;
+}
+
+u32_t _flag_get(flag_t *flag)
+{
+        return 0;
+}
+
+int _slab_create(const char *name, size_t size, size_t align, enum _mm_mem mpur, _slab_t **slab)
+{
+        *slab = cast(_slab_t*, size);
+        return ESUCC;
+}
+
+int _slab_destroy(_slab_t *slab)
+{
+        return ESUCC;
+}
+
+int _slab_alloc(_slab_t *slab, void **obj)
+{
+        return _kzalloc(_MM_KRN, cast(size_t, slab), obj);
+}
+
+int _slab_free(_slab_t *slab, void **obj)
+{
+        return _kfree(_MM_KRN, obj);
+}
+
+size_t _mm_get_block_size(void *mem)
+{
+        return 0;
+}
+
+bool _mm_is_object_in_heap(const void *mem, size_t size)
+{
+        return true;
+}
+
+void _kernel_panic_report(enum _kernel_panic_desc_cause cause)
+{
+        HT_CHECK(false);
+}
+
+void _poll_notify(_poll_list_t *list, const void *obj)
+{
+}
+
+void _poll_disarm(_poll_waiter_t *waiter)
+{
+}
+
+void _poll_release(_poll_waiter_t *waiter)
+{
+}
+
+int _vfs_realpath(char *path, enum path_correction corr)
+{
+        return ESUCC;
+}
+
+int _vfs_closedir(DIR *dir)
+{
+        return ESUCC;
+}
+
+int _vfs_fopen(const struct vfs_path *path, const char *mode, FILE **file)
+{
+        return ENOENT;
+}
+
+int _vfs_fclose(FILE *file, bool force)
+{
+        return ESUCC;
+}
+
+int _vfs_fwrite(const void *ptr, size_t size, size_t *wrcnt, FILE *file)
+{
+        *wrcnt = size;
+        return ESUCC;
+}
+
+int _vfs_vfioctl(FILE *file, int request, va_list arg)
+{
+        return ESUCC;
+}
+
+int _vfs_fbuf_flush(FILE *file)
+{
+        return ESUCC;
+}
+
+void _vfs_fbuf_release(pid_t pid, tid_t tid)
+{
+}
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Thread function.
+ */
+//==============================================================================
+static void thread_func(void *arg)
+{
+}
+
+//==============================================================================
+/**
+ * @brief  Context switch hook before change: task tag is process and thread
+ *         is found by scanning task table of process.
+ */
+//==============================================================================
+static void scan_switched_in(task_t *task, _process_t *proc)
+{
+        active_process = proc;
+        active_thread  = -1;
+
+        u8_t threads = PROC_MAX_THREADS(proc);
+
+        for (int i = 0; i < threads; i++) {
+                if (proc->task[i] == task) {
+                        active_thread = i;
+                        break;
+                }
+        }
+
+        stdin  = proc->f_stdin;
+        stdout = proc->f_stdout;
+        stderr = proc->f_stderr;
+        global = proc->globals;
+        _errno = proc->errnov;
+}
+
+//==============================================================================
+/**
+ * @brief  Switch context to selected task and return process context set by
+ *         hook. Standard streams of tested file replace host ones, so context
+ *         is cleared before return to allow host output.
+ */
+//==============================================================================
+static struct ctx switch_in(task_t *task, void *tag)
+{
+        current = cast(struct fake_task*, task);
+        _task_switched_in(task, tag);
+
+        struct ctx ctx = {
+                .proc   = active_process,
+                .tid    = active_thread,
+                .in     = stdin,
+                .out    = stdout,
+                .err    = stderr,
+                .global = global
+        };
+
+        _task_switched_in(task, NULL);
+
+        return ctx;
+}
+
+//==============================================================================
+/**
+ * @brief  Run task function until task exits.
+ */
+//==============================================================================
+static void run(task_t *task)
+{
+        current = cast(struct fake_task*, task);
+        current->func(current->arg);
+        current->used = false;
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        process_attr_t attr = {
+                .f_stdin  = f_in,
+                .f_stdout = f_out,
+                .f_stderr = f_err,
+                .cwd      = "/",
+                .detached = true
+        };
+
+        pid_t       pid;
+        _process_t *proc;
+
+        HT_CHECK(_process_create("none", &attr, &pid) == ENOENT);
+        HT_CHECK_OK(_process_create("app arg", &attr, &pid));
+        proc = active_process_list;
+        HT_CHECK(proc != NULL && proc->pid == pid);
+
+        // program memory is marked as resource by kernel allocator
+        cast(res_header_t*, proc->globals)[-1].type = RES_TYPE_MEMORY;
+
+        u8_t threads = PROC_MAX_THREADS(proc);
+        HT_CHECK(threads > 2);
+
+        for (tid_t id = 1; id < threads; id++) {
+                tid_t tid;
+                HT_CHECK_OK(_process_thread_create(proc, thread_func, NULL, NULL, &tid));
+                HT_CHECK(tid == id);
+        }
+
+        tid_t tid;
+        HT_CHECK(_process_thread_create(proc, thread_func, NULL, NULL, &tid) != ESUCC);
+
+        // hook identifies process and thread of each task
+        for (tid_t id = 0; id < threads; id++) {
+                task_t *task = _process_thread_get_task(proc, id);
+                HT_CHECK(task != NULL);
+
+                struct ctx ctx = switch_in(task, _task_get_tag(task));
+                HT_CHECK(ctx.proc == proc && ctx.tid == id);
+                HT_CHECK(ctx.in == f_in && ctx.out == f_out && ctx.err == f_err);
+                HT_CHECK(ctx.global == proc->globals && ctx.global != NULL);
+                HT_CHECK(_process_get_current() == proc);
+
+                _process_t *p = NULL;
+                tid = threads;
+                _task_get_process_container(task, &p, &tid);
+                HT_CHECK(p == proc && tid == id);
+        }
+
+        // exited thread is not identified
+        task_t *exited = _process_thread_get_task(proc, 2);
+        run(exited);
+        HT_CHECK(_process_thread_get_task(proc, 2) == NULL);
+
+        struct ctx ctx = switch_in(exited, _task_get_tag(exited));
+        HT_CHECK(ctx.proc == proc && ctx.tid == cast(tid_t, -1));
+
+        HT_CHECK_OK(_process_thread_create(proc, thread_func, NULL, NULL, &tid));
+        HT_CHECK(tid == 2);
+
+        // task without process
+        _task_switched_in(_process_thread_get_task(proc, 0), &proc->thread[0]);
+        ctx = switch_in(exited, NULL);
+        HT_CHECK(ctx.proc == NULL && ctx.in == NULL && ctx.global == NULL);
+
+        // cost of thread identification
+        task_t *first = _process_thread_get_task(proc, 0);
+        task_t *last  = _process_thread_get_task(proc, threads - 1);
+
+        void *first_tag = _task_get_tag(first);
+        void *last_tag  = _task_get_tag(last);
+
+        unsigned long long t_hook = ht_clock_us();
+        for (int i = 0; i < SWITCHES; i++) {
+                if (i & 1) {
+                        _task_switched_in(last, last_tag);
+                } else {
+                        _task_switched_in(first, first_tag);
+                }
+        }
+        t_hook = ht_clock_us() - t_hook;
+
+        tid = active_thread;
+        _task_switched_in(first, NULL);
+        HT_CHECK(tid == threads - 1);
+
+        unsigned long long t_scan = ht_clock_us();
+        for (int i = 0; i < SWITCHES; i++) {
+                scan_switched_in((i & 1) ? last : first, proc);
+        }
+        t_scan = ht_clock_us() - t_scan;
+
+        tid = active_thread;
+        _task_switched_in(first, NULL);
+        HT_CHECK(tid == threads - 1);
+
+        ht_print("process: %d switches, hook %llu us, hook with task table scan %llu us (%u threads)\n",
+                 SWITCHES, t_hook, t_scan, threads);
+
+        // all resources are released
+        for (tid_t id = 1; id < threads; id++) {
+                run(_process_thread_get_task(proc, id));
+        }
+
+        HT_CHECK_OK(_process_kill(pid));
+        HT_CHECK_OK(_process_clean_up_killed_processes());
+        HT_CHECK(active_process_list == NULL && destroy_process_list == NULL);
+        HT_CHECK(ht_mem_blocks() == 0);
+
+        ht_print("process: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -3,7 +3,7 @@ File     btree.c
 
 Author   Daniel Zorychta
 
-Brief    BTree library.
+Brief    BTree library (red-black tree).
 
          Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
 
@@ -44,6 +44,8 @@ Brief    BTree library.
 #define parent(n)               (n->parent)
 #define left(n)                 (n->left)
 #define right(n)                (n->right)
+#define red(n)                  (n->red)
+#define is_red(n)               ((n) && (n)->red)
 
 #define data(t,n)               (((char *)n) + node_size(t))
 #define data_copy(t, d, s)      memcpy(d, s, elem_size(t))
@@ -71,6 +73,7 @@ typedef struct node {
         struct node *parent;
         struct node *left;
         struct node *right;
+        bool         red;
 } btnode_t;
 
 /*==============================================================================
@@ -82,7 +85,15 @@ static btnode_t *node_maximum(btnode_t*);
 static btnode_t *node_search(btree_t*, btnode_t*, void *);
 static void      node_close(btree_t*, btnode_t*);
 static btnode_t *node_successor(btnode_t*);
-static btnode_t *node_make(btree_t *tree, void *data);
+static btnode_t *node_predecessor(btnode_t*);
+static btnode_t *node_make(btree_t *tree, const void *data);
+static btnode_t *node_build(btree_t *tree, const char *data, size_t count, size_t depth, size_t red_depth, int *err);
+static int       cursor_get(btree_t *tree, btree_cursor_t *cursor, void *ret);
+static void      rotate_left(btree_t *tree, btnode_t *node);
+static void      rotate_right(btree_t *tree, btnode_t *node);
+static void      transplant(btree_t *tree, btnode_t *node, btnode_t *other);
+static void      insert_fixup(btree_t *tree, btnode_t *node);
+static void      remove_fixup(btree_t *tree, btnode_t *node, btnode_t *par);
 static void     *malloc_usr(size_t size, void *allocctx);
 static void      free_usr(void *mem, void *freectx);
 static void     *malloc_krn(size_t size, void *allocctx);
@@ -237,9 +248,7 @@ int _btree_create_mod(size_t              modid,
 //==============================================================================
 int _btree_search(btree_t *tree, void *key, void *ret)
 {
-        btnode_t *node = root(tree);
-
-        node = node_search(tree, node, key);
+        btnode_t *node = node_search(tree, root(tree), key);
 
         if (node) {
                 if (ret) {
@@ -321,10 +330,6 @@ bool _btree_is_empty(btree_t *tree)
 //==============================================================================
 int _btree_successor(btree_t *tree, void *key, void *ret)
 {
-        if (!root(tree)) {
-                return ENOENT;
-        }
-
         btnode_t *node = node_search(tree, root(tree), key);
         if (!node) {
                 return ENOENT;
@@ -352,26 +357,12 @@ int _btree_successor(btree_t *tree, void *key, void *ret)
 //==============================================================================
 int _btree_predecessor(btree_t *tree, void *key, void *ret)
 {
-        if (!root(tree)) {
-                return ENOENT;
-        }
-
         btnode_t *node = node_search(tree, root(tree), key);
         if (!node) {
                 return ENOENT;
         }
 
-        if (left(node)) {
-                node = node_maximum(left(node));
-        } else {
-                btnode_t *node2 = parent(node);
-                while (node2 && node == left(node2)) {
-                        node  = node2;
-                        node2 = parent(node);
-                }
-                node = node2;
-        }
-
+        node = node_predecessor(node);
         if (node) {
                 data_copy(tree, ret, data(tree, node));
                 return ESUCC;
@@ -382,50 +373,129 @@ int _btree_predecessor(btree_t *tree, void *key, void *ret)
 
 //==============================================================================
 /**
- * @brief  Function insert object to BTree.
+ * @brief  Function set cursor at object with minimum value.
  *
  * @param  tree         BTree object
- * @param  data         object to insert to
+ * @param  cursor       cursor to set
+ * @param  ret          first object
  *
  * @return One of errno value.
  */
 //==============================================================================
-int _btree_insert(btree_t *tree, void *data)
+int _btree_cursor_first(btree_t *tree, btree_cursor_t *cursor, void *ret)
 {
-        btnode_t *enode = node_search(tree, root(tree), data);
-        if (enode) {
-                return EEXIST;
+        cursor->node = node_minimum(root(tree));
+        return cursor_get(tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function set cursor at object with maximum value.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor to set
+ * @param  ret          last object
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _btree_cursor_last(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        cursor->node = node_maximum(root(tree));
+        return cursor_get(tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function move cursor to the next object. Tree is not searched,
+ *         the next node is reached by parent links (O(1) amortized).
+ *         Object pointed by cursor must not be removed.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor
+ * @param  ret          next object
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _btree_cursor_next(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        if (cursor->node) {
+                cursor->node = node_successor(cursor->node);
         }
 
-        btnode_t *newnode = node_make(tree, data);
-        if (!newnode) {
-                return ENOMEM;
+        return cursor_get(tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function move cursor to the previous object. Tree is not searched,
+ *         the previous node is reached by parent links (O(1) amortized).
+ *         Object pointed by cursor must not be removed.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor
+ * @param  ret          previous object
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _btree_cursor_prev(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        if (cursor->node) {
+                cursor->node = node_predecessor(cursor->node);
         }
 
+        return cursor_get(tree, cursor, ret);
+}
+
+//==============================================================================
+/**
+ * @brief  Function insert object to BTree. Object is not inserted when equal
+ *         object (compare functor returns 0) already exists in the tree.
+ *
+ * @param  tree         BTree object
+ * @param  data         object to insert to
+ *
+ * @return One of errno value, EEXIST if equal object already exists.
+ */
+//==============================================================================
+int _btree_insert(btree_t *tree, void *data)
+{
         btnode_t *parent = NULL;
         btnode_t *node   = root(tree);
+        int       cmp    = 0;
 
         while (node) {
                 parent = node;
-                if (data_compare(tree, data, data(tree, node)) < 0) {
+                cmp    = data_compare(tree, data, data(tree, node));
+
+                if (cmp == 0) {
+                        return EEXIST;
+                } else if (cmp < 0) {
                         node = left(node);
                 } else {
                         node = right(node);
                 }
         }
 
+        btnode_t *newnode = node_make(tree, data);
+        if (!newnode) {
+                return ENOMEM;
+        }
+
         parent(newnode) = parent;
 
         if (!parent) {
                 root(tree) = newnode;
+        } else if (cmp < 0) {
+                left(parent) = newnode;
         } else {
-                if (data_compare(tree, data, data(tree, parent)) < 0) {
-                        left(parent) = newnode;
-                } else {
-                        right(parent) = newnode;
-                }
+                right(parent) = newnode;
         }
 
+        insert_fixup(tree, newnode);
+
         return ESUCC;
 }
 
@@ -441,46 +511,47 @@ int _btree_insert(btree_t *tree, void *data)
 //==============================================================================
 int _btree_remove(btree_t *tree, void *key)
 {
-        if (!root(tree)) {
-                return ENOENT;
-        }
-
-        btnode_t *remove;
-        btnode_t *other;
         btnode_t *node = node_search(tree, root(tree), key);
-
         if (!node) {
                 return ENOENT;
         }
 
+        btnode_t *child;
+        btnode_t *child_parent;
+        bool      removed_red;
+
         if (!left(node) || !right(node)) {
-                remove = node;
-        } else {
-                remove = node_successor(node);
-        }
+                child        = left(node) ? left(node) : right(node);
+                child_parent = parent(node);
+                removed_red  = red(node);
+
+                transplant(tree, node, child);
 
-        if (left(remove)) {
-                other = left(remove);
         } else {
-                other = right(remove);
-        }
+                // node is replaced by its successor, nodes are relinked
+                // (not copied) so cursors of other nodes stay valid
+                btnode_t *succ = node_minimum(right(node));
 
-        if (other) {
-                parent(other) = parent(remove);
-        }
+                child       = right(succ);
+                removed_red = red(succ);
 
-        if (!parent(remove)) {
-                root(tree) = other;
-        } else {
-                if (remove == left(parent(remove))) {
-                        left(parent(remove)) = other;
+                if (parent(succ) == node) {
+                        child_parent = succ;
                 } else {
-                        right(parent(remove)) = other;
+                        child_parent = parent(succ);
+                        transplant(tree, succ, child);
+                        right(succ) = right(node);
+                        parent(right(succ)) = succ;
                 }
+
+                transplant(tree, node, succ);
+                left(succ) = left(node);
+                parent(left(succ)) = succ;
+                red(succ) = red(node);
         }
 
-        if (node != remove) {
-                data_copy(tree, data(tree, node), data(tree, remove));
+        if (!removed_red) {
+                remove_fixup(tree, child, child_parent);
         }
 
         if (tree->node_dtor) {
@@ -492,6 +563,52 @@ int _btree_remove(btree_t *tree, void *key)
         return ESUCC;
 }
 
+//==============================================================================
+/**
+ * @brief  Function build balanced BTree from sorted array of objects in
+ *         linear time. The tree must be empty.
+ *
+ * @param  tree         BTree object
+ * @param  data         array of objects sorted in ascending order (objects
+ *                      must be unique)
+ * @param  count        number of objects
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _btree_build(btree_t *tree, const void *data, size_t count)
+{
+        if (root(tree)) {
+                return EBUSY;
+        }
+
+        const char *obj = data;
+
+        for (size_t i = 1; i < count; i++) {
+                if (data_compare(tree, obj + ((i - 1) * elem_size(tree)),
+                                       obj + (i * elem_size(tree))) >= 0) {
+                        return EINVAL;
+                }
+        }
+
+        // nodes on the last (incomplete) level are red, so all paths
+        // have the same number of black nodes
+        size_t red_depth = 0;
+        for (size_t n = count + 1; n > 1; n >>= 1) {
+                red_depth++;
+        }
+
+        int err = ESUCC;
+        root(tree) = node_build(tree, obj, count, 0, red_depth, &err);
+
+        if (err && root(tree)) {
+                node_close(tree, root(tree));
+                root(tree) = NULL;
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief  Function destroy BTree.
@@ -530,6 +647,32 @@ static void btree_init(btree_t            *tree,
         tree->node_dtor = obj_dtor;
 }
 
+//==============================================================================
+/**
+ * @brief  Function copy object pointed by cursor.
+ *
+ * @param  tree         BTree object
+ * @param  cursor       cursor
+ * @param  ret          object
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int cursor_get(btree_t *tree, btree_cursor_t *cursor, void *ret)
+{
+        btnode_t *node = cursor->node;
+
+        if (node) {
+                if (ret) {
+                        data_copy(tree, ret, data(tree, node));
+                }
+
+                return ESUCC;
+        }
+
+        return ENOENT;
+}
+
 //==============================================================================
 /**
  * @brief  Function get successor node.
@@ -557,6 +700,33 @@ static btnode_t *node_successor(btnode_t *node)
         return node;
 }
 
+//==============================================================================
+/**
+ * @brief  Function get predecessor node.
+ *
+ * @param  node         node
+ *
+ * @return Predecessor node.
+ */
+//==============================================================================
+static btnode_t *node_predecessor(btnode_t *node)
+{
+        btnode_t *node2;
+
+        if (left(node)) {
+                node = node_maximum(left(node));
+        } else {
+                node2 = parent(node);
+                while (node2 && node == left(node2)) {
+                        node  = node2;
+                        node2 = parent(node);
+                }
+                node = node2;
+        }
+
+        return node;
+}
+
 //==============================================================================
 /**
  * @brief  Function return node with maximum value.
@@ -652,7 +822,7 @@ static void node_close(btree_t *tree, btnode_t *node)
 
 //==============================================================================
 /**
- * @brief  Function create new node.
+ * @brief  Function create new node. New node is red.
  *
  * @param  tree         BTree object
  * @param  data         node data
@@ -660,18 +830,268 @@ static void node_close(btree_t *tree, btnode_t *node)
  * @return New node object.
  */
 //==============================================================================
-static btnode_t *node_make(btree_t *tree, void *data)
+static btnode_t *node_make(btree_t *tree, const void *data)
 {
         btnode_t *node = tree->malloc(node_size(tree) + elem_size(tree), tree->allocctx);
 
         if (node) {
                 data_copy(tree, data(tree, node), data);
                 parent(node) = left(node) = right(node) = NULL;
+                red(node) = true;
         }
 
         return node;
 }
 
+//==============================================================================
+/**
+ * @brief  Function build balanced subtree from sorted array of objects.
+ *
+ * @param  tree         BTree object
+ * @param  data         sorted objects
+ * @param  count        number of objects
+ * @param  depth        depth of created subtree root
+ * @param  red_depth    depth of red nodes
+ * @param  err          error (set on failure)
+ *
+ * @return Root of created subtree.
+ */
+//==============================================================================
+static btnode_t *node_build(btree_t *tree, const char *data, size_t count,
+                            size_t depth, size_t red_depth, int *err)
+{
+        if (count == 0 || *err) {
+                return NULL;
+        }
+
+        size_t mid = count / 2;
+
+        btnode_t *node = node_make(tree, data + (mid * elem_size(tree)));
+        if (!node) {
+                *err = ENOMEM;
+                return NULL;
+        }
+
+        red(node)   = (depth == red_depth);
+        left(node)  = node_build(tree, data, mid, depth + 1, red_depth, err);
+        right(node) = node_build(tree, data + ((mid + 1) * elem_size(tree)),
+                                 count - mid - 1, depth + 1, red_depth, err);
+
+        if (left(node)) {
+                parent(left(node)) = node;
+        }
+
+        if (right(node)) {
+                parent(right(node)) = node;
+        }
+
+        return node;
+}
+
+//==============================================================================
+/**
+ * @brief  Function rotate subtree left.
+ *
+ * @param  tree         BTree object
+ * @param  node         subtree root
+ */
+//==============================================================================
+static void rotate_left(btree_t *tree, btnode_t *node)
+{
+        btnode_t *pivot = right(node);
+
+        right(node) = left(pivot);
+        if (left(pivot)) {
+                parent(left(pivot)) = node;
+        }
+
+        transplant(tree, node, pivot);
+
+        left(pivot)  = node;
+        parent(node) = pivot;
+}
+
+//==============================================================================
+/**
+ * @brief  Function rotate subtree right.
+ *
+ * @param  tree         BTree object
+ * @param  node         subtree root
+ */
+//==============================================================================
+static void rotate_right(btree_t *tree, btnode_t *node)
+{
+        btnode_t *pivot = left(node);
+
+        left(node) = right(pivot);
+        if (right(pivot)) {
+                parent(right(pivot)) = node;
+        }
+
+        transplant(tree, node, pivot);
+
+        right(pivot) = node;
+        parent(node) = pivot;
+}
+
+//==============================================================================
+/**
+ * @brief  Function replace subtree by other subtree in parent of the first.
+ *
+ * @param  tree         BTree object
+ * @param  node         replaced node
+ * @param  other        new node (can be NULL)
+ */
+//==============================================================================
+static void transplant(btree_t *tree, btnode_t *node, btnode_t *other)
+{
+        if (!parent(node)) {
+                root(tree) = other;
+        } else if (node == left(parent(node))) {
+                left(parent(node)) = other;
+        } else {
+                right(parent(node)) = other;
+        }
+
+        if (other) {
+                parent(other) = parent(node);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function restore red-black properties after insertion.
+ *
+ * @param  tree         BTree object
+ * @param  node         inserted node
+ */
+//==============================================================================
+static void insert_fixup(btree_t *tree, btnode_t *node)
+{
+        while (is_red(parent(node))) {
+                btnode_t *par   = parent(node);
+                btnode_t *grand = parent(par);
+
+                if (par == left(grand)) {
+                        btnode_t *uncle = right(grand);
+
+                        if (is_red(uncle)) {
+                                red(par)   = false;
+                                red(uncle) = false;
+                                red(grand) = true;
+                                node       = grand;
+                        } else {
+                                if (node == right(par)) {
+                                        node = par;
+                                        rotate_left(tree, node);
+                                        par = parent(node);
+                                }
+
+                                red(par)   = false;
+                                red(grand) = true;
+                                rotate_right(tree, grand);
+                        }
+                } else {
+                        btnode_t *uncle = left(grand);
+
+                        if (is_red(uncle)) {
+                                red(par)   = false;
+                                red(uncle) = false;
+                                red(grand) = true;
+                                node       = grand;
+                        } else {
+                                if (node == left(par)) {
+                                        node = par;
+                                        rotate_right(tree, node);
+                                        par = parent(node);
+                                }
+
+                                red(par)   = false;
+                                red(grand) = true;
+                                rotate_left(tree, grand);
+                        }
+                }
+        }
+
+        red(root(tree)) = false;
+}
+
+//==============================================================================
+/**
+ * @brief  Function restore red-black properties after removal of black node.
+ *
+ * @param  tree         BTree object
+ * @param  node         node that replaced removed node (can be NULL)
+ * @param  par          parent of node
+ */
+//==============================================================================
+static void remove_fixup(btree_t *tree, btnode_t *node, btnode_t *par)
+{
+        while (node != root(tree) && !is_red(node)) {
+                if (node == left(par)) {
+                        btnode_t *sibling = right(par);
+
+                        if (is_red(sibling)) {
+                                red(sibling) = false;
+                                red(par)     = true;
+                                rotate_left(tree, par);
+                                sibling = right(par);
+                        }
+
+                        if (!is_red(left(sibling)) && !is_red(right(sibling))) {
+                                red(sibling) = true;
+                                node = par;
+                                par  = parent(node);
+                        } else {
+                                if (!is_red(right(sibling))) {
+                                        red(left(sibling)) = false;
+                                        red(sibling)       = true;
+                                        rotate_right(tree, sibling);
+                                        sibling = right(par);
+                                }
+
+                                red(sibling)        = red(par);
+                                red(par)            = false;
+                                red(right(sibling)) = false;
+                                rotate_left(tree, par);
+                                node = root(tree);
+                        }
+                } else {
+                        btnode_t *sibling = left(par);
+
+                        if (is_red(sibling)) {
+                                red(sibling) = false;
+                                red(par)     = true;
+                                rotate_right(tree, par);
+                                sibling = left(par);
+                        }
+
+                        if (!is_red(left(sibling)) && !is_red(right(sibling))) {
+                                red(sibling) = true;
+                                node = par;
+                                par  = parent(node);
+                        } else {
+                                if (!is_red(left(sibling))) {
+                                        red(right(sibling)) = false;
+                                        red(sibling)        = true;
+                                        rotate_left(tree, sibling);
+                                        sibling = left(par);
+                                }
+
+                                red(sibling)       = red(par);
+                                red(par)           = false;
+                                red(left(sibling)) = false;
+                                rotate_right(tree, par);
+                                node = root(tree);
+                        }
+                }
+        }
+
+        if (node) {
+                red(node) = false;
+        }
+}
+
 //==============================================================================
 /**
  * @brief  Allocate memory in user space.
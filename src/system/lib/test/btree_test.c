@@ -0,0 +1,259 @@
+/*=========================================================================*//**
+File     btree_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test and benchmark of binary tree library.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Random insert/remove trace is replayed and red-black properties and parent
+ * links are checked periodically. Test checks in-order and reverse iteration,
+ * break out of foreach loop and trees built from sorted input of each size.
+ * Time of sorted insertion, full iteration and search is printed. Tested file
+ * is included to check tree nodes.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "../btree.c"
+#include "lib/cast.h"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define KEYS                    5000
+#define TRACE_OPS               200000
+#define BUILD_MAX               300
+#define BENCH_KEYS              50000
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static bool present[KEYS];
+static int  sorted[BENCH_KEYS];
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Compare integers.
+ */
+//==============================================================================
+static int int_cmp(const void *a, const void *b)
+{
+        int x = *cast(const int*, a);
+        int y = *cast(const int*, b);
+
+        return (x < y) ? -1 : (x > y);
+}
+
+//==============================================================================
+/**
+ * @brief  Check red-black properties and parent links of subtree.
+ *
+ * @return Black height of subtree.
+ */
+//==============================================================================
+static int check_node(btnode_t *node, btnode_t *parent)
+{
+        if (node == NULL) {
+                return 1;
+        }
+
+        HT_CHECK(parent(node) == parent);
+        HT_CHECK(!red(node) || (!is_red(left(node)) && !is_red(right(node))));
+
+        int lh = check_node(left(node), node);
+        int rh = check_node(right(node), node);
+        HT_CHECK(lh == rh);
+
+        return lh + (red(node) ? 0 : 1);
+}
+
+//==============================================================================
+/**
+ * @brief  Check tree.
+ */
+//==============================================================================
+static void check_tree(btree_t *tree)
+{
+        HT_CHECK(!is_red(root(tree)));
+        check_node(root(tree), NULL);
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        btree_t *tree;
+
+        HT_CHECK_OK(_btree_create_krn(_MM_KRN, sizeof(int), int_cmp, NULL, &tree));
+        HT_CHECK(_btree_is_empty(tree));
+
+        // random trace
+        ht_srand(6);
+
+        for (int op = 0; op < TRACE_OPS; op++) {
+                int key = ht_rand() % KEYS;
+
+                if (present[key]) {
+                        HT_CHECK_OK(_btree_remove(tree, &key));
+                        present[key] = false;
+                } else {
+                        HT_CHECK_OK(_btree_insert(tree, &key));
+                        present[key] = true;
+                }
+
+                if ((op % 1000) == 0) {
+                        check_tree(tree);
+                }
+        }
+
+        check_tree(tree);
+
+        int key = 0;
+        while (!present[key]) {
+                key++;
+        }
+
+        HT_CHECK(_btree_insert(tree, &key) == EEXIST);
+
+        int found;
+        HT_CHECK_OK(_btree_search(tree, &key, &found));
+        HT_CHECK(found == key);
+
+        // in-order iteration
+        int count = 0;
+        int prev  = -1;
+
+        _btree_foreach(int, val, tree) {
+                HT_CHECK(val > prev && present[val]);
+                prev = val;
+                count++;
+        }
+
+        int expected = 0;
+        for (int i = 0; i < KEYS; i++) {
+                expected += present[i] ? 1 : 0;
+        }
+
+        HT_CHECK(count == expected);
+
+        prev = KEYS;
+        _btree_foreach_reverse(int, val, tree) {
+                HT_CHECK(val < prev);
+                prev = val;
+        }
+
+        count = 0;
+        _btree_foreach(int, val, tree) {
+                if (++count == 10) {
+                        break;
+                }
+        }
+
+        HT_CHECK(count == 10);
+
+        _btree_destroy(tree);
+
+        // build from sorted input
+        for (int n = 0; n < BUILD_MAX; n++) {
+                for (int i = 0; i < n; i++) {
+                        sorted[i] = i * 2;
+                }
+
+                HT_CHECK_OK(_btree_create_krn(_MM_KRN, sizeof(int), int_cmp, NULL, &tree));
+                HT_CHECK_OK(_btree_build(tree, sorted, n));
+                check_tree(tree);
+
+                int i = 0;
+                _btree_foreach(int, val, tree) {
+                        HT_CHECK(val == sorted[i++]);
+                }
+
+                HT_CHECK(i == n);
+
+                // built tree is balanced for following updates
+                for (int k = 0; k < n; k += 3) {
+                        HT_CHECK_OK(_btree_remove(tree, &sorted[k]));
+                }
+
+                int odd = 7;
+                HT_CHECK_OK(_btree_insert(tree, &odd));
+                check_tree(tree);
+
+                _btree_destroy(tree);
+        }
+
+        int unsorted[] = {1, 3, 2};
+        HT_CHECK_OK(_btree_create_krn(_MM_KRN, sizeof(int), int_cmp, NULL, &tree));
+        HT_CHECK(_btree_build(tree, unsorted, ARRAY_SIZE(unsorted)) == EINVAL);
+        _btree_destroy(tree);
+
+        // sorted insertion, iteration and search
+        HT_CHECK_OK(_btree_create_krn(_MM_KRN, sizeof(int), int_cmp, NULL, &tree));
+
+        unsigned long long t_insert = ht_clock_us();
+        for (int i = 0; i < BENCH_KEYS; i++) {
+                HT_CHECK_OK(_btree_insert(tree, &i));
+        }
+        t_insert = ht_clock_us() - t_insert;
+
+        check_tree(tree);
+
+        unsigned long long t_iter = ht_clock_us();
+        count = 0;
+        _btree_foreach(int, val, tree) {
+                count++;
+        }
+        t_iter = ht_clock_us() - t_iter;
+
+        HT_CHECK(count == BENCH_KEYS);
+
+        unsigned long long t_search = ht_clock_us();
+        for (int i = 0; i < BENCH_KEYS; i++) {
+                HT_CHECK_OK(_btree_search(tree, &i, &found));
+        }
+        t_search = ht_clock_us() - t_search;
+
+        _btree_destroy(tree);
+        HT_CHECK(ht_mem_blocks() == 0);
+
+        ht_print("btree: %d keys sorted insert %llu us, iteration %llu us, "
+                 "search %llu us\n", BENCH_KEYS, t_insert, t_iter, t_search);
+
+        ht_print("btree: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
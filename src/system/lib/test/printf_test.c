@@ -0,0 +1,227 @@
+/*=========================================================================*//**
+File     printf_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test and benchmark of formatted output.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Test checks supported conversions, output longer than formatter chunk,
+ * truncation to the buffer and stop of formatting when output function does
+ * not accept all characters. Benchmark compares streaming output with the
+ * previous path of vfprintf(): length measurement, heap buffer, second
+ * formatting and single write. Time and peak heap usage are printed.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <string.h>
+#include <stdarg.h>
+#include "lib/vsnprintf.h"
+#include "lib/cast.h"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define CALLS                   100000
+#define LONG_LEN                300
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct {
+        size_t  limit;
+        size_t  len;
+        size_t  calls;
+} sink_t;
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static char buf[1024];
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Check formatted string.
+ */
+//==============================================================================
+static void check(const char *expected, const char *format, ...)
+{
+        va_list arg;
+        va_start(arg, format);
+        int n = _vsnprintf(buf, sizeof(buf), format, arg);
+        va_end(arg);
+
+        if (strcmp(buf, expected) != 0) {
+                ht_print("'%s' != '%s'\n", buf, expected);
+        }
+
+        HT_CHECK(strcmp(buf, expected) == 0);
+        HT_CHECK(n == cast(int, strlen(expected)));
+}
+
+//==============================================================================
+/**
+ * @brief  Output function that accepts selected number of characters.
+ */
+//==============================================================================
+static size_t sink_put(void *ctx, const char *str, size_t len)
+{
+        sink_t *sink = ctx;
+
+        size_t n = (sink->len + len <= sink->limit) ? len : sink->limit - sink->len;
+        sink->len += n;
+        sink->calls++;
+
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief  Streaming formatted output.
+ */
+//==============================================================================
+static int stream_printf(sink_t *sink, const char *format, ...)
+{
+        va_list arg;
+        va_start(arg, format);
+        int n = _vprintf_put(sink_put, sink, format, arg);
+        va_end(arg);
+
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief  Formatted output by two formatting passes and heap buffer.
+ */
+//==============================================================================
+static int heap_printf(sink_t *sink, size_t *peak, const char *format, ...)
+{
+        va_list arg;
+        va_start(arg, format);
+        int size = _vsnprintf(NULL, 0, format, arg) + 1;
+        va_end(arg);
+
+        char *str = ht_malloc(size);
+        *peak = (cast(size_t, size) > *peak) ? cast(size_t, size) : *peak;
+
+        va_start(arg, format);
+        int n = _vsnprintf(str, size, format, arg);
+        va_end(arg);
+
+        sink_put(sink, str, n);
+        ht_free(str);
+
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        // conversions
+        check("%", "%%");
+        check("_x_", "_%c_", 'x');
+        check("__", "_%c_", '\0');
+        check("Foobar", "%s", "Foobar");
+        check("Foo", "%.*s", 3, "Foobar");
+        check("Foo", "%.3s", "Foobar");
+        check("-5, 10", "%d, %i", -5, 10);
+        check("4294967295, 10", "%u, %u", -1, 10);
+        check("0x5a, 0xFA", "0x%x, 0x%X", 0x5A, 0xfa);
+        check("0x05, 0x1F43", "0x%02X, 0x%03X", 0x5, 0x1F43);
+        check("1.000000", "%f", 1.0);
+        check("-1234567890", "%d", -1234567890);
+
+        // output longer than formatter chunk
+        static char str[LONG_LEN + 1];
+        for (int i = 0; i < LONG_LEN; i++) {
+                str[i] = 'a' + (i % 26);
+        }
+
+        check(str, "%s", str);
+        check(str, "%.*s%s", 100, str, str + 100);
+
+        // truncated output
+        HT_CHECK(_snprintf(buf, 4, "Foobar") == 3);
+        HT_CHECK(strcmp(buf, "Foo") == 0);
+        HT_CHECK(_snprintf(buf, 1, "Foobar") == 0);
+        HT_CHECK(buf[0] == '\0');
+        HT_CHECK(_snprintf(NULL, 0, "%s%d", str, 12345) == LONG_LEN + 5);
+
+        // formatting stops when output is not accepted
+        sink_t sink = {.limit = 100};
+        HT_CHECK(stream_printf(&sink, "%s", str) == 100);
+        HT_CHECK(sink.len == 100);
+        size_t calls = sink.calls;
+        HT_CHECK(stream_printf(&sink, "%s", str) == 0);
+        HT_CHECK(sink.calls == calls + 1);
+
+        // throughput and peak heap usage
+        static const char *format = "%s: pid %d, mem %u B, addr 0x%08X, %.*s\n";
+
+        size_t peak_heap = 0;
+        sink = (sink_t){.limit = SIZE_MAX};
+        unsigned long long t_heap = ht_clock_us();
+
+        for (int i = 0; i < CALLS; i++) {
+                heap_printf(&sink, &peak_heap, format, "task", i, i * 3, i * 7, i % 64, str);
+        }
+
+        t_heap = ht_clock_us() - t_heap;
+        size_t len_heap = sink.len;
+
+        sink = (sink_t){.limit = SIZE_MAX};
+        unsigned long long t_stream = ht_clock_us();
+
+        for (int i = 0; i < CALLS; i++) {
+                stream_printf(&sink, format, "task", i, i * 3, i * 7, i % 64, str);
+        }
+
+        t_stream = ht_clock_us() - t_stream;
+
+        HT_CHECK(sink.len == len_heap);
+        HT_CHECK(ht_mem_blocks() == 0);
+
+        ht_print("printf: %d calls, two-pass with heap buffer %llu us (peak heap %u B), "
+                 "streaming %llu us (peak heap 0 B)\n",
+                 CALLS, t_heap, cast(unsigned, peak_heap), t_stream);
+
+        ht_print("printf: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
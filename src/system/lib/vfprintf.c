@@ -34,7 +34,6 @@
 #include "lib/vfprintf.h"
 #include "lib/vsnprintf.h"
 #include "lib/cast.h"
-#include "mm/mm.h"
 
 /*==============================================================================
   Local macros
@@ -64,6 +63,26 @@
   Function definitions
 ==============================================================================*/
 
+#if (__OS_PRINTF_ENABLE__ > 0)
+//==============================================================================
+/**
+ * @brief Function write formatted chunk to the file.
+ *
+ * @param ctx                 file
+ * @param str                 chunk
+ * @param len                 chunk length
+ *
+ * @retval number of written characters
+ */
+//==============================================================================
+static size_t file_put(void *ctx, const char *str, size_t len)
+{
+        size_t wrcnt = 0;
+        _vfs_fwrite(str, len, &wrcnt, ctx);
+        return wrcnt;
+}
+#endif
+
 //==============================================================================
 /**
  * @brief Function write to file formatted string
@@ -82,21 +101,7 @@ int _vfprintf(FILE *file, const char *format, va_list arg)
 #if (__OS_PRINTF_ENABLE__ > 0)
 
         if (file && format) {
-                va_list carg;
-                va_copy(carg, arg);
-                u32_t size = _vsnprintf(NULL, 0, format, carg) + 1;
-                va_end(carg);
-
-                char *str = NULL;
-                int err = _kzalloc(_MM_KRN, size, cast(void*, &str));
-                if (!err && str) {
-                        n = _vsnprintf(str, size, format, arg);
-
-                        size_t wrcnt;
-                        _vfs_fwrite(str, n, &wrcnt, file);
-
-                        _kfree(_MM_KRN, cast(void*, &str));
-                }
+                n = _vprintf_put(file_put, file, format, arg);
         }
 
 #else
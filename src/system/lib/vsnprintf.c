@@ -41,10 +41,16 @@
 /*==============================================================================
   Local macros
 ==============================================================================*/
+#define CHUNK_LEN               64
 
 /*==============================================================================
   Local object types
 ==============================================================================*/
+typedef struct {
+        char   *buf;
+        size_t  size;
+        size_t  len;
+} sbuf_t;
 
 /*==============================================================================
   Local function prototypes
@@ -69,14 +75,17 @@
 
 //==============================================================================
 /**
- * @brief Function convert arguments to stream
+ * @brief Function convert arguments to stream. Output is formatted in a single
+ *        pass to the small chunk on the stack. The chunk is passed to the
+ *        output function each time when is full and at the end of format.
  *
- * @param[in] *buf           buffer for stream
- * @param[in]  size          buffer size
+ * @param[in]  put           output function (returns number of accepted
+ *                           characters, formatting is stopped if not all)
+ * @param[in] *ctx           output function context
  * @param[in] *format        message format
  * @param[in]  arg           argument list
  *
- * @return number of printed characters
+ * @return number of characters accepted by output function
  *
  * Supported flags:
  *   %%         - print % character
@@ -119,12 +128,14 @@
  *                printf("Pointer: %p", main); => Pointer: 0x4028B4
  */
 //==============================================================================
-int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
+int _vprintf_put(vprintf_put_t put, void *ctx, const char *format, va_list arg)
 {
 #if (__OS_PRINTF_ENABLE__ > 0)
         char   chr;
         int    arg_size;
-        size_t scan_len     = 1;
+        char   chunk[CHUNK_LEN];
+        size_t chunk_len    = 0;
+        int    count        = 0;
         bool   leading_zero = false;
         bool   loop_break   = false;
         bool   long_long    = false;
@@ -138,21 +149,39 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
                 loop_break = true;
         }
 
-        /// @brief  Put character to the buffer
-        /// @param  c    character to put
+        /// @brief  Pass chunk to the output function
+        /// @param  None
         /// @return On success true is returned, otherwise false and loop is break
-        bool put_char(const char c)
+        bool flush_chunk()
         {
-                if (buf) {
-                        if (scan_len < size) {
-                                *buf++ = c;
-                        } else {
+                if (chunk_len > 0) {
+                        size_t n = put(ctx, chunk, chunk_len);
+                        count   += n;
+
+                        if (n < chunk_len) {
                                 break_loop();
-                                return false;
                         }
+
+                        chunk_len = 0;
                 }
 
-                scan_len++;
+                return !loop_break;
+        }
+
+        /// @brief  Put character to the chunk
+        /// @param  c    character to put
+        /// @return On success true is returned, otherwise false and loop is break
+        bool put_char(const char c)
+        {
+                if (loop_break) {
+                        return false;
+                }
+
+                if (chunk_len == sizeof(chunk) && !flush_chunk()) {
+                        return false;
+                }
+
+                chunk[chunk_len++] = c;
                 return true;
         }
 
@@ -454,19 +483,71 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
                 }
         }
 
-        if (buf)
-                *buf = 0;
+        flush_chunk();
 
-        return (scan_len - 1);
+        return count;
 #else
-        UNUSED_ARG1(buf);
-        UNUSED_ARG1(size);
+        UNUSED_ARG1(put);
+        UNUSED_ARG1(ctx);
         UNUSED_ARG1(format);
         UNUSED_ARG1(arg);
         return 0;
 #endif
 }
 
+//==============================================================================
+/**
+ * @brief Function copy formatted chunk to the buffer.
+ *
+ * @param[in] *ctx           buffer descriptor
+ * @param[in] *str           chunk
+ * @param[in]  len           chunk length
+ *
+ * @return number of accepted characters
+ */
+//==============================================================================
+static size_t buf_put(void *ctx, const char *str, size_t len)
+{
+        sbuf_t *sbuf = ctx;
+
+        if (sbuf->buf) {
+                size_t free = (sbuf->len + 1 < sbuf->size) ? sbuf->size - sbuf->len - 1 : 0;
+
+                len = (len < free) ? len : free;
+                memcpy(&sbuf->buf[sbuf->len], str, len);
+                sbuf->len += len;
+        }
+
+        return len;
+}
+
+//==============================================================================
+/**
+ * @brief Function convert arguments to stream
+ *
+ * @param[in] *buf           buffer for stream (NULL to count characters)
+ * @param[in]  size          buffer size
+ * @param[in] *format        message format
+ * @param[in]  arg           argument list
+ *
+ * @return number of printed characters
+ *
+ * @see _vprintf_put() for supported flags
+ */
+//==============================================================================
+int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
+{
+        sbuf_t sbuf = {.buf = buf, .size = size, .len = 0};
+
+        int n = _vprintf_put(buf_put, &sbuf, format, arg);
+
+        if (buf && size) {
+                buf[sbuf.len] = '\0';
+        }
+
+        return n;
+}
+
 //==============================================================================
 /**
  * @brief Function convert arguments to stream.
@@ -32,7 +32,6 @@
 #include <config.h>
 #include <stdio.h>
 #include <string.h>
-#include <sys/stat.h>
 #include "lib/unarg.h"
 
 /*==============================================================================
@@ -81,64 +80,29 @@ char *fgets(char *str, int size, FILE *stream)
                 return NULL;
         }
 
-        struct stat file_stat;
-        if (fstat(stream, &file_stat) == 0) {
-
-                char *p = str;
-                int   c = EOF;
-
-                size--;
-
-                if (file_stat.st_type == FILE_TYPE_PIPE || file_stat.st_type == FILE_TYPE_DRV) {
-
-                        while ((c != '\n') && size--) {
-
-                                c = fgetc(stream);
-                                if (c == EOF) {
-                                        break;
-                                } else {
-                                        *p++ = c;
-                                }
-                        }
+        char *p = str;
+        int   c = EOF;
 
+        // stream buffer is used so characters are read one by one
+        while ((c != '\n') && --size > 0) {
+                c = fgetc(stream);
+                if (c == EOF) {
+                        break;
                 } else {
-                        char chunk[16];
-                        int  n = 0;
-
-                        i64_t fpos = ftell(stream);
-
-                        fseek(stream, 0, SEEK_END);
-                        i64_t end = ftell(stream);
-
-                        fseek(stream, fpos, SEEK_SET);
-
-                        while ((c != '\n') && (size > 0) && !(ferror(stream) || feof(stream))) {
-
-                                n = fread(chunk, 1, sizeof(chunk), stream);
-
-                                for (int i = 0; c != '\n' && size > 0 && i < n; size--, i++) {
-                                        c    = chunk[i];
-                                        *p++ = c;
-                                        fpos++;
-                                }
-                        }
-
-                        if ((c == '\n' || size == 0) && fpos < end) {
-                                fseek(stream, fpos, SEEK_SET);
-                        }
+                        *p++ = c;
                 }
+        }
 
-                *p = '\0';
-
-                if (ferror(stream)) {
-                        str = NULL;
+        *p = '\0';
 
-                } else if (feof(stream)) {
-                        str = (p == str) ? NULL : str;
-                }
+        if (ferror(stream)) {
+                str = NULL;
 
-                return str;
+        } else if (c == EOF) {
+                str = (p == str) ? NULL : str;
         }
+
+        return str;
 #else
         UNUSED_ARG3(str, size, stream);
 #endif
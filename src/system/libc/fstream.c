@@ -0,0 +1,661 @@
+/*=========================================================================*//**
+@file    fstream.c
+
+@author  Daniel Zorychta
+
+@brief   Buffered stream functions.
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <dnx/misc.h>
+#include "fs/vfs.h"
+#include "kernel/kwrapper.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief Function write data directly to file (system call).
+ *
+ * @param  ptr          data to write
+ * @param  size         number of bytes to write
+ * @param  file         file
+ *
+ * @return Number of written bytes.
+ */
+//==============================================================================
+static size_t raw_write(const void *ptr, size_t size, FILE *file)
+{
+        size_t n = 0, count = 1;
+        syscall(SYSCALL_FWRITE, &n, ptr, &count, &size, file);
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief Function read data directly from file (system call).
+ *
+ * @param  ptr          destination buffer
+ * @param  size         number of bytes to read
+ * @param  file         file
+ *
+ * @return Number of read bytes.
+ */
+//==============================================================================
+static size_t raw_read(void *ptr, size_t size, FILE *file)
+{
+        size_t n = 0, count = 1;
+        syscall(SYSCALL_FREAD, &n, ptr, &count, &size, file);
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief Function set file position directly (system call).
+ *
+ * @param  file         file
+ * @param  offset       offset
+ * @param  mode         seek mode
+ *
+ * @return 0 on success, other value on error.
+ */
+//==============================================================================
+static int raw_seek(FILE *file, i64_t offset, int mode)
+{
+        int r = 1;
+        syscall(SYSCALL_FSEEK, &r, file, &offset, &mode);
+        return r;
+}
+
+//==============================================================================
+/**
+ * @brief Function return file buffer and lock it. Buffer of regular file is
+ *        created at first buffered I/O (full buffering). Other files and
+ *        stderr are not buffered until setvbuf() is called.
+ *
+ * @param  file         file
+ * @param  create       create buffer if file does not have it
+ *
+ * @return Locked buffer or NULL if file is not buffered.
+ */
+//==============================================================================
+static struct vfs_file_buf *buf_lock(FILE *file, bool create)
+{
+        if (!file || file->header.type != RES_TYPE_FILE) {
+                return NULL;
+        }
+
+        if (  !file->f_buf && create && file->f_flag.regular
+           && (file != stderr || stderr == stdout) ) {
+
+                int    r    = EOF;
+                int    mode = VFS_BUF_FULL;
+                size_t size = BUFSIZ;
+                syscall(SYSCALL_FSETVBUF, &r, file, NULL, &mode, &size);
+        }
+
+        struct vfs_file_buf *fbuf = file->f_buf;
+
+        if (fbuf && _builtinfunc(vfs_fbuf_lock, fbuf, MAX_DELAY_MS) == ESUCC) {
+                return fbuf;
+        }
+
+        return NULL;
+}
+
+//==============================================================================
+/**
+ * @brief Function unlock file buffer.
+ *
+ * @param  fbuf         file buffer
+ */
+//==============================================================================
+static void buf_unlock(struct vfs_file_buf *fbuf)
+{
+        _builtinfunc(vfs_fbuf_unlock, fbuf);
+}
+
+//==============================================================================
+/**
+ * @brief Function write pending data of file buffer. Data that cannot be
+ *        written stays in the buffer.
+ *
+ * @param  file         file
+ * @param  fbuf         file buffer (locked)
+ *
+ * @return 0 on success, EOF on error.
+ */
+//==============================================================================
+static int buf_flush(FILE *file, struct vfs_file_buf *fbuf)
+{
+        if (fbuf->wr) {
+                size_t n = raw_write(fbuf->data, fbuf->pos, file);
+
+                if (n < fbuf->pos) {
+                        memmove(fbuf->data, &fbuf->data[n], fbuf->pos - n);
+                        fbuf->pos -= n;
+                        return EOF;
+                }
+
+                fbuf->wr  = false;
+                fbuf->pos = 0;
+        }
+
+        return 0;
+}
+
+//==============================================================================
+/**
+ * @brief Function read data to the file buffer.
+ *
+ * @param  file         file
+ * @param  fbuf         file buffer (locked)
+ *
+ * @return Number of read bytes.
+ */
+//==============================================================================
+static size_t buf_fill(FILE *file, struct vfs_file_buf *fbuf)
+{
+        fbuf->pos = 0;
+        fbuf->len = raw_read(fbuf->data, fbuf->size, file);
+
+        return fbuf->len;
+}
+
+//==============================================================================
+/**
+ * @brief Function drop read-ahead data. File position is moved back to the
+ *        position seen by the user.
+ *
+ * @param  file         file
+ * @param  fbuf         file buffer (locked)
+ */
+//==============================================================================
+static void buf_drop(FILE *file, struct vfs_file_buf *fbuf)
+{
+        if (!fbuf->wr) {
+                if (fbuf->len > fbuf->pos && !fbuf->stream) {
+                        raw_seek(file, -cast(i64_t, fbuf->len - fbuf->pos), SEEK_CUR);
+                }
+
+                fbuf->pos = 0;
+                fbuf->len = 0;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function write data to the file by buffer. Data greater than buffer
+ *        is written directly after pending data.
+ *
+ * @param  file         file
+ * @param  fbuf         file buffer (locked)
+ * @param  ptr          data to write
+ * @param  n            number of bytes to write
+ *
+ * @return Number of written bytes.
+ */
+//==============================================================================
+static size_t buf_write(FILE *file, struct vfs_file_buf *fbuf, const void *ptr, size_t n)
+{
+        buf_drop(file, fbuf);
+
+        if (fbuf->mode == VFS_BUF_NONE || n >= fbuf->size) {
+                return (buf_flush(file, fbuf) == 0) ? raw_write(ptr, n, file) : 0;
+        }
+
+        const u8_t *src   = ptr;
+        size_t      wrcnt = 0;
+
+        while (wrcnt < n) {
+                size_t chunk = min(n - wrcnt, fbuf->size - fbuf->pos);
+
+                memcpy(&fbuf->data[fbuf->pos], &src[wrcnt], chunk);
+                fbuf->pos += chunk;
+                fbuf->wr   = true;
+                wrcnt     += chunk;
+
+                if (fbuf->pos == fbuf->size && buf_flush(file, fbuf) != 0) {
+                        break;
+                }
+        }
+
+        if (fbuf->mode == VFS_BUF_LINE && memchr(ptr, '\n', n)) {
+                buf_flush(file, fbuf);
+        }
+
+        return wrcnt;
+}
+
+//==============================================================================
+/**
+ * @brief Function write data to stream.
+ *
+ * @param  ptr          data to write
+ * @param  size         element size
+ * @param  count        number of elements
+ * @param  file         stream
+ *
+ * @return Number of written elements.
+ */
+//==============================================================================
+size_t fwrite(const void *ptr, size_t size, size_t count, FILE *file)
+{
+        size_t n = size * count;
+
+        if (!ptr || n == 0) {
+                return 0;
+        }
+
+        struct vfs_file_buf *fbuf = buf_lock(file, true);
+        if (!fbuf) {
+                return raw_write(ptr, n, file) / size;
+        }
+
+        size_t wrcnt = buf_write(file, fbuf, ptr, n);
+
+        buf_unlock(fbuf);
+
+        return wrcnt / size;
+}
+
+//==============================================================================
+/**
+ * @brief Function read data from stream. Before read the stdout stream is
+ *        flushed (e.g. to show prompt).
+ *
+ * @param  ptr          destination buffer
+ * @param  size         element size
+ * @param  count        number of elements
+ * @param  file         stream
+ *
+ * @return Number of read elements.
+ */
+//==============================================================================
+size_t fread(void *ptr, size_t size, size_t count, FILE *file)
+{
+        size_t n = size * count;
+
+        if (!ptr || n == 0) {
+                return 0;
+        }
+
+        if (stdout && stdout != file) {
+                struct vfs_file_buf *fbuf = buf_lock(stdout, false);
+                if (fbuf) {
+                        buf_flush(stdout, fbuf);
+                        buf_unlock(fbuf);
+                }
+        }
+
+        struct vfs_file_buf *fbuf = buf_lock(file, true);
+        if (!fbuf) {
+                return raw_read(ptr, n, file) / size;
+        }
+
+        // pending data must be written before read
+        if (buf_flush(file, fbuf) != 0) {
+                buf_unlock(fbuf);
+                return 0;
+        }
+
+        // unbuffered read (e.g. terminal) does not use buffer memory, thus
+        // lock is not held (terminal can be used for output at the same time)
+        if (!fbuf->rd || fbuf->mode == VFS_BUF_NONE) {
+                buf_unlock(fbuf);
+                return raw_read(ptr, n, file) / size;
+        }
+
+        size_t rdcnt = 0;
+        u8_t  *dst   = ptr;
+
+        while (rdcnt < n) {
+                if (fbuf->pos < fbuf->len) {
+                        size_t chunk = min(n - rdcnt, fbuf->len - fbuf->pos);
+                        memcpy(&dst[rdcnt], &fbuf->data[fbuf->pos], chunk);
+                        fbuf->pos += chunk;
+                        rdcnt     += chunk;
+
+                } else if (rdcnt > 0 && fbuf->stream) {
+                        // stream returns only available data
+                        break;
+
+                } else if (n - rdcnt >= fbuf->size) {
+                        rdcnt += raw_read(&dst[rdcnt], n - rdcnt, file);
+                        break;
+
+                } else if (buf_fill(file, fbuf) == 0) {
+                        break;
+                }
+        }
+
+        buf_unlock(fbuf);
+
+        return rdcnt / size;
+}
+
+//==============================================================================
+/**
+ * @brief Function copy data between streams by program buffer. Used when
+ *        source is not a regular file (position cannot be restored when
+ *        destination does not accept all data).
+ *
+ * @param  fin          source stream
+ * @param  fout         destination stream
+ * @param  count        number of bytes to copy
+ *
+ * @return Number of copied bytes.
+ */
+//==============================================================================
+static size_t stream_copy(FILE *fin, FILE *fout, size_t count)
+{
+        size_t copied = 0;
+        size_t size   = min(count, cast(size_t, BUFSIZ));
+        char  *buf    = malloc(size);
+
+        if (buf) {
+                _errno = ESUCC;
+
+                while (copied < count) {
+                        size_t chunk = min(count - copied, size);
+                        size_t rdcnt = fread(buf, 1, chunk, fin);
+                        size_t wrcnt = (rdcnt > 0) ? fwrite(buf, 1, rdcnt, fout) : 0;
+
+                        copied += wrcnt;
+
+                        if (wrcnt < rdcnt || rdcnt < chunk) {
+                                break;
+                        }
+                }
+
+                free(buf);
+        }
+
+        return copied;
+}
+
+//==============================================================================
+/**
+ * @brief Function copy data between streams. Data buffered in source stream
+ *        is copied at first, next data is copied by system without user
+ *        space buffer. Buffers are not locked during copy because copy can
+ *        block (e.g. pipe).
+ *
+ * @param  fin          source stream
+ * @param  fout         destination stream
+ * @param  count        number of bytes to copy
+ *
+ * @return Number of copied bytes or -1 on error.
+ */
+//==============================================================================
+ssize_t copy_file_range(FILE *fin, FILE *fout, size_t count)
+{
+        if (!fin || !fout || fin == fout) {
+                _errno = EINVAL;
+                return -1;
+        }
+
+        // buffers are locked in the same order in each thread (deadlock)
+        struct vfs_file_buf *fbin  = (fin < fout) ? buf_lock(fin, false) : NULL;
+        struct vfs_file_buf *fbout = buf_lock(fout, false);
+
+        if (fin > fout) {
+                fbin = buf_lock(fin, false);
+        }
+
+        size_t copied = 0;
+        bool   done   = false;
+        int    r      = 0;
+
+        if (fbin) {
+                r = buf_flush(fin, fbin);
+
+                if (r == 0 && fbin->pos < fbin->len) {
+                        size_t n = min(fbin->len - fbin->pos, count);
+
+                        if (fbout) {
+                                copied = buf_write(fout, fbout, &fbin->data[fbin->pos], n);
+                        } else {
+                                copied = raw_write(&fbin->data[fbin->pos], n, fout);
+                        }
+
+                        fbin->pos += copied;
+                        done       = (copied < n) || (copied == count);
+                }
+        }
+
+        if (r == 0 && !done && fbout) {
+                buf_drop(fout, fbout);
+                done = (buf_flush(fout, fbout) != 0);
+        }
+
+        if (fbin) {
+                buf_unlock(fbin);
+        }
+
+        if (fbout) {
+                buf_unlock(fbout);
+        }
+
+        if (r != 0) {
+                return -1;
+        }
+
+        if (!done) {
+                size_t n = count - copied;
+                size_t k = 0;
+                syscall(SYSCALL_FCOPY, &k, fin, fout, &n);
+                copied += k;
+
+                // devices and pipes are copied by program buffer
+                if (_errno == ESPIPE) {
+                        copied += stream_copy(fin, fout, count - copied);
+                }
+        }
+
+        return (copied == 0 && _errno) ? -1 : cast(ssize_t, copied);
+}
+
+//==============================================================================
+/**
+ * @brief Function set stream position. Stream buffer is flushed.
+ *
+ * @param  file         stream
+ * @param  offset       offset
+ * @param  mode         seek mode
+ *
+ * @return 0 on success, other value on error.
+ */
+//==============================================================================
+int fseek(FILE *file, i64_t offset, int mode)
+{
+        struct vfs_file_buf *fbuf = buf_lock(file, false);
+        if (!fbuf) {
+                return raw_seek(file, offset, mode);
+        }
+
+        int r = buf_flush(file, fbuf);
+        if (r == 0) {
+                if (mode == SEEK_CUR && !fbuf->stream) {
+                        offset -= cast(i64_t, fbuf->len - fbuf->pos);
+                }
+
+                fbuf->pos = 0;
+                fbuf->len = 0;
+
+                r = raw_seek(file, offset, mode);
+        }
+
+        buf_unlock(fbuf);
+
+        return r;
+}
+
+//==============================================================================
+/**
+ * @brief Function return stream position (including buffered data).
+ *
+ * @param  file         stream
+ *
+ * @return Stream position.
+ */
+//==============================================================================
+i64_t ftell(FILE *file)
+{
+        i64_t lseek = 0;
+
+        struct vfs_file_buf *fbuf = buf_lock(file, false);
+
+        _errno = _builtinfunc(vfs_ftell, file, &lseek);
+
+        if (fbuf) {
+                if (_errno == ESUCC) {
+                        if (fbuf->wr) {
+                                lseek += fbuf->pos;
+
+                        } else if (!fbuf->stream) {
+                                lseek -= fbuf->len - fbuf->pos;
+                        }
+                }
+
+                buf_unlock(fbuf);
+        }
+
+        return lseek;
+}
+
+//==============================================================================
+/**
+ * @brief Function write buffered data and flush file.
+ *
+ * @param  file         stream
+ *
+ * @return 0 on success, EOF on error.
+ */
+//==============================================================================
+int fflush(FILE *file)
+{
+        int r = EOF;
+
+        struct vfs_file_buf *fbuf = buf_lock(file, false);
+        if (fbuf) {
+                r = buf_flush(file, fbuf);
+                buf_unlock(fbuf);
+
+                if (r != 0) {
+                        return r;
+                }
+        }
+
+        syscall(SYSCALL_FFLUSH, &r, file);
+
+        return r;
+}
+
+//==============================================================================
+/**
+ * @brief Function test end-of-file indicator. Indicator set by system is
+ *        ignored if buffer still contains data to read.
+ *
+ * @param  file         stream
+ *
+ * @return Nonzero if end-of-file is reached, 0 otherwise.
+ */
+//==============================================================================
+int feof(FILE *file)
+{
+        int eof = 0;
+
+        struct vfs_file_buf *fbuf = buf_lock(file, false);
+
+        _errno = _builtinfunc(vfs_feof, file, &eof);
+
+        if (fbuf) {
+                if (eof && !fbuf->wr && fbuf->pos < fbuf->len) {
+                        eof = 0;
+                }
+
+                buf_unlock(fbuf);
+        }
+
+        return _errno | eof;
+}
+
+//==============================================================================
+/**
+ * @brief Function set stream buffer.
+ *
+ * @param  file         stream
+ * @param  buffer       buffer (NULL to allocate by system)
+ * @param  mode         buffer mode
+ * @param  size         buffer size
+ *
+ * @return 0 on success, other value on error.
+ */
+//==============================================================================
+int setvbuf(FILE *file, char *buffer, int mode, size_t size)
+{
+        int r = EOF;
+
+        if (mode == _IOFBF || mode == _IOLBF || mode == _IONBF) {
+                syscall(SYSCALL_FSETVBUF, &r, file, buffer, &mode, &size);
+        }
+
+        return r;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -77,16 +77,12 @@ int getc(FILE *stream)
                 return EOF;
         }
 
-        int chr = 0;
-        if (fread(&chr, sizeof(char), 1, stream) != 0) {
-                if (ferror(stream) || feof(stream)) {
-                        return EOF;
-                }
+        unsigned char chr;
+        if (fread(&chr, sizeof(char), 1, stream) == 1) {
+                return chr;
         } else {
                 return EOF;
         }
-
-        return chr;
 #else
         UNUSED_ARG1(stream);
         return EOF;
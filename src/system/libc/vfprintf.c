@@ -31,7 +31,6 @@
 ==============================================================================*/
 #include <config.h>
 #include <stdio.h>
-#include <stdlib.h>
 #include <stdarg.h>
 #include <lib/vsnprintf.h>
 #include <dnx/misc.h>
@@ -64,6 +63,24 @@
   Function definitions
 ==============================================================================*/
 
+#if (__OS_PRINTF_ENABLE__ > 0)
+//==============================================================================
+/**
+ * @brief Function write formatted chunk to the file (stream buffer).
+ *
+ * @param ctx                 file
+ * @param str                 chunk
+ * @param len                 chunk length
+ *
+ * @retval number of written characters
+ */
+//==============================================================================
+static size_t file_put(void *ctx, const char *str, size_t len)
+{
+        return fwrite(str, sizeof(char), len, ctx);
+}
+#endif
+
 //==============================================================================
 /**
  * @brief Function write to file formatted string
@@ -81,19 +98,7 @@ int vfprintf(FILE *file, const char *format, va_list arg)
 
 #if (__OS_PRINTF_ENABLE__ > 0)
         if (file && format) {
-                va_list carg;
-                va_copy(carg, arg);
-                u32_t size = vsnprintf(NULL, 0, format, carg) + 1;
-                va_end(carg);
-
-                char *str = calloc(1, size);
-                if (str) {
-                        n = vsnprintf(str, size, format, arg);
-                        fwrite(str, sizeof(char), n, file);
-                        int err = _errno;
-                        free(str);
-                        _errno = err;
-                }
+                n = _builtinfunc(vprintf_put, file_put, file, format, arg);
         }
 #else
         UNUSED_ARG3(file, format, arg);
@@ -44,24 +44,63 @@ Brief    Cache management.
 ==============================================================================*/
 #define cache_buf(cache)        cache[1]
 #define MTX_TIMEOUT             MAX_DELAY_MS
+#define CACHE_HASH_SIZE         64
+#define SYNC_MAX_BLOCKS         8
+#define READ_AHEAD_BLOCKS       __OS_SYSTEM_CACHE_READ_AHEAD__
+#define DIRTY_BACKGROUND        __OS_SYSTEM_CACHE_DIRTY_BACKGROUND__
+#define DIRTY_LIMIT             __OS_SYSTEM_CACHE_DIRTY_LIMIT__
+#define DIRTY_EXPIRE_MS         (1000 * __OS_SYSTEM_CACHE_SYNC_PERIOD__)
+#define WRITEBACK_PERIOD_MS     1000
+#define WRITEBACK_BATCH_BLOCKS  (2 * SYNC_MAX_BLOCKS)
+#define THROTTLE_PERIOD_MS      10
+#define THROTTLE_MAX_MS         1000
+#define cache_hash(dev, pos)    ((((u32_t)(dev) * 31) + (pos)) & (CACHE_HASH_SIZE - 1))
+
+#if (CACHE_HASH_SIZE & (CACHE_HASH_SIZE - 1)) != 0
+#error "CACHE_HASH_SIZE must be power of 2!"
+#endif
+
+#if DIRTY_LIMIT < DIRTY_BACKGROUND
+#error "Cache dirty limit must be greater or equal than background threshold!"
+#endif
 
 /*==============================================================================
   Local object types
 ==============================================================================*/
 typedef struct cache {
-        struct cache       *next;               //!< next cache object
-        struct cache       *prev;               //!< previous cache object
+        struct cache       *hnext;              //!< next cache object in hash bucket
+        struct cache       *next;               //!< next (older) cache object in LRU list
+        struct cache       *prev;               //!< previous (newer) cache object in LRU list
         dev_t               dev;                //!< device ID (final medium)
-        i32_t               temp;               //!< cache temperature
         u32_t               pos;                //!< file position (block number)
         size_t              size;               //!< block size
         bool                dirty;              //!< cache is dirty
+        bool                readahead;          //!< block read in advance and not used yet
+        u32_t               dirty_time;         //!< time when block become dirty [ms]
         u8_t                buf[];              //!< block data
 } cache_t;
 
 typedef struct {
-        cache_t            *list_head;          //!< the smallest cache
+        cache_t            *head;               //!< the most recently used cache
+        cache_t            *tail;               //!< the least recently used cache
+        size_t              count;              //!< number of caches in list
+        size_t              bytes;              //!< number of cached bytes in list
+} cache_list_t;
+
+typedef struct cache_dev {
+        struct cache_dev   *next;               //!< next device
+        u32_t               next_pos;           //!< expected block of sequential read
+        _cache_dev_stat_t   stat;               //!< device statistics
+} cache_dev_t;
+
+typedef struct {
+        cache_t            *hash[CACHE_HASH_SIZE];  //!< cache index
+        cache_list_t        clean;              //!< LRU list of clean caches
+        cache_list_t        dirty;              //!< LRU list of dirty caches
+        cache_dev_t        *dev_list;           //!< list of cached devices
         mutex_t            *list_mtx;           //!< protection mutex
+        sem_t              *wb_sem;             //!< writeback thread wake up semaphore
+        task_t             *wb_task;            //!< writeback thread
         bool                sync_needed;        //!< FS synchronization needed to free dirty caches
 } cache_man_t;
 
@@ -88,6 +127,203 @@ static cache_man_t cman;
   Function definitions
 ==============================================================================*/
 #if __OS_SYSTEM_FS_CACHE_ENABLE__ > 0
+//==============================================================================
+/**
+ * @brief Function remove cache from selected LRU list.
+ *
+ * @param  list         LRU list
+ * @param  cache        cache object
+ */
+//==============================================================================
+static void list_unlink(cache_list_t *list, cache_t *cache)
+{
+        if (cache->prev) {
+                cache->prev->next = cache->next;
+        } else {
+                list->head = cache->next;
+        }
+
+        if (cache->next) {
+                cache->next->prev = cache->prev;
+        } else {
+                list->tail = cache->prev;
+        }
+
+        cache->next = NULL;
+        cache->prev = NULL;
+        list->count--;
+        list->bytes -= cache->size;
+}
+
+//==============================================================================
+/**
+ * @brief Function add cache at beginning of selected LRU list (the most
+ *        recently used).
+ *
+ * @param  list         LRU list
+ * @param  cache        cache object
+ */
+//==============================================================================
+static void list_push_front(cache_list_t *list, cache_t *cache)
+{
+        cache->prev = NULL;
+        cache->next = list->head;
+
+        if (list->head) {
+                list->head->prev = cache;
+        } else {
+                list->tail = cache;
+        }
+
+        list->head = cache;
+        list->count++;
+        list->bytes += cache->size;
+}
+
+//==============================================================================
+/**
+ * @brief Function return LRU list of selected cache.
+ *
+ * @param  cache        cache object
+ *
+ * @return LRU list.
+ */
+//==============================================================================
+static inline cache_list_t *cache_list(cache_t *cache)
+{
+        return cache->dirty ? &cman.dirty : &cman.clean;
+}
+
+//==============================================================================
+/**
+ * @brief Function mark cache as the most recently used and set dirty flag.
+ *        Cache is moved to the list of clean or dirty caches. Dirty list is
+ *        ordered by time when block become dirty, thus already dirty cache
+ *        is not moved.
+ *
+ * @param  cache        cache object
+ * @param  dirty        dirty flag
+ */
+//==============================================================================
+static void cache_touch(cache_t *cache, bool dirty)
+{
+        if (!(cache->dirty && dirty)) {
+                list_unlink(cache_list(cache), cache);
+
+                // writeback thread sleeps without timeout when all caches are clean
+                if (dirty && cman.dirty.count == 0 && cman.wb_sem) {
+                        _semaphore_signal(cman.wb_sem);
+                }
+
+                if (dirty) {
+                        cache->dirty_time = _kernel_get_time_ms();
+                }
+
+                cache->dirty = dirty;
+                list_push_front(cache_list(cache), cache);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function return statistics object of selected device.
+ *
+ * @param  dev          device
+ * @param  create       create object if does not exist
+ *
+ * @return Device object or NULL if not exist.
+ */
+//==============================================================================
+static cache_dev_t *cache_dev_get(dev_t dev, bool create)
+{
+        for (cache_dev_t *cdev = cman.dev_list; cdev; cdev = cdev->next) {
+                if (cdev->stat.dev == dev) {
+                        return cdev;
+                }
+        }
+
+        cache_dev_t *cdev = NULL;
+
+        if (create) {
+                // cache memory type does not call cache reduction (locked mutex)
+                if (_kzalloc(_MM_CACHE, sizeof(cache_dev_t), cast(void*, &cdev)) == ESUCC) {
+                        cdev->stat.dev = dev;
+                        cdev->next     = cman.dev_list;
+                        cman.dev_list  = cdev;
+                }
+        }
+
+        return cdev;
+}
+
+//==============================================================================
+/**
+ * @brief Function read selected blocks directly from device.
+ *
+ * @param  dev          device
+ * @param  blkpos       block position
+ * @param  blksz        block size
+ * @param  blkcnt       block count
+ * @param  buf          destination buffer
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int device_read(dev_t dev, u32_t blkpos, size_t blksz, size_t blkcnt, u8_t *buf)
+{
+        fpos_t fpos  = cast(fpos_t, blkpos) * blksz;
+        size_t rdcnt = 0;
+        size_t rdsz  = blksz * blkcnt;
+        struct vfs_fattr fattr = {false, false};
+
+        int err = _driver_read(dev, buf, rdsz, &fpos, &rdcnt, fattr);
+
+        if (!err && rdcnt != rdsz) {
+                err = EIO;
+        }
+
+        cache_dev_t *cdev = cache_dev_get(dev, false);
+        if (cdev) {
+                cdev->stat.rd_requests++;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function write selected blocks directly to device.
+ *
+ * @param  dev          device
+ * @param  blkpos       block position
+ * @param  blksz        block size
+ * @param  blkcnt       block count
+ * @param  buf          source buffer
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int device_write(dev_t dev, u32_t blkpos, size_t blksz, size_t blkcnt, const u8_t *buf)
+{
+        fpos_t fpos  = cast(fpos_t, blkpos) * blksz;
+        size_t wrcnt = 0;
+        size_t wrsz  = blksz * blkcnt;
+        struct vfs_fattr fattr = {false, false};
+
+        int err = _driver_write(dev, buf, wrsz, &fpos, &wrcnt, fattr);
+
+        if (!err && wrcnt != wrsz) {
+                err = EIO;
+        }
+
+        cache_dev_t *cdev = cache_dev_get(dev, false);
+        if (cdev) {
+                cdev->stat.wr_requests++;
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief Function allocate new cache object and add to list.
@@ -109,18 +345,17 @@ static int cache_alloc(dev_t dev, u32_t blkpos, size_t blksz, cache_t **cache)
 
         int err = _kzalloc(_MM_CACHE, sizeof(cache_t) + blksz, cast(void*, cache));
         if (!err) {
-                (*cache)->dev  = dev;
-                (*cache)->pos  = blkpos;
-                (*cache)->size = blksz;
-                (*cache)->next = cman.list_head;
+                u32_t hash = cache_hash(dev, blkpos);
 
-                if ((*cache)->next) {
-                        (*cache)->next->prev = *cache;
-                }
+                (*cache)->dev   = dev;
+                (*cache)->pos   = blkpos;
+                (*cache)->size  = blksz;
+                (*cache)->hnext = cman.hash[hash];
+                cman.hash[hash] = *cache;
 
-                cman.list_head = *cache;
+                list_push_front(&cman.clean, *cache);
 
-                printk("CACHE: created (%d B)", blksz);
+                printk_log(_PRINTK_LEVEL_DEBUG, _PRINTK_SUBSYS_MM, "CACHE: created (%d B)", blksz);
         }
 
         return err;
@@ -140,25 +375,20 @@ static int cache_free(cache_t *cache)
         int err = EINVAL;
 
         if (cache) {
-                printk("CACHE: freed (%d B)", cache->size);
-
-                if (cache == cman.list_head) {
-                        cman.list_head = cache->next;
+                printk_log(_PRINTK_LEVEL_DEBUG, _PRINTK_SUBSYS_MM, "CACHE: freed (%d B)", cache->size);
 
-                        if (cman.list_head) {
-                                cman.list_head->prev = NULL;
+                cache_t **c = &cman.hash[cache_hash(cache->dev, cache->pos)];
+                while (*c) {
+                        if (*c == cache) {
+                                *c = cache->hnext;
+                                break;
                         }
 
-                } else {
-                        if (cache->next) {
-                                cache->next->prev = cache->prev;
-                        }
-
-                        if (cache->prev) {
-                                cache->prev->next = cache->next;
-                        }
+                        c = &(*c)->hnext;
                 }
 
+                list_unlink(cache_list(cache), cache);
+
                 memset(cache, 0, sizeof(cache_t));
 
                 err = _kfree(_MM_CACHE, cast(void*, &cache));
@@ -187,18 +417,117 @@ static int cache_find(dev_t dev, u32_t blkpos, cache_t **cache)
 {
         int err = ENOENT;
 
-        cache_t *c = cman.list_head;
-        while (c) {
-                cache_t *next = c->next;
-
+        for (cache_t *c = cman.hash[cache_hash(dev, blkpos)]; c; c = c->hnext) {
                 if ((c->dev == dev) && (c->pos == blkpos)) {
-
                         *cache = c;
                         err    = ESUCC;
                         break;
                 }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function sort chain of caches by device and block position
+ *        (merge sort). Chain is linked by next pointer.
+ *
+ * @param  chain        chain to sort
+ *
+ * @return Sorted chain.
+ */
+//==============================================================================
+static cache_t *cache_sort(cache_t *chain)
+{
+        if (!chain || !chain->next) {
+                return chain;
+        }
+
+        // split chain to halves
+        cache_t *slow = chain;
+        cache_t *fast = chain->next;
+        while (fast && fast->next) {
+                slow = slow->next;
+                fast = fast->next->next;
+        }
+
+        cache_t *half = slow->next;
+        slow->next = NULL;
+
+        cache_t *a = cache_sort(chain);
+        cache_t *b = cache_sort(half);
+
+        // merge halves
+        cache_t  *head = NULL;
+        cache_t **tail = &head;
+
+        while (a && b) {
+                if (  (a->dev < b->dev)
+                   || (a->dev == b->dev && a->pos <= b->pos) ) {
+                        *tail = a;
+                        a = a->next;
+                } else {
+                        *tail = b;
+                        b = b->next;
+                }
+
+                tail = &(*tail)->next;
+        }
+
+        *tail = a ? a : b;
+
+        return head;
+}
+
+//==============================================================================
+/**
+ * @brief Function write run of consecutive caches to device. If possible all
+ *        blocks are written by using single request.
+ *
+ * @param  first        first cache of run (next caches linked by next pointer)
+ * @param  count        number of caches in run
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int cache_write_run(cache_t *first, size_t count)
+{
+        int   err = ENOMEM;
+        u8_t *buf = NULL;
+
+        if (count > 1) {
+                // cache memory type does not call cache reduction (locked mutex)
+                err = _kmalloc(_MM_CACHE, count * first->size, cast(void*, &buf));
+        }
+
+        if (!err) {
+                cache_t *cache = first;
+                for (size_t i = 0; i < count; i++, cache = cache->next) {
+                        memcpy(buf + (i * first->size), &cache_buf(cache), first->size);
+                }
+
+                err = device_write(first->dev, first->pos, first->size, count, buf);
+
+                _kfree(_MM_CACHE, cast(void*, &buf));
+
+        } else {
+                // lack of memory: each block is written separately
+                err = ESUCC;
+
+                cache_t *cache = first;
+                for (size_t i = 0; !err && i < count; i++, cache = cache->next) {
+                        err = device_write(cache->dev, cache->pos, cache->size, 1,
+                                           cast(const u8_t*, &cache_buf(cache)));
+                }
+        }
 
-                c = next;
+        if (err) {
+                printk_log(_PRINTK_LEVEL_ERROR, _PRINTK_SUBSYS_MM,
+                           "CACHE: sync error %d [%d:%d:%d]", err,
+                           _dev_t__extract_modno(first->dev),
+                           _dev_t__extract_major(first->dev),
+                           _dev_t__extract_minor(first->dev));
         }
 
         return err;
@@ -206,39 +535,218 @@ static int cache_find(dev_t dev, u32_t blkpos, cache_t **cache)
 
 //==============================================================================
 /**
- * @brief Function analyze caches and find the lowest temperature of cache and
- *        calculate how many this caches is. Function calculate count of dirty
- *        caches and total number of caches.
- *
- * @param  tmin         minimal temperature
- * @param  tmincnt      number of caches of minimal temperature
- * @param  dirty        number of dirty caches
- * @param  count        number of all caches
+ * @brief Function synchronize chain of caches detached from dirty list. Caches
+ *        are sorted by position and consecutive blocks are written by using
+ *        single request. Caches are moved to the clean list if synchronization
+ *        success or back to the dirty list on error.
+ *
+ * @param  chain        chain of caches (linked by next pointer)
+ * @param  count        number of synchronized blocks (can be NULL)
+ *
+ * @return One of errno value.
  */
 //==============================================================================
-static void get_cache_stats(i32_t *tmin, size_t *tmincnt, size_t *dirty, size_t *count)
+static int cache_flush_chain(cache_t *chain, u16_t *count)
 {
-        *tmin    = INT32_MAX;
-        *tmincnt = 0;
-        *dirty   = 0;
-        *count   = 0;
+        int err = ESUCC;
+
+        chain = cache_sort(chain);
+
+        while (chain) {
+                size_t   run  = 1;
+                cache_t *last = chain;
+
+                while (  last->next
+                      && run < SYNC_MAX_BLOCKS
+                      && last->next->dev  == chain->dev
+                      && last->next->size == chain->size
+                      && last->next->pos  == last->pos + 1) {
+
+                        last = last->next;
+                        run++;
+                }
+
+                cache_t *rest = last->next;
+
+                int e = cache_write_run(chain, run);
+                if (e && !err) {
+                        err = e;
+                }
+
+                // move caches to the list according to synchronization result
+                cache_t *cache = chain;
+                for (size_t i = 0; i < run; i++) {
+                        cache_t *next = cache->next;
+                        cache->dirty  = (e != ESUCC);
+                        list_push_front(cache_list(cache), cache);
+                        cache = next;
+                }
+
+                if (count && !e) {
+                        *count += run;
+                }
+
+                chain = rest;
+        }
+
+        // writeback thread retries synchronization of not written caches; the
+        // thread itself retries after period, so it is not woken up here
+        if (err && cman.wb_sem && _task_get_handle() != cman.wb_task) {
+                _semaphore_signal(cman.wb_sem);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function synchronize dirty caches of selected device or all devices.
+ *
+ * @param  all          synchronize caches of all devices
+ * @param  dev          device to synchronize (if all is false)
+ * @param  count        number of synchronized blocks (can be NULL)
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int cache_flush_dirty(bool all, dev_t dev, u16_t *count)
+{
+        cache_t *chain = NULL;
+        cache_t *cache = cman.dirty.head;
 
-        cache_t *cache = cman.list_head;
         while (cache) {
-                if (!cache->dirty) {
-                        if (cache->temp < *tmin) {
-                                *tmin    = cache->temp;
-                                *tmincnt = 1;
+                cache_t *next = cache->next;
 
-                        } else if (cache->temp == *tmin) {
-                                *tmincnt += 1;
+                if (all || cache->dev == dev) {
+                        list_unlink(&cman.dirty, cache);
+                        cache->next = chain;
+                        chain       = cache;
+                }
+
+                cache = next;
+        }
+
+        return cache_flush_chain(chain, count);
+}
+
+//==============================================================================
+/**
+ * @brief Function synchronize small batch of the oldest dirty caches. If force
+ *        flag is not set then only expired caches are synchronized.
+ *
+ * @param  force        synchronize caches that are not expired
+ * @param  count        number of synchronized blocks
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int cache_writeback_batch(bool force, u16_t *count)
+{
+        cache_t *chain = NULL;
+        u32_t    now   = _kernel_get_time_ms();
+
+        for (int i = 0; i < WRITEBACK_BATCH_BLOCKS && cman.dirty.tail; i++) {
+                cache_t *cache = cman.dirty.tail;
+
+                if (!force && (now - cache->dirty_time) < DIRTY_EXPIRE_MS) {
+                        break;
+                }
+
+                list_unlink(&cman.dirty, cache);
+                cache->next = chain;
+                chain       = cache;
+        }
+
+        return cache_flush_chain(chain, count);
+}
+
+//==============================================================================
+/**
+ * @brief Function calculate time to expiration of the oldest dirty cache.
+ *        Writeback thread sleeps until this time, thus there are no periodic
+ *        wake ups when all caches are clean.
+ *
+ * @return Writeback thread timeout [ms].
+ */
+//==============================================================================
+static u32_t cache_writeback_timeout(void)
+{
+        if (cman.dirty.tail == NULL) {
+                return MAX_DELAY_MS;
+        }
+
+        u32_t age = _kernel_get_time_ms() - cman.dirty.tail->dirty_time;
+
+        return (age < DIRTY_EXPIRE_MS) ? (DIRTY_EXPIRE_MS - age) : WRITEBACK_PERIOD_MS;
+}
+
+//==============================================================================
+/**
+ * @brief Function throttle writer if amount of dirty data exceed hard limit.
+ *        Writer waits until writeback thread synchronize caches. Writeback
+ *        thread is never throttled.
+ */
+//==============================================================================
+static void cache_throttle(void)
+{
+        if (cman.dirty.bytes > DIRTY_BACKGROUND) {
+                _semaphore_signal(cman.wb_sem);
+        }
+
+        if (cman.wb_task && _task_get_handle() != cman.wb_task) {
+                for (u32_t t = 0; (cman.dirty.bytes > DIRTY_LIMIT) && (t < THROTTLE_MAX_MS);
+                     t += THROTTLE_PERIOD_MS) {
+
+                        _semaphore_signal(cman.wb_sem);
+                        _sleep_ms(THROTTLE_PERIOD_MS);
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function read blocks in advance. Function is used when sequential
+ *        read is detected. Blocks are read by using single request.
+ *
+ * @param  cdev         device
+ * @param  blkpos       first block to read
+ * @param  blksz        block size
+ */
+//==============================================================================
+static void cache_read_ahead(cache_dev_t *cdev, u32_t blkpos, size_t blksz)
+{
+        cache_t *cache = NULL;
+        size_t   count = 0;
+
+        while (  count < READ_AHEAD_BLOCKS
+              && cache_find(cdev->stat.dev, blkpos + count, &cache) != ESUCC) {
+                count++;
+        }
+
+        // read ahead cannot take memory needed by system
+        size_t need = __OS_SYSTEM_CACHE_MIN_FREE__ + (count * (2 * blksz + sizeof(cache_t)));
+
+        if (count == 0 || _mm_get_mem_free() < need) {
+                return;
+        }
+
+        u8_t *buf = NULL;
+        if (_kmalloc(_MM_CACHE, count * blksz, cast(void*, &buf)) == ESUCC) {
+
+                if (device_read(cdev->stat.dev, blkpos, blksz, count, buf) == ESUCC) {
+
+                        for (size_t i = 0; i < count; i++) {
+                                if (cache_alloc(cdev->stat.dev, blkpos + i, blksz, &cache) == ESUCC) {
+                                        memcpy(&cache_buf(cache), buf + (i * blksz), blksz);
+                                        cache->readahead = true;
+                                        cdev->stat.readahead++;
+                                } else {
+                                        break;
+                                }
                         }
-                } else {
-                        *dirty += 1;
                 }
 
-                *count += 1;
-                cache   = cache->next;
+                _kfree(_MM_CACHE, cast(void*, &buf));
         }
 }
 
@@ -247,7 +755,8 @@ static void get_cache_stats(i32_t *tmin, size_t *tmincnt, size_t *dirty, size_t
  * @brief Function write block to selected device. If cache exist then block is
  *        write to the cache. If cache does not exist then new one is created.
  *        When CACHE_WRITE_THROUGH is used then data is write both to the cache
- *        and device.
+ *        and device. Blocks that cannot be cached are written by using single
+ *        request.
  *
  * @param  dev          block device
  * @param  blkpos       block position
@@ -261,57 +770,49 @@ static void get_cache_stats(i32_t *tmin, size_t *tmincnt, size_t *dirty, size_t
 //==============================================================================
 static int _cache_write(dev_t dev, u32_t blkpos, size_t blksz, size_t blkcnt, const u8_t *buf, enum cache_mode mode)
 {
-        int err = ESUCC;
+        int err = _mutex_lock(cman.list_mtx, MTX_TIMEOUT);
+        if (!err) {
+                cache_dev_get(dev, true);
 
-        if (mode == CACHE_WRITE_THROUGH) {
-                fpos_t fpos  = cast(fpos_t, blkpos) * blksz;
-                size_t wrcnt = 0;
-                size_t wrsz  = blksz * blkcnt;
-                struct vfs_fattr fattr = {false, false};
+                if (mode == CACHE_WRITE_THROUGH) {
+                        err = device_write(dev, blkpos, blksz, blkcnt, buf);
+                }
 
-                err = _driver_write(dev, buf, wrsz, &fpos, &wrcnt, fattr);
+                size_t blk = 0;
 
-                if (!err && (wrcnt != wrsz) ) {
-                        err = EIO;
-                }
-        }
+                while (!err && blk < blkcnt) {
+                        cache_t *cache = NULL;
 
-        while (!err && blkcnt--) {
-                cache_t *cache = NULL;
+                        if (  cache_find(dev, blkpos + blk, &cache) == ESUCC
+                           || cache_alloc(dev, blkpos + blk, blksz, &cache) == ESUCC) {
 
-                err = _mutex_lock(cman.list_mtx, MTX_TIMEOUT);
-                if (!err) {
+                                memcpy(&cache_buf(cache), buf + (blk * blksz), blksz);
+                                cache->readahead = false;
+                                cache_touch(cache, mode != CACHE_WRITE_THROUGH);
+                                blk++;
 
-                        if (cache_find(dev, blkpos, &cache) != ESUCC) {
+                        } else if (mode == CACHE_WRITE_THROUGH) {
+                                blk++;
 
-                                if (cache_alloc(dev, blkpos, blksz, &cache) != ESUCC) {
-                                        cache = NULL;
+                        } else {
+                                // merge blocks that cannot be cached to single request
+                                size_t run = 1;
+                                while (  (blk + run) < blkcnt
+                                      && cache_find(dev, blkpos + blk + run, &cache) != ESUCC) {
+                                        run++;
                                 }
-                        }
 
-                        if (cache) {
-                                memcpy(&cache_buf(cache), buf, blksz);
-                                cache->dirty = true;
-                                cache->temp++;
+                                err  = device_write(dev, blkpos + blk, blksz, run,
+                                                    buf + (blk * blksz));
+                                blk += run;
                         }
-
-                        _mutex_unlock(cman.list_mtx);
                 }
 
-                if (!err && !cache && mode != CACHE_WRITE_THROUGH) {
-                        fpos_t fpos  = cast(fpos_t, blkpos) * blksz;
-                        size_t wrcnt = 0;
-                        struct vfs_fattr fattr = {false, false};
-
-                        err = _driver_write(dev, buf, blksz, &fpos, &wrcnt, fattr);
+                _mutex_unlock(cman.list_mtx);
 
-                        if (!err && wrcnt != blksz) {
-                                err = EIO;
-                        }
+                if (mode == CACHE_WRITE_BACK) {
+                        cache_throttle();
                 }
-
-                blkpos++;
-                buf += blksz;
         }
 
         return err;
@@ -321,7 +822,8 @@ static int _cache_write(dev_t dev, u32_t blkpos, size_t blksz, size_t blkcnt, co
 /**
  * @brief Function read block from selected device. If cache exist then cache
  *        data is used. If cache does not exist then file is read and new cache
- *        is created.
+ *        is created. Consecutive missed blocks are read by using single request.
+ *        If sequential read is detected then next blocks are read in advance.
  *
  * @param  dev          block dev
  * @param  blkpos       block position
@@ -334,41 +836,63 @@ static int _cache_write(dev_t dev, u32_t blkpos, size_t blksz, size_t blkcnt, co
 //==============================================================================
 static int _cache_read(dev_t dev, u32_t blkpos, size_t blksz, size_t blkcnt, u8_t *buf)
 {
-        int err = ESUCC;
+        int err = _mutex_lock(cman.list_mtx, MTX_TIMEOUT);
+        if (!err) {
+                cache_dev_t *cdev = cache_dev_get(dev, true);
 
-        while (!err && blkcnt--) {
-                cache_t *cache = NULL;
+                size_t blk = 0;
 
-                err = _mutex_lock(cman.list_mtx, MTX_TIMEOUT);
-                if (!err) {
+                while (!err && blk < blkcnt) {
+                        cache_t *cache = NULL;
 
-                        if (cache_find(dev, blkpos, &cache) == ESUCC) {
-                                memcpy(buf, &cache_buf(cache), blksz);
-                                cache->temp++;
+                        if (cache_find(dev, blkpos + blk, &cache) == ESUCC) {
+                                memcpy(buf + (blk * blksz), &cache_buf(cache), blksz);
+                                cache_touch(cache, cache->dirty);
 
-                        } else {
-                                fpos_t fpos  = cast(fpos_t, blkpos) * blksz;
-                                size_t rdcnt = 0;
-                                struct vfs_fattr fattr = {false, false};
+                                if (cdev) {
+                                        cdev->stat.hits++;
+                                        cdev->stat.readahead_hits += cache->readahead ? 1 : 0;
+                                }
 
-                                err = _driver_read(dev, buf, blksz, &fpos, &rdcnt, fattr);
+                                cache->readahead = false;
+                                blk++;
 
-                                if (!err && rdcnt != blksz) {
-                                        err = EIO;
+                        } else {
+                                // merge consecutive missed blocks to single request
+                                size_t run = 1;
+                                while (  (blk + run) < blkcnt
+                                      && cache_find(dev, blkpos + blk + run, &cache) != ESUCC) {
+                                        run++;
                                 }
 
-                                if (!err) {
-                                        if (cache_alloc(dev, blkpos, blksz, &cache) == ESUCC) {
-                                                memcpy(&cache_buf(cache), buf, blksz);
+                                err = device_read(dev, blkpos + blk, blksz, run,
+                                                  buf + (blk * blksz));
+
+                                for (size_t i = 0; !err && i < run; i++) {
+                                        if (cache_alloc(dev, blkpos + blk + i, blksz, &cache) == ESUCC) {
+                                                memcpy(&cache_buf(cache), buf + ((blk + i) * blksz), blksz);
+                                        } else {
+                                                break;
                                         }
                                 }
+
+                                if (cdev) {
+                                        cdev->stat.misses += run;
+                                }
+
+                                blk += run;
                         }
+                }
 
-                        _mutex_unlock(cman.list_mtx);
+                if (!err && cdev) {
+                        if ((READ_AHEAD_BLOCKS > 0) && (cdev->next_pos == blkpos)) {
+                                cache_read_ahead(cdev, blkpos + blkcnt, blksz);
+                        }
+
+                        cdev->next_pos = blkpos + blkcnt;
                 }
 
-                blkpos++;
-                buf += blksz;
+                _mutex_unlock(cman.list_mtx);
         }
 
         return err;
@@ -385,7 +909,12 @@ static int _cache_read(dev_t dev, u32_t blkpos, size_t blksz, size_t blkcnt, u8_
 int _cache_init(void)
 {
 #if __OS_SYSTEM_FS_CACHE_ENABLE__ > 0
-        return _mutex_create(MUTEX_TYPE_NORMAL, &cman.list_mtx);
+        int err = _mutex_create(MUTEX_TYPE_NORMAL, &cman.list_mtx);
+        if (!err) {
+                err = _semaphore_create(1, 0, &cman.wb_sem);
+        }
+
+        return err;
 #else
         return ESUCC;
 #endif
@@ -404,43 +933,14 @@ void _cache_sync(void)
         if (!err) {
                 u16_t sync_cnt = 0;
 
-                cache_t *cache = cman.list_head;
-
-                while (cache) {
-                        cache_t *next = cache->next;
-
-                        if (cache->dirty) {
-
-                                fpos_t fpos  = cast(fpos_t, cache->pos) * cache->size;
-                                size_t wrcnt = 0;
-                                struct vfs_fattr fattr = {false, false};
-
-                                int e = _driver_write(cache->dev,
-                                                      cast(const u8_t*, &cache_buf(cache)),
-                                                      cache->size, &fpos, &wrcnt, fattr);
-                                if (e) {
-                                        printk("CACHE: sync error %d [%d:%d:%d]", e,
-                                               _dev_t__extract_modno(cache->dev),
-                                               _dev_t__extract_major(cache->dev),
-                                               _dev_t__extract_minor(cache->dev));
-                                } else {
-                                        cache->dirty = false;
-                                }
-
-                                sync_cnt++;
-                        }
-
-                        cache->temp--;
-
-                        cache = next;
-                }
+                cache_flush_dirty(true, 0, &sync_cnt);
 
                 cman.sync_needed = false;
 
                 _mutex_unlock(cman.list_mtx);
 
                 if (sync_cnt) {
-                        printk("CACHE: synchronized %d blocks", sync_cnt);
+                        printk_log(_PRINTK_LEVEL_DEBUG, _PRINTK_SUBSYS_MM, "CACHE: synchronized %d blocks", sync_cnt);
                 }
         }
 #endif
@@ -458,22 +958,14 @@ void _cache_drop(void)
         if (!err) {
                 u16_t dropped = 0;
 
-                cache_t *cache = cman.list_head;
-
-                while (cache) {
-                        cache_t *next = cache->next;
-
-                        if (!cache->dirty) {
-                                cache_free(cache);
-                                dropped++;
-                        }
-
-                        cache = next;
+                while (cman.clean.head) {
+                        cache_free(cman.clean.head);
+                        dropped++;
                 }
 
                 _mutex_unlock(cman.list_mtx);
 
-                printk("CACHE: dropped %d blocks", dropped);
+                printk_log(_PRINTK_LEVEL_DEBUG, _PRINTK_SUBSYS_MM, "CACHE: dropped %d blocks", dropped);
         }
 #endif
 }
@@ -493,45 +985,19 @@ void _cache_reduce(size_t size)
         int err = _mutex_lock(cman.list_mtx, MTX_TIMEOUT);
         if (!err) {
 
-                if (cman.list_head && to_reduce > 0) {
-
-                        // Algorithm find caches that have the lowest
-                        // temperature that means there are used very rare.
-                        i32_t  tmin;
-                        size_t tmincnt, dirty, count;
-                        get_cache_stats(&tmin, &tmincnt, &dirty, &count);
-
-                        while (to_reduce > 0 && dirty < count) {
-
-                                cache_t *cache = cman.list_head;
-                                while (cache && tmincnt > 0) {
-                                        cache_t *next = cache->next;
-
-                                        if (!cache->dirty && cache->temp == tmin) {
-                                                to_reduce -= cache->size + sizeof(cache_t);
-                                                cache_free(cache);
-                                                tmincnt--;
-
-                                                if (to_reduce <= 0) {
-                                                        break;
-                                                }
-                                        }
-
-                                        cache = next;
-                                }
-
-                                if (to_reduce > 0) {
-                                        get_cache_stats(&tmin, &tmincnt, &dirty, &count);
-                                }
-                        }
+                // the least recently used clean caches are released first
+                while (to_reduce > 0 && cman.clean.tail) {
+                        to_reduce -= cman.clean.tail->size + sizeof(cache_t);
+                        cache_free(cman.clean.tail);
+                }
 
-                        // There is still not enough space so system try to
-                        // synchronize all caches.
-                        cman.sync_needed = (to_reduce > 0 && dirty > 0);
+                // There is still not enough space so system try to
+                // synchronize all caches.
+                cman.sync_needed = (to_reduce > 0 && cman.dirty.count > 0);
 
-                        if (cman.sync_needed) {
-                                printk("CACHE: sync needed", to_reduce);
-                        }
+                if (cman.sync_needed) {
+                        printk_log(_PRINTK_LEVEL_DEBUG, _PRINTK_SUBSYS_MM, "CACHE: sync needed");
+                        _semaphore_signal(cman.wb_sem);
                 }
 
                 _mutex_unlock(cman.list_mtx);
@@ -557,6 +1023,103 @@ bool _cache_is_sync_needed(void)
 #endif
 }
 
+//==============================================================================
+/**
+ * @brief Writeback thread. Thread synchronize dirty caches in small batches
+ *        when dirty data exceed background threshold, when dirty blocks
+ *        expire, or when there is lack of memory. Function must be started as
+ *        system thread that is prepared for file system handling.
+ *
+ * @param  arg          not used
+ */
+//==============================================================================
+void _cache_writeback_thread(void *arg)
+{
+        UNUSED_ARG1(arg);
+
+#if __OS_SYSTEM_FS_CACHE_ENABLE__ > 0
+        cman.wb_task = _task_get_handle();
+
+        u32_t timeout = WRITEBACK_PERIOD_MS;
+
+        for (;;) {
+                _semaphore_wait(cman.wb_sem, timeout);
+
+                // file systems buffers are moved to the cache to release memory
+                if (cman.sync_needed) {
+                        _vfs_sync();
+                }
+
+                bool more;
+
+                do {
+                        more = false;
+
+                        if (_mutex_lock(cman.list_mtx, MTX_TIMEOUT) == ESUCC) {
+                                u16_t cnt   = 0;
+                                bool  force = cman.sync_needed
+                                           || (cman.dirty.bytes > DIRTY_BACKGROUND);
+
+                                int err = cache_writeback_batch(force, &cnt);
+
+                                if (err || cman.dirty.count == 0) {
+                                        cman.sync_needed = false;
+                                }
+
+                                more = !err && (cnt == WRITEBACK_BATCH_BLOCKS);
+
+                                timeout = err ? WRITEBACK_PERIOD_MS
+                                              : cache_writeback_timeout();
+
+                                _mutex_unlock(cman.list_mtx);
+
+                                if (cnt) {
+                                        printk_log(_PRINTK_LEVEL_DEBUG, _PRINTK_SUBSYS_MM, "CACHE: written back %d blocks", cnt);
+                                }
+                        }
+                } while (more);
+        }
+#endif
+}
+
+//==============================================================================
+/**
+ * @brief Function return statistics of cached device.
+ *
+ * @param  seek         device seek (start from 0)
+ * @param  stat         statistics container
+ *
+ * @return One of errno value (ESUCC, EINVAL, ENOENT).
+ */
+//==============================================================================
+int _cache_get_dev_stat(size_t seek, _cache_dev_stat_t *stat)
+{
+        int err = EINVAL;
+
+        if (stat) {
+                err = ENOENT;
+
+#if __OS_SYSTEM_FS_CACHE_ENABLE__ > 0
+                if (_mutex_lock(cman.list_mtx, MTX_TIMEOUT) == ESUCC) {
+
+                        for (cache_dev_t *cdev = cman.dev_list; cdev; cdev = cdev->next) {
+                                if (seek-- == 0) {
+                                        *stat = cdev->stat;
+                                        err   = ESUCC;
+                                        break;
+                                }
+                        }
+
+                        _mutex_unlock(cman.list_mtx);
+                }
+#else
+                UNUSED_ARG1(seek);
+#endif
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief  Function drop cache of selected device (sync on dirty pages).
@@ -587,38 +1150,32 @@ int sys_cache_drop(FILE *file)
 
         err = _mutex_lock(cman.list_mtx, MTX_TIMEOUT);
         if (!err) {
-                cache_t *cache = cman.list_head;
+                err = cache_flush_dirty(false, stat.st_dev, NULL);
+
+                cache_t *cache = cman.clean.head;
 
                 while (!err && cache) {
                         cache_t *next = cache->next;
 
                         if (cache->dev == stat.st_dev) {
+                                cache_free(cache);
+                        }
 
-                                if (cache->dirty) {
-
-                                        fpos_t fpos  = cast(fpos_t, cache->pos) * cache->size;
-                                        size_t wrcnt = 0;
-                                        struct vfs_fattr fattr = {false, false};
+                        cache = next;
+                }
 
-                                        err = _driver_write(cache->dev,
-                                                            cast(const u8_t*, &cache_buf(cache)),
-                                                            cache->size, &fpos, &wrcnt, fattr);
-                                        if (err) {
-                                                printk("CACHE: sync error %d [%d:%d:%d]", err,
-                                                       _dev_t__extract_modno(cache->dev),
-                                                       _dev_t__extract_major(cache->dev),
-                                                       _dev_t__extract_minor(cache->dev));
-                                        } else {
-                                                cache->dirty = false;
-                                        }
+                if (!err) {
+                        cache_dev_t **cdev = &cman.dev_list;
+                        while (*cdev) {
+                                if ((*cdev)->stat.dev == stat.st_dev) {
+                                        cache_dev_t *to_free = *cdev;
+                                        *cdev = to_free->next;
+                                        _kfree(_MM_CACHE, cast(void*, &to_free));
+                                        break;
                                 }
 
-                                if (!err) {
-                                        cache_free(cache);
-                                }
+                                cdev = &(*cdev)->next;
                         }
-
-                        cache = next;
                 }
 
                 _mutex_unlock(cman.list_mtx);
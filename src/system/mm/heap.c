@@ -67,6 +67,7 @@
 #include "kernel/errno.h"
 #include <string.h>
 
+#if __HEAP_ALLOCATOR__ == _HEAP_ALLOCATOR_FIRST_FIT
 /*==============================================================================
   Local symbolic constants/macros
 ==============================================================================*/
@@ -171,8 +172,9 @@ int _heap_init(_heap_t *heap, void *start, size_t size)
         int err = EINVAL;
 
         if (heap && start && size) {
-                heap->used     = 0;
-                heap->used_max = 0;
+                heap->used       = 0;
+                heap->used_max   = 0;
+                heap->search_max = 0;
 
                 /* align the heap */
                 heap->begin = start;
@@ -257,6 +259,7 @@ void *_heap_alloc(_heap_t *heap, size_t size, size_t *allocated)
         size_t ptr, ptr2;
         struct mem *mem, *mem2;
         size_t used;
+        u32_t search = 0;
 
         if (!heap || size == 0) {
                 return NULL;
@@ -286,6 +289,7 @@ void *_heap_alloc(_heap_t *heap, size_t size, size_t *allocated)
              ptr = ((struct mem *)(void *)&heap->begin[ptr])->next) {
 
                 mem = (struct mem *)(void *)&heap->begin[ptr];
+                search++;
 
                 if ((!mem->used) && (mem->next - (ptr + SIZEOF_STRUCT_MEM)) >= size) {
                         /*
@@ -346,8 +350,9 @@ void *_heap_alloc(_heap_t *heap, size_t size, size_t *allocated)
                                 }
                         }
 
-                        heap->used    += used;
-                        heap->used_max = heap->used_max < heap->used ? heap->used : heap->used_max;
+                        heap->used      += used;
+                        heap->used_max   = heap->used_max < heap->used ? heap->used : heap->used_max;
+                        heap->search_max = heap->search_max < search ? search : heap->search_max;
 
                         if (allocated) {
                                 *allocated = used;
@@ -359,6 +364,8 @@ void *_heap_alloc(_heap_t *heap, size_t size, size_t *allocated)
                 }
         }
 
+        heap->search_max = heap->search_max < search ? search : heap->search_max;
+
         _kernel_scheduler_unlock();
 
         return NULL;
@@ -435,6 +442,51 @@ size_t _heap_get_block_size(_heap_t *heap, void *rmem)
     return blksize;
 }
 
+//==============================================================================
+/**
+ * @brief  Function return heap statistics. Function walks through all free
+ *         blocks, so it should not be used in time critical code.
+ *
+ * @param  heap         heap object
+ * @param  stat         statistics container
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _heap_get_stat(_heap_t *heap, _heap_stat_t *stat)
+{
+        if (!heap || !stat) {
+                return EINVAL;
+        }
+
+        memset(stat, 0, sizeof(_heap_stat_t));
+
+        _kernel_scheduler_lock();
+        {
+                for (struct mem *mem = heap->lfree; mem != heap->end;
+                     mem = (struct mem *)(void *)&heap->begin[mem->next]) {
+
+                        if (!mem->used) {
+                                size_t blksize = mem->next - (size_t)((u8_t *)mem - heap->begin)
+                                               - SIZEOF_STRUCT_MEM;
+
+                                stat->free_blocks++;
+                                stat->largest_free = stat->largest_free < blksize
+                                                   ? blksize : stat->largest_free;
+                        }
+                }
+
+                stat->size       = _heap_get_size(heap);
+                stat->used       = heap->used;
+                stat->used_max   = heap->used_max;
+                stat->search_max = heap->search_max;
+        }
+        _kernel_scheduler_unlock();
+
+        return ESUCC;
+}
+#endif
+
 /*==============================================================================
   End of file
 ==============================================================================*/
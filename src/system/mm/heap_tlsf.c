@@ -0,0 +1,591 @@
+/*=========================================================================*//**
+@file    heap_tlsf.c
+
+@author  Daniel Zorychta
+
+@brief   Two-level segregated fit (TLSF) dynamic memory allocator.
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "config.h"
+#include "mm/heap.h"
+#include "kernel/kwrapper.h"
+#include "kernel/errno.h"
+#include <string.h>
+
+#if __HEAP_ALLOCATOR__ == _HEAP_ALLOCATOR_TLSF
+/*==============================================================================
+  Local symbolic constants/macros
+==============================================================================*/
+/** calculate aligned size of memory block */
+#define MEM_ALIGN_SIZE(size)            (((size) + _HEAP_ALIGN_ - 1) & ~(_HEAP_ALIGN_-1))
+
+/** number of second level lists (log2) */
+#define SL_INDEX_COUNT_LOG2             2
+#define SL_INDEX_COUNT                  (1 << SL_INDEX_COUNT_LOG2)
+
+/** blocks smaller than this value are stored in the first level list 0 */
+#define ALIGN_SIZE_LOG2                 ((_HEAP_ALIGN_ == 4) ? 2 : (_HEAP_ALIGN_ == 8) ? 3 : 4)
+#define FL_INDEX_SHIFT                  (SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2)
+#define SMALL_BLOCK_SIZE                (1 << FL_INDEX_SHIFT)
+#define FL_INDEX_COUNT_MAX              (32 - FL_INDEX_SHIFT + 1)
+
+/** block flags stored in the size field */
+#define BLOCK_FREE                      (1 << 0)
+#define BLOCK_FLAGS                     (_HEAP_ALIGN_ - 1)
+
+/** size of header of used block */
+#define BLOCK_HDR_SIZE                  MEM_ALIGN_SIZE(offsetof(struct mem, next_free))
+
+/** every block must be able to store free list links */
+#define BLOCK_MIN_SIZE                  MEM_ALIGN_SIZE(__HEAP_BLOCK_SIZE__ > (sizeof(struct mem) - BLOCK_HDR_SIZE) \
+                                                       ? __HEAP_BLOCK_SIZE__ : (sizeof(struct mem) - BLOCK_HDR_SIZE))
+
+#define block_size(b)                   ((b)->size & ~BLOCK_FLAGS)
+#define block_is_free(b)                ((b)->size & BLOCK_FREE)
+#define block_next(b)                   ((struct mem *)(void *)((u8_t *)(b) + BLOCK_HDR_SIZE + block_size(b)))
+#define block_data(b)                   ((void *)((u8_t *)(b) + BLOCK_HDR_SIZE))
+#define block_from_data(p)              ((struct mem *)(void *)((u8_t *)(p) - BLOCK_HDR_SIZE))
+
+#if (_HEAP_ALIGN_ != 4) && (_HEAP_ALIGN_ != 8) && (_HEAP_ALIGN_ != 16)
+#error "TLSF allocator supports heap alignment of 4, 8, or 16 bytes!"
+#endif
+
+/*==============================================================================
+  Local types, enums definitions
+==============================================================================*/
+/**
+ * Block header. Free list links are stored in the data part of free blocks,
+ * thus used blocks have only previous block pointer and size.
+ */
+struct mem {
+        struct mem *prev_phys;  /**< previous physical block                   */
+        size_t      size;       /**< size of data part and flags               */
+        struct mem *next_free;  /**< next free block (free blocks only)        */
+        struct mem *prev_free;  /**< previous free block (free blocks only)    */
+};
+
+/**
+ * Control structure placed at the beginning of the heap. Number of first
+ * level lists depends on heap size.
+ */
+struct heap_ctrl {
+        u32_t       fl_bitmap;                          /**< first level bitmap  */
+        u8_t        fl_count;                           /**< first level lists   */
+        u8_t        sl_bitmap[FL_INDEX_COUNT_MAX];      /**< second level bitmap */
+        struct mem *blocks[][SL_INDEX_COUNT];           /**< free lists          */
+};
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local object definitions
+==============================================================================*/
+
+/*==============================================================================
+  Exported object definitions
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Find last set bit.
+ *
+ * @param  x            value (must not be 0)
+ *
+ * @return Index of the most significant set bit.
+ */
+//==============================================================================
+static inline int fls(u32_t x)
+{
+        return 31 - __builtin_clz(x);
+}
+
+//==============================================================================
+/**
+ * @brief  Find first set bit.
+ *
+ * @param  x            value (must not be 0)
+ *
+ * @return Index of the least significant set bit.
+ */
+//==============================================================================
+static inline int ffs_bit(u32_t x)
+{
+        return __builtin_ctz(x);
+}
+
+//==============================================================================
+/**
+ * @brief  Calculate list indexes of block of selected size.
+ *
+ * @param  size         block size
+ * @param  fl           first level index
+ * @param  sl           second level index
+ */
+//==============================================================================
+static void mapping_insert(size_t size, int *fl, int *sl)
+{
+        if (size < SMALL_BLOCK_SIZE) {
+                *fl = 0;
+                *sl = size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT);
+        } else {
+                int t = fls(size);
+                *sl = (size >> (t - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+                *fl = t - (FL_INDEX_SHIFT - 1);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Calculate list indexes of the smallest list that contains blocks
+ *         big enough for selected size (size is rounded up to the next list).
+ *
+ * @param  size         requested size
+ * @param  fl           first level index
+ * @param  sl           second level index
+ */
+//==============================================================================
+static void mapping_search(size_t size, int *fl, int *sl)
+{
+        if (size >= SMALL_BLOCK_SIZE) {
+                size += (1 << (fls(size) - SL_INDEX_COUNT_LOG2)) - 1;
+        }
+
+        mapping_insert(size, fl, sl);
+}
+
+//==============================================================================
+/**
+ * @brief  Find free block that is not smaller than list of selected indexes.
+ *
+ * @param  ctrl         control structure
+ * @param  fl           first level index (updated to found list)
+ * @param  sl           second level index (updated to found list)
+ *
+ * @return Free block or NULL if not found.
+ */
+//==============================================================================
+static struct mem *search_suitable_block(struct heap_ctrl *ctrl, int *fl, int *sl)
+{
+        u32_t sl_map = ctrl->sl_bitmap[*fl] & (~0U << *sl);
+
+        if (!sl_map) {
+                u32_t fl_map = ctrl->fl_bitmap & (~0U << (*fl + 1));
+                if (!fl_map) {
+                        return NULL;
+                }
+
+                *fl    = ffs_bit(fl_map);
+                sl_map = ctrl->sl_bitmap[*fl];
+        }
+
+        *sl = ffs_bit(sl_map);
+
+        return ctrl->blocks[*fl][*sl];
+}
+
+//==============================================================================
+/**
+ * @brief  Remove free block from list of selected indexes.
+ *
+ * @param  heap         heap object
+ * @param  block        block to remove
+ * @param  fl           first level index
+ * @param  sl           second level index
+ */
+//==============================================================================
+static void remove_free_block(_heap_t *heap, struct mem *block, int fl, int sl)
+{
+        struct heap_ctrl *ctrl = heap->ctrl;
+
+        if (block->next_free) {
+                block->next_free->prev_free = block->prev_free;
+        }
+
+        if (block->prev_free) {
+                block->prev_free->next_free = block->next_free;
+        }
+
+        if (ctrl->blocks[fl][sl] == block) {
+                ctrl->blocks[fl][sl] = block->next_free;
+
+                if (ctrl->blocks[fl][sl] == NULL) {
+                        ctrl->sl_bitmap[fl] &= ~(1U << sl);
+
+                        if (ctrl->sl_bitmap[fl] == 0) {
+                                ctrl->fl_bitmap &= ~(1U << fl);
+                        }
+                }
+        }
+
+        heap->free_blocks--;
+}
+
+//==============================================================================
+/**
+ * @brief  Insert free block to list according to block size.
+ *
+ * @param  heap         heap object
+ * @param  block        block to insert
+ */
+//==============================================================================
+static void insert_free_block(_heap_t *heap, struct mem *block)
+{
+        struct heap_ctrl *ctrl = heap->ctrl;
+
+        int fl, sl;
+        mapping_insert(block_size(block), &fl, &sl);
+
+        block->prev_free = NULL;
+        block->next_free = ctrl->blocks[fl][sl];
+
+        if (block->next_free) {
+                block->next_free->prev_free = block;
+        }
+
+        ctrl->blocks[fl][sl] = block;
+        ctrl->fl_bitmap     |= (1U << fl);
+        ctrl->sl_bitmap[fl] |= (1U << sl);
+
+        heap->free_blocks++;
+}
+
+//==============================================================================
+/**
+ * @brief  Remove free block from list calculated from block size.
+ *
+ * @param  heap         heap object
+ * @param  block        block to remove
+ */
+//==============================================================================
+static void detach_free_block(_heap_t *heap, struct mem *block)
+{
+        int fl, sl;
+        mapping_insert(block_size(block), &fl, &sl);
+        remove_free_block(heap, block, fl, sl);
+}
+
+//==============================================================================
+/**
+* @brief  Initialize heap. Control structure is placed at the beginning of
+*         the heap, the rest of memory is a single free block.
+*
+* @param  heap          heap object
+* @param  start         memory start address
+* @param  size          memory size
+*
+* @return One of errno value.
+*/
+//==============================================================================
+int _heap_init(_heap_t *heap, void *start, size_t size)
+{
+        if (!heap || !start || size < (SMALL_BLOCK_SIZE * 4)) {
+                return EINVAL;
+        }
+
+        int fl, sl;
+        mapping_insert(size, &fl, &sl);
+
+        size_t ctrl_size = MEM_ALIGN_SIZE(offsetof(struct heap_ctrl, blocks)
+                                          + (fl + 1) * sizeof(((struct heap_ctrl*)0)->blocks[0]));
+
+        if (size < ctrl_size + (2 * BLOCK_HDR_SIZE) + BLOCK_MIN_SIZE) {
+                return EINVAL;
+        }
+
+        memset(heap, 0, sizeof(_heap_t));
+
+        heap->begin    = start;
+        heap->ctrl     = start;
+        heap->size     = (size - ctrl_size - BLOCK_HDR_SIZE) & ~(_HEAP_ALIGN_ - 1);
+
+        memset(heap->ctrl, 0, ctrl_size);
+        heap->ctrl->fl_count = fl + 1;
+
+        /* the whole memory is a single free block */
+        struct mem *block = (struct mem *)(void *)(heap->begin + ctrl_size);
+        block->prev_phys  = NULL;
+        block->size       = (heap->size - BLOCK_HDR_SIZE) | BLOCK_FREE;
+
+        /* the last block is always used and has no data */
+        heap->end            = block_next(block);
+        heap->end->prev_phys = block;
+        heap->end->size      = 0;
+
+        insert_free_block(heap, block);
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief  Put a block back on the heap. Block is merged with free neighbors.
+ *
+ * @param  heap         heap object
+ * @param  rmem         is the data portion of a block as returned by a previous
+ *                      call to _heap_alloc()
+ * @param  freed        freed block size (can be NULL)
+ */
+//==============================================================================
+void _heap_free(_heap_t *heap, void *rmem, size_t *freed)
+{
+        if (heap && (u8_t *)rmem >= (u8_t *)heap->begin && (u8_t *)rmem < (u8_t *)heap->end) {
+
+                _kernel_scheduler_lock();
+
+                struct mem *block = block_from_data(rmem);
+
+                if (!block_is_free(block)) {
+                        size_t blksize = BLOCK_HDR_SIZE + block_size(block);
+                        heap->used -= blksize;
+
+                        if (freed) {
+                                *freed = blksize;
+                        }
+
+                        block->size |= BLOCK_FREE;
+
+                        /* merge with previous block */
+                        struct mem *prev = block->prev_phys;
+                        if (prev && block_is_free(prev)) {
+                                detach_free_block(heap, prev);
+                                prev->size += BLOCK_HDR_SIZE + block_size(block);
+                                block = prev;
+                                block_next(block)->prev_phys = block;
+                        }
+
+                        /* merge with next block (the last block is always used) */
+                        struct mem *next = block_next(block);
+                        if (block_is_free(next)) {
+                                detach_free_block(heap, next);
+                                block->size += BLOCK_HDR_SIZE + block_size(next);
+                                block_next(block)->prev_phys = block;
+                        }
+
+                        insert_free_block(heap, block);
+                }
+
+                _kernel_scheduler_unlock();
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Allocate a block of memory with a minimum of 'size' bytes.
+ *         Free block is found by using bitmaps in constant time.
+ *
+ * @param  heap         heap object
+ * @param  size         is the minimum size of the requested block in bytes.
+ * @param  allocated    real size of allocated block (it can be bigger than size)
+
+ * @return Pointer to allocated memory or NULL if no free memory was found.
+ */
+//==============================================================================
+void *_heap_alloc(_heap_t *heap, size_t size, size_t *allocated)
+{
+        if (!heap || size == 0) {
+                return NULL;
+        }
+
+        size = MEM_ALIGN_SIZE(size);
+
+        if (size < BLOCK_MIN_SIZE) {
+                size = BLOCK_MIN_SIZE;
+        }
+
+        if (size > heap->size) {
+                return NULL;
+        }
+
+        int fl, sl;
+        mapping_search(size, &fl, &sl);
+
+        if (fl >= heap->ctrl->fl_count) {
+                return NULL;
+        }
+
+        void *mem = NULL;
+
+        _kernel_scheduler_lock();
+
+        struct mem *block = search_suitable_block(heap->ctrl, &fl, &sl);
+
+        heap->search_max = heap->search_max < 1 ? 1 : heap->search_max;
+
+        if (block) {
+                remove_free_block(heap, block, fl, sl);
+
+                /* split block if remainder can store another block */
+                size_t remain = block_size(block) - size;
+
+                if (remain >= BLOCK_HDR_SIZE + BLOCK_MIN_SIZE) {
+                        block->size = size;
+
+                        struct mem *rest = block_next(block);
+                        rest->prev_phys  = block;
+                        rest->size       = (remain - BLOCK_HDR_SIZE) | BLOCK_FREE;
+
+                        block_next(rest)->prev_phys = rest;
+
+                        insert_free_block(heap, rest);
+                } else {
+                        block->size &= ~BLOCK_FREE;
+                }
+
+                size_t used = BLOCK_HDR_SIZE + block_size(block);
+
+                heap->used    += used;
+                heap->used_max = heap->used_max < heap->used ? heap->used : heap->used_max;
+
+                if (allocated) {
+                        *allocated = used;
+                }
+
+                mem = block_data(block);
+        }
+
+        _kernel_scheduler_unlock();
+
+        return mem;
+}
+
+//==============================================================================
+/**
+ * @brief  Function return free heap
+ *
+ * @param  heap         heap object
+ *
+ * @return Free heap value
+ */
+//==============================================================================
+size_t _heap_get_free(_heap_t *heap)
+{
+        return (heap->size - heap->used);
+}
+
+//==============================================================================
+/**
+ * @brief  Function return used heap
+ *
+ * @param  heap         heap object
+ *
+ * @return Use heap value
+ */
+//==============================================================================
+size_t _heap_get_used(_heap_t *heap)
+{
+        return heap->used;
+}
+
+//==============================================================================
+/**
+ * @brief  Function return heap size (including control structure)
+ *
+ * @param  heap         heap object
+ *
+ * @return Heap size
+ */
+//==============================================================================
+size_t _heap_get_size(_heap_t *heap)
+{
+        return ((u8_t *)heap->end - heap->begin) + BLOCK_HDR_SIZE;
+}
+
+//==============================================================================
+/**
+ * @brief  Function return size of selected block
+ *
+ * @param  heap     heap object
+ * @param  rmem     memory block
+ *
+ * @return Block size, 0 on error
+ */
+//==============================================================================
+size_t _heap_get_block_size(_heap_t *heap, void *rmem)
+{
+        size_t blksize = 0;
+
+        if (heap && (u8_t *)rmem >= (u8_t *)heap->begin && (u8_t *)rmem < (u8_t *)heap->end) {
+                blksize = BLOCK_HDR_SIZE + block_size(block_from_data(rmem));
+        }
+
+        return blksize;
+}
+
+//==============================================================================
+/**
+ * @brief  Function return heap statistics. Only the list of the biggest
+ *         blocks is searched to find the largest free block.
+ *
+ * @param  heap         heap object
+ * @param  stat         statistics container
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _heap_get_stat(_heap_t *heap, _heap_stat_t *stat)
+{
+        if (!heap || !stat) {
+                return EINVAL;
+        }
+
+        memset(stat, 0, sizeof(_heap_stat_t));
+
+        _kernel_scheduler_lock();
+        {
+                struct heap_ctrl *ctrl = heap->ctrl;
+
+                if (ctrl->fl_bitmap) {
+                        int fl = fls(ctrl->fl_bitmap);
+                        int sl = fls(ctrl->sl_bitmap[fl]);
+
+                        for (struct mem *b = ctrl->blocks[fl][sl]; b; b = b->next_free) {
+                                if (block_size(b) > stat->largest_free) {
+                                        stat->largest_free = block_size(b);
+                                }
+                        }
+                }
+
+                stat->size        = _heap_get_size(heap);
+                stat->used        = heap->used;
+                stat->used_max    = heap->used_max;
+                stat->free_blocks = heap->free_blocks;
+                stat->search_max  = heap->search_max;
+        }
+        _kernel_scheduler_unlock();
+
+        return ESUCC;
+}
+#endif
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -261,8 +261,10 @@ int _kfree(enum _mm_mem mpur, void **mem, ...)
                         if ((*cast(res_header_t**, mem))->type == RES_TYPE_MEMORY) {
                                 usage = arg;
                                 err   = ESUCC;
-                                (*cast(res_header_t**, mem))->next = NULL;
-                                (*cast(res_header_t**, mem))->type = RES_TYPE_UNKNOWN;
+                                (*cast(res_header_t**, mem))->next  = NULL;
+                                (*cast(res_header_t**, mem))->prev  = NULL;
+                                (*cast(res_header_t**, mem))->owner = NULL;
+                                (*cast(res_header_t**, mem))->type  = RES_TYPE_UNKNOWN;
                         } else {
                                 err = EFAULT;
                                 break;
@@ -374,6 +376,29 @@ size_t _mm_get_block_size(void *mem)
         return 0;
 }
 
+//==============================================================================
+/**
+ * @brief  Function check if selected object is placed in one of heap regions.
+ *         Object content is not accessed.
+ *
+ * @param  mem      object to check
+ * @param  size     object size
+ *
+ * @return If whole object is in heap then true is returned, otherwise false.
+ */
+//==============================================================================
+bool _mm_is_object_in_heap(const void *mem, size_t size)
+{
+        for (_mm_region_t *r = &memory_region; r; r = r->next) {
+                if (  IS_IN_HEAP(r->heap, mem)
+                   && (cast(uintptr_t, r->heap.end) - cast(uintptr_t, mem)) >= size) {
+                        return true;
+                }
+        }
+
+        return false;
+}
+
 //==============================================================================
 /**
  * @brief  Return free memory (calculate by using all heap regions).
@@ -428,6 +453,27 @@ size_t _mm_get_mem_size(void)
         return ramsize;
 }
 
+//==============================================================================
+/**
+ * @brief  Return statistics of selected heap region.
+ *
+ * @param  seek         region seek (start from 0)
+ * @param  stat         statistics container
+ *
+ * @return One of errno values.
+ */
+//==============================================================================
+int _mm_get_heap_stat(size_t seek, _heap_stat_t *stat)
+{
+        for (_mm_region_t *r = &memory_region; r; r = r->next) {
+                if (seek-- == 0) {
+                        return _heap_get_stat(&r->heap, stat);
+                }
+        }
+
+        return ENOENT;
+}
+
 //==============================================================================
 /**
  * @brief  Allocate memory
@@ -517,8 +563,10 @@ static int kalloc(enum _mm_mem mpur, size_t size, bool clear, void **mem, void *
                                                 }
 
                                                 if (mpur == _MM_PROG) {
-                                                         cast(res_header_t*, blk)->next = NULL;
-                                                         cast(res_header_t*, blk)->type = RES_TYPE_MEMORY;
+                                                         cast(res_header_t*, blk)->next  = NULL;
+                                                         cast(res_header_t*, blk)->prev  = NULL;
+                                                         cast(res_header_t*, blk)->owner = NULL;
+                                                         cast(res_header_t*, blk)->type  = RES_TYPE_MEMORY;
                                                 }
 
                                                 *mem = blk;
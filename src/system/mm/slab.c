@@ -0,0 +1,538 @@
+/*=========================================================================*//**
+File     slab.c
+
+Author   Daniel Zorychta
+
+Brief    Fixed-size object caches (slab allocator).
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <string.h>
+#include "mm/slab.h"
+#include "mm/mm.h"
+#include "kernel/errno.h"
+#include "kernel/kwrapper.h"
+#include "dnx/misc.h"
+#include "lib/cast.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define PAGE_SIZE               256
+#define PAGE_OBJECTS_MIN        2
+#define PAGE_OBJECTS_MAX        16
+#define MAGAZINE_SIZE           8
+#define MAGAZINE_BATCH          (MAGAZINE_SIZE / 2)
+
+#define align_up(_val, _align)  (((_val) + (_align) - 1) & ~((_align) - 1))
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+/**
+ * Magazine is a small stack of free objects in front of the pages. Objects
+ * are taken from and returned to the magazine in O(1) and moved between
+ * magazine and pages in batches of MAGAZINE_BATCH objects.
+ *
+ * Page is a single heap block that contains several objects. Each object is
+ * preceded by the pointer to the page.
+ */
+typedef struct slab_page {
+        struct slab_page   *next;               //!< next page in list
+        struct slab_page   *prev;               //!< previous page in list
+        _slab_t            *slab;               //!< slab owner
+        void               *free;               //!< list of free objects
+        u16_t               used;               //!< number of used objects
+} slab_page_t;
+
+struct _slab {
+        struct _slab       *next;               //!< next registered slab
+        const char         *name;               //!< slab name
+        enum _mm_mem        mpur;               //!< memory purpose
+        size_t              obj_size;           //!< object size
+        size_t              obj_hdr;            //!< object header size (aligned)
+        size_t              stride;             //!< distance between objects
+        size_t              align;              //!< object alignment
+        size_t              page_size;          //!< page size (with page header)
+        u16_t               page_objects;       //!< number of objects in page
+        slab_page_t        *partial;            //!< pages with free objects
+        slab_page_t        *full;               //!< pages without free objects
+        slab_page_t        *empty;              //!< spare empty page
+        void               *mag[MAGAZINE_SIZE]; //!< magazine of free objects
+        u8_t                mag_cnt;            //!< number of objects in magazine
+        size_t              pages;              //!< number of pages
+        size_t              objects;            //!< number of allocated objects
+        size_t              objects_max;        //!< max number of allocated objects
+};
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static _slab_t *slab_list;
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief Function remove page from selected list.
+ *
+ * @param  list         page list
+ * @param  page         page to remove
+ */
+//==============================================================================
+static void page_unlink(slab_page_t **list, slab_page_t *page)
+{
+        if (page->prev) {
+                page->prev->next = page->next;
+        } else {
+                *list = page->next;
+        }
+
+        if (page->next) {
+                page->next->prev = page->prev;
+        }
+
+        page->next = NULL;
+        page->prev = NULL;
+}
+
+//==============================================================================
+/**
+ * @brief Function add page to the beginning of selected list.
+ *
+ * @param  list         page list
+ * @param  page         page to add
+ */
+//==============================================================================
+static void page_link(slab_page_t **list, slab_page_t *page)
+{
+        page->prev = NULL;
+        page->next = *list;
+
+        if (*list) {
+                (*list)->prev = page;
+        }
+
+        *list = page;
+}
+
+//==============================================================================
+/**
+ * @brief Function allocate new page and divide it to objects. All objects
+ *        are added to the page free list.
+ *
+ * @param  slab         slab object
+ * @param  page         allocated page
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int page_alloc(_slab_t *slab, slab_page_t **page)
+{
+        int err = _kmalloc(slab->mpur, slab->page_size, cast(void*, page));
+        if (!err) {
+                slab_page_t *p = *page;
+                memset(p, 0, sizeof(slab_page_t));
+                p->slab = slab;
+
+                u8_t *base = cast(u8_t*, align_up(cast(size_t, p) + sizeof(slab_page_t),
+                                                  slab->align));
+
+                for (int i = slab->page_objects - 1; i >= 0; i--) {
+                        u8_t *obj = base + (i * slab->stride) + slab->obj_hdr;
+
+                        cast(slab_page_t**, obj)[-1] = p;
+                        *cast(void**, obj) = p->free;
+                        p->free = obj;
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function take free object from the first partial page. Scheduler
+ *        must be locked and partial list can not be empty.
+ *
+ * @param  slab         slab object
+ *
+ * @return Object.
+ */
+//==============================================================================
+static void *page_obj_get(_slab_t *slab)
+{
+        slab_page_t *page = slab->partial;
+
+        void *obj  = page->free;
+        page->free = *cast(void**, obj);
+        page->used++;
+
+        if (page->free == NULL) {
+                page_unlink(&slab->partial, page);
+                page_link(&slab->full, page);
+        }
+
+        return obj;
+}
+
+//==============================================================================
+/**
+ * @brief Function return object to its page. Scheduler must be locked.
+ *        Page that becomes empty is kept as spare page or added to release
+ *        list when cache already has a spare page.
+ *
+ * @param  slab         slab object
+ * @param  obj          object to return
+ * @param  release      list of pages to release (linked by next field)
+ */
+//==============================================================================
+static void page_obj_put(_slab_t *slab, void *obj, slab_page_t **release)
+{
+        slab_page_t *page = cast(slab_page_t**, obj)[-1];
+
+        if (page->free == NULL) {
+                page_unlink(&slab->full, page);
+                page_link(&slab->partial, page);
+        }
+
+        *cast(void**, obj) = page->free;
+        page->free = obj;
+        page->used--;
+
+        if (page->used == 0) {
+                page_unlink(&slab->partial, page);
+
+                if (slab->empty == NULL) {
+                        slab->empty = page;
+                } else {
+                        page->next = *release;
+                        *release   = page;
+                        slab->pages--;
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function release pages from list created by page_obj_put().
+ *
+ * @param  slab         slab object
+ * @param  release      list of pages to release
+ */
+//==============================================================================
+static void page_release(_slab_t *slab, slab_page_t *release)
+{
+        while (release) {
+                slab_page_t *page = release;
+                release = page->next;
+                _kfree(slab->mpur, cast(void*, &page));
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function create object cache.
+ *
+ * @param  name         cache name (string must exist during cache lifetime)
+ * @param  size         object size
+ * @param  align        object alignment (power of 2, 0 for default alignment)
+ * @param  mpur         memory purpose of pages (_MM_PROG and _MM_MOD are not
+ *                      supported)
+ * @param  slab         created cache
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _slab_create(const char *name, size_t size, size_t align, enum _mm_mem mpur, _slab_t **slab)
+{
+        if (  !name || !size || !slab || mpur >= _MM_COUNT
+           || mpur == _MM_PROG || mpur == _MM_MOD
+           || (align & (align - 1)) ) {
+
+                return EINVAL;
+        }
+
+        align = (align < _HEAP_ALIGN_) ? _HEAP_ALIGN_ : align;
+
+        int err = _kzalloc(_MM_KRN, sizeof(_slab_t), cast(void*, slab));
+        if (!err) {
+                _slab_t *s = *slab;
+
+                s->name     = name;
+                s->mpur     = mpur;
+                s->align    = align;
+                s->obj_size = size;
+                s->obj_hdr  = align_up(sizeof(slab_page_t*), align);
+                s->stride   = s->obj_hdr + align_up(max(size, sizeof(void*)), align);
+
+                size_t n = PAGE_SIZE / s->stride;
+                s->page_objects = (n < PAGE_OBJECTS_MIN) ? PAGE_OBJECTS_MIN
+                                : (n > PAGE_OBJECTS_MAX) ? PAGE_OBJECTS_MAX : n;
+
+                // extra space is reserved to align the first object
+                s->page_size = sizeof(slab_page_t) + (align - 1)
+                             + (s->page_objects * s->stride);
+
+                _kernel_scheduler_lock();
+                {
+                        s->next   = slab_list;
+                        slab_list = s;
+                }
+                _kernel_scheduler_unlock();
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function destroy object cache. All objects must be freed before.
+ *
+ * @param  slab         slab to destroy
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _slab_destroy(_slab_t *slab)
+{
+        if (!slab) {
+                return EINVAL;
+        }
+
+        _kernel_scheduler_lock();
+
+        if (slab->objects > 0) {
+                _kernel_scheduler_unlock();
+                return EBUSY;
+        }
+
+        for (_slab_t **s = &slab_list; *s; s = &(*s)->next) {
+                if (*s == slab) {
+                        *s = slab->next;
+                        break;
+                }
+        }
+
+        slab_page_t *release = NULL;
+
+        while (slab->mag_cnt > 0) {
+                page_obj_put(slab, slab->mag[--slab->mag_cnt], &release);
+        }
+
+        _kernel_scheduler_unlock();
+
+        page_release(slab, release);
+
+        while (slab->partial) {
+                slab_page_t *page = slab->partial;
+                page_unlink(&slab->partial, page);
+                _kfree(slab->mpur, cast(void*, &page));
+        }
+
+        if (slab->empty) {
+                _kfree(slab->mpur, cast(void*, &slab->empty));
+        }
+
+        return _kfree(_MM_KRN, cast(void*, &slab));
+}
+
+//==============================================================================
+/**
+ * @brief Function allocate object from cache. Object is zeroed.
+ *
+ * @param  slab         slab object
+ * @param  obj          allocated object
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _slab_alloc(_slab_t *slab, void **obj)
+{
+        if (!slab || !obj) {
+                return EINVAL;
+        }
+
+        _kernel_scheduler_lock();
+
+        // magazine is refilled by a batch of objects from pages
+        while (slab->mag_cnt < MAGAZINE_BATCH) {
+
+                if (!slab->partial && slab->empty) {
+                        page_link(&slab->partial, slab->empty);
+                        slab->empty = NULL;
+                }
+
+                if (!slab->partial) {
+                        if (slab->mag_cnt > 0) {
+                                break;
+                        }
+
+                        _kernel_scheduler_unlock();
+
+                        // page is allocated outside of locked scheduler because
+                        // memory allocation can reduce caches
+                        slab_page_t *page = NULL;
+                        int err = page_alloc(slab, &page);
+                        if (err) {
+                                return err;
+                        }
+
+                        _kernel_scheduler_lock();
+                        page_link(&slab->partial, page);
+                        slab->pages++;
+                }
+
+                slab->mag[slab->mag_cnt++] = page_obj_get(slab);
+        }
+
+        void *o = slab->mag[--slab->mag_cnt];
+
+        slab->objects++;
+        slab->objects_max = max(slab->objects, slab->objects_max);
+
+        _kernel_scheduler_unlock();
+
+        memset(o, 0, slab->obj_size);
+        *obj = o;
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief Function return object to cache. Object is put to the magazine,
+ *        page is released when all its objects are returned from magazine
+ *        and cache already has a spare empty page. Magazine is emptied when
+ *        last object of cache is freed.
+ *
+ * @param  slab         slab object
+ * @param  obj          object to free
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _slab_free(_slab_t *slab, void **obj)
+{
+        if (!slab || !obj || !*obj) {
+                return EINVAL;
+        }
+
+        slab_page_t *page    = cast(slab_page_t**, *obj)[-1];
+        slab_page_t *release = NULL;
+
+        if (page->slab != slab) {
+                return EFAULT;
+        }
+
+        _kernel_scheduler_lock();
+
+        // the oldest batch of objects is returned to pages when magazine is full
+        if (slab->mag_cnt == MAGAZINE_SIZE) {
+                for (int i = 0; i < MAGAZINE_BATCH; i++) {
+                        page_obj_put(slab, slab->mag[i], &release);
+                }
+
+                slab->mag_cnt -= MAGAZINE_BATCH;
+                memmove(&slab->mag[0], &slab->mag[MAGAZINE_BATCH],
+                        slab->mag_cnt * sizeof(void*));
+        }
+
+        slab->mag[slab->mag_cnt++] = *obj;
+        slab->objects--;
+
+        // pages are not held by magazine when cache is not used
+        if (slab->objects == 0) {
+                while (slab->mag_cnt > 0) {
+                        page_obj_put(slab, slab->mag[--slab->mag_cnt], &release);
+                }
+        }
+
+        _kernel_scheduler_unlock();
+
+        page_release(slab, release);
+
+        *obj = NULL;
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief Function return statistics of selected cache.
+ *
+ * @param  seek         cache seek (start from 0)
+ * @param  stat         statistics container
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _slab_get_stat(size_t seek, _slab_stat_t *stat)
+{
+        if (!stat) {
+                return EINVAL;
+        }
+
+        int err = ENOENT;
+
+        _kernel_scheduler_lock();
+        {
+                for (_slab_t *s = slab_list; s; s = s->next) {
+                        if (seek-- == 0) {
+                                stat->name        = s->name;
+                                stat->obj_size    = s->obj_size;
+                                stat->objects     = s->objects;
+                                stat->objects_max = s->objects_max;
+                                stat->cached      = s->mag_cnt;
+                                stat->capacity    = s->pages * s->page_objects;
+                                stat->pages       = s->pages;
+                                stat->page_size   = s->page_size;
+                                err = ESUCC;
+                                break;
+                        }
+                }
+        }
+        _kernel_scheduler_unlock();
+
+        return err;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -0,0 +1,473 @@
+/*=========================================================================*//**
+File     cache_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test and benchmark of block cache.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Devices are RAM images connected to the cache by fake driver functions.
+ * Cache is enabled for this test only, thus tested file is included. Test
+ * checks lookup, LRU eviction of clean blocks and separation of dirty blocks,
+ * merging of device requests, read-ahead and device statistics.
+ * Block traces of FAT and ext4 like access are replayed with limited number
+ * of cached blocks and replay time is printed.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "config.h"
+
+#undef  __OS_SYSTEM_FS_CACHE_ENABLE__
+#define __OS_SYSTEM_FS_CACHE_ENABLE__ _YES_
+
+#include "../cache.c"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define BLKSZ                   512
+#define DEV_BLOCKS              4096
+#define DEVICES                 2
+#define CACHE_BLOCKS            256
+#define TRACE_OPS               200000
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+struct fake_dev {
+        dev_t dev;
+        u8_t  img[DEV_BLOCKS * BLKSZ];
+        u32_t rd_req;
+        u32_t rd_blk;
+        u32_t wr_req;
+        u32_t wr_blk;
+};
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static struct fake_dev devs[DEVICES];
+
+/*==============================================================================
+  Kernel services
+==============================================================================*/
+static struct fake_dev *fake_dev_get(dev_t dev)
+{
+        for (int i = 0; i < DEVICES; i++) {
+                if (devs[i].dev == dev) {
+                        return &devs[i];
+                }
+        }
+
+        return NULL;
+}
+
+int _driver_read(dev_t id, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt, struct vfs_fattr fattr)
+{
+        struct fake_dev *d = fake_dev_get(id);
+
+        if (!d || (*fpos + count) > sizeof(d->img)) {
+                return EIO;
+        }
+
+        memcpy(dst, &d->img[*fpos], count);
+        *rdcnt = count;
+        d->rd_req++;
+        d->rd_blk += count / BLKSZ;
+        return ESUCC;
+}
+
+int _driver_write(dev_t id, const u8_t *src, size_t count, fpos_t *fpos, size_t *wrcnt, struct vfs_fattr fattr)
+{
+        struct fake_dev *d = fake_dev_get(id);
+
+        if (!d || (*fpos + count) > sizeof(d->img)) {
+                return EIO;
+        }
+
+        memcpy(&d->img[*fpos], src, count);
+        *wrcnt = count;
+        d->wr_req++;
+        d->wr_blk += count / BLKSZ;
+        return ESUCC;
+}
+
+int _vfs_fstat(FILE *file, struct stat *stat)
+{
+        struct fake_dev *d = cast(struct fake_dev*, file);
+
+        stat->st_type = FILE_TYPE_DRV;
+        stat->st_dev  = d->dev;
+        return ESUCC;
+}
+
+int _vfs_fseek(FILE *file, i64_t offset, int mode)
+{
+        return ENOTSUP;
+}
+
+int _vfs_fread(void *ptr, size_t size, size_t *rdcnt, FILE *file)
+{
+        return ENOTSUP;
+}
+
+int _vfs_fwrite(const void *ptr, size_t size, size_t *wrcnt, FILE *file)
+{
+        return ENOTSUP;
+}
+
+void _vfs_sync(void)
+{
+}
+
+size_t _mm_get_mem_free(void)
+{
+        return 1024 * 1024;
+}
+
+void _kernel_panic_report(enum _kernel_panic_desc_cause cause)
+{
+        HT_CHECK(false);
+}
+
+u32_t _kernel_get_time_ms(void)
+{
+        return 0;
+}
+
+task_t *_task_get_handle(void)
+{
+        return NULL;
+}
+
+void _sleep_ms(const u32_t milliseconds)
+{
+}
+
+int _mutex_create(enum mutex_type type, mutex_t **mtx)
+{
+        static int m;
+        *mtx = cast(mutex_t*, &m);
+        return ESUCC;
+}
+
+int _mutex_lock(mutex_t *mtx, const u32_t timeout)
+{
+        return ESUCC;
+}
+
+int _mutex_unlock(mutex_t *mtx)
+{
+        return ESUCC;
+}
+
+int _semaphore_create(size_t cnt_max, size_t cnt_init, sem_t **sem)
+{
+        static int s;
+        *sem = cast(sem_t*, &s);
+        return ESUCC;
+}
+
+int _semaphore_wait(sem_t *sem, const u32_t timeout)
+{
+        return ESUCC;
+}
+
+int _semaphore_signal(sem_t *sem)
+{
+        return ESUCC;
+}
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Fill device with pattern.
+ */
+//==============================================================================
+static void dev_init(struct fake_dev *d, dev_t dev)
+{
+        d->dev = dev;
+
+        for (size_t i = 0; i < sizeof(d->img); i++) {
+                d->img[i] = (i / BLKSZ) + (dev * 101);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Read single block and check content.
+ */
+//==============================================================================
+static void check_block(struct fake_dev *d, u32_t blk)
+{
+        static u8_t buf[BLKSZ];
+
+        HT_CHECK_OK(sys_cache_read(cast(FILE*, d), blk, BLKSZ, 1, buf));
+
+        for (int i = 0; i < BLKSZ; i++) {
+                HT_CHECK(buf[i] == d->img[blk * BLKSZ + i]);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Check if block is cached.
+ */
+//==============================================================================
+static bool is_cached(struct fake_dev *d, u32_t blk)
+{
+        cache_t *cache;
+        return cache_find(d->dev, blk, &cache) == ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief  Replay block trace. Number of cached blocks is limited by cache
+ *         reduction as done by memory allocator.
+ *
+ * @param  name         trace name
+ * @param  next         function that return next block of trace
+ */
+//==============================================================================
+static void replay(const char *name, u32_t (*next)(u32_t i, bool *wr))
+{
+        static u8_t buf[BLKSZ];
+        struct fake_dev *d = &devs[0];
+
+        _cache_drop();
+        u32_t rd_req = d->rd_req;
+        u32_t rd_blk = d->rd_blk;
+
+        unsigned long long t = ht_clock_us();
+
+        for (u32_t i = 0; i < TRACE_OPS; i++) {
+                bool  wr  = false;
+                u32_t blk = next(i, &wr);
+
+                if (wr) {
+                        HT_CHECK_OK(sys_cache_write(cast(FILE*, d), blk, BLKSZ, 1, buf, CACHE_WRITE_BACK));
+                } else {
+                        HT_CHECK_OK(sys_cache_read(cast(FILE*, d), blk, BLKSZ, 1, buf));
+                }
+
+                if (cman.clean.count + cman.dirty.count > CACHE_BLOCKS) {
+                        _cache_reduce(BLKSZ);
+                }
+
+                if (cman.dirty.bytes > DIRTY_BACKGROUND) {
+                        _cache_sync();
+                }
+        }
+
+        _cache_sync();
+
+        t = ht_clock_us() - t;
+
+        ht_print("cache: %s trace %u ops, %u read requests, %u blocks read, %llu us\n",
+                 name, TRACE_OPS, d->rd_req - rd_req, d->rd_blk - rd_blk, t);
+}
+
+//==============================================================================
+/**
+ * @brief  FAT like trace: FAT sectors, directory and sequential file data.
+ */
+//==============================================================================
+static u32_t trace_fat(u32_t i, bool *wr)
+{
+        static u32_t data = 1024;
+
+        switch (i % 8) {
+        case 0:  return 32 + (ht_rand() % 64);
+        case 1:  *wr = (ht_rand() % 4) == 0; return 160 + (ht_rand() % 8);
+        default: data = (data + 1 < DEV_BLOCKS) ? data + 1 : 1024; return data;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  ext4 like trace: bitmaps, inode table and random file data.
+ */
+//==============================================================================
+static u32_t trace_ext4(u32_t i, bool *wr)
+{
+        switch (i % 4) {
+        case 0:  return 2 + (ht_rand() % 2);
+        case 1:  *wr = (ht_rand() % 8) == 0; return 16 + (ht_rand() % 128);
+        default: return 512 + (ht_rand() % (DEV_BLOCKS - 512));
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        static u8_t buf[BLKSZ * 8];
+        _cache_dev_stat_t stat;
+
+        HT_CHECK_OK(_cache_init());
+
+        for (int i = 0; i < DEVICES; i++) {
+                dev_init(&devs[i], i + 1);
+        }
+
+        FILE *f0 = cast(FILE*, &devs[0]);
+
+        // blocks of the same position on different devices
+        for (u32_t blk = 0; blk < 200; blk++) {
+                check_block(&devs[0], blk);
+                check_block(&devs[1], blk);
+        }
+
+        u32_t rd_req = devs[0].rd_req + devs[1].rd_req;
+        for (u32_t blk = 0; blk < 200; blk += 7) {
+                check_block(&devs[1], blk);
+                check_block(&devs[0], blk);
+        }
+
+        HT_CHECK(devs[0].rd_req + devs[1].rd_req == rd_req);
+
+        // the least recently used clean block is released first
+        _cache_drop();
+        HT_CHECK(cman.clean.count == 0);
+
+        for (u32_t blk = 0; blk < 10; blk++) {
+                HT_CHECK_OK(sys_cache_read(f0, blk * 2, BLKSZ, 1, buf));
+        }
+
+        HT_CHECK_OK(sys_cache_read(f0, 0, BLKSZ, 1, buf));
+        _cache_reduce(1);
+        HT_CHECK(is_cached(&devs[0], 0));
+        HT_CHECK(!is_cached(&devs[0], 2));
+        HT_CHECK(is_cached(&devs[0], 4));
+
+        // dirty blocks are not released by reduction
+        _cache_drop();
+        memset(buf, 0xA5, BLKSZ);
+        HT_CHECK_OK(sys_cache_write(f0, 3000, BLKSZ, 1, buf, CACHE_WRITE_BACK));
+        HT_CHECK(devs[0].img[3000 * BLKSZ] != 0xA5);
+
+        _cache_reduce(UINT16_MAX);
+        HT_CHECK(is_cached(&devs[0], 3000));
+        HT_CHECK(_cache_is_sync_needed());
+
+        _cache_sync();
+        HT_CHECK(!_cache_is_sync_needed());
+        HT_CHECK(devs[0].img[3000 * BLKSZ] == 0xA5);
+        HT_CHECK(cman.dirty.count == 0);
+
+        _cache_reduce(UINT16_MAX);
+        HT_CHECK(!is_cached(&devs[0], 3000));
+
+        // device cache drop
+        check_block(&devs[1], 100);
+        HT_CHECK_OK(sys_cache_drop(cast(FILE*, &devs[1])));
+        HT_CHECK(!is_cached(&devs[1], 100));
+
+        // consecutive missed blocks are read by single request
+        _cache_drop();
+        struct fake_dev *d = &devs[0];
+
+        HT_CHECK_OK(sys_cache_read(f0, 2000, BLKSZ, 1, buf));
+        HT_CHECK_OK(sys_cache_read(f0, 2003, BLKSZ, 1, buf));
+
+        rd_req = d->rd_req;
+        HT_CHECK_OK(sys_cache_read(f0, 2000, BLKSZ, 8, buf));
+        HT_CHECK(d->rd_req - rd_req == 2);
+        HT_CHECK(memcmp(buf, &d->img[2000 * BLKSZ], BLKSZ * 8) == 0);
+
+        // sequential read, next blocks are read in advance by single request
+        rd_req = d->rd_req;
+        HT_CHECK_OK(sys_cache_read(f0, 2008, BLKSZ, 1, buf));
+        HT_CHECK(d->rd_req - rd_req == 2);
+
+        for (u32_t blk = 2009; blk < 2009 + READ_AHEAD_BLOCKS; blk++) {
+                HT_CHECK(is_cached(d, blk));
+        }
+
+        HT_CHECK(!is_cached(d, 2009 + READ_AHEAD_BLOCKS));
+        check_block(d, 2009);
+
+        // dirty blocks are written by position in runs of consecutive blocks
+        static const u32_t dirty_blk[] = {3005, 3003, 3011, 3004, 3010};
+
+        u32_t wr_req = d->wr_req;
+        u32_t wr_blk = d->wr_blk;
+
+        for (size_t i = 0; i < ARRAY_SIZE(dirty_blk); i++) {
+                memset(buf, i + 1, BLKSZ);
+                HT_CHECK_OK(sys_cache_write(f0, dirty_blk[i], BLKSZ, 1, buf, CACHE_WRITE_BACK));
+        }
+
+        HT_CHECK(d->wr_req == wr_req);
+        _cache_sync();
+        HT_CHECK(d->wr_req - wr_req == 2);
+        HT_CHECK(d->wr_blk - wr_blk == ARRAY_SIZE(dirty_blk));
+
+        for (size_t i = 0; i < ARRAY_SIZE(dirty_blk); i++) {
+                HT_CHECK(d->img[dirty_blk[i] * BLKSZ] == i + 1);
+        }
+
+        // write through
+        wr_req = d->wr_req;
+        memset(buf, 0x5A, BLKSZ * 2);
+        HT_CHECK_OK(sys_cache_write(f0, 3020, BLKSZ, 2, buf, CACHE_WRITE_THROUGH));
+        HT_CHECK(d->wr_req - wr_req == 1);
+        HT_CHECK(d->img[3021 * BLKSZ] == 0x5A);
+        HT_CHECK(is_cached(d, 3021) && cman.dirty.count == 0);
+
+        // statistics
+        HT_CHECK_OK(_cache_get_dev_stat(0, &stat));
+        HT_CHECK(stat.dev == d->dev);
+        HT_CHECK(stat.rd_requests == d->rd_req);
+        HT_CHECK(stat.wr_requests == d->wr_req);
+        HT_CHECK(stat.hits > 0 && stat.misses > 0);
+        HT_CHECK(stat.readahead >= READ_AHEAD_BLOCKS);
+        HT_CHECK(stat.readahead_hits >= 1);
+        HT_CHECK(_cache_get_dev_stat(1, &stat) == ENOENT);
+
+        // trace replay
+        ht_srand(7);
+        replay("FAT", trace_fat);
+        replay("ext4", trace_ext4);
+
+        HT_CHECK_OK(sys_cache_drop(f0));
+        HT_CHECK(cman.clean.count == 0 && cman.dirty.count == 0);
+        HT_CHECK(ht_mem_blocks() == 0);
+
+        ht_print("cache: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -0,0 +1,213 @@
+/*=========================================================================*//**
+File     heap_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test and allocation trace benchmark of heap allocators.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Test is built for each allocator selected by HEAP_TEST_ALLOCATOR (see
+ * Makefile), thus tested files are included. Random allocation trace is
+ * replayed and content of blocks is checked. Throughput, the longest
+ * operation, the longest free block search and peak fragmentation (part of
+ * free memory not available in the largest block) are printed.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "config.h"
+
+#undef  __HEAP_ALLOCATOR__
+#define __HEAP_ALLOCATOR__ HEAP_TEST_ALLOCATOR
+
+// block headers contain pointers that are 8 bytes long on the host
+#undef  _HEAP_ALIGN_
+#define _HEAP_ALIGN_ 8
+
+#include "../heap.c"
+#include "../heap_tlsf.c"
+#include "dnx/misc.h"
+#include "lib/cast.h"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define HEAP_SIZE               (128 * 1024)
+#define SLOTS                   500
+#define TRACE_OPS               200000
+#define SIZE_MAX_SMALL          300
+#define SIZE_MAX_LARGE          4096
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static u32_t mem[HEAP_SIZE / sizeof(u32_t)];
+
+static struct {
+        u8_t  *ptr;
+        size_t size;
+} slot[SLOTS];
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Return allocator name.
+ */
+//==============================================================================
+static const char *allocator_name(void)
+{
+        return (__HEAP_ALLOCATOR__ == _HEAP_ALLOCATOR_TLSF) ? "tlsf" : "first-fit";
+}
+
+//==============================================================================
+/**
+ * @brief  Free block of selected slot and check its content.
+ *
+ * @return Time of free operation [us].
+ */
+//==============================================================================
+static unsigned long long slot_free(_heap_t *heap, int i)
+{
+        for (size_t k = 0; k < slot[i].size; k++) {
+                HT_CHECK(slot[i].ptr[k] == cast(u8_t, i));
+        }
+
+        size_t freed = 0;
+        unsigned long long t = ht_clock_us();
+        _heap_free(heap, slot[i].ptr, &freed);
+        t = ht_clock_us() - t;
+        HT_CHECK(freed >= slot[i].size);
+
+        slot[i].ptr  = NULL;
+        slot[i].size = 0;
+
+        return t;
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        _heap_t      heap;
+        _heap_stat_t stat;
+
+        HT_CHECK_OK(_heap_init(&heap, mem, sizeof(mem)));
+
+        size_t free = _heap_get_free(&heap);
+        HT_CHECK(free > 0 && free <= sizeof(mem));
+        HT_CHECK(_heap_get_used(&heap) == 0);
+
+        // large block can be allocated
+        size_t allocated = 0;
+        void  *blk = _heap_alloc(&heap, free / 2, &allocated);
+        HT_CHECK(blk != NULL && allocated >= free / 2);
+        HT_CHECK(_heap_get_block_size(&heap, blk) == allocated);
+        HT_CHECK(_heap_alloc(&heap, free, NULL) == NULL);
+        _heap_free(&heap, blk, NULL);
+        HT_CHECK(_heap_get_free(&heap) == free);
+
+        // random trace of small and large blocks
+        unsigned long long t_total = 0;
+        unsigned long long t_max   = 0;
+        u32_t              frag    = 0;
+        u32_t              failed  = 0;
+
+        ht_srand(1);
+
+        for (int op = 0; op < TRACE_OPS; op++) {
+                int i = ht_rand() % SLOTS;
+
+                unsigned long long t;
+
+                if (slot[i].ptr) {
+                        t = slot_free(&heap, i);
+                } else {
+                        size_t size = 1 + ((ht_rand() % 16) ? ht_rand() % SIZE_MAX_SMALL
+                                                            : ht_rand() % SIZE_MAX_LARGE);
+
+                        t = ht_clock_us();
+                        slot[i].ptr = _heap_alloc(&heap, size, &allocated);
+                        t = ht_clock_us() - t;
+
+                        if (slot[i].ptr) {
+                                HT_CHECK((cast(uintptr_t, slot[i].ptr) % _HEAP_ALIGN_) == 0);
+                                HT_CHECK(allocated >= size);
+                                slot[i].size = size;
+                                memset(slot[i].ptr, cast(u8_t, i), size);
+                        } else {
+                                failed++;
+                        }
+                }
+
+                t_total += t;
+                t_max    = max(t_max, t);
+
+                if ((op % 64) == 0) {
+                        HT_CHECK_OK(_heap_get_stat(&heap, &stat));
+                        size_t hfree = stat.size - stat.used;
+                        if (hfree > 0) {
+                                frag = max(frag, cast(u32_t, 100 - (stat.largest_free * 100 / hfree)));
+                        }
+                }
+        }
+
+        for (int i = 0; i < SLOTS; i++) {
+                if (slot[i].ptr) {
+                        slot_free(&heap, i);
+                }
+        }
+
+        // all blocks are merged back
+        HT_CHECK(_heap_get_used(&heap) == 0);
+        HT_CHECK(_heap_get_free(&heap) == free);
+
+        HT_CHECK_OK(_heap_get_stat(&heap, &stat));
+        HT_CHECK(stat.free_blocks == 1);
+        HT_CHECK(stat.used_max > 0 && stat.used_max <= stat.size);
+
+        // TLSF finds free block without list search
+        if (__HEAP_ALLOCATOR__ == _HEAP_ALLOCATOR_TLSF) {
+                HT_CHECK(stat.search_max == 1);
+        }
+
+        ht_print("heap: %s %d ops in %llu us, longest operation %llu us, "
+                 "longest search %u, peak fragmentation %u%%, failed %u\n",
+                 allocator_name(), TRACE_OPS, t_total, t_max,
+                 stat.search_max, frag, failed);
+
+        ht_print("heap: %s ok\n", allocator_name());
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -0,0 +1,191 @@
+/*=========================================================================*//**
+File     slab_test.c
+
+Author   Daniel Zorychta
+
+Brief    Host test of object caches (slab allocator).
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Random allocation trace is replayed on two caches of different object size
+ * and alignment. Test checks content and alignment of objects, statistics,
+ * that objects cycled through the magazine do not allocate pages, and that
+ * all memory is returned. Tested file is included to use host alignment of
+ * heap blocks.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "config.h"
+
+// page headers contain pointers that are 8 bytes long on the host
+#undef  _HEAP_ALIGN_
+#define _HEAP_ALIGN_ 8
+
+#include "../slab.c"
+#include "hosttest.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define SLOTS                   300
+#define TRACE_OPS               100000
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static struct {
+        _slab_t *slab;
+        u8_t    *obj;
+} slot[SLOTS];
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Return statistics of selected cache.
+ */
+//==============================================================================
+static _slab_stat_t slab_stat(_slab_t *slab)
+{
+        _slab_stat_t stat;
+
+        for (size_t seek = 0; _slab_get_stat(seek, &stat) == ESUCC; seek++) {
+                if (stat.obj_size == slab->obj_size) {
+                        return stat;
+                }
+        }
+
+        HT_CHECK(false);
+        return stat;
+}
+
+//==============================================================================
+/**
+ * @brief  Test entry.
+ */
+//==============================================================================
+int main(void)
+{
+        _slab_t *small;
+        _slab_t *large;
+
+        HT_CHECK(_slab_create("bad", 16, 3, _MM_KRN, &small) == EINVAL);
+        HT_CHECK(_slab_create("bad", 16, 8, _MM_PROG, &small) == EINVAL);
+
+        HT_CHECK_OK(_slab_create("small", 3, 16, _MM_KRN, &small));
+        HT_CHECK_OK(_slab_create("large", 40, 8, _MM_FS, &large));
+
+        // random trace
+        ht_srand(2);
+
+        for (int op = 0; op < TRACE_OPS; op++) {
+                int i = ht_rand() % SLOTS;
+
+                if (slot[i].obj) {
+                        size_t size = slot[i].slab->obj_size;
+                        for (size_t k = 0; k < size; k++) {
+                                HT_CHECK(slot[i].obj[k] == cast(u8_t, i));
+                        }
+
+                        HT_CHECK_OK(_slab_free(slot[i].slab, cast(void*, &slot[i].obj)));
+                        HT_CHECK(slot[i].obj == NULL);
+
+                } else {
+                        slot[i].slab = (i & 1) ? small : large;
+
+                        HT_CHECK_OK(_slab_alloc(slot[i].slab, cast(void*, &slot[i].obj)));
+                        HT_CHECK((cast(uintptr_t, slot[i].obj) % slot[i].slab->align) == 0);
+
+                        size_t size = slot[i].slab->obj_size;
+                        for (size_t k = 0; k < size; k++) {
+                                HT_CHECK(slot[i].obj[k] == 0);
+                        }
+
+                        memset(slot[i].obj, cast(u8_t, i), size);
+                }
+        }
+
+        // statistics
+        size_t used = 0;
+        for (int i = 1; i < SLOTS; i += 2) {
+                used += slot[i].obj ? 1 : 0;
+        }
+
+        _slab_stat_t stat = slab_stat(small);
+        HT_CHECK(stat.objects == used);
+        HT_CHECK(stat.objects_max >= used);
+        HT_CHECK(stat.cached <= MAGAZINE_SIZE);
+        HT_CHECK(stat.capacity >= stat.objects + stat.cached);
+
+        // object of other cache is not accepted
+        int i = 0;
+        while (!slot[i].obj || slot[i].slab != large) {
+                i++;
+        }
+
+        HT_CHECK(_slab_free(small, cast(void*, &slot[i].obj)) == EFAULT);
+        HT_CHECK(_slab_destroy(large) == EBUSY);
+
+        // objects cycled through magazine do not allocate pages
+        long blocks = ht_mem_blocks();
+        for (int n = 0; n < 1000; n++) {
+                void *obj[MAGAZINE_BATCH];
+
+                for (int k = 0; k < MAGAZINE_BATCH; k++) {
+                        HT_CHECK_OK(_slab_alloc(large, &obj[k]));
+                }
+
+                for (int k = 0; k < MAGAZINE_BATCH; k++) {
+                        HT_CHECK_OK(_slab_free(large, &obj[k]));
+                }
+        }
+
+        HT_CHECK(ht_mem_blocks() <= blocks + 1);
+
+        // all objects freed, only spare empty page is kept
+        for (int i = 0; i < SLOTS; i++) {
+                if (slot[i].obj) {
+                        HT_CHECK_OK(_slab_free(slot[i].slab, cast(void*, &slot[i].obj)));
+                }
+        }
+
+        stat = slab_stat(large);
+        HT_CHECK(stat.objects == 0 && stat.cached == 0);
+        HT_CHECK(stat.pages <= 1);
+
+        HT_CHECK_OK(_slab_destroy(small));
+        HT_CHECK_OK(_slab_destroy(large));
+        HT_CHECK(_slab_get_stat(0, &stat) == ENOENT);
+        HT_CHECK(ht_mem_blocks() == 0);
+
+        ht_print("slab: ok\n");
+        return 0;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -83,9 +83,19 @@ extern const u16_t memp_sizes[MEMP_MAX];
 
 #include "mem.h"
 
+#if MEMP_PORT_POOLS
+void  memp_port_init(void);
+void *memp_port_malloc(memp_t type);
+void  memp_port_free(memp_t type, void *mem);
+
+#define memp_init()           memp_port_init()
+#define memp_malloc(type)     memp_port_malloc(type)
+#define memp_free(type, mem)  memp_port_free((type), (mem))
+#else /* MEMP_PORT_POOLS */
 #define memp_init()
 #define memp_malloc(type)     mem_malloc(memp_sizes[type])
 #define memp_free(type, mem)  mem_free(mem)
+#endif /* MEMP_PORT_POOLS */
 
 #else /* MEMP_MEM_MALLOC */
 
@@ -115,6 +115,15 @@
 #define MEMP_MEM_MALLOC                 0
 #endif
 
+/**
+* MEMP_PORT_POOLS==1: With MEMP_MEM_MALLOC, memp_malloc/memp_free are served by
+* the port (memp_port_malloc/memp_port_free), which can keep selected pools
+* in dedicated memory and pass all other types to mem_malloc/mem_free.
+*/
+#ifndef MEMP_PORT_POOLS
+#define MEMP_PORT_POOLS                 0
+#endif
+
 /**
  * MEM_ALIGNMENT: should be set to the alignment of the CPU
  *    4 byte alignment -> #define MEM_ALIGNMENT 4
@@ -42,6 +42,7 @@ Brief    Network management.
   Local macros
 ==============================================================================*/
 #define MAXIMUM_SAFE_UDP_PAYLOAD                1024
+#define SENDFILE_TCP_CHUNK                      (TCP_MSS * 2)
 
 /*==============================================================================
   Local object types
@@ -58,6 +59,7 @@ static void  restore_configuration();
 static int   DHCP_start_client();
 static err_t netif_configure(struct netif *netif);
 static int   IF_up(const ip_addr_t *ip_address, const ip_addr_t *net_mask, const ip_addr_t *gateway);
+static int   LOOP_up(const ip_addr_t *ip_address, const ip_addr_t *net_mask, u16_t mtu);
 
 /*==============================================================================
   External function prototypes
@@ -67,16 +69,21 @@ extern int   _inetdrv_hardware_deinit  (inet_t *inet);
 extern err_t _inetdrv_handle_output    (struct netif *netif, struct pbuf *p);
 extern void  _inetdrv_handle_input     (inet_t *inet, u32_t timeout);
 extern bool  _inetdrv_is_link_connected(inet_t *inet);
+extern void  _memp_arch_get_stat       (NET_INET_pool_stat_t *stat);
+extern err_t _inetloop_netif_init      (struct netif *netif);
 
 /*==============================================================================
   Local objects
 ==============================================================================*/
 static inet_t     *inet;
+static _poll_list_t socket_poll;
 static const u32_t ACCESS_TIMEOUT = 10000;
 static const u32_t DHCP_TIMEOUT   = 5000;
 static const u32_t INIT_TIMEOUT   = 5000;
 static const u32_t INPUT_TIMEOUT  = 5000;
 static const u32_t LINK_POLL_TIME = 250;
+static const u16_t LOOP_MTU       = 1500;
+static const u16_t LOOP_MTU_MIN   = 68;
 
 /*==============================================================================
   Exported objects
@@ -275,6 +282,27 @@ static void create_lwIP_addr(ip_addr_t *lwip_addr, const NET_INET_IPv4_t *addr)
                  NET_INET_IPv4_d(*addr));
 }
 
+//==============================================================================
+/**
+ * @brief Function is called by lwIP when connection state is changed. Waiters
+ *        of poll() are woken up when data or connection was received, send
+ *        buffer was released, or error occurred. Connection has no reference
+ *        to socket, thus all sockets use one wait list and waiters are
+ *        selected by connection.
+ * @param conn          connection
+ * @param evt           event
+ * @param len           data length
+ */
+//==============================================================================
+static void netconn_event(struct netconn *conn, enum netconn_evt evt, u16_t len)
+{
+        UNUSED_ARG1(len);
+
+        if (evt != NETCONN_EVT_RCVMINUS && evt != NETCONN_EVT_SENDMINUS) {
+                sys_poll_notify(&socket_poll, conn);
+        }
+}
+
 //==============================================================================
 /**
  * @brief  Function starts network manager, TCP/IP stack, and set network interface.
@@ -342,6 +370,7 @@ static int IF_up(const ip_addr_t *ip_address, const ip_addr_t *net_mask, const i
 
         if (  inet && ip_address && net_mask && gateway
            && !netif_is_up(&inet->netif)
+           && !inet->loopback
            && is_init_done()
            && sys_mutex_lock(inet->access, ACCESS_TIMEOUT) == ESUCC ) {
 
@@ -363,6 +392,62 @@ static int IF_up(const ip_addr_t *ip_address, const ip_addr_t *net_mask, const i
         return status;
 }
 
+//==============================================================================
+/**
+ * @brief  Function configure loopback interface. Interface does not need any
+ *         hardware, thus it can be used on boards without Ethernet interface.
+ *         Ethernet interface cannot be configured when loopback is active.
+ * @param  ip_address        a IP address
+ * @param  net_mask          a net mask value
+ * @param  mtu               interface MTU
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static int LOOP_up(const ip_addr_t *ip_address, const ip_addr_t *net_mask, u16_t mtu)
+{
+        if (!inet) {
+                return ENONET;
+        }
+
+        if (netif_is_up(&inet->netif) || inet->loopback) {
+                return EADDRINUSE;
+        }
+
+        if (mtu < LOOP_MTU_MIN) {
+                return EINVAL;
+        }
+
+        int err = sys_mutex_lock(inet->access, ACCESS_TIMEOUT);
+        if (!err) {
+                clear_rx_tx_counters();
+
+                if (inet->loop.state == NULL) {
+                        netif_add(&inet->loop,
+                                  const_cast(ip_addr_t*, ip_address),
+                                  const_cast(ip_addr_t*, net_mask),
+                                  const_cast(ip_addr_t*, &ip_addr_any),
+                                  inet,
+                                  _inetloop_netif_init,
+                                  tcpip_input);
+                } else {
+                        netif_set_addr(&inet->loop,
+                                       const_cast(ip_addr_t*, ip_address),
+                                       const_cast(ip_addr_t*, net_mask),
+                                       const_cast(ip_addr_t*, &ip_addr_any));
+                }
+
+                inet->loop.mtu = mtu;
+                netif_set_up(&inet->loop);
+                netif_set_default(&inet->loop);
+
+                inet->loopback = true;
+
+                sys_mutex_unlock(inet->access);
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief  Function starts DHCP client
@@ -374,7 +459,7 @@ static int DHCP_start_client()
         int err = ENONET;
 
         if (inet) {
-                if (netif_is_up(&inet->netif)) {
+                if (netif_is_up(&inet->netif) || inet->loopback) {
                         err = EADDRINUSE;
                         goto finish;
                 }
@@ -557,6 +642,19 @@ int INET_ifup(const NET_INET_config_t *cfg)
                 err = DHCP_renew_connection();
                 break;
 
+        case NET_INET_MODE__LOOPBACK: {
+                NET_INET_IPv4_t a = cfg->address ? cfg->address : NET_INET_IPv4_LOOPBACK;
+                NET_INET_IPv4_t m = cfg->mask    ? cfg->mask    : cast(NET_INET_IPv4_t, NET_INET_IPv4(255,0,0,0));
+
+                ip_addr_t addr, mask;
+                create_lwIP_addr(&addr, &a);
+                create_lwIP_addr(&mask, &m);
+
+                err = LOOP_up(&addr, &mask, cfg->mtu ? cfg->mtu : LOOP_MTU);
+
+                break;
+        }
+
         default:
                 err = EINVAL;
         }
@@ -574,9 +672,19 @@ int INET_ifdown(void)
 {
         int status = ENONET;
 
-        if (  inet
-           && netif_is_up(&inet->netif)
-           && sys_mutex_lock(inet->access, ACCESS_TIMEOUT) == ESUCC ) {
+        if (inet && inet->loopback) {
+                if (sys_mutex_lock(inet->access, ACCESS_TIMEOUT) == ESUCC) {
+                        netif_set_down(&inet->loop);
+                        netif_set_default(&inet->netif);
+                        inet->loopback = false;
+                        status = ESUCC;
+
+                        sys_mutex_unlock(inet->access);
+                }
+
+        } else if (  inet
+                  && netif_is_up(&inet->netif)
+                  && sys_mutex_lock(inet->access, ACCESS_TIMEOUT) == ESUCC ) {
 
                 if (DHCP_is_started()) {
                         if (dhcp_release(&inet->netif) == ERR_OK) {
@@ -617,9 +725,19 @@ int INET_ifstatus(NET_INET_status_t *status)
                 status->tx_packets = inet->tx_packets;
                 status->tx_bytes   = inet->tx_bytes;
 
+                _memp_arch_get_stat(status->pool);
+
                 status->state      = NET_INET_STATE__NOT_CONFIGURED;
 
-                if (inet->configured) {
+                if (inet->loopback) {
+                        memset(status->hw_addr, 0, sizeof(status->hw_addr));
+
+                        status->state = NET_INET_STATE__LOOPBACK;
+
+                        create_addr(&status->address, &inet->loop.ip_addr);
+                        create_addr(&status->mask, &inet->loop.netmask);
+
+                } else if (inet->configured) {
                         if (inet->disconnected) {
                                 status->state = NET_INET_STATE__LINK_DISCONNECTED;
 
@@ -662,9 +780,10 @@ int INET_socket_create(NET_protocol_t prot, INET_socket_t *inet_sock)
 
                 _errno = 0;
 
-                inet_sock->netconn = netconn_new(prot == NET_PROTOCOL__TCP
-                                                       ? NETCONN_TCP
-                                                       : NETCONN_UDP);
+                inet_sock->netconn = netconn_new_with_callback(prot == NET_PROTOCOL__TCP
+                                                               ? NETCONN_TCP
+                                                               : NETCONN_UDP,
+                                                               netconn_event);
 
                 if (inet_sock->netconn) {
                         err = ESUCC;
@@ -695,6 +814,7 @@ int INET_socket_destroy(INET_socket_t *inet_sock)
 
         if (inet_sock->netconn) {
                 netconn_close(inet_sock->netconn);
+                sys_poll_notify(&socket_poll, inet_sock->netconn);
                 netconn_delete(inet_sock->netconn);
         }
 
@@ -1086,6 +1206,130 @@ int INET_socket_get_send_timeout(INET_socket_t *inet_sock, uint32_t *timeout)
         return ESUCC;
 }
 
+//==============================================================================
+/**
+ * @brief  Function send file data to socket. TCP stores data in own buffers
+ *         until acknowledged, thus data is copied to segments. UDP datagram
+ *         is passed to interface before send is finished, thus read buffer
+ *         is referenced without copy. File must be a regular file: position
+ *         is moved back by bytes not accepted by socket.
+ * @param  inet_sock    socket
+ * @param  file         source file
+ * @param  len          number of bytes to send
+ * @param  sent         number of sent bytes
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int INET_socket_sendfile(INET_socket_t *inet_sock, struct vfs_file *file, size_t len, size_t *sent)
+{
+        bool        tcp   = netconn_type(inet_sock->netconn) & NETCONN_TCP;
+        NET_flags_t flags = tcp ? NET_FLAGS__COPY : NET_FLAGS__NOCOPY;
+        size_t      size  = tcp ? SENDFILE_TCP_CHUNK : MAXIMUM_SAFE_UDP_PAYLOAD;
+
+        *sent = 0;
+
+        if (len == 0) {
+                return ESUCC;
+        }
+
+        size = (len < size) ? len : size;
+
+        // position of devices and pipes cannot be restored
+        struct stat stat;
+        int err = sys_fstat(file, &stat);
+        if (err) {
+                return err;
+
+        } else if (stat.st_type != FILE_TYPE_REGULAR) {
+                return ESPIPE;
+        }
+
+        u8_t *buf = NULL;
+        err = _kmalloc(_MM_NET, size, cast(void**, &buf));
+
+        while (!err && *sent < len) {
+                size_t chunk = len - *sent;
+                chunk = (chunk < size) ? chunk : size;
+
+                size_t rdcnt = 0;
+                err = sys_fread(buf, chunk, &rdcnt, file);
+                if (err || rdcnt == 0) {
+                        break;
+                }
+
+                size_t n = 0;
+                err = INET_socket_send(inet_sock, buf, rdcnt, flags, &n);
+                n   = err ? 0 : n;
+
+                *sent += n;
+
+                if (n < rdcnt) {
+                        int serr = sys_fseek(file, -cast(i64_t, rdcnt - n), VFS_SEEK_CUR);
+                        err = err ? err : serr;
+                        break;
+                }
+
+                if (rdcnt < chunk) {
+                        break;
+                }
+        }
+
+        if (buf) {
+                _kfree(_MM_NET, cast(void**, &buf));
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function returns socket events. Accepted connections inherit event
+ *         callback of listening socket, thus all sockets notify poll waiters.
+ * @param  inet_sock    socket
+ * @param  events       socket events (POLLIN, POLLOUT, ...)
+ * @param  entry        poll waiter entry (can be NULL)
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int INET_socket_poll(INET_socket_t *inet_sock, u32_t *events, struct _poll_entry *entry)
+{
+        struct netconn *conn = inet_sock->netconn;
+        size_t items = 0;
+
+        sys_poll_wait(&socket_poll, conn, entry);
+
+        *events = 0;
+
+        if (inet_sock->netbuf) {
+                *events |= POLLIN;
+        }
+
+        if (sys_mbox_valid(&conn->recvmbox)) {
+                sys_queue_get_number_of_items(conn->recvmbox, &items);
+        }
+
+#if LWIP_TCP
+        if (sys_mbox_valid(&conn->acceptmbox)) {
+                size_t accept = 0;
+                sys_queue_get_number_of_items(conn->acceptmbox, &accept);
+                items += accept;
+        }
+#endif
+
+        if (items > 0) {
+                *events |= POLLIN;
+        }
+
+        if (ERR_IS_FATAL(conn->last_err)) {
+                *events |= POLLERR | POLLHUP | POLLIN;
+
+        } else if (conn->type != NETCONN_TCP || conn->pcb.tcp) {
+                *events |= POLLOUT;
+        }
+
+        return ESUCC;
+}
+
 //==============================================================================
 /**
  * @brief  Function returns address of socket (remote connection address).
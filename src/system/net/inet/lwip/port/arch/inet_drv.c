@@ -37,6 +37,12 @@
 /*==============================================================================
   Local macros
 ==============================================================================*/
+/* received packets are stored in dedicated pool if enabled */
+#if MEMP_PORT_POOLS
+#define RX_PBUF_TYPE            PBUF_POOL
+#else
+#define RX_PBUF_TYPE            PBUF_RAM
+#endif
 
 /*==============================================================================
   Local object types
@@ -142,7 +148,7 @@ void _inetdrv_handle_input(inet_t *inet, u32_t timeout)
                 LWIP_DEBUGF(LOW_LEVEL_DEBUG, ("_netman_handle_input: packet size = %d\n", pw.pkt_size));
 
                 // NOTE: subtract packet size by 4 to discard CRC32
-                struct pbuf *p = pbuf_alloc(PBUF_RAW, pw.pkt_size - 4, PBUF_RAM);
+                struct pbuf *p = pbuf_alloc(PBUF_RAW, pw.pkt_size - 4, RX_PBUF_TYPE);
                 if (p) {
                         r = sys_ioctl(inet->if_file, IOCTL_ETHMAC__RECEIVE_PACKET_TO_CHAIN, p);
 
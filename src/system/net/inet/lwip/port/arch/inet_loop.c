@@ -0,0 +1,199 @@
+/*=========================================================================*//**
+@file    inet_loop.c
+
+@author  Daniel Zorychta
+
+@brief   Network manager. Loopback interface.
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "inet_types.h"
+#include "kernel/sysfunc.h"
+#include "lwip/ip.h"
+#include "lwip/tcpip.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+//==============================================================================
+/**
+ * @brief  Function pass all queued packets to the IP layer.
+ *
+ * @param  arg          inet container
+ *
+ * @note   Called from TCPIP thread.
+ */
+//==============================================================================
+static void loop_poll(void *arg)
+{
+        inet_t *inet = arg;
+
+        for (;;) {
+                struct pbuf *p;
+
+                sys_critical_section_begin();
+                {
+                        p = inet->loop_first;
+
+                        if (p) {
+                                inet->loop_first = p->next;
+                                inet->loop_queued--;
+
+                                if (inet->loop_first == NULL) {
+                                        inet->loop_last = NULL;
+                                }
+                        }
+                }
+                sys_critical_section_end();
+
+                if (p == NULL) {
+                        break;
+                }
+
+                p->next = NULL;
+
+                inet->rx_packets++;
+                inet->rx_bytes += p->tot_len;
+
+                if (ip_input(p, &inet->loop) != ERR_OK) {
+                        pbuf_free(p);
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function send IP packet to the loopback interface. Packet is copied
+ *         to the single buffer because callers keep sent buffers (e.g. TCP
+ *         retransmission queue) and modify them after return. Buffer is
+ *         passed to the TCPIP thread by one message per queued burst.
+ *
+ * @param  netif        loopback interface
+ * @param  p            IP packet (can be chained)
+ * @param  ipaddr       destination address (not used)
+ *
+ * @return ERR_OK on success, ERR_MEM if packet was dropped.
+ *
+ * @note   Called from TCPIP thread.
+ */
+//==============================================================================
+static err_t loop_output(struct netif *netif, struct pbuf *p, ip_addr_t *ipaddr)
+{
+        LWIP_UNUSED_ARG(ipaddr);
+
+        inet_t *inet = netif->state;
+
+#if LWIP_LOOPBACK_MAX_PBUFS
+        if (inet->loop_queued >= LWIP_LOOPBACK_MAX_PBUFS) {
+                return ERR_MEM;
+        }
+#endif
+
+        struct pbuf *r = pbuf_alloc(PBUF_LINK, p->tot_len, PBUF_RAM);
+        if (r == NULL) {
+                return ERR_MEM;
+        }
+
+        pbuf_copy(r, p);
+
+        // poll is scheduled only for the first packet of queue
+        if (inet->loop_first == NULL) {
+                if (tcpip_callback_with_block(loop_poll, inet, 0) != ERR_OK) {
+                        pbuf_free(r);
+                        return ERR_MEM;
+                }
+        }
+
+        sys_critical_section_begin();
+        {
+                if (inet->loop_last) {
+                        inet->loop_last->next = r;
+                } else {
+                        inet->loop_first = r;
+                }
+
+                inet->loop_last = r;
+                inet->loop_queued++;
+        }
+        sys_critical_section_end();
+
+        inet->tx_packets++;
+        inet->tx_bytes += p->tot_len;
+
+        return ERR_OK;
+}
+
+//==============================================================================
+/**
+ * @brief  Function configures loopback interface (TCPIP stack configuration).
+ *         Interface does not use link layer, packets are looped back at IP
+ *         level.
+ *
+ * @param  netif        the lwip network interface structure for this interface
+ *
+ * @return ERR_OK
+ *
+ * @note   Called by netif_add().
+ */
+//==============================================================================
+err_t _inetloop_netif_init(struct netif *netif)
+{
+        netif->name[0]    = 'l';
+        netif->name[1]    = 'o';
+        netif->output     = loop_output;
+        netif->linkoutput = NULL;
+        netif->hwaddr_len = 0;
+        netif->flags      = NETIF_FLAG_LINK_UP;
+
+        return ERR_OK;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
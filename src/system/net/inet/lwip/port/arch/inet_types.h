@@ -59,6 +59,10 @@ typedef struct {
         FILE           *if_file;
         tid_t           if_thread;
         struct netif    netif;
+        struct netif    loop;
+        struct pbuf    *loop_first;
+        struct pbuf    *loop_last;
+        u16_t           loop_queued;
         uint            rx_packets;
         uint            tx_packets;
         uint            rx_bytes;
@@ -66,6 +70,7 @@ typedef struct {
         bool            ready:1;
         bool            disconnected:1;
         bool            configured:1;
+        bool            loopback:1;
 } inet_t;
 
 /*==============================================================================
@@ -0,0 +1,277 @@
+/*=========================================================================*//**
+@file    memp_arch.c
+
+@author  Daniel Zorychta
+
+@brief   Dedicated lwIP memory pools.
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <string.h>
+#include "kernel/sysfunc.h"
+#include "net/netm.h"
+#include "lwip/opt.h"
+#include "lwip/memp.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp_impl.h"
+#include "lwip/netbuf.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#if MEMP_PORT_POOLS
+/* object sizes must be the same as in memp_sizes[] */
+#define PBUF_OBJ_SIZE           LWIP_MEM_ALIGN_SIZE(LWIP_MEM_ALIGN_SIZE(sizeof(struct pbuf)) \
+                                                    + LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE))
+#define NETBUF_OBJ_SIZE         LWIP_MEM_ALIGN_SIZE(sizeof(struct netbuf))
+
+#if LWIP_TCP
+#define TCP_SEG_OBJ_SIZE        LWIP_MEM_ALIGN_SIZE(sizeof(struct tcp_seg))
+#define TCP_SEG_OBJ_NUM         MEMP_NUM_TCP_SEG
+#else
+#define TCP_SEG_OBJ_SIZE        0
+#define TCP_SEG_OBJ_NUM         0
+#endif
+
+#define REGION_SIZE             ( (PBUF_POOL_SIZE  * PBUF_OBJ_SIZE)    \
+                                + (TCP_SEG_OBJ_NUM * TCP_SEG_OBJ_SIZE) \
+                                + (MEMP_NUM_NETBUF * NETBUF_OBJ_SIZE) )
+#endif
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+#if MEMP_PORT_POOLS
+/** Pool object. Free objects are linked by the first word. */
+typedef struct {
+        void   *free;                   //!< list of free objects
+        u8_t   *begin;                  //!< first object
+        u8_t   *end;                    //!< end of last object
+        u16_t   size;                   //!< object size
+        u16_t   total;                  //!< number of objects
+        u16_t   used;                   //!< number of used objects
+        u16_t   used_max;               //!< max number of used objects
+        u32_t   fails;                  //!< number of failed allocations
+} pool_t;
+#endif
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+#if MEMP_PORT_POOLS
+static pool_t pool[_NET_INET_POOL__COUNT];
+
+/* region reserved for pools, not used by kernel heap */
+static u8_t region[MEM_ALIGNMENT - 1 + REGION_SIZE];
+#endif
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+#if MEMP_PORT_POOLS
+//==============================================================================
+/**
+ * @brief  Function return pool of selected lwIP memory type.
+ *
+ * @param  type         memory type
+ *
+ * @return Pool object or NULL if type is allocated by mem_malloc().
+ */
+//==============================================================================
+static pool_t *get_pool(memp_t type)
+{
+        switch (type) {
+        case MEMP_PBUF_POOL: return &pool[NET_INET_POOL__PBUF];
+#if LWIP_TCP
+        case MEMP_TCP_SEG:   return &pool[NET_INET_POOL__TCP_SEG];
+#endif
+        case MEMP_NETBUF:    return &pool[NET_INET_POOL__NETBUF];
+        default:             return NULL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function divide part of region to pool objects.
+ *
+ * @param  p            pool to initialize
+ * @param  type         memory type
+ * @param  size         object size
+ * @param  total        number of objects
+ * @param  mem          region pointer (moved to end of pool)
+ */
+//==============================================================================
+static void pool_init(pool_t *p, memp_t type, u16_t size, u16_t total, u8_t **mem)
+{
+        LWIP_UNUSED_ARG(type);
+        LWIP_ASSERT("memp_port: object size mismatch", memp_sizes[type] == size);
+
+        p->size  = size;
+        p->total = total;
+        p->begin = *mem;
+        p->end   = *mem + (size * total);
+        p->free  = NULL;
+
+        for (int i = total - 1; i >= 0; i--) {
+                void *obj = p->begin + (i * size);
+                *cast(void**, obj) = p->free;
+                p->free = obj;
+        }
+
+        *mem = p->end;
+}
+
+//==============================================================================
+/**
+ * @brief  Function initialize dedicated pools. Called once by lwip_init().
+ */
+//==============================================================================
+void memp_port_init(void)
+{
+        u8_t *mem = LWIP_MEM_ALIGN(region);
+
+        memset(pool, 0, sizeof(pool));
+
+        pool_init(&pool[NET_INET_POOL__PBUF], MEMP_PBUF_POOL,
+                  PBUF_OBJ_SIZE, PBUF_POOL_SIZE, &mem);
+#if LWIP_TCP
+        pool_init(&pool[NET_INET_POOL__TCP_SEG], MEMP_TCP_SEG,
+                  TCP_SEG_OBJ_SIZE, TCP_SEG_OBJ_NUM, &mem);
+#endif
+        pool_init(&pool[NET_INET_POOL__NETBUF], MEMP_NETBUF,
+                  NETBUF_OBJ_SIZE, MEMP_NUM_NETBUF, &mem);
+}
+
+//==============================================================================
+/**
+ * @brief  Function allocate object of selected type. Objects of dedicated
+ *         pools are not taken from the kernel heap when pool is empty.
+ *
+ * @param  type         memory type
+ *
+ * @return Allocated object or NULL if no free memory.
+ */
+//==============================================================================
+void *memp_port_malloc(memp_t type)
+{
+        pool_t *p = get_pool(type);
+        if (!p) {
+                return mem_malloc(memp_sizes[type]);
+        }
+
+        void *obj;
+
+        sys_critical_section_begin();
+        {
+                obj = p->free;
+
+                if (obj) {
+                        p->free = *cast(void**, obj);
+                        p->used++;
+                        p->used_max = max(p->used, p->used_max);
+                } else {
+                        p->fails++;
+                }
+        }
+        sys_critical_section_end();
+
+        return obj;
+}
+
+//==============================================================================
+/**
+ * @brief  Function free object of selected type.
+ *
+ * @param  type         memory type
+ * @param  mem          object to free
+ */
+//==============================================================================
+void memp_port_free(memp_t type, void *mem)
+{
+        if (!mem) {
+                return;
+        }
+
+        pool_t *p = get_pool(type);
+        if (!p) {
+                mem_free(mem);
+                return;
+        }
+
+        LWIP_ASSERT("memp_port: object out of pool",
+                    cast(u8_t*, mem) >= p->begin && cast(u8_t*, mem) < p->end);
+
+        sys_critical_section_begin();
+        {
+                *cast(void**, mem) = p->free;
+                p->free = mem;
+                p->used--;
+        }
+        sys_critical_section_end();
+}
+#endif
+
+//==============================================================================
+/**
+ * @brief  Function return statistics of dedicated pools. All statistics are
+ *         zeroed if pools are disabled.
+ *
+ * @param  stat         statistics table (_NET_INET_POOL__COUNT items)
+ */
+//==============================================================================
+void _memp_arch_get_stat(NET_INET_pool_stat_t *stat)
+{
+        memset(stat, 0, _NET_INET_POOL__COUNT * sizeof(NET_INET_pool_stat_t));
+
+#if MEMP_PORT_POOLS
+        sys_critical_section_begin();
+        {
+                for (int i = 0; i < _NET_INET_POOL__COUNT; i++) {
+                        stat[i].size     = pool[i].size;
+                        stat[i].total    = pool[i].total;
+                        stat[i].used     = pool[i].used;
+                        stat[i].used_max = pool[i].used_max;
+                        stat[i].fails    = pool[i].fails;
+                }
+        }
+        sys_critical_section_end();
+#endif
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -122,6 +122,13 @@ static inline void *_netcalloc(size_t count, size_t size)
  */
 #define MEMP_MEM_MALLOC                         1
 
+/**
+ * MEMP_PORT_POOLS==1: PBUF_POOL, TCP_SEG, and NETBUF objects are allocated
+ * from dedicated pools reserved at build time (port/arch/memp_arch.c). Other
+ * types are allocated by mem_malloc().
+ */
+#define MEMP_PORT_POOLS                         __NETWORK_MEMP_DEDICATED_POOLS__
+
 /**
  * MEM_ALIGNMENT: should be set to the alignment of the CPU for which
  * lwIP is compiled. 4 byte alignment -> define MEM_ALIGNMENT to 4, 2
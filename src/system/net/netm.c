@@ -33,6 +33,7 @@ Brief    Network management.
 #include "net/inet/inet.h"
 #include "cpuctl.h"
 #include "kernel/sysfunc.h"
+#include "mm/slab.h"
 
 /*==============================================================================
   Local macros
@@ -61,6 +62,7 @@ typedef int (*proxy_func_t)();
 /*==============================================================================
   Local objects
 ==============================================================================*/
+static _slab_t *socket_slab[_NET_FAMILY__COUNT];
 
 /*==============================================================================
   Exported objects
@@ -88,9 +90,36 @@ static int socket_alloc(SOCKET **socket, NET_family_t family)
                 [NET_FAMILY__INET] = _mm_align(sizeof(INET_socket_t)),
         };
 
-        int err = _kzalloc(_MM_NET,
-                           _mm_align(sizeof(SOCKET)) + net_socket_size[family],
-                           cast(void**, socket));
+        static const char *const net_socket_name[_NET_FAMILY__COUNT] = {
+                [NET_FAMILY__INET] = "socket inet",
+        };
+
+        int err = ESUCC;
+
+        // socket cache is created at first use, only one cache can be registered
+        if (!socket_slab[family]) {
+                _slab_t *slab = NULL;
+                err = _slab_create(net_socket_name[family],
+                                   _mm_align(sizeof(SOCKET)) + net_socket_size[family],
+                                   0, _MM_NET, &slab);
+                if (!err) {
+                        _kernel_scheduler_lock();
+                        if (!socket_slab[family]) {
+                                socket_slab[family] = slab;
+                                slab = NULL;
+                        }
+                        _kernel_scheduler_unlock();
+
+                        if (slab) {
+                                _slab_destroy(slab);
+                        }
+                }
+        }
+
+        if (!err) {
+                err = _slab_alloc(socket_slab[family], cast(void**, socket));
+        }
+
         if (!err) {
                 (*socket)->header.type = RES_TYPE_SOCKET;
                 (*socket)->family      = family;
@@ -111,7 +140,7 @@ static int socket_alloc(SOCKET **socket, NET_family_t family)
 static void socket_free(SOCKET **socket)
 {
         (*socket)->header.type = RES_TYPE_UNKNOWN;
-        _kfree(_MM_NET, cast(void**, socket));
+        _slab_free(socket_slab[(*socket)->family], cast(void**, socket));
         *socket = NULL;
 }
 
@@ -583,6 +612,51 @@ int _net_socket_shutdown(SOCKET *socket, NET_shut_t how)
         }
 }
 
+//==============================================================================
+/**
+ * @brief Function send file data to socket.
+ * @param socket        socket
+ * @param file          source file (read from current position)
+ * @param len           number of bytes to send
+ * @param sent          number of sent bytes
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int _net_socket_sendfile(SOCKET *socket, FILE *file, size_t len, size_t *sent)
+{
+        PROXY_TABLE = {
+                PROXY_ADD_FAMILY(INET, INET_socket_sendfile),
+        };
+
+        if (is_socket_valid(socket) && file && sent) {
+                return call_proxy_function(socket->family, socket->ctx, file, len, sent);
+        } else {
+                return EINVAL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function return current socket events (POLLIN, POLLOUT, ...).
+ * @param socket        socket
+ * @param events        socket events
+ * @param entry         poll waiter entry (can be NULL)
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int _net_socket_poll(SOCKET *socket, u32_t *events, struct _poll_entry *entry)
+{
+        PROXY_TABLE = {
+                PROXY_ADD_FAMILY(INET, INET_socket_poll),
+        };
+
+        if (is_socket_valid(socket) && events) {
+                return call_proxy_function(socket->family, socket->ctx, events, entry);
+        } else {
+                return EINVAL;
+        }
+}
+
 //==============================================================================
 /**
  * @brief Function return address to which socket is connected.
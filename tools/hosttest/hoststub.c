@@ -0,0 +1,253 @@
+/*=========================================================================*//**
+File     hoststub.c
+
+Author   Daniel Zorychta
+
+Brief    Host test support: kernel services used by tested code and test
+         reporting functions.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "hosttest.h"
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static long     mem_blocks;
+static unsigned rand_state = 1;
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief Function stop test when condition is not true.
+ */
+//==============================================================================
+void ht_check(int ok, const char *expr, const char *file, int line)
+{
+        if (!ok) {
+                dprintf(STDERR_FILENO, "%s:%d: check failed: %s\n", file, line, expr);
+                exit(EXIT_FAILURE);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function stop test when expression returned an error.
+ */
+//==============================================================================
+void ht_check_err(int err, const char *expr, const char *file, int line)
+{
+        if (err) {
+                dprintf(STDERR_FILENO, "%s:%d: %s returned %d\n", file, line, expr, err);
+                exit(EXIT_FAILURE);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function print message to standard output. Output is written to the
+ *        file descriptor because tested kernel code can define own stdout.
+ */
+//==============================================================================
+void ht_print(const char *fmt, ...)
+{
+        va_list args;
+        va_start(args, fmt);
+        vdprintf(STDOUT_FILENO, fmt, args);
+        va_end(args);
+}
+
+//==============================================================================
+/**
+ * @brief Host memory allocation for test data.
+ */
+//==============================================================================
+void *ht_malloc(size_t size)
+{
+        void *mem = calloc(1, size);
+        ht_check(mem != NULL, "ht_malloc()", __FILE__, __LINE__);
+        return mem;
+}
+
+//==============================================================================
+/**
+ * @brief Host memory release.
+ */
+//==============================================================================
+void ht_free(void *mem)
+{
+        free(mem);
+}
+
+//==============================================================================
+/**
+ * @brief Repeatable pseudo random generator (independent of host libc).
+ */
+//==============================================================================
+unsigned ht_rand(void)
+{
+        rand_state = rand_state * 1103515245u + 12345u;
+        return (rand_state >> 1) & 0x7FFFFFFF;
+}
+
+//==============================================================================
+/**
+ * @brief Set seed of pseudo random generator.
+ */
+//==============================================================================
+void ht_srand(unsigned seed)
+{
+        rand_state = seed;
+}
+
+//==============================================================================
+/**
+ * @brief Monotonic host clock in microseconds (benchmarks).
+ */
+//==============================================================================
+unsigned long long ht_clock_us(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long long)ts.tv_sec * 1000000ull + (ts.tv_nsec / 1000);
+}
+
+//==============================================================================
+/**
+ * @brief Number of blocks allocated by kernel memory functions.
+ */
+//==============================================================================
+long ht_mem_blocks(void)
+{
+        return mem_blocks;
+}
+
+/*==============================================================================
+  Kernel services (weak, test can provide own implementation)
+==============================================================================*/
+__attribute__((weak))
+int _kmalloc(int mpur, const size_t size, void **mem, ...)
+{
+        (void)mpur;
+        *mem = malloc(size);
+        if (*mem) {
+                mem_blocks++;
+        }
+        return *mem ? 0 : 12 /* ENOMEM */;
+}
+
+__attribute__((weak))
+int _kzalloc(int mpur, const size_t size, void **mem, ...)
+{
+        (void)mpur;
+        *mem = calloc(1, size);
+        if (*mem) {
+                mem_blocks++;
+        }
+        return *mem ? 0 : 12 /* ENOMEM */;
+}
+
+__attribute__((weak))
+int _kfree(int mpur, void **mem, ...)
+{
+        (void)mpur;
+        if (*mem) {
+                free(*mem);
+                *mem = NULL;
+                mem_blocks--;
+        }
+        return 0;
+}
+
+__attribute__((weak))
+void _kernel_scheduler_lock(void)
+{
+}
+
+__attribute__((weak))
+void _kernel_scheduler_unlock(void)
+{
+}
+
+__attribute__((weak))
+void *_process_get_current(void)
+{
+        return NULL;
+}
+
+__attribute__((weak))
+void _process_exit(void *proc, int status)
+{
+        (void)proc;
+        exit(status);
+}
+
+__attribute__((weak))
+void _process_abort(void *proc)
+{
+        (void)proc;
+        abort();
+}
+
+__attribute__((weak))
+void _printk(const char *fmt, ...)
+{
+        (void)fmt;
+}
+
+__attribute__((weak))
+void _printk_log(int level, int subsys, const char *fmt, ...)
+{
+        (void)level;
+        (void)subsys;
+        (void)fmt;
+}
+
+__attribute__((weak))
+void _poll_wait(void *list, const void *obj, void *entry)
+{
+        (void)list;
+        (void)obj;
+        (void)entry;
+}
+
+__attribute__((weak))
+void _poll_list_release(void *list)
+{
+        (void)list;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
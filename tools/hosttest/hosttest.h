@@ -0,0 +1,76 @@
+/*=========================================================================*//**
+File     hosttest.h
+
+Author   Daniel Zorychta
+
+Brief    Host test support.
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Test sources are compiled with kernel headers, so host C library headers
+ * can not be included there. Functions below are implemented in hoststub.c
+ * which is compiled with host headers.
+ */
+
+#ifndef _HOSTTEST_H_
+#define _HOSTTEST_H_
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+/** Check condition, test is stopped on failure. */
+#define HT_CHECK(_expr)         ht_check(!!(_expr), #_expr, __FILE__, __LINE__)
+
+/** Check that expression returns 0 (ESUCC). */
+#define HT_CHECK_OK(_expr)      ht_check_err((_expr), #_expr, __FILE__, __LINE__)
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+extern void               ht_check(int ok, const char *expr, const char *file, int line);
+extern void               ht_check_err(int err, const char *expr, const char *file, int line);
+extern void               ht_print(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+extern void              *ht_malloc(size_t size);
+extern void               ht_free(void *mem);
+extern unsigned           ht_rand(void);
+extern void               ht_srand(unsigned seed);
+extern unsigned long long ht_clock_us(void);
+extern long               ht_mem_blocks(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HOSTTEST_H_ */
+/*==============================================================================
+  End of file
+==============================================================================*/
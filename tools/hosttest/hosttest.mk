@@ -0,0 +1,89 @@
+# Makefile for GNU make
+####################################################################################################
+#
+# Host test rules. File is included by test/Makefile placed next to the tested
+# code. The including Makefile defines:
+#
+#   HT_TESTS            list of test names
+#   <test>_SRC          test sources (test file and tested kernel sources)
+#   <test>_CFLAGS       additional compiler flags (optional)
+#
+# Sources are compiled with kernel headers for the host CPU. Kernel services
+# used by the tested code are provided by hoststub.c (memory, scheduler lock)
+# or by the test itself. Tests are built in build/hosttest and run by "make".
+#
+####################################################################################################
+
+HT_ROOT  := $(abspath $(dir $(lastword $(MAKEFILE_LIST)))/../..)
+HT_DIR   := $(HT_ROOT)/tools/hosttest
+HT_NAME  := $(subst /,_,$(patsubst $(HT_ROOT)/%,%,$(CURDIR)))
+HT_OUT   := $(HT_ROOT)/build/hosttest/$(HT_NAME)
+
+HT_CC    ?= gcc
+
+HT_SYS    = $(HT_ROOT)/src/system
+HT_INC    = -I$(HT_SYS)/config \
+            -I$(HT_SYS)/include \
+            -I$(HT_SYS)/include/libc \
+            -I$(HT_SYS)/drivers \
+            -I$(HT_SYS)/fs \
+            -I$(HT_SYS)/kernel/FreeRTOS/Source/include \
+            -I$(HT_SYS)/kernel/FreeRTOS \
+            -I$(HT_SYS)/kernel \
+            -I$(HT_SYS)/kernel/FreeRTOS/Source/portable/GCC/ARM_CM3 \
+            -I$(HT_SYS)/lib \
+            -I$(HT_SYS)/mm \
+            -I$(HT_SYS)/portable \
+            -I$(HT_SYS)/libc \
+            -I$(HT_SYS)/portable/stm32f1 \
+            -I$(HT_SYS)/portable/lib/CMSIS \
+            -I$(HT_ROOT)/src \
+            -I$(HT_DIR) \
+            $(addprefix -I,$(sort $(dir $(wildcard $(HT_SYS)/drivers/*/*_ioctl.h))))
+
+HT_CFLAGS = -std=gnu99 \
+            -g \
+            -O1 \
+            -Wall \
+            -Wextra \
+            -Wno-unused-parameter \
+            -fsanitize=address,undefined \
+            -fno-omit-frame-pointer \
+            -include $(HT_ROOT)/config/config.h \
+            -DCOMPILE_EPOCH_TIME=0 \
+            -D__ARM_ARCH_7M__ \
+            -idirafter $(HT_OUT)/stub
+
+HT_LFLAGS = -fsanitize=address,undefined
+
+HT_BINS   = $(addprefix $(HT_OUT)/,$(HT_TESTS))
+
+.PHONY : all run clean FORCE
+all : run
+
+run : $(HT_BINS)
+	@for test in $(HT_BINS); do \
+		echo "RUN  $$(basename $$test)"; \
+		(cd $(CURDIR) && $$test) || exit 1; \
+	done
+
+clean :
+	-@rm -rf $(HT_OUT)
+
+# empty replacements of toolchain specific headers used by libc headers
+$(HT_OUT)/stub :
+	@mkdir -p $@/machine
+	@touch $@/_ansi.h $@/machine/ieeefp.h
+
+$(HT_OUT)/hoststub.o : $(HT_DIR)/hoststub.c $(HT_DIR)/hosttest.h | $(HT_OUT)/stub
+	@$(HT_CC) -c -std=gnu99 -g -Wall -Wextra -fsanitize=address,undefined -o $@ $<
+
+define HT_TEST_RULE
+$(HT_OUT)/$(1) : $$($(1)_SRC) $(HT_OUT)/hoststub.o FORCE | $(HT_OUT)/stub
+	@echo "CC   $(1)"
+	@$(HT_CC) $(HT_CFLAGS) $$($(1)_CFLAGS) $(HT_INC) -o $$@ $$($(1)_SRC) $(HT_OUT)/hoststub.o $(HT_LFLAGS)
+endef
+
+$(foreach test,$(HT_TESTS),$(eval $(call HT_TEST_RULE,$(test))))
+
+FORCE :